@@ -0,0 +1,270 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "wx/init.h"
+#include "wx/wx.h"
+
+#include "allocation_stats.h"
+#include "delimiter_scanner.h"
+#include "polynomial_batch_searcher.h"
+
+namespace {
+
+/// \par OVERVIEW
+///
+/// This struct contains a registered benchmark.
+struct Entry {
+  /// \var function
+  ///   The benchmark function.
+  BenchmarkRunner::Function function;
+
+  /// \var name
+  ///   The benchmark name.
+  std::string name;
+};
+
+/// \brief Gets the registered benchmarks.
+/// This is a function static so it is initialized before the first
+/// registration.
+std::vector<Entry>& Entries() {
+  static std::vector<Entry> entries;
+  return entries;
+}
+
+/// \par OVERVIEW
+///
+/// This struct contains the result of a benchmark run.
+struct Result {
+  /// \var allocations
+  ///   The number of heap allocations.
+  int64_t allocations;
+
+  /// \var bytes_allocated
+  ///   The number of heap allocated bytes.
+  int64_t bytes_allocated;
+
+  /// \var bytes_processed
+  ///   The number of bytes processed.
+  int64_t bytes_processed;
+
+  /// \var error
+  ///   The error message.
+  std::string error;
+
+  /// \var iterations
+  ///   The number of iterations.
+  int64_t iterations;
+
+  /// \var seconds
+  ///   The run time.
+  double seconds;
+};
+
+/// \brief Runs a benchmark function once.
+Result RunOnce(const BenchmarkRunner::Function& function,
+               const int64_t& iterations) {
+  BenchmarkState state(iterations);
+
+  const AllocationStats::Counts counts_start =
+      AllocationStats::ThreadCounts();
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+
+  function(state);
+
+  const std::chrono::steady_clock::time_point stop =
+      std::chrono::steady_clock::now();
+
+  const AllocationStats::Counts counts_stop = AllocationStats::ThreadCounts();
+
+  Result result;
+  result.allocations = counts_stop.allocations - counts_start.allocations;
+  result.bytes_allocated = counts_stop.bytes - counts_start.bytes;
+  result.bytes_processed = state.bytes_per_iteration() * iterations;
+  result.error = state.error();
+  result.iterations = iterations;
+  result.seconds = std::chrono::duration<double>(stop - start).count();
+  return result;
+}
+
+/// \brief Writes a string with JSON escaping.
+void WriteJsonString(FILE* file, const std::string& str) {
+  std::fputc('"', file);
+  for (auto iter = str.cbegin(); iter != str.cend(); iter++) {
+    const char c = *iter;
+    if ((c == '"') || (c == '\\')) {
+      std::fputc('\\', file);
+      std::fputc(c, file);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      std::fprintf(file, "\\u%04x", c);
+    } else {
+      std::fputc(c, file);
+    }
+  }
+  std::fputc('"', file);
+}
+
+}  // namespace
+
+BenchmarkState::BenchmarkState(const int64_t& iterations) {
+  bytes_per_iteration_ = 0;
+  iterations_ = iterations;
+}
+
+void BenchmarkState::SkipWithError(const std::string& message) {
+  error_ = message;
+}
+
+int64_t BenchmarkState::bytes_per_iteration() const {
+  return bytes_per_iteration_;
+}
+
+const std::string& BenchmarkState::error() const {
+  return error_;
+}
+
+int64_t BenchmarkState::iterations() const {
+  return iterations_;
+}
+
+void BenchmarkState::set_bytes_per_iteration(
+    const int64_t& bytes_per_iteration) {
+  bytes_per_iteration_ = bytes_per_iteration;
+}
+
+bool BenchmarkRunner::Register(const char* name, Function function) {
+  Entry entry;
+  entry.function = function;
+  entry.name = name;
+  Entries().push_back(entry);
+  return true;
+}
+
+bool BenchmarkRunner::RunAll(const std::string& filter,
+                             const double& time_min,
+                             const std::string& filepath) {
+  FILE* file = stdout;
+  if (filepath.empty() == false) {
+    file = std::fopen(filepath.c_str(), "w");
+    if (file == nullptr) {
+      std::fprintf(stderr, "Could not open output file: %s\n",
+                   filepath.c_str());
+      return false;
+    }
+  }
+
+  std::fprintf(file, "{\n  \"context\": {\n");
+  std::fprintf(file, "    \"batch_searcher_avx2\": %s,\n",
+               PolynomialBatchSearcher::IsVectorized() ? "true" : "false");
+  std::fprintf(file, "    \"delimiter_scanner\": \"%s\"\n",
+               DelimiterScanner::InstructionSet());
+  std::fprintf(file, "  },\n  \"benchmarks\": [");
+
+  bool is_first = true;
+  for (auto iter = Entries().cbegin(); iter != Entries().cend(); iter++) {
+    const Entry& entry = *iter;
+    if ((filter.empty() == false)
+        && (entry.name.find(filter) == std::string::npos)) {
+      continue;
+    }
+
+    // increases iterations until the minimum time is reached
+    int64_t iterations = 1;
+    Result result = RunOnce(entry.function, iterations);
+    while ((result.error.empty() == true) && (result.seconds < time_min)
+           && (iterations < (1LL << 40))) {
+      double multiplier = 10;
+      if (0 < result.seconds) {
+        multiplier = std::min(10.0, 1.4 * time_min / result.seconds);
+      }
+      iterations = std::max(iterations + 1,
+                            static_cast<int64_t>(iterations * multiplier));
+      result = RunOnce(entry.function, iterations);
+    }
+
+    std::fprintf(file, "%s\n    {\"name\": ", is_first ? "" : ",");
+    WriteJsonString(file, entry.name);
+    is_first = false;
+
+    if (result.error.empty() == false) {
+      std::fprintf(file, ", \"error\": ");
+      WriteJsonString(file, result.error);
+      std::fprintf(file, "}");
+      std::fprintf(stderr, "%-45s ERROR: %s\n", entry.name.c_str(),
+                   result.error.c_str());
+      continue;
+    }
+
+    // writes result
+    const double ns_per_op = result.seconds * 1e9 / result.iterations;
+    const double allocs_per_op =
+        static_cast<double>(result.allocations) / result.iterations;
+    const double bytes_allocated_per_op =
+        static_cast<double>(result.bytes_allocated) / result.iterations;
+    double mb_per_s = 0;
+    if (0 < result.seconds) {
+      mb_per_s = result.bytes_processed / result.seconds / 1e6;
+    }
+
+    std::fprintf(file, ", \"iterations\": %lld, \"ns_per_op\": %.3f, "
+                       "\"allocs_per_op\": %.3f, "
+                       "\"bytes_allocated_per_op\": %.1f, "
+                       "\"throughput_mb_per_s\": %.3f}",
+                 static_cast<long long>(result.iterations), ns_per_op,
+                 allocs_per_op, bytes_allocated_per_op, mb_per_s);
+    std::fflush(file);
+
+    std::fprintf(stderr, "%-45s %14.1f ns/op %10.2f allocs/op\n",
+                 entry.name.c_str(), ns_per_op, allocs_per_op);
+  }
+
+  std::fprintf(file, "\n  ]\n}\n");
+
+  if (file != stdout) {
+    std::fclose(file);
+  }
+  return true;
+}
+
+/// \brief Runs the benchmarks.
+/// Usage: CableFileConverterBenchmarks [--filter=<substring>]
+///                                     [--min-time=<seconds>]
+///                                     [--output=<json file>]
+int main(int argc, char** argv) {
+  std::string filter;
+  std::string filepath;
+  double time_min = 0.2;
+
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg.compare(0, 9, "--filter=") == 0) {
+      filter = arg.substr(9);
+    } else if (arg.compare(0, 11, "--min-time=") == 0) {
+      time_min = std::atof(arg.substr(11).c_str());
+    } else if (arg.compare(0, 9, "--output=") == 0) {
+      filepath = arg.substr(9);
+    } else {
+      std::fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+      return 1;
+    }
+  }
+
+  // initializes wxWidgets and disables logging, so the benchmarks only
+  // measure the conversion code
+  wxInitializer initializer;
+  if (initializer.IsOk() == false) {
+    std::fprintf(stderr, "Could not initialize wxWidgets.\n");
+    return 1;
+  }
+  wxLog::EnableLogging(false);
+
+  return BenchmarkRunner::RunAll(filter, time_min, filepath) ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_BENCHMARK_H_
+#define OTLS_CABLEFILECONVERTER_BENCHMARK_H_
+
+#include <cstdint>
+#include <string>
+
+/// \par OVERVIEW
+///
+/// This class contains the state of a running benchmark.
+///
+/// A benchmark function runs its operation once per iteration. The number of
+/// iterations is chosen by the runner, which increases it until the timing is
+/// stable.
+///
+/// \code
+/// void BM_Example(BenchmarkState& state) {
+///   for (int64_t i = 0; i < state.iterations(); i++) {
+///     DoNotOptimize(Operation());
+///   }
+///   state.set_bytes_per_iteration(kSizeInput);
+/// }
+/// BENCHMARK(BM_Example);
+/// \endcode
+class BenchmarkState {
+ public:
+  /// \brief Constructor.
+  /// \param[in] iterations
+  ///   The number of iterations to run.
+  explicit BenchmarkState(const int64_t& iterations);
+
+  /// \brief Stops the benchmark and reports an error.
+  /// \param[in] message
+  ///   The error message.
+  /// The benchmark function should return after calling this.
+  void SkipWithError(const std::string& message);
+
+  /// \brief Gets the number of bytes processed per iteration.
+  /// \return The number of bytes processed per iteration.
+  int64_t bytes_per_iteration() const;
+
+  /// \brief Gets the error message.
+  /// \return The error message. This is empty if no error occurred.
+  const std::string& error() const;
+
+  /// \brief Gets the number of iterations to run.
+  /// \return The number of iterations to run.
+  int64_t iterations() const;
+
+  /// \brief Sets the number of bytes processed per iteration. This is used to
+  ///   calculate throughput.
+  /// \param[in] bytes_per_iteration
+  ///   The number of bytes processed per iteration.
+  void set_bytes_per_iteration(const int64_t& bytes_per_iteration);
+
+ private:
+  /// \var bytes_per_iteration_
+  ///   The number of bytes processed per iteration.
+  int64_t bytes_per_iteration_;
+
+  /// \var error_
+  ///   The error message.
+  std::string error_;
+
+  /// \var iterations_
+  ///   The number of iterations to run.
+  int64_t iterations_;
+};
+
+/// \par OVERVIEW
+///
+/// This class registers and runs benchmarks.
+///
+/// \par RESULTS
+///
+/// Each benchmark reports the time per operation, the heap allocations per
+/// operation, and the throughput. Allocations are counted by replacing the
+/// global operator new. The results are written as JSON.
+class BenchmarkRunner {
+ public:
+  /// The benchmark function type.
+  typedef void (*Function)(BenchmarkState& state);
+
+  /// \brief Registers a benchmark.
+  /// \param[in] name
+  ///   The benchmark name.
+  /// \param[in] function
+  ///   The benchmark function.
+  /// \return true. This allows registration during static initialization.
+  static bool Register(const char* name, Function function);
+
+  /// \brief Runs all benchmarks that match the filter.
+  /// \param[in] filter
+  ///   A substring of the benchmark names to run. If empty, all benchmarks are
+  ///   run.
+  /// \param[in] time_min
+  ///   The minimum run time of each benchmark, in seconds.
+  /// \param[in] filepath
+  ///   The JSON output filepath. If empty, the JSON is written to stdout.
+  /// \return The success status.
+  static bool RunAll(const std::string& filter, const double& time_min,
+                     const std::string& filepath);
+};
+
+/// \brief Prevents the compiler from optimizing away a value.
+/// \param[in] value
+///   The value.
+template<typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+
+/// Registers a benchmark function.
+#define BENCHMARK(function) \
+  static const bool benchmark_registered_##function = \
+      BenchmarkRunner::Register(#function, function)
+
+#endif  // OTLS_CABLEFILECONVERTER_BENCHMARK_H_
@@ -0,0 +1,236 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "benchmark_cable.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "models/base/units.h"
+#include "wx/filename.h"
+
+#include "file_parser.h"
+#include "mapped_file.h"
+
+namespace {
+
+/// \brief Formats a key and value line.
+std::string Line(const char* key, const double& value) {
+  char buffer[128];
+  std::snprintf(buffer, sizeof(buffer), "%s=%.17g\n", key, value);
+  return buffer;
+}
+
+/// \brief Formats a key and coefficients line.
+std::string Line(const char* key, const std::vector<double>& coefficients) {
+  std::string str = std::string(key) + "=";
+  for (auto iter = coefficients.cbegin(); iter != coefficients.cend();
+       iter++) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%s%.17g",
+                  iter == coefficients.cbegin() ? "" : " ", *iter);
+    str += buffer;
+  }
+  return str + "\n";
+}
+
+/// \brief Formats the component lines.
+std::string LinesComponent(const std::string& prefix,
+                           const CableComponent& component) {
+  std::string str;
+  str += Line((prefix + ".coefficient_expansion_linear_thermal").c_str(),
+              component.coefficient_expansion_linear_thermal);
+  str += Line((prefix + ".coefficients_polynomial_creep").c_str(),
+              component.coefficients_polynomial_creep);
+  str += Line((prefix + ".coefficients_polynomial_loadstrain").c_str(),
+              component.coefficients_polynomial_loadstrain);
+  str += Line((prefix + ".modulus_compression_elastic_area").c_str(),
+              component.modulus_compression_elastic_area);
+  str += Line((prefix + ".modulus_tension_elastic_area").c_str(),
+              component.modulus_tension_elastic_area);
+  return str;
+}
+
+/// \brief Parses a value into a number or coefficients.
+void ParseValue(const TextView& value, double& number) {
+  number = std::strtod(value.ToString().c_str(), nullptr);
+}
+
+void ParseValue(const TextView& value, std::vector<double>& coefficients) {
+  coefficients.clear();
+  FileParser::TokenIterator iter(value, " ");
+  TextView token;
+  while (iter.Next(token) == true) {
+    coefficients.push_back(std::strtod(token.ToString().c_str(), nullptr));
+  }
+}
+
+/// \brief Parses a component key and value.
+bool ParseComponent(const TextView& key, const TextView& value,
+                    CableComponent& component) {
+  if (key == "coefficient_expansion_linear_thermal") {
+    ParseValue(value, component.coefficient_expansion_linear_thermal);
+  } else if (key == "coefficients_polynomial_creep") {
+    ParseValue(value, component.coefficients_polynomial_creep);
+  } else if (key == "coefficients_polynomial_loadstrain") {
+    ParseValue(value, component.coefficients_polynomial_loadstrain);
+  } else if (key == "modulus_compression_elastic_area") {
+    ParseValue(value, component.modulus_compression_elastic_area);
+  } else if (key == "modulus_tension_elastic_area") {
+    ParseValue(value, component.modulus_tension_elastic_area);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+/// \brief Parses a benchmark cable input file.
+/// This is the benchmark definition of the externally linked parser.
+bool ParseCableFile(const wxString& filepath, units::UnitSystem& units,
+                    Cable& cable) {
+  MappedFile file;
+  if (file.Open(filepath) == false) {
+    return false;
+  }
+
+  return benchmark_cable::ParseRecord(filepath, file.contents(), 0, units,
+                                      cable);
+}
+
+namespace benchmark_cable {
+
+bool ParseRecord(const wxString& filepath, const TextView& record,
+                 const int& line_number, units::UnitSystem& units,
+                 Cable& cable) {
+  FileParser::LineIterator iter(record, line_number);
+  TextView line;
+  while (iter.Next(line) == true) {
+    TextView key;
+    TextView value;
+    if (FileParser::Separate(line, "=", key, value) == false) {
+      wxLogError(FileParser::FileAndLineNumber(filepath, iter.line_number())
+                 + "Invalid line.");
+      return false;
+    }
+
+    TextView name_component;
+    TextView key_component;
+    if (key == "name") {
+      cable.name = std::string(value.data(), value.size());
+    } else if (key == "area_physical") {
+      ParseValue(value, cable.area_physical);
+    } else if (key == "diameter") {
+      ParseValue(value, cable.diameter);
+    } else if (key == "strength_rated") {
+      ParseValue(value, cable.strength_rated);
+    } else if (key == "temperature_properties_components") {
+      ParseValue(value, cable.temperature_properties_components);
+    } else if (key == "weight_unit") {
+      ParseValue(value, cable.weight_unit);
+    } else if (FileParser::Separate(key, ".", name_component,
+                                    key_component) == true) {
+      CableComponent* component = nullptr;
+      if (name_component == "core") {
+        component = &cable.component_core;
+      } else if (name_component == "shell") {
+        component = &cable.component_shell;
+      }
+
+      if ((component == nullptr)
+          || (ParseComponent(key_component, value, *component) == false)) {
+        wxLogError(FileParser::FileAndLineNumber(filepath, iter.line_number())
+                   + "Invalid key.");
+        return false;
+      }
+    } else {
+      wxLogError(FileParser::FileAndLineNumber(filepath, iter.line_number())
+                 + "Invalid key.");
+      return false;
+    }
+  }
+
+  units = units::UnitSystem::kImperial;
+  return true;
+}
+
+Cable Drake() {
+  Cable cable;
+  cable.name = "Drake (795 kcmil 26/7 ACSR)";
+  cable.area_physical = 0.7264;
+  cable.diameter = 1.108;
+  cable.strength_rated = 31200;
+  cable.temperature_properties_components = 70;
+  cable.weight_unit = 1.094;
+
+  CableComponent& core = cable.component_core;
+  core.coefficient_expansion_linear_thermal = 0.0000064;
+  core.coefficients_polynomial_creep = {47.1, 36211.3, 12201.4, -72392, 46338};
+  core.coefficients_polynomial_loadstrain =
+      {-69.3, 38629, 3998.1, -45713, 27892};
+  core.load_limit_polynomial_creep = -999999;
+  core.load_limit_polynomial_loadstrain = -999999;
+  core.modulus_compression_elastic_area = 0;
+  core.modulus_tension_elastic_area = 37000 * 100;
+
+  CableComponent& shell = cable.component_shell;
+  shell.coefficient_expansion_linear_thermal = 0.0000128;
+  shell.coefficients_polynomial_creep =
+      {-544.8, 21426.8, -18842.2, 5495, 0};
+  shell.coefficients_polynomial_loadstrain =
+      {-1213, 44308.1, -14004.4, -37618, 30676};
+  shell.load_limit_polynomial_creep = -999999;
+  shell.load_limit_polynomial_loadstrain = -999999;
+  shell.modulus_compression_elastic_area = 1500 * 100;
+  shell.modulus_tension_elastic_area = 64000 * 100;
+
+  return cable;
+}
+
+std::string InputText() {
+  const Cable cable = Drake();
+
+  std::string str = "name=" + cable.name + "\n";
+  str += Line("area_physical", cable.area_physical);
+  str += Line("diameter", cable.diameter);
+  str += Line("strength_rated", cable.strength_rated);
+  str += Line("temperature_properties_components",
+              cable.temperature_properties_components);
+  str += Line("weight_unit", cable.weight_unit);
+  str += LinesComponent("core", cable.component_core);
+  str += LinesComponent("shell", cable.component_shell);
+  return str;
+}
+
+std::string InputTextRecords(const int& num_records) {
+  // each record has its own name, so the records can be told apart
+  const std::string text = InputText();
+  const std::size_t pos_line = text.find('\n');
+  const std::string name = text.substr(0, pos_line);
+  const std::string body = text.substr(pos_line);
+
+  std::string str;
+  for (int i = 0; i < num_records; i++) {
+    str += name + " #" + std::to_string(i + 1) + body;
+  }
+  return str;
+}
+
+wxString TempFilePath(const wxString& name) {
+  return wxFileName(wxFileName::GetTempDir(), name).GetFullPath();
+}
+
+bool WriteInputFile(const wxString& filepath) {
+  FILE* file = std::fopen(filepath.mb_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  const std::string text = InputText();
+  const bool status = std::fwrite(text.data(), 1, text.size(), file)
+                      == text.size();
+  return (std::fclose(file) == 0) && status;
+}
+
+}  // namespace benchmark_cable
@@ -0,0 +1,76 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_BENCHMARKCABLE_H_
+#define OTLS_CABLEFILECONVERTER_BENCHMARKCABLE_H_
+
+#include <string>
+
+#include "models/base/units.h"
+#include "models/transmissionline/cable.h"
+#include "wx/wx.h"
+
+#include "text_view.h"
+
+/// \par OVERVIEW
+///
+/// This namespace contains a representative cable for the benchmarks.
+///
+/// The cable is modeled after a 795 kcmil 26/7 ACSR (Drake) conductor, in
+/// 'consistent' imperial units.
+///
+/// \par INPUT FILE
+///
+/// The benchmarks link a ParseCableFile() that reads a simple 'key=value'
+/// text file, because the production parser is supplied externally. The
+/// parser uses the zero-copy FileParser helpers, so the end-to-end benchmark
+/// still includes a realistic parsing cost.
+namespace benchmark_cable {
+
+/// \brief Gets the benchmark cable.
+/// \return The benchmark cable.
+Cable Drake();
+
+/// \brief Gets the benchmark cable input file text.
+/// \return The input file text.
+std::string InputText();
+
+/// \brief Gets the text of a multi-record input file.
+/// \param[in] num_records
+///   The number of cable records.
+/// \return The input file text. Each record starts with a 'name=' line.
+std::string InputTextRecords(const int& num_records);
+
+/// \brief Parses a benchmark cable record.
+/// This has the ParserRegistry::ParseRecordFunction signature, and is also
+/// used to parse whole input files.
+/// \param[in] filepath
+///   The input filepath.
+/// \param[in] record
+///   The record text.
+/// \param[in] line_number
+///   The line number of the line before the record.
+/// \param[out] units
+///   The unit system that is populated.
+/// \param[out] cable
+///   The cable that is populated.
+/// \return The status of the record parsing.
+bool ParseRecord(const wxString& filepath, const TextView& record,
+                 const int& line_number, units::UnitSystem& units,
+                 Cable& cable);
+
+/// \brief Gets a filepath in the temporary directory.
+/// \param[in] name
+///   The file name.
+/// \return The filepath.
+wxString TempFilePath(const wxString& name);
+
+/// \brief Writes the benchmark cable input file.
+/// \param[in] filepath
+///   The filepath.
+/// \return The success status.
+bool WriteInputFile(const wxString& filepath);
+
+}  // namespace benchmark_cable
+
+#endif  // OTLS_CABLEFILECONVERTER_BENCHMARKCABLE_H_
@@ -0,0 +1,247 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "appcommon/units/cable_unit_converter.h"
+#include "wx/mstream.h"
+#include "wx/xml/xml.h"
+
+#include "benchmark.h"
+#include "benchmark_cable.h"
+#include "cable_binary_handler.h"
+#include "cable_binary_reader.h"
+#include "cable_converter.h"
+#include "cable_file_xml_handler.h"
+#include "cable_unit_table.h"
+#include "output_writer.h"
+#include "trace_recorder.h"
+#include "xml_stream_writer.h"
+
+/// \file
+/// These benchmarks measure the output serialization (XML and binary), the
+/// binary load, and the full conversion of a single file, which is what the
+/// app does for each input file. The unit conversion is measured with
+/// CableUnitConverter and with the precomputed factor tables. The trace span
+/// cost is also measured, with tracing disabled and enabled. The output writer
+/// is measured writing a batch of small cable files with each backend.
+
+namespace {
+
+/// \brief Gets the benchmark cable in the output unit style.
+Cable CableOutput() {
+  Cable cable = benchmark_cable::Drake();
+  CableUnitConverter::ConvertUnitStyleToDifferent(
+      units::UnitSystem::kImperial, true, cable);
+  return cable;
+}
+
+void BM_Serialize_XmlDocument(BenchmarkState& state) {
+  const Cable cable = CableOutput();
+  int64_t size = 0;
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    wxXmlDocument doc;
+    doc.SetRoot(CableFileXmlHandler::CreateNode(
+        cable, "", units::UnitSystem::kImperial,
+        units::UnitStyle::kDifferent));
+    wxMemoryOutputStream stream;
+    doc.Save(stream, 2);
+    size = stream.GetSize();
+  }
+  state.set_bytes_per_iteration(size);
+}
+BENCHMARK(BM_Serialize_XmlDocument);
+
+void BM_Serialize_XmlStreamWriter(BenchmarkState& state) {
+  const Cable cable = CableOutput();
+  XmlStreamWriter writer(2);
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    writer.Clear();
+    CableFileXmlHandler::WriteNode(cable, "", units::UnitSystem::kImperial,
+                                   units::UnitStyle::kDifferent, writer);
+    DoNotOptimize(writer.buffer().data());
+  }
+  state.set_bytes_per_iteration(writer.buffer().size());
+}
+BENCHMARK(BM_Serialize_XmlStreamWriter);
+
+void BM_Serialize_Binary(BenchmarkState& state) {
+  const Cable cable = CableOutput();
+  std::string buffer;
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    CableBinaryHandler::Write(cable, units::UnitSystem::kImperial, buffer);
+    DoNotOptimize(buffer.data());
+  }
+  state.set_bytes_per_iteration(buffer.size());
+}
+BENCHMARK(BM_Serialize_Binary);
+
+void BM_Load_Binary(BenchmarkState& state) {
+  std::string buffer;
+  CableBinaryHandler::Write(CableOutput(), units::UnitSystem::kImperial,
+                            buffer);
+
+  CableBinaryReader reader;
+  Cable cable;
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    wxString message;
+    if (reader.Attach(buffer, message) == false) {
+      state.SkipWithError("Invalid binary cable file.");
+      return;
+    }
+    reader.ToCable(cable);
+    DoNotOptimize(cable.diameter);
+  }
+  state.set_bytes_per_iteration(buffer.size());
+}
+BENCHMARK(BM_Load_Binary);
+
+void BM_CableConverter_Convert(BenchmarkState& state) {
+  const wxString filepath_input =
+      benchmark_cable::TempFilePath("otls_benchmark_input.txt");
+  const wxString filepath_output =
+      benchmark_cable::TempFilePath("otls_benchmark_output.cable");
+  if (benchmark_cable::WriteInputFile(filepath_input) == false) {
+    state.SkipWithError("Could not write input file.");
+    return;
+  }
+
+  CableConverter converter;
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    wxString message;
+    DoNotOptimize(converter.Convert(filepath_input, filepath_output,
+                                    message));
+  }
+  state.set_bytes_per_iteration(benchmark_cable::InputText().size());
+
+  wxRemoveFile(filepath_input);
+  wxRemoveFile(filepath_output);
+}
+BENCHMARK(BM_CableConverter_Convert);
+
+void BM_ConvertUnits_CableUnitConverter(BenchmarkState& state) {
+  // each iteration converts to metric and back, so the values don't drift
+  Cable cable = benchmark_cable::Drake();
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    CableUnitConverter::ConvertUnitSystem(units::UnitSystem::kImperial,
+                                          units::UnitSystem::kMetric, true,
+                                          cable);
+    CableUnitConverter::ConvertUnitSystem(units::UnitSystem::kMetric,
+                                          units::UnitSystem::kImperial, true,
+                                          cable);
+    DoNotOptimize(cable.diameter);
+  }
+}
+BENCHMARK(BM_ConvertUnits_CableUnitConverter);
+
+void BM_ConvertUnits_Table(BenchmarkState& state) {
+  const CableUnitTable* table_to = CableUnitTable::Find(
+      units::UnitSystem::kImperial, units::UnitSystem::kMetric,
+      units::UnitStyle::kConsistent);
+  const CableUnitTable* table_from = CableUnitTable::Find(
+      units::UnitSystem::kMetric, units::UnitSystem::kImperial,
+      units::UnitStyle::kConsistent);
+  if ((table_to == nullptr) || (table_from == nullptr)) {
+    state.SkipWithError("No unit table for the conversion.");
+    return;
+  }
+
+  Cable cable = benchmark_cable::Drake();
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    table_to->Convert(cable);
+    table_from->Convert(cable);
+    DoNotOptimize(cable.diameter);
+  }
+}
+BENCHMARK(BM_ConvertUnits_Table);
+
+void BM_ConvertUnits_TableBatch(BenchmarkState& state) {
+  // converts a batch of cables, and reports the time for the whole batch
+  const CableUnitTable* table_to = CableUnitTable::Find(
+      units::UnitSystem::kImperial, units::UnitSystem::kMetric,
+      units::UnitStyle::kConsistent);
+  const CableUnitTable* table_from = CableUnitTable::Find(
+      units::UnitSystem::kMetric, units::UnitSystem::kImperial,
+      units::UnitStyle::kConsistent);
+  if ((table_to == nullptr) || (table_from == nullptr)) {
+    state.SkipWithError("No unit table for the conversion.");
+    return;
+  }
+
+  std::vector<Cable> cables(64, benchmark_cable::Drake());
+  std::vector<Cable*> pointers;
+  for (auto iter = cables.begin(); iter != cables.end(); iter++) {
+    pointers.push_back(&*iter);
+  }
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    table_to->Convert(pointers);
+    table_from->Convert(pointers);
+    DoNotOptimize(cables.front().diameter);
+  }
+}
+BENCHMARK(BM_ConvertUnits_TableBatch);
+
+void BM_TraceSpan_Disabled(BenchmarkState& state) {
+  const wxString filepath = "cable.txt";
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    TraceSpan span(nullptr, "Benchmark", filepath);
+  }
+}
+BENCHMARK(BM_TraceSpan_Disabled);
+
+void BM_TraceSpan_Enabled(BenchmarkState& state) {
+  const wxString filepath = "cable.txt";
+  TraceRecorder recorder;
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    TraceSpan span(&recorder, "Benchmark", filepath);
+  }
+}
+BENCHMARK(BM_TraceSpan_Enabled);
+
+/// \brief Writes batches of small cable files with an output writer backend.
+void WriteBatches(BenchmarkState& state,
+                  const OutputWriter::Backend& backend) {
+  const int kNumFiles = 64;
+  std::string buffer;
+  CableBinaryHandler::Write(CableOutput(), units::UnitSystem::kImperial,
+                            buffer);
+
+  std::vector<OutputWriter::File> files(kNumFiles);
+  for (int i = 0; i < kNumFiles; i++) {
+    files[i].data = &buffer;
+    files[i].filepath = benchmark_cable::TempFilePath(
+        "otls_benchmark_output_" + std::to_string(i) + ".cablebin");
+  }
+
+  OutputWriter writer;
+  OutputWriter::Options options;
+  options.backend = backend;
+  options.sync = OutputWriter::SyncPolicy::kNone;
+  writer.Open(options);
+
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    if (writer.Write(files) == false) {
+      state.SkipWithError("Could not write output files.");
+      break;
+    }
+  }
+  state.set_bytes_per_iteration(kNumFiles * buffer.size());
+
+  for (int i = 0; i < kNumFiles; i++) {
+    wxRemoveFile(files[i].filepath);
+  }
+}
+
+void BM_OutputWriter_Posix(BenchmarkState& state) {
+  WriteBatches(state, OutputWriter::Backend::kPosix);
+}
+BENCHMARK(BM_OutputWriter_Posix);
+
+void BM_OutputWriter_IoUring(BenchmarkState& state) {
+  WriteBatches(state, OutputWriter::Backend::kIoUring);
+}
+BENCHMARK(BM_OutputWriter_IoUring);
+
+}  // namespace
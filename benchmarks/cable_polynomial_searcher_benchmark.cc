@@ -0,0 +1,144 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include <vector>
+
+#include "models/base/polynomial.h"
+
+#include "benchmark.h"
+#include "benchmark_cable.h"
+#include "cable_limit_table.h"
+#include "cable_polynomial_searcher.h"
+#include "polynomial_batch_searcher.h"
+#include "polynomial_kernel.h"
+#include "polynomial_limit_cache.h"
+
+/// \file
+/// These benchmarks measure the polynomial limit search. Each SolveLimits()
+/// call searches all four component polynomials (core/shell, creep/loadstrain)
+/// by inflection and by slope, so it covers every limit search path.
+
+namespace {
+
+/// The number of cables in the batch benchmarks.
+const int kNumCablesBatch = 256;
+
+/// The scan parameters, which match CablePolynomialSearcher.
+const double kXMin = 0.0;
+const double kXStep = 0.001;
+const double kXMax = 1.0;
+
+void BM_SolveLimits_Scan(BenchmarkState& state) {
+  const Cable cable_base = benchmark_cable::Drake();
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    Cable cable = cable_base;
+    DoNotOptimize(CablePolynomialSearcher::SolveLimits(-1, cable));
+  }
+}
+BENCHMARK(BM_SolveLimits_Scan);
+
+void BM_SolveLimits_Roots(BenchmarkState& state) {
+  const Cable cable_base = benchmark_cable::Drake();
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    Cable cable = cable_base;
+    DoNotOptimize(CablePolynomialSearcher::SolveLimits(
+        -1, CablePolynomialSearcher::SearchType::kRoots, 0.000001, nullptr,
+        cable));
+  }
+}
+BENCHMARK(BM_SolveLimits_Roots);
+
+void BM_SolveLimits_ScanCached(BenchmarkState& state) {
+  const Cable cable_base = benchmark_cable::Drake();
+  PolynomialLimitCache cache;
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    Cable cable = cable_base;
+    DoNotOptimize(CablePolynomialSearcher::SolveLimits(
+        -1, CablePolynomialSearcher::SearchType::kScan, -1, &cache, cable));
+  }
+}
+BENCHMARK(BM_SolveLimits_ScanCached);
+
+void BM_SolveLimits_Batch(BenchmarkState& state) {
+  const std::vector<Cable> cables_base(kNumCablesBatch,
+                                       benchmark_cable::Drake());
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    std::vector<Cable> cables = cables_base;
+    std::vector<Cable*> pointers;
+    for (auto iter = cables.begin(); iter != cables.end(); iter++) {
+      pointers.push_back(&*iter);
+    }
+    DoNotOptimize(CablePolynomialSearcher::SolveLimits(-1, -1, nullptr,
+                                                       pointers));
+  }
+}
+BENCHMARK(BM_SolveLimits_Batch);
+
+void BM_SolveLimits_FixedStrainSweep(BenchmarkState& state) {
+  const Cable cable_base = benchmark_cable::Drake();
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    for (double x = kXMin; x <= kXMax; x += kXStep) {
+      Cable cable = cable_base;
+      DoNotOptimize(CablePolynomialSearcher::SolveLimits(x, cable));
+    }
+  }
+}
+BENCHMARK(BM_SolveLimits_FixedStrainSweep);
+
+void BM_CableLimitTable_Solve(BenchmarkState& state) {
+  const Cable cable = benchmark_cable::Drake();
+  CableLimitTable::Range range;
+  range.start = kXMin;
+  range.step = kXStep;
+  range.stop = kXMax;
+
+  CableLimitTable table;
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    DoNotOptimize(table.Solve(cable, range));
+  }
+}
+BENCHMARK(BM_CableLimitTable_Solve);
+
+void BM_PolynomialBatchSearcher_Search(BenchmarkState& state) {
+  const Cable cable = benchmark_cable::Drake();
+  PolynomialBatchSearcher searcher;
+  for (int i = 0; i < kNumCablesBatch; i++) {
+    searcher.Add(cable.component_shell.coefficients_polynomial_loadstrain, 0,
+                 cable.component_shell.modulus_tension_elastic_area / 100);
+  }
+
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    DoNotOptimize(searcher.Search(kXMin, 0.1, kXStep, kXMax));
+  }
+}
+BENCHMARK(BM_PolynomialBatchSearcher_Search);
+
+void BM_Polynomial_ScanGeneric(BenchmarkState& state) {
+  std::vector<double> coefficients =
+      benchmark_cable::Drake().component_core.coefficients_polynomial_creep;
+  const Polynomial polynomial(&coefficients);
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    for (double x = kXMin; x <= kXMax; x += kXStep) {
+      DoNotOptimize(polynomial.Y(x));
+      DoNotOptimize(polynomial.Slope(x));
+    }
+  }
+}
+BENCHMARK(BM_Polynomial_ScanGeneric);
+
+void BM_Polynomial_ScanKernel(BenchmarkState& state) {
+  const PolynomialKernel<5> kernel(
+      benchmark_cable::Drake().component_core.coefficients_polynomial_creep);
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    for (double x = kXMin; x <= kXMax; x += kXStep) {
+      double y;
+      double slope;
+      kernel.Evaluate(x, y, slope);
+      DoNotOptimize(y);
+      DoNotOptimize(slope);
+    }
+  }
+}
+BENCHMARK(BM_Polynomial_ScanKernel);
+
+}  // namespace
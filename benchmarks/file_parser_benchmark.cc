@@ -0,0 +1,222 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "benchmark_cable.h"
+#include "conversion_arena.h"
+#include "delimiter_scanner.h"
+#include "file_parser.h"
+#include "record_parser.h"
+
+/// \file
+/// These benchmarks measure the FileParser string helpers on line widths that
+/// are typical of cable files: a short 'key = value' line, and a wide
+/// comma separated line of polynomial coefficients and table values. The
+/// wxString helpers are compared against the zero-copy TextView helpers and
+/// the DelimiterScanner, with and without a conversion arena. The
+/// RecordParser benchmarks split and parse a multi-record file, on one thread
+/// and on all hardware threads.
+
+namespace {
+
+/// \brief Gets a short key and value line.
+const std::string& LineNarrow() {
+  static const std::string line =
+      "\"modulus_tension_elastic_area\", \"6400000\"";
+  return line;
+}
+
+/// \brief Gets a wide comma separated line.
+const std::string& LineWide() {
+  static std::string line;
+  if (line.empty() == true) {
+    const char* values[] = {"-1213", "44308.1", "-14004.4", "-37618",
+                            "30676", "0.0000128", "64000", "1500"};
+    for (int i = 0; i < 64; i++) {
+      if (i != 0) {
+        line += ",";
+      }
+      line += values[i % 8];
+    }
+  }
+  return line;
+}
+
+void BM_FileParser_Separate_wxString(BenchmarkState& state) {
+  const wxString line(LineNarrow());
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    wxString left;
+    wxString right;
+    DoNotOptimize(FileParser::Separate(line, ",", left, right));
+    DoNotOptimize(right);
+  }
+  state.set_bytes_per_iteration(LineNarrow().size());
+}
+BENCHMARK(BM_FileParser_Separate_wxString);
+
+void BM_FileParser_Separate_TextView(BenchmarkState& state) {
+  const TextView line(LineNarrow());
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    TextView left;
+    TextView right;
+    DoNotOptimize(FileParser::Separate(line, ",", left, right));
+    DoNotOptimize(right);
+  }
+  state.set_bytes_per_iteration(LineNarrow().size());
+}
+BENCHMARK(BM_FileParser_Separate_TextView);
+
+void BM_FileParser_Extract_wxString(BenchmarkState& state) {
+  const wxString line(LineNarrow());
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    DoNotOptimize(FileParser::Extract(line, "\""));
+  }
+  state.set_bytes_per_iteration(LineNarrow().size());
+}
+BENCHMARK(BM_FileParser_Extract_wxString);
+
+void BM_FileParser_Extract_TextView(BenchmarkState& state) {
+  const TextView line(LineNarrow());
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    DoNotOptimize(FileParser::Extract(line, "\""));
+  }
+  state.set_bytes_per_iteration(LineNarrow().size());
+}
+BENCHMARK(BM_FileParser_Extract_TextView);
+
+void BM_FileParser_SubStrings_Narrow(BenchmarkState& state) {
+  const wxString line(LineNarrow());
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    DoNotOptimize(FileParser::SubStrings(line, ","));
+  }
+  state.set_bytes_per_iteration(LineNarrow().size());
+}
+BENCHMARK(BM_FileParser_SubStrings_Narrow);
+
+void BM_FileParser_SubStrings_Wide(BenchmarkState& state) {
+  const wxString line(LineWide());
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    DoNotOptimize(FileParser::SubStrings(line, ","));
+  }
+  state.set_bytes_per_iteration(LineWide().size());
+}
+BENCHMARK(BM_FileParser_SubStrings_Wide);
+
+void BM_FileParser_TokenIterator_Wide(BenchmarkState& state) {
+  const TextView line(LineWide());
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    FileParser::TokenIterator iter(line, ",");
+    TextView token;
+    while (iter.Next(token) == true) {
+      DoNotOptimize(token);
+    }
+  }
+  state.set_bytes_per_iteration(LineWide().size());
+}
+BENCHMARK(BM_FileParser_TokenIterator_Wide);
+
+void BM_DelimiterScanner_Split_Wide(BenchmarkState& state) {
+  const TextView line(LineWide());
+  DelimiterScanner::FieldIndex index;
+  ArenaVector<TextView> tokens;
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    DelimiterScanner::Index(line, ",", "\"", index);
+    DelimiterScanner::Split(index, tokens);
+    DoNotOptimize(tokens.data());
+  }
+  state.set_bytes_per_iteration(LineWide().size());
+}
+BENCHMARK(BM_DelimiterScanner_Split_Wide);
+
+void BM_DelimiterScanner_Split_Wide_PerFile(BenchmarkState& state) {
+  // each iteration is a new conversion, so the index and tokens are created
+  // again from the heap
+  const TextView line(LineWide());
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    DelimiterScanner::FieldIndex index;
+    ArenaVector<TextView> tokens;
+    DelimiterScanner::Index(line, ",", "\"", index);
+    DelimiterScanner::Split(index, tokens);
+    DoNotOptimize(tokens.data());
+  }
+  state.set_bytes_per_iteration(LineWide().size());
+}
+BENCHMARK(BM_DelimiterScanner_Split_Wide_PerFile);
+
+void BM_DelimiterScanner_Split_Wide_PerFileArena(BenchmarkState& state) {
+  // each iteration is a new conversion, so the index and tokens are created
+  // again from the reset arena
+  const TextView line(LineWide());
+  ConversionArena arena;
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    ConversionArena::Scope scope(&arena);
+    DelimiterScanner::FieldIndex index;
+    ArenaVector<TextView> tokens;
+    DelimiterScanner::Index(line, ",", "\"", index);
+    DelimiterScanner::Split(index, tokens);
+    DoNotOptimize(tokens.data());
+  }
+  state.set_bytes_per_iteration(LineWide().size());
+}
+BENCHMARK(BM_DelimiterScanner_Split_Wide_PerFileArena);
+
+void BM_FileParser_LineIterator_CableFile(BenchmarkState& state) {
+  const std::string text = benchmark_cable::InputText();
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    FileParser::LineIterator iter(text);
+    TextView line;
+    while (iter.Next(line) == true) {
+      DoNotOptimize(line);
+    }
+  }
+  state.set_bytes_per_iteration(text.size());
+}
+BENCHMARK(BM_FileParser_LineIterator_CableFile);
+
+/// \brief Gets a multi-record input file with 2000 records.
+const std::string& TextRecords() {
+  static const std::string text = benchmark_cable::InputTextRecords(2000);
+  return text;
+}
+
+void BM_RecordParser_Split(BenchmarkState& state) {
+  const TextView text(TextRecords());
+  std::vector<RecordParser::Record> records;
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    RecordParser::Split(text, "name=", records);
+    DoNotOptimize(records.data());
+  }
+  state.set_bytes_per_iteration(TextRecords().size());
+}
+BENCHMARK(BM_RecordParser_Split);
+
+void BM_RecordParser_Parse_1Thread(BenchmarkState& state) {
+  std::vector<RecordParser::Record> records;
+  RecordParser::Split(TextRecords(), "name=", records);
+  std::vector<RecordParser::Result> results;
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    DoNotOptimize(RecordParser::Parse("records.txt", records,
+                                      benchmark_cable::ParseRecord, 1,
+                                      nullptr, results));
+  }
+  state.set_bytes_per_iteration(TextRecords().size());
+}
+BENCHMARK(BM_RecordParser_Parse_1Thread);
+
+void BM_RecordParser_Parse_AllThreads(BenchmarkState& state) {
+  std::vector<RecordParser::Record> records;
+  RecordParser::Split(TextRecords(), "name=", records);
+  std::vector<RecordParser::Result> results;
+  for (int64_t i = 0; i < state.iterations(); i++) {
+    DoNotOptimize(RecordParser::Parse("records.txt", records,
+                                      benchmark_cable::ParseRecord, 0,
+                                      nullptr, results));
+  }
+  state.set_bytes_per_iteration(TextRecords().size());
+}
+BENCHMARK(BM_RecordParser_Parse_AllThreads);
+
+}  // namespace
@@ -0,0 +1,51 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_ALLOCATIONSTATS_H_
+#define OTLS_CABLEFILECONVERTER_ALLOCATIONSTATS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+/// \par OVERVIEW
+///
+/// This class counts the heap allocations made by each thread.
+///
+/// The global operator new is replaced (see allocation_hooks.cc), and every
+/// allocation is counted, including allocations made inside wxWidgets and the
+/// standard library. The replacement is only linked into the app and the
+/// benchmarks, so the converter library leaves the host allocator alone, and
+/// the counts stay zero there. The counts are kept per thread, so counting
+/// never contends between threads, and the difference in counts over a block
+/// of code is the allocations made by that block on the calling thread.
+///
+/// \par THREAD SAFETY
+///
+/// All methods are safe to call from multiple threads. Each thread only sees
+/// its own counts.
+class AllocationStats {
+ public:
+  /// \par OVERVIEW
+  ///
+  /// This struct contains allocation counts.
+  struct Counts {
+    /// \var allocations
+    ///   The number of heap allocations.
+    int64_t allocations;
+
+    /// \var bytes
+    ///   The number of heap allocated bytes.
+    int64_t bytes;
+  };
+
+  /// \brief Counts an allocation on the calling thread.
+  /// \param[in] size
+  ///   The allocation size, in bytes.
+  static void Count(const std::size_t& size);
+
+  /// \brief Gets the counts of the calling thread.
+  /// \return The counts since the thread started.
+  static Counts ThreadCounts();
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_ALLOCATIONSTATS_H_
@@ -0,0 +1,204 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_ASYNCLOGSINK_H_
+#define OTLS_CABLEFILECONVERTER_ASYNCLOGSINK_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "wx/wx.h"
+
+/// \par OVERVIEW
+///
+/// This class is a log target that writes to a file on a background thread.
+///
+/// Logging threads only format the message and push a record onto a queue.
+/// A background thread drains the queue, formats each record into a line,
+/// and writes the lines to the file in batches. Each line contains a
+/// timestamp, the logging thread, the input file the thread is converting (if
+/// any), the level, the message, and the source file and line number.
+///
+/// \par QUEUE
+///
+/// The queue is a fixed size lock-free ring buffer. Logging threads never
+/// wait on a lock or on the file. If the queue is full, the record is dropped
+/// and counted, and the number of dropped records is written to the file.
+///
+/// \par THREADS
+///
+/// By default wxWidgets buffers messages from secondary threads behind a lock
+/// until the main thread flushes them. This target is thread safe, so it can
+/// also be set as the thread active target (wxLog::SetThreadActiveTarget) of
+/// worker threads to log directly.
+class AsyncLogSink : public wxLog {
+ public:
+  /// \brief Default constructor.
+  AsyncLogSink();
+
+  /// \brief Destructor. This closes the sink.
+  ~AsyncLogSink();
+
+  /// \brief Writes all queued records and closes the file.
+  void Close();
+
+  /// \brief Waits until all records that were queued before this call are
+  ///   written.
+  virtual void Flush();
+
+  /// \brief Opens a file for appending and starts the writer thread.
+  /// \param[in] filepath
+  ///   The log filepath.
+  /// \return The success status.
+  bool Open(const wxString& filepath);
+
+  /// \brief Gets the number of records that were dropped because the queue
+  ///   was full.
+  /// \return The number of dropped records.
+  uint64_t num_dropped() const;
+
+ protected:
+  /// \brief Queues a log record.
+  /// \param[in] level
+  ///   The log level.
+  /// \param[in] msg
+  ///   The message.
+  /// \param[in] info
+  ///   The record info, which contains the source location.
+  virtual void DoLogRecord(wxLogLevel level, const wxString& msg,
+                           const wxLogRecordInfo& info);
+
+ private:
+  /// \par OVERVIEW
+  ///
+  /// This struct contains a log record.
+  struct Record {
+    /// \var input
+    ///   The UTF-8 encoded input filepath that the logging thread is
+    ///   converting. This is empty if the thread is not converting a file.
+    std::string input;
+
+    /// \var level
+    ///   The log level.
+    wxLogLevel level;
+
+    /// \var line
+    ///   The source line number.
+    int line;
+
+    /// \var message
+    ///   The UTF-8 encoded message.
+    std::string message;
+
+    /// \var source
+    ///   The source filename. This is a string literal, and can be a nullptr.
+    const char* source;
+
+    /// \var thread
+    ///   The logging thread index.
+    int thread;
+
+    /// \var time
+    ///   The time the record was logged.
+    std::chrono::system_clock::time_point time;
+  };
+
+  /// \par OVERVIEW
+  ///
+  /// This struct is a ring buffer slot.
+  ///
+  /// The sequence tells who owns the slot. If it equals the enqueue position
+  /// the slot is free for a producer. If it equals the position + 1 the
+  /// record is ready for the consumer.
+  struct Cell {
+    /// \var record
+    ///   The record.
+    Record record;
+
+    /// \var sequence
+    ///   The sequence number.
+    std::atomic<std::size_t> sequence;
+  };
+
+  /// \brief Copy constructor. This is not implemented.
+  AsyncLogSink(const AsyncLogSink&);
+
+  /// \brief Assignment operator. This is not implemented.
+  AsyncLogSink& operator=(const AsyncLogSink&);
+
+  /// \brief Formats a record and appends it to a buffer.
+  /// \param[in] record
+  ///   The record.
+  /// \param[in,out] buffer
+  ///   The buffer.
+  static void Append(const Record& record, std::string& buffer);
+
+  /// \brief Pops and writes all queued records.
+  /// \return The number of records that were written.
+  /// This must only be called by one thread at a time.
+  std::size_t Drain();
+
+  /// \brief Pops a record from the queue.
+  /// \param[out] record
+  ///   The record.
+  /// \return If a record was popped.
+  /// This must only be called by one thread at a time.
+  bool Pop(Record& record);
+
+  /// \brief Pushes a record onto the queue.
+  /// \param[in] record
+  ///   The record, which is moved.
+  /// \return If the record was pushed. This fails if the queue is full.
+  bool Push(Record& record);
+
+  /// \brief Runs the writer thread.
+  void Run();
+
+  /// \var buffer_
+  ///   The formatted lines that are waiting to be written. This is only used
+  ///   by the draining thread.
+  std::string buffer_;
+
+  /// \var cells_
+  ///   The ring buffer.
+  std::unique_ptr<Cell[]> cells_;
+
+  /// \var file_
+  ///   The log file.
+  FILE* file_;
+
+  /// \var is_stopping_
+  ///   An indicator that tells the writer thread to stop.
+  std::atomic<bool> is_stopping_;
+
+  /// \var num_dropped_
+  ///   The number of records that were dropped.
+  std::atomic<uint64_t> num_dropped_;
+
+  /// \var num_dropped_reported_
+  ///   The number of dropped records that have been written to the file.
+  uint64_t num_dropped_reported_;
+
+  /// \var pos_dequeue_
+  ///   The next position to pop. This is only used by the draining thread.
+  std::size_t pos_dequeue_;
+
+  /// \var pos_enqueue_
+  ///   The next position to push.
+  std::atomic<std::size_t> pos_enqueue_;
+
+  /// \var pos_written_
+  ///   The position up to which records have been written to the file.
+  std::atomic<std::size_t> pos_written_;
+
+  /// \var thread_
+  ///   The writer thread.
+  std::thread thread_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_ASYNCLOGSINK_H_
@@ -0,0 +1,321 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_BATCHCONVERTER_H_
+#define OTLS_CABLEFILECONVERTER_BATCHCONVERTER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "wx/wx.h"
+
+#include "bounded_queue.h"
+#include "cable_converter.h"
+#include "cable_library_writer.h"
+#include "conversion_manifest.h"
+
+/// \par OVERVIEW
+///
+/// This class converts all of the files in an input directory to cable files
+/// in an output directory.
+///
+/// \par WORKER THREADS
+///
+/// The files are distributed to a pool of worker threads. Each worker takes
+/// the next unconverted file from a shared index, so no thread sits idle while
+/// files remain. A failure only affects the file that caused it.
+///
+/// \par PIPELINE
+///
+/// If a pipeline is set, each file instead passes through the converter
+/// stages (read, parse, solve, serialize, write), and each stage has its own
+/// threads. The stages are connected by bounded queues, so a file can be read
+/// while another is parsed and another is written. This overlaps the disk
+/// access with the computation, and lets the thread counts follow the cost of
+/// each stage. The utilization of each stage, and the depth and stall time of
+/// each queue, are logged when the batch finishes.
+///
+/// The solve stage takes every file that is waiting in its queue (up to 32),
+/// and solves them as one batch (see CableConverter::SolveBatch()). If the
+/// converter has an output writer, the write stage does the same, and writes
+/// them as one batch.
+///
+/// \par OUTPUT FILES
+///
+/// The output filename matches the input filename, with the extension replaced
+/// by the converter output extension ('cable' or 'cablebin'). If several
+/// input files have the same output file (ex: 'a.txt' and 'a.csv'), none of
+/// them are converted, and each one fails.
+///
+/// If a library is set, the cable files are added to the library instead, and
+/// the output directory is not used.
+///
+/// \par INCREMENTAL CONVERSION
+///
+/// If a manifest is set, files whose contents, converter settings, and output
+/// file are unchanged since the last conversion are skipped. The manifest is
+/// updated as files are converted. The manifest is not used with a library.
+class BatchConverter {
+ public:
+  /// \par OVERVIEW
+  ///
+  /// This struct contains the conversion status of a single file.
+  struct FileStatus {
+    /// \var filepath_input
+    ///   The input filepath.
+    wxString filepath_input;
+
+    /// \var filepath_output
+    ///   The output filepath.
+    wxString filepath_output;
+
+    /// \var is_converted
+    ///   An indicator that tells if the file was converted successfully, or
+    ///   skipped because the output is current.
+    bool is_converted;
+
+    /// \var is_skipped
+    ///   An indicator that tells if the file was skipped because the output is
+    ///   current.
+    bool is_skipped;
+
+    /// \var message
+    ///   The error message. This is empty if the file was converted.
+    wxString message;
+  };
+
+  /// \var kNumStages
+  ///   The number of pipeline stages.
+  static const int kNumStages = 5;
+
+  /// \par OVERVIEW
+  ///
+  /// This struct contains the pipeline settings.
+  struct PipelineOptions {
+    /// \var depth_queue
+    ///   The maximum number of files waiting between two stages.
+    int depth_queue;
+
+    /// \var num_threads
+    ///   The number of threads for each stage, in the order: read, parse,
+    ///   solve, serialize, write. Each must be at least 1.
+    int num_threads[kNumStages];
+  };
+
+  /// \brief Constructor.
+  /// \param[in] converter
+  ///   The converter that is shared by all worker threads.
+  BatchConverter(const CableConverter* converter);
+
+  /// \brief Destructor.
+  ~BatchConverter();
+
+  /// \brief Logs a summary of the file statuses.
+  /// This should be called after the batch has been run.
+  void LogSummary() const;
+
+  /// \brief Parses pipeline stage thread counts.
+  /// \param[in] str
+  ///   The thread counts, formatted as 'read:parse:solve:serialize:write'.
+  /// \param[out] options
+  ///   The pipeline settings. Only the thread counts are modified.
+  /// \return If the thread counts are valid.
+  static bool ParsePipeline(const std::string& str, PipelineOptions& options);
+
+  /// \brief Converts all files in the input directory.
+  /// \param[in] dir_input
+  ///   The input directory.
+  /// \param[in] dir_output
+  ///   The output directory. This is not used if a library is set.
+  /// \param[in] num_jobs
+  ///   The number of worker threads. If this is less than 1, the number of
+  ///   hardware threads is used. This is not used if a pipeline is set.
+  /// \return If the batch was run. Individual file failures do not affect
+  ///   this, and are stored in the file statuses.
+  bool Run(const wxString& dir_input, const wxString& dir_output,
+           const int& num_jobs);
+
+  /// \brief Sets the library.
+  /// \param[in] library
+  ///   The open library that the cable files are added to. This can be a
+  ///   nullptr to write a cable file for each input file.
+  void set_library(CableLibraryWriter* library);
+
+  /// \brief Sets the manifest.
+  /// \param[in] manifest
+  ///   The manifest, which is used to skip unchanged files. This can be a
+  ///   nullptr to convert all files.
+  void set_manifest(ConversionManifest* manifest);
+
+  /// \brief Sets the pipeline.
+  /// \param[in] pipeline
+  ///   The pipeline settings. This can be a nullptr to use a pool of worker
+  ///   threads that each convert whole files.
+  void set_pipeline(const PipelineOptions* pipeline);
+
+  /// \brief Gets the file statuses.
+  /// \return The file statuses.
+  const std::vector<FileStatus>& statuses() const;
+
+ private:
+  /// \par OVERVIEW
+  ///
+  /// This struct contains a file that is passed between pipeline stages.
+  struct Job {
+    /// \var conversion
+    ///   The conversion state.
+    CableConverter::Conversion conversion;
+
+    /// \var entry
+    ///   The manifest entry, which holds the input file hash.
+    ConversionManifest::Entry entry;
+
+    /// \var index
+    ///   The index of the file status.
+    std::size_t index;
+
+    /// \var is_hashed
+    ///   An indicator that tells if the input file was hashed.
+    bool is_hashed;
+  };
+
+  /// \var JobQueue
+  ///   A queue that connects two pipeline stages.
+  typedef BoundedQueue<std::unique_ptr<Job>> JobQueue;
+
+  /// \par OVERVIEW
+  ///
+  /// This struct contains a pipeline stage and its statistics.
+  struct Stage {
+    /// \var index
+    ///   The stage index.
+    int index;
+
+    /// \var mutex
+    ///   The mutex that guards the statistics.
+    std::mutex mutex;
+
+    /// \var num_active
+    ///   The number of stage threads that are still running. The last thread
+    ///   to finish closes the output queue.
+    std::atomic<int> num_active;
+
+    /// \var num_items
+    ///   The number of files that passed through the stage.
+    int num_items;
+
+    /// \var queue_in
+    ///   The queue that files are taken from. This is a nullptr for the read
+    ///   stage, which claims files from the shared index.
+    JobQueue* queue_in;
+
+    /// \var queue_out
+    ///   The queue that files are passed to. This is a nullptr for the write
+    ///   stage.
+    JobQueue* queue_out;
+
+    /// \var seconds_busy
+    ///   The total time the stage threads spent working on files, in seconds.
+    double seconds_busy;
+  };
+
+  /// \brief Converts files until the shared index is exhausted.
+  /// \param[in] log
+  ///   A thread safe log target that the worker logs to directly. If this is
+  ///   a nullptr, messages are buffered by wxWidgets until the main thread
+  ///   flushes them.
+  /// This is the worker thread entry point.
+  void ConvertFiles(wxLog* log);
+
+  /// \brief Converts a file and adds the cable to the library.
+  /// \param[in,out] status
+  ///   The file status. The message is populated if the conversion fails.
+  /// \return If the cable was added to the library.
+  bool ConvertToLibrary(FileStatus& status) const;
+
+  /// \brief Finishes a file by updating the status and manifest.
+  /// \param[in] is_converted
+  ///   An indicator that tells if the file was converted.
+  /// \param[in,out] job
+  ///   The file.
+  void FinishJob(const bool& is_converted, Job& job);
+
+  /// \brief Logs the pipeline statistics.
+  /// \param[in] stages
+  ///   The stages.
+  /// \param[in] queues
+  ///   The queues between the stages.
+  /// \param[in] seconds
+  ///   The total pipeline run time, in seconds.
+  void LogPipelineSummary(const Stage* stages, const JobQueue* const* queues,
+                          const double& seconds) const;
+
+  /// \brief Runs a file through a single stage.
+  /// \param[in] index_stage
+  ///   The stage index.
+  /// \param[in,out] job
+  ///   The file.
+  /// \return If the stage succeeded.
+  bool ProcessJob(const int& index_stage, Job& job) const;
+
+  /// \brief Runs several files through a single stage.
+  /// \param[in] index_stage
+  ///   The stage index.
+  /// \param[in,out] jobs
+  ///   The files.
+  /// \param[out] statuses
+  ///   The success status of each file.
+  /// The solve stage solves the files as one batch, and the write stage
+  /// writes the output files as one batch.
+  void ProcessJobs(const int& index_stage,
+                   std::vector<std::unique_ptr<Job>>& jobs,
+                   std::vector<bool>& statuses) const;
+
+  /// \brief Runs the files through the pipeline stages.
+  /// \param[in] log
+  ///   A thread safe log target, or a nullptr. See ConvertFiles().
+  void RunPipeline(wxLog* log);
+
+  /// \brief Runs a pipeline stage until its input is exhausted.
+  /// This is the stage thread entry point.
+  /// \param[in,out] stage
+  ///   The stage.
+  /// \param[in] log
+  ///   A thread safe log target, or a nullptr. See ConvertFiles().
+  void RunStage(Stage* stage, wxLog* log);
+
+  /// \var converter_
+  ///   The converter that is shared by all worker threads.
+  const CableConverter* converter_;
+
+  /// \var hash_settings_
+  ///   The hash of the converter settings.
+  uint64_t hash_settings_;
+
+  /// \var index_next_
+  ///   The index of the next file status to be converted.
+  std::atomic<std::size_t> index_next_;
+
+  /// \var library_
+  ///   The library. This is not owned by the batch converter.
+  CableLibraryWriter* library_;
+
+  /// \var manifest_
+  ///   The manifest. This is not owned by the batch converter.
+  ConversionManifest* manifest_;
+
+  /// \var pipeline_
+  ///   The pipeline settings. This is not owned by the batch converter.
+  const PipelineOptions* pipeline_;
+
+  /// \var statuses_
+  ///   The file statuses. Each worker thread only modifies the statuses it has
+  ///   claimed through the shared index.
+  std::vector<FileStatus> statuses_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_BATCHCONVERTER_H_
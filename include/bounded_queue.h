@@ -0,0 +1,207 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_BOUNDEDQUEUE_H_
+#define OTLS_CABLEFILECONVERTER_BOUNDEDQUEUE_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+/// \par OVERVIEW
+///
+/// This class is a first-in first-out queue with a maximum depth, which
+/// connects the stages of a pipeline.
+///
+/// A producer that pushes to a full queue waits until a consumer pops, and a
+/// consumer that pops from an empty queue waits until a producer pushes. The
+/// depth limit keeps a fast stage from running ahead of a slow one, so the
+/// memory held by items in flight is bounded.
+///
+/// \par CLOSING
+///
+/// When all producers are finished, the queue is closed. Consumers then drain
+/// the remaining items, after which popping fails.
+///
+/// \par STATISTICS
+///
+/// The queue records its depth and the time that producers and consumers
+/// spend waiting (stalled). A queue that is usually full with stalled
+/// producers is in front of the slowest stage.
+///
+/// \par THREAD SAFETY
+///
+/// All methods are safe to call from multiple threads.
+template<class T>
+class BoundedQueue {
+ public:
+  /// \par OVERVIEW
+  ///
+  /// This struct contains queue statistics.
+  struct Stats {
+    /// \var depth_max
+    ///   The maximum depth, measured after each push.
+    std::size_t depth_max;
+
+    /// \var depth_sum
+    ///   The sum of the depths measured after each push. This is divided by
+    ///   the number of pushes for the mean depth.
+    std::size_t depth_sum;
+
+    /// \var num_pushes
+    ///   The number of items pushed.
+    std::size_t num_pushes;
+
+    /// \var seconds_stall_pop
+    ///   The total time consumers waited for the queue to be non-empty, in
+    ///   seconds.
+    double seconds_stall_pop;
+
+    /// \var seconds_stall_push
+    ///   The total time producers waited for the queue to be non-full, in
+    ///   seconds.
+    double seconds_stall_push;
+  };
+
+  /// \brief Constructor.
+  /// \param[in] depth
+  ///   The maximum number of items in the queue. This must be at least 1.
+  explicit BoundedQueue(const std::size_t& depth) {
+    depth_ = (depth < 1) ? 1 : depth;
+    is_closed_ = false;
+
+    stats_.depth_max = 0;
+    stats_.depth_sum = 0;
+    stats_.num_pushes = 0;
+    stats_.seconds_stall_pop = 0;
+    stats_.seconds_stall_push = 0;
+  }
+
+  /// \brief Closes the queue. No more items can be pushed, and consumers
+  ///   are woken once the remaining items are popped.
+  void Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_closed_ = true;
+    not_empty_.notify_all();
+    not_full_.notify_all();
+  }
+
+  /// \brief Pops an item, waiting while the queue is empty.
+  /// \param[out] item
+  ///   The item.
+  /// \return If an item was popped. This fails if the queue is closed and
+  ///   empty.
+  bool Pop(T& item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if ((items_.empty() == true) && (is_closed_ == false)) {
+      const auto time_start = std::chrono::steady_clock::now();
+      while ((items_.empty() == true) && (is_closed_ == false)) {
+        not_empty_.wait(lock);
+      }
+      stats_.seconds_stall_pop += std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - time_start).count();
+    }
+
+    if (items_.empty() == true) {
+      return false;
+    }
+
+    item = std::move(items_.front());
+    items_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  /// \brief Pushes an item, waiting while the queue is full.
+  /// \param[in] item
+  ///   The item.
+  /// \return If the item was pushed. This fails if the queue is closed.
+  bool Push(T item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if ((depth_ <= items_.size()) && (is_closed_ == false)) {
+      const auto time_start = std::chrono::steady_clock::now();
+      while ((depth_ <= items_.size()) && (is_closed_ == false)) {
+        not_full_.wait(lock);
+      }
+      stats_.seconds_stall_push += std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - time_start).count();
+    }
+
+    if (is_closed_ == true) {
+      return false;
+    }
+
+    items_.push_back(std::move(item));
+    if (stats_.depth_max < items_.size()) {
+      stats_.depth_max = items_.size();
+    }
+    stats_.depth_sum += items_.size();
+    stats_.num_pushes++;
+
+    not_empty_.notify_one();
+    return true;
+  }
+
+  /// \brief Pops an item without waiting.
+  /// \param[out] item
+  ///   The item.
+  /// \return If an item was popped. This fails if the queue is empty.
+  bool TryPop(T& item) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (items_.empty() == true) {
+      return false;
+    }
+
+    item = std::move(items_.front());
+    items_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  /// \brief Gets the statistics.
+  /// \return The statistics.
+  Stats stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+ private:
+  /// \brief Copy constructor. This is not implemented.
+  BoundedQueue(const BoundedQueue&);
+
+  /// \brief Assignment operator. This is not implemented.
+  BoundedQueue& operator=(const BoundedQueue&);
+
+  /// \var depth_
+  ///   The maximum number of items in the queue.
+  std::size_t depth_;
+
+  /// \var is_closed_
+  ///   An indicator that tells if the queue is closed.
+  bool is_closed_;
+
+  /// \var items_
+  ///   The items, from oldest to newest.
+  std::deque<T> items_;
+
+  /// \var mutex_
+  ///   The mutex that guards all other members.
+  mutable std::mutex mutex_;
+
+  /// \var not_empty_
+  ///   The condition that consumers wait on.
+  std::condition_variable not_empty_;
+
+  /// \var not_full_
+  ///   The condition that producers wait on.
+  std::condition_variable not_full_;
+
+  /// \var stats_
+  ///   The statistics.
+  Stats stats_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_BOUNDEDQUEUE_H_
@@ -0,0 +1,233 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_CABLEBINARYHANDLER_H_
+#define OTLS_CABLEFILECONVERTER_CABLEBINARYHANDLER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "models/base/units.h"
+#include "models/transmissionline/cable.h"
+#include "wx/wx.h"
+
+#include "text_view.h"
+
+/// \par OVERVIEW
+///
+/// This class writes and validates the binary cable file format.
+///
+/// The binary format stores the same cable values as the XML cable file, in
+/// the 'different' unit style. It is meant for tools that load many cables at
+/// startup, and can be read directly from a mapped file without parsing (see
+/// CableBinaryReader).
+///
+/// \par LAYOUT
+///
+/// All values are little endian, and every struct and array starts on an
+/// 8 byte boundary:
+/// - Header (64 bytes)
+/// - Record (192 bytes)
+/// - coefficient arrays (doubles), referenced by offset from the file start
+/// - cable name (UTF-8, not terminated), padded to 8 bytes
+///
+/// \par VERSION
+///
+/// The version is increased whenever the layout changes. Files with a
+/// different version are rejected.
+///
+/// \par CHECKSUM
+///
+/// The header contains a FNV-1a checksum of every byte after the header. The
+/// checksum is calculated eight bytes at a time, so validating a file costs
+/// about as much as reading it once.
+class CableBinaryHandler {
+ public:
+  /// \par OVERVIEW
+  ///
+  /// This struct is the file header.
+  struct Header {
+    /// \var magic
+    ///   The file signature, which matches kMagic.
+    char magic[8];
+
+    /// \var version
+    ///   The layout version.
+    uint32_t version;
+
+    /// \var size_header
+    ///   The header size in bytes.
+    uint32_t size_header;
+
+    /// \var units
+    ///   The unit system: 1 for imperial, or 2 for metric.
+    uint32_t units;
+
+    /// \var style
+    ///   The unit style: 1 for consistent, or 2 for different. Only the
+    ///   different style is written and read.
+    uint32_t style;
+
+    /// \var size_file
+    ///   The file size in bytes.
+    uint64_t size_file;
+
+    /// \var checksum
+    ///   The checksum of all bytes after the header.
+    uint64_t checksum;
+
+    /// \var reserved
+    ///   Reserved for future use, and set to zero.
+    uint64_t reserved[3];
+  };
+
+  /// \par OVERVIEW
+  ///
+  /// This struct is a cable component.
+  struct Component {
+    /// \var coefficient_expansion_linear_thermal
+    ///   The coefficient of linear thermal expansion.
+    double coefficient_expansion_linear_thermal;
+
+    /// \var load_limit_polynomial_creep
+    ///   The load limit of the creep polynomial.
+    double load_limit_polynomial_creep;
+
+    /// \var load_limit_polynomial_loadstrain
+    ///   The load limit of the load-strain polynomial.
+    double load_limit_polynomial_loadstrain;
+
+    /// \var modulus_compression_elastic_area
+    ///   The compression elastic area modulus.
+    double modulus_compression_elastic_area;
+
+    /// \var modulus_tension_elastic_area
+    ///   The tension elastic area modulus.
+    double modulus_tension_elastic_area;
+
+    /// \var num_coefficients_creep
+    ///   The number of creep polynomial coefficients.
+    uint32_t num_coefficients_creep;
+
+    /// \var num_coefficients_loadstrain
+    ///   The number of load-strain polynomial coefficients.
+    uint32_t num_coefficients_loadstrain;
+
+    /// \var offset_coefficients_creep
+    ///   The file offset of the creep polynomial coefficients.
+    uint64_t offset_coefficients_creep;
+
+    /// \var offset_coefficients_loadstrain
+    ///   The file offset of the load-strain polynomial coefficients.
+    uint64_t offset_coefficients_loadstrain;
+  };
+
+  /// \par OVERVIEW
+  ///
+  /// This struct is the cable record.
+  struct Record {
+    /// \var area_physical
+    ///   The physical cross-sectional area.
+    double area_physical;
+
+    /// \var diameter
+    ///   The diameter.
+    double diameter;
+
+    /// \var strength_rated
+    ///   The rated strength.
+    double strength_rated;
+
+    /// \var temperature_properties_components
+    ///   The temperature of the component properties.
+    double temperature_properties_components;
+
+    /// \var weight_unit
+    ///   The unit weight.
+    double weight_unit;
+
+    /// \var offset_name
+    ///   The file offset of the name.
+    uint64_t offset_name;
+
+    /// \var size_name
+    ///   The name size in bytes.
+    uint64_t size_name;
+
+    /// \var component_core
+    ///   The core component.
+    Component component_core;
+
+    /// \var component_shell
+    ///   The shell component.
+    Component component_shell;
+
+    /// \var reserved
+    ///   Reserved for future use, and set to zero.
+    uint64_t reserved;
+  };
+
+  /// \var kMagic
+  ///   The file signature.
+  static const char kMagic[8];
+
+  /// \var kVersion
+  ///   The layout version that is written.
+  static const uint32_t kVersion = 1;
+
+  /// \brief Calculates the checksum of bytes.
+  /// \param[in] data
+  ///   The data.
+  /// \param[in] size
+  ///   The number of bytes.
+  /// \return The checksum.
+  static uint64_t Checksum(const char* data, const std::size_t& size);
+
+  /// \brief Determines if data starts with the binary cable file signature.
+  /// \param[in] data
+  ///   The data.
+  /// \return If the data starts with the binary cable file signature.
+  static bool IsBinary(const TextView& data);
+
+  /// \brief Copies a binary cable file into a cable.
+  /// \param[in] data
+  ///   The binary cable file, which must be 8 byte aligned.
+  /// \param[out] units
+  ///   The unit system of the file.
+  /// \param[out] cable
+  ///   The cable that is populated, in the 'different' unit style.
+  /// \param[out] message
+  ///   The error message. This is only populated if the data is invalid.
+  /// \return If the data is a valid binary cable file.
+  static bool Parse(const TextView& data, units::UnitSystem& units,
+                    Cable& cable, wxString& message);
+
+  /// \brief Copies a validated binary cable file into a cable.
+  /// \param[in] data
+  ///   The binary cable file, which must already be validated.
+  /// \param[out] cable
+  ///   The cable that is populated, in the 'different' unit style.
+  static void Read(const TextView& data, Cable& cable);
+
+  /// \brief Validates a binary cable file.
+  /// \param[in] data
+  ///   The binary cable file, which must be 8 byte aligned.
+  /// \param[out] message
+  ///   The error message. This is only populated if the data is invalid.
+  /// \return If the data is a valid binary cable file. If true, the header
+  ///   and record can be accessed in place, and all offsets are in bounds.
+  static bool Validate(const TextView& data, wxString& message);
+
+  /// \brief Writes a binary cable file.
+  /// \param[in] cable
+  ///   The cable, in the 'different' unit style.
+  /// \param[in] units
+  ///   The unit system of the cable.
+  /// \param[out] buffer
+  ///   The binary cable file.
+  static void Write(const Cable& cable, const units::UnitSystem& units,
+                    std::string& buffer);
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_CABLEBINARYHANDLER_H_
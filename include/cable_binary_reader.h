@@ -0,0 +1,104 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_CABLEBINARYREADER_H_
+#define OTLS_CABLEFILECONVERTER_CABLEBINARYREADER_H_
+
+#include "models/base/units.h"
+#include "models/transmissionline/cable.h"
+#include "wx/wx.h"
+
+#include "cable_binary_handler.h"
+#include "mapped_file.h"
+#include "text_view.h"
+
+/// \par OVERVIEW
+///
+/// This class reads a binary cable file without parsing.
+///
+/// The file is mapped and validated once. The record and coefficient arrays
+/// are then accessed in place, so loading a cable costs about as much as
+/// reading the file. The cable can also be copied into a Cable model.
+///
+/// \par LIFETIME
+///
+/// The record, arrays, and name point into the mapped file, so they must not
+/// be used after the reader is closed or destroyed.
+class CableBinaryReader {
+ public:
+  /// \brief Default constructor.
+  CableBinaryReader();
+
+  /// \brief Destructor.
+  ~CableBinaryReader();
+
+  /// \brief Attaches to a binary cable file that is already in memory.
+  /// \param[in] data
+  ///   The binary cable file, which must be 8 byte aligned. The data is not
+  ///   copied, so it must outlive the reader.
+  /// \param[out] message
+  ///   The error message. This is only populated if the data is invalid.
+  /// \return If the data is a valid binary cable file.
+  bool Attach(const TextView& data, wxString& message);
+
+  /// \brief Closes the file.
+  void Close();
+
+  /// \brief Maps and validates a binary cable file.
+  /// \param[in] filepath
+  ///   The filepath.
+  /// \param[out] message
+  ///   The error message. This is only populated if the file is invalid.
+  /// \return If the file is a valid binary cable file.
+  bool Open(const wxString& filepath, wxString& message);
+
+  /// \brief Copies the file into a cable.
+  /// \param[out] cable
+  ///   The cable that is populated, in the 'different' unit style.
+  void ToCable(Cable& cable) const;
+
+  /// \brief Gets the creep polynomial coefficients of a component.
+  /// \param[in] component
+  ///   The component, from the record.
+  /// \return The coefficients. The number of coefficients is in the component.
+  const double* coefficients_creep(
+      const CableBinaryHandler::Component& component) const;
+
+  /// \brief Gets the load-strain polynomial coefficients of a component.
+  /// \param[in] component
+  ///   The component, from the record.
+  /// \return The coefficients. The number of coefficients is in the component.
+  const double* coefficients_loadstrain(
+      const CableBinaryHandler::Component& component) const;
+
+  /// \brief Gets the cable name.
+  /// \return The cable name.
+  TextView name() const;
+
+  /// \brief Gets the cable record.
+  /// \return The cable record, or a nullptr if no file is open.
+  const CableBinaryHandler::Record* record() const;
+
+  /// \brief Gets the unit system.
+  /// \return The unit system.
+  units::UnitSystem units() const;
+
+ private:
+  /// \var data_
+  ///   The binary cable file.
+  TextView data_;
+
+  /// \var file_
+  ///   The mapped file, if the reader opened a file.
+  MappedFile file_;
+
+  /// \var record_
+  ///   The cable record.
+  const CableBinaryHandler::Record* record_;
+
+  /// \var units_
+  ///   The unit system.
+  units::UnitSystem units_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_CABLEBINARYREADER_H_
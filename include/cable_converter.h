@@ -0,0 +1,508 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_CABLECONVERTER_H_
+#define OTLS_CABLEFILECONVERTER_CABLECONVERTER_H_
+
+#include <string>
+#include <vector>
+
+#include "models/base/units.h"
+#include "models/transmissionline/cable.h"
+#include "wx/wx.h"
+
+#include "cable_limit_table.h"
+#include "conversion_metrics.h"
+#include "mapped_file.h"
+#include "output_writer.h"
+#include "parser_registry.h"
+#include "polynomial_limit_cache.h"
+#include "text_view.h"
+#include "trace_recorder.h"
+
+/// \par OVERVIEW
+///
+/// This class converts a single input file to an OTLS cable file.
+///
+/// The conversion consists of parsing the input file, converting the unit
+/// system, solving the polynomial limits, converting the unit style, and
+/// saving the cable file. The cable file is streamed directly to a buffer and
+/// written to disk with a single write.
+///
+/// \par PARSERS
+///
+/// If a parser registry is set, the input file is sniffed and parsed by the
+/// first matching parser. Otherwise, or if no parser matches, the input file
+/// is parsed by the ParseCableFile function that is linked into the app.
+///
+/// \par OUTPUT FORMATS
+///
+/// The cable file is generated as XML, or in the binary cable file format
+/// (see CableBinaryHandler). Binary cable files can also be converted, which
+/// serializes the stored cable again without solving it. This converts a
+/// binary cable file back to XML.
+///
+/// \par LIMIT TABLES
+///
+/// If a strain sweep is set, a table of the polynomial limits over the strain
+/// range is written next to each cable file (see CableLimitTable). The table
+/// is solved from the same parsed cable, so the input is only parsed once.
+/// Tables are not generated for binary cable input files, or for conversions
+/// to a buffer.
+///
+/// \par STAGES
+///
+/// A conversion is made of five stages: reading the input file, parsing it,
+/// solving the cable, serializing it, and writing the output. Each stage can
+/// be run on its own with a Conversion, which holds the state between stages,
+/// so a batch can run the stages on different threads (see BatchConverter).
+/// Convert() runs all of the stages in order.
+///
+/// \par OUTPUT WRITER
+///
+/// If output writer settings are set, output files are written through an
+/// OutputWriter that is kept for each thread, and the output files of several
+/// conversions can be written together with WriteBatch(). Otherwise, each
+/// output file is written in place with a single write.
+///
+/// \par TRACING
+///
+/// If a trace recorder is set, a span is recorded for the conversion and for
+/// each of its stages.
+///
+/// \par THREAD SAFETY
+///
+/// The converter settings are not modified during a conversion, so a single
+/// converter can be shared by multiple threads. The linked ParseCableFile
+/// function must also be reentrant for this to be safe.
+class CableConverter {
+ public:
+  /// \par OVERVIEW
+  ///
+  /// This enum contains the output formats.
+  enum class Format {
+    kBinary,
+    kXml
+  };
+
+  /// \par OVERVIEW
+  ///
+  /// This struct contains the state of a file as it moves through the
+  /// conversion stages.
+  struct Conversion {
+    /// \var buffer
+    ///   The generated output file. This is populated by the serialize stage.
+    std::string buffer;
+
+    /// \var cable
+    ///   The cable. This is populated by the parse stage.
+    Cable cable;
+
+    /// \var contents
+    ///   The input file contents. This is populated by the read stage, or by
+    ///   ConvertBuffer() for input that is already in memory, and is only
+    ///   valid until the parse stage finishes.
+    TextView contents;
+
+    /// \var file
+    ///   The mapped input file. This is opened by the read stage, and closed
+    ///   by the parse stage.
+    MappedFile file;
+
+    /// \var filepath_input
+    ///   The input filepath.
+    wxString filepath_input;
+
+    /// \var is_binary
+    ///   An indicator that tells if the input is a binary cable file, which is
+    ///   not solved again.
+    bool is_binary;
+
+    /// \var is_table
+    ///   An indicator that tells if a limit table is generated when a strain
+    ///   sweep is set.
+    bool is_table;
+
+    /// \var message
+    ///   The error message. This is populated by the stage that fails.
+    wxString message;
+
+    /// \var table
+    ///   The generated limit table. This is populated by the solve stage, and
+    ///   is empty if no table is generated.
+    std::string table;
+
+    /// \var units
+    ///   The unit system of the input file. This is populated by the parse
+    ///   stage.
+    units::UnitSystem units;
+  };
+
+  /// \brief Default constructor.
+  CableConverter();
+
+  /// \brief Destructor.
+  ~CableConverter();
+
+  /// \brief Starts a conversion.
+  /// \param[in] filepath_input
+  ///   The input filepath.
+  /// \param[in] is_table
+  ///   An indicator that tells if a limit table is generated when a strain
+  ///   sweep is set.
+  /// \param[out] conversion
+  ///   The conversion, which is reset.
+  static void Begin(const wxString& filepath_input, const bool& is_table,
+                    Conversion& conversion);
+
+  /// \brief Converts an input file to a cable file.
+  /// \param[in] filepath_input
+  ///   The input filepath.
+  /// \param[in] filepath_output
+  ///   The output filepath. If a strain sweep is set, the limit table is
+  ///   written to FilePathLimitTable(filepath_output).
+  /// \param[out] message
+  ///   The error message. This is only populated if the conversion fails.
+  /// \return The success status of the conversion.
+  bool Convert(const wxString& filepath_input,
+               const wxString& filepath_output,
+               wxString& message) const;
+
+  /// \brief Converts an input file to a cable file in memory.
+  /// \param[in] filepath_input
+  ///   The input filepath.
+  /// \param[out] buffer
+  ///   The generated cable file, in the output format. This is only populated
+  ///   if the conversion succeeds.
+  /// \param[out] name
+  ///   The cable name. This is only populated if the conversion succeeds.
+  /// \param[out] message
+  ///   The error message. This is only populated if the conversion fails.
+  /// \return The success status of the conversion.
+  bool ConvertToBuffer(const wxString& filepath_input, std::string& buffer,
+                       std::string& name, wxString& message) const;
+
+  /// \brief Converts input that is already in memory.
+  /// \param[in] name
+  ///   The input name, which is used for sniffing and diagnostics in place of
+  ///   a filepath.
+  /// \param[in] input
+  ///   The input file contents, which must stay valid until this returns.
+  /// \param[out] conversion
+  ///   The conversion, which is reset. The generated file, the solved cable,
+  ///   and the error message are populated.
+  /// \return The success status of the conversion.
+  /// Binary cable files and input that a registered parser recognizes are
+  /// parsed directly from memory. Otherwise, the input is written to a private
+  /// temporary file for the linked ParseCableFile function, which reads files.
+  /// Limit tables are not generated.
+  bool ConvertBuffer(const wxString& name, const TextView& input,
+                     Conversion& conversion) const;
+
+  /// \brief Describes the settings that affect the generated file.
+  /// \return A description that changes if any setting that affects the
+  ///   generated file changes.
+  std::string DescribeSettings() const;
+
+  /// \brief Gets the limit table filepath for an output file.
+  /// \param[in] filepath_output
+  ///   The output filepath.
+  /// \return The limit table filepath, which replaces the output extension
+  ///   with the table extension. This is empty if no strain sweep is set.
+  wxString FilePathLimitTable(const wxString& filepath_output) const;
+
+  /// \brief Gets the output file extension for the output format.
+  /// \return The output file extension, without a leading dot.
+  wxString ExtensionOutput() const;
+
+  /// \brief Parses the input file. This is the parse stage.
+  /// \param[in,out] conversion
+  ///   The conversion, which has been read.
+  /// \return The success status of the stage.
+  /// The input file is closed once it is parsed.
+  bool Parse(Conversion& conversion) const;
+
+  /// \brief Reads the input file. This is the read stage.
+  /// \param[in,out] conversion
+  ///   The conversion, which has been started.
+  /// \return The success status of the stage.
+  /// The input file is mapped, and every page is read, so the disk or network
+  /// reads are made in this stage instead of while parsing.
+  bool Read(Conversion& conversion) const;
+
+  /// \brief Generates the output file. This is the serialize stage.
+  /// \param[in,out] conversion
+  ///   The conversion, which has been solved.
+  /// \return The success status of the stage.
+  bool Serialize(Conversion& conversion) const;
+
+  /// \brief Converts the unit system, solves the limit table and polynomial
+  ///   limits, and converts the unit style. This is the solve stage.
+  /// \param[in,out] conversion
+  ///   The conversion, which has been parsed.
+  /// \return The success status of the stage.
+  bool Solve(Conversion& conversion) const;
+
+  /// \brief Solves several conversions as one batch. This is the solve stage
+  ///   for a batch of files.
+  /// \param[in,out] conversions
+  ///   The conversions, which have been parsed. The message of each
+  ///   conversion that fails is populated.
+  /// \param[out] statuses
+  ///   The success status of each conversion.
+  /// \return If all of the conversions were solved.
+  /// The cables of each unit system are converted together. If the
+  /// polynomial limits are found with the default scan (no root tolerance and
+  /// no fixed strain), the limits of all of the cables that are not in the
+  /// limit cache are scanned together in one vectorized sweep, which is timed
+  /// as one search. Otherwise, the limits of each cable are solved on their
+  /// own.
+  bool SolveBatch(const std::vector<Conversion*>& conversions,
+                  std::vector<bool>& statuses) const;
+
+  /// \brief Gets the input filepath of the conversion stage that the calling
+  ///   thread is running.
+  /// \return The input filepath, or an empty string if the thread is not
+  ///   running a stage. For a batch solve, this is the file being solved,
+  ///   and is empty while the limits of the whole batch are searched.
+  /// This lets a log target tag each message with the file it is about.
+  static wxString ThreadFilePathInput();
+
+  /// \brief Writes the output file, and the limit table next to it. This is
+  ///   the write stage.
+  /// \param[in] filepath_output
+  ///   The output filepath.
+  /// \param[in,out] conversion
+  ///   The conversion, which has been serialized.
+  /// \return The success status of the stage.
+  bool Write(const wxString& filepath_output, Conversion& conversion) const;
+
+  /// \brief Writes the output files of several conversions as one batch. This
+  ///   is the write stage for a batch of files.
+  /// \param[in] filepaths_output
+  ///   The output filepaths, in the same order as the conversions.
+  /// \param[in,out] conversions
+  ///   The conversions, which have been serialized. The message of each
+  ///   conversion that fails is populated.
+  /// \param[out] statuses
+  ///   The success status of each conversion.
+  /// \return If all of the conversions were written.
+  /// The files are only written as one batch if output writer settings are
+  /// set. Otherwise, each conversion is written on its own.
+  bool WriteBatch(const std::vector<wxString>& filepaths_output,
+                  const std::vector<Conversion*>& conversions,
+                  std::vector<bool>& statuses) const;
+
+  /// \brief Gets the polynomial limit cache.
+  /// \return The polynomial limit cache.
+  PolynomialLimitCache* cache_polynomial_limits() const;
+
+  /// \brief Gets the x tolerance for the polynomial limit search.
+  /// \return The x tolerance for the polynomial limit search.
+  double tolerance_polynomial_limits() const;
+
+  /// \brief Gets the output format.
+  /// \return The output format.
+  Format format() const;
+
+  /// \brief Gets the limit table format.
+  /// \return The limit table format.
+  CableLimitTable::Format format_limit_table() const;
+
+  /// \brief Gets if the generated file is compact (not indented).
+  /// \return If the generated file is compact.
+  bool is_compact() const;
+
+  /// \brief Gets the conversion metrics.
+  /// \return The conversion metrics.
+  ConversionMetrics* metrics() const;
+
+  /// \brief Gets the output writer settings.
+  /// \return The output writer settings.
+  const OutputWriter::Options* output_writer() const;
+
+  /// \brief Gets the parser registry.
+  /// \return The parser registry.
+  const ParserRegistry* parser_registry() const;
+
+  /// \brief Gets the percent strain for the polynomial limits.
+  /// \return The percent strain for the polynomial limits.
+  double strain_percent_polynomial_limits() const;
+
+  /// \brief Gets the strain sweep for the limit table.
+  /// \return The strain sweep. If the step is zero, no table is generated.
+  CableLimitTable::Range strain_sweep() const;
+
+  /// \brief Gets the trace recorder.
+  /// \return The trace recorder.
+  TraceRecorder* trace_recorder() const;
+
+  /// \brief Gets the unit system of the generated file.
+  /// \return The unit system of the generated file.
+  units::UnitSystem units() const;
+
+  /// \brief Sets the polynomial limit cache.
+  /// \param[in] cache_polynomial_limits
+  ///   The polynomial limit cache, which is shared by all conversions. This
+  ///   can be a nullptr to disable caching.
+  void set_cache_polynomial_limits(
+      PolynomialLimitCache* cache_polynomial_limits);
+
+  /// \brief Sets the output format.
+  /// \param[in] format
+  ///   The output format.
+  void set_format(const Format& format);
+
+  /// \brief Sets the limit table format.
+  /// \param[in] format_limit_table
+  ///   The limit table format.
+  void set_format_limit_table(
+      const CableLimitTable::Format& format_limit_table);
+
+  /// \brief Sets if the generated file is compact (not indented).
+  /// \param[in] is_compact
+  ///   An indicator that tells if the generated file is compact.
+  void set_is_compact(const bool& is_compact);
+
+  /// \brief Sets the conversion metrics.
+  /// \param[in] metrics
+  ///   The conversion metrics, which are shared by all conversions. This can
+  ///   be a nullptr to disable metrics.
+  void set_metrics(ConversionMetrics* metrics);
+
+  /// \brief Sets the output writer settings.
+  /// \param[in] output_writer
+  ///   The output writer settings, which are shared by all conversions. This
+  ///   can be a nullptr to write each output file in place.
+  void set_output_writer(const OutputWriter::Options* output_writer);
+
+  /// \brief Sets the parser registry.
+  /// \param[in] parser_registry
+  ///   The parser registry, which is shared by all conversions. This can be a
+  ///   nullptr to only use the linked ParseCableFile function.
+  void set_parser_registry(const ParserRegistry* parser_registry);
+
+  /// \brief Sets the percent strain for the polynomial limits.
+  /// \param[in] strain_percent_polynomial_limits
+  ///   The percent strain for the polynomial limits. If this is set to -1 the
+  ///   strain will be searched for.
+  void set_strain_percent_polynomial_limits(
+      const double& strain_percent_polynomial_limits);
+
+  /// \brief Sets the strain sweep for the limit table.
+  /// \param[in] strain_sweep
+  ///   The strain sweep. If the step is zero, no table is generated.
+  void set_strain_sweep(const CableLimitTable::Range& strain_sweep);
+
+  /// \brief Sets the x tolerance for the polynomial limit search.
+  /// \param[in] tolerance_polynomial_limits
+  ///   The x tolerance for the polynomial limit search. If this is greater
+  ///   than zero the limits are solved using polynomial roots, otherwise a
+  ///   fixed step scan is used.
+  void set_tolerance_polynomial_limits(
+      const double& tolerance_polynomial_limits);
+
+  /// \brief Sets the trace recorder.
+  /// \param[in] trace_recorder
+  ///   The trace recorder, which is shared by all conversions. This can be a
+  ///   nullptr to disable tracing.
+  void set_trace_recorder(TraceRecorder* trace_recorder);
+
+  /// \brief Sets the unit system of the generated file.
+  /// \param[in] units
+  ///   The unit system of the generated file.
+  void set_units(const units::UnitSystem& units);
+
+ private:
+  /// \brief Converts cables to the 'different' unit style.
+  /// \param[in,out] conversions
+  ///   The conversions, which have their polynomial limits solved.
+  /// The cables of each unit system are converted together with a unit table.
+  void ConvertUnitStyle(const std::vector<Conversion*>& conversions) const;
+
+  /// \brief Converts cables from the file unit system to the app unit system.
+  /// \param[in,out] conversions
+  ///   The conversions, which have been parsed and are not binary files.
+  /// The cables of each file unit system are converted together with a unit
+  /// table.
+  void ConvertUnitSystem(const std::vector<Conversion*>& conversions) const;
+
+  /// \brief Runs the read, parse, solve, and serialize stages.
+  /// \param[in,out] conversion
+  ///   The conversion, which has been started.
+  /// \return The success status of the conversion.
+  bool Generate(Conversion& conversion) const;
+
+  /// \brief Serializes a cable in the output format.
+  /// \param[in] cable
+  ///   The cable, in the 'different' unit style.
+  /// \param[in] units
+  ///   The unit system of the cable.
+  /// \param[out] buffer
+  ///   The generated output file.
+  void Serialize(const Cable& cable, const units::UnitSystem& units,
+                 std::string& buffer) const;
+
+  /// \brief Solves the polynomial limits of a cable.
+  /// \param[in,out] conversion
+  ///   The conversion, which is in the app unit system.
+  /// \return The success status.
+  bool SolveLimits(Conversion& conversion) const;
+
+  /// \brief Solves the limit table of a cable, if one is generated.
+  /// \param[in,out] conversion
+  ///   The conversion, which is in the app unit system.
+  /// \return The success status.
+  bool SolveTable(Conversion& conversion) const;
+
+  /// \var cache_polynomial_limits_
+  ///   The polynomial limit cache. This is not owned by the converter.
+  PolynomialLimitCache* cache_polynomial_limits_;
+
+  /// \var format_
+  ///   The output format.
+  Format format_;
+
+  /// \var format_limit_table_
+  ///   The limit table format.
+  CableLimitTable::Format format_limit_table_;
+
+  /// \var is_compact_
+  ///   An indicator that tells if the generated file is compact.
+  bool is_compact_;
+
+  /// \var metrics_
+  ///   The conversion metrics, which are not owned by the converter.
+  ConversionMetrics* metrics_;
+
+  /// \var output_writer_
+  ///   The output writer settings. This is not owned by the converter.
+  const OutputWriter::Options* output_writer_;
+
+  /// \var parser_registry_
+  ///   The parser registry. This is not owned by the converter.
+  const ParserRegistry* parser_registry_;
+
+  /// \var strain_percent_polynomial_limits_
+  ///   The percent strain value for the polynomial limits.
+  double strain_percent_polynomial_limits_;
+
+  /// \var strain_sweep_
+  ///   The strain sweep for the limit table. If the step is zero, no table is
+  ///   generated.
+  CableLimitTable::Range strain_sweep_;
+
+  /// \var tolerance_polynomial_limits_
+  ///   The x tolerance for the polynomial limit search.
+  double tolerance_polynomial_limits_;
+
+  /// \var trace_recorder_
+  ///   The trace recorder. This is not owned by the converter.
+  TraceRecorder* trace_recorder_;
+
+  /// \var units_
+  ///   The unit system of the generated file.
+  units::UnitSystem units_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_CABLECONVERTER_H_
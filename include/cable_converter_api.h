@@ -0,0 +1,296 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_CABLECONVERTERAPI_H_
+#define OTLS_CABLEFILECONVERTER_CABLECONVERTERAPI_H_
+
+#include <stddef.h>
+
+/// \par OVERVIEW
+///
+/// This is the C interface of the converter library, which converts cable
+/// input files in-process instead of running the app for each file.
+///
+/// A converter is created once with the conversion options, and can then be
+/// shared by any number of threads. Each conversion returns a result that
+/// holds the generated cable file, the solved cable, the error message, and
+/// the diagnostics that were logged during the conversion. The result is owned
+/// by the caller, and is freed with otls_cfc_result_destroy().
+///
+/// \par PARSERS
+///
+/// Like the app, the library calls the ParseCableFile function that is linked
+/// with it, unless a parser plugin recognizes the input. Plugins are loaded
+/// for each converter, so converters with different plugins can be used at
+/// the same time. A plugin parses an in-memory input directly, while the
+/// linked function reads a private temporary copy of it.
+///
+/// \par DIAGNOSTICS
+///
+/// The errors, warnings, and messages that are logged while a result is
+/// generated are captured in that result, and are not sent to the process log
+/// target. A log target is only set for the calling thread, so conversions
+/// on other threads are not affected. wxWidgets ignores thread log targets on
+/// its main thread (the thread that created the first converter), so a call
+/// from that thread runs on a helper thread that each converter keeps, and
+/// waits for it.
+///
+/// \par STRINGS
+///
+/// All strings are UTF-8, and are terminated. Strings and pointers that are
+/// returned from a result stay valid until the result is destroyed.
+///
+/// \par EXAMPLE
+///
+/// \code
+/// OtlsCfcOptions options;
+/// otls_cfc_options_init(&options);
+/// options.units = OTLS_CFC_UNITS_METRIC;
+///
+/// char message[256];
+/// OtlsCfcConverter* converter =
+///     otls_cfc_converter_create(&options, message, sizeof(message));
+///
+/// OtlsCfcResult* result = otls_cfc_convert_file(converter, "drake.txt");
+/// if (otls_cfc_result_is_converted(result) != 0) {
+///   size_t size = 0;
+///   const char* xml = otls_cfc_result_output(result, &size);
+/// }
+/// otls_cfc_result_destroy(result);
+/// otls_cfc_converter_destroy(converter);
+/// \endcode
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// The output formats.
+enum {
+  OTLS_CFC_FORMAT_XML = 0,
+  OTLS_CFC_FORMAT_BINARY = 1
+};
+
+/// The unit systems.
+enum {
+  OTLS_CFC_UNITS_IMPERIAL = 1,
+  OTLS_CFC_UNITS_METRIC = 2
+};
+
+/// \par OVERVIEW
+///
+/// This struct contains the conversion options. It should be initialized with
+/// otls_cfc_options_init() so new options keep their defaults.
+typedef struct OtlsCfcOptions {
+  /// \var format
+  ///   The output format. The default is XML.
+  int format;
+
+  /// \var is_compact
+  ///   Non-zero to generate the file without indentation. The default is 0.
+  int is_compact;
+
+  /// \var plugins
+  ///   A parser plugin, or a directory of parser plugins, that are sniffed
+  ///   before the linked parser. The default is NULL, which loads none.
+  const char* plugins;
+
+  /// \var strain_percent_polynomial_limits
+  ///   The percent strain for the polynomial limits. The default is -1, which
+  ///   searches for the strain.
+  double strain_percent_polynomial_limits;
+
+  /// \var tolerance_polynomial_limits
+  ///   The x tolerance for the polynomial limit search. If this is greater
+  ///   than zero the limits are solved using polynomial roots, and it must be
+  ///   at least 1e-12. The default is -1, which uses a fixed step scan.
+  double tolerance_polynomial_limits;
+
+  /// \var units
+  ///   The unit system of the generated file. The default is imperial.
+  int units;
+} OtlsCfcOptions;
+
+/// \par OVERVIEW
+///
+/// This struct contains a solved cable component.
+typedef struct OtlsCfcCableComponent {
+  /// \var coefficient_expansion_linear_thermal
+  ///   The linear thermal expansion coefficient.
+  double coefficient_expansion_linear_thermal;
+
+  /// \var coefficients_polynomial_creep
+  ///   The creep polynomial coefficients.
+  const double* coefficients_polynomial_creep;
+
+  /// \var coefficients_polynomial_loadstrain
+  ///   The load-strain polynomial coefficients.
+  const double* coefficients_polynomial_loadstrain;
+
+  /// \var load_limit_polynomial_creep
+  ///   The creep polynomial load limit.
+  double load_limit_polynomial_creep;
+
+  /// \var load_limit_polynomial_loadstrain
+  ///   The load-strain polynomial load limit.
+  double load_limit_polynomial_loadstrain;
+
+  /// \var modulus_compression_elastic_area
+  ///   The compression elastic area modulus.
+  double modulus_compression_elastic_area;
+
+  /// \var modulus_tension_elastic_area
+  ///   The tension elastic area modulus.
+  double modulus_tension_elastic_area;
+
+  /// \var num_coefficients_polynomial_creep
+  ///   The number of creep polynomial coefficients.
+  size_t num_coefficients_polynomial_creep;
+
+  /// \var num_coefficients_polynomial_loadstrain
+  ///   The number of load-strain polynomial coefficients.
+  size_t num_coefficients_polynomial_loadstrain;
+} OtlsCfcCableComponent;
+
+/// \par OVERVIEW
+///
+/// This struct contains a solved cable, in the 'different' unit style of the
+/// generated file.
+typedef struct OtlsCfcCable {
+  /// \var area_physical
+  ///   The physical cross section area.
+  double area_physical;
+
+  /// \var component_core
+  ///   The core component.
+  OtlsCfcCableComponent component_core;
+
+  /// \var component_shell
+  ///   The shell component.
+  OtlsCfcCableComponent component_shell;
+
+  /// \var diameter
+  ///   The diameter.
+  double diameter;
+
+  /// \var name
+  ///   The cable name.
+  const char* name;
+
+  /// \var strength_rated
+  ///   The rated strength.
+  double strength_rated;
+
+  /// \var temperature_properties_components
+  ///   The temperature of the component properties.
+  double temperature_properties_components;
+
+  /// \var units
+  ///   The unit system of the values.
+  int units;
+
+  /// \var weight_unit
+  ///   The unit weight.
+  double weight_unit;
+} OtlsCfcCable;
+
+/// An opaque converter, which is created with otls_cfc_converter_create().
+typedef struct OtlsCfcConverter OtlsCfcConverter;
+
+/// An opaque conversion result, which is returned by the convert functions.
+typedef struct OtlsCfcResult OtlsCfcResult;
+
+/// \brief Sets the options to their defaults.
+/// \param[out] options
+///   The options.
+void otls_cfc_options_init(OtlsCfcOptions* options);
+
+/// \brief Creates a converter.
+/// \param[in] options
+///   The options, or NULL for the defaults. The options are copied.
+/// \param[out] message
+///   A buffer for the error message, or NULL. This is only populated if the
+///   converter can't be created.
+/// \param[in] size_message
+///   The size of the message buffer, including the terminator.
+/// \return The converter, or NULL if the options are invalid or the plugins
+///   can't be loaded.
+OtlsCfcConverter* otls_cfc_converter_create(const OtlsCfcOptions* options,
+                                            char* message,
+                                            size_t size_message);
+
+/// \brief Destroys a converter. No conversion may be running with it.
+/// \param[in] converter
+///   The converter, or NULL.
+void otls_cfc_converter_destroy(OtlsCfcConverter* converter);
+
+/// \brief Converts input that is already in memory.
+/// \param[in] converter
+///   The converter.
+/// \param[in] name
+///   The input name (ex: the original filename), which is used to sniff the
+///   format and in diagnostics. This can be NULL.
+/// \param[in] data
+///   The input file contents.
+/// \param[in] size
+///   The size of the input, in bytes.
+/// \return The result, which must be destroyed. This is only NULL if memory
+///   could not be allocated.
+OtlsCfcResult* otls_cfc_convert_buffer(const OtlsCfcConverter* converter,
+                                       const char* name, const void* data,
+                                       size_t size);
+
+/// \brief Converts an input file.
+/// \param[in] converter
+///   The converter.
+/// \param[in] filepath
+///   The input filepath.
+/// \return The result, which must be destroyed. This is only NULL if memory
+///   could not be allocated.
+OtlsCfcResult* otls_cfc_convert_file(const OtlsCfcConverter* converter,
+                                     const char* filepath);
+
+/// \brief Destroys a result.
+/// \param[in] result
+///   The result, or NULL.
+void otls_cfc_result_destroy(OtlsCfcResult* result);
+
+/// \brief Gets the solved cable.
+/// \param[in] result
+///   The result.
+/// \return The cable, or NULL if the conversion failed.
+const OtlsCfcCable* otls_cfc_result_cable(const OtlsCfcResult* result);
+
+/// \brief Gets the diagnostics that were logged during the conversion.
+/// \param[in] result
+///   The result.
+/// \return The diagnostics, one per line, with the level first (ex:
+///   'Error: ...'). This is empty if nothing was logged.
+const char* otls_cfc_result_diagnostics(const OtlsCfcResult* result);
+
+/// \brief Gets if the conversion succeeded.
+/// \param[in] result
+///   The result.
+/// \return Non-zero if the conversion succeeded.
+int otls_cfc_result_is_converted(const OtlsCfcResult* result);
+
+/// \brief Gets the error message.
+/// \param[in] result
+///   The result.
+/// \return The error message. This is empty if the conversion succeeded.
+const char* otls_cfc_result_message(const OtlsCfcResult* result);
+
+/// \brief Gets the generated cable file.
+/// \param[in] result
+///   The result.
+/// \param[out] size
+///   The size of the generated file, in bytes. This can be NULL.
+/// \return The generated file, in the output format. This is empty if the
+///   conversion failed. XML files are also terminated.
+const char* otls_cfc_result_output(const OtlsCfcResult* result,
+                                   size_t* size);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // OTLS_CABLEFILECONVERTER_CABLECONVERTERAPI_H_
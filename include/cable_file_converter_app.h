@@ -8,11 +8,26 @@
 #include "wx/cmdline.h"
 #include "wx/wx.h"
 
+#include "batch_converter.h"
+#include "cable_converter.h"
+#include "conversion_manifest.h"
+#include "conversion_metrics.h"
+#include "output_writer.h"
+#include "parser_registry.h"
+#include "polynomial_limit_cache.h"
+#include "trace_recorder.h"
+
 /// \par OVERVIEW
 ///
 /// This is the CableFileConverter application class.
 ///
-/// This application converts an input file to an OTLS cable file.
+/// This application converts an input file to an OTLS cable file. In batch
+/// mode, all files in an input directory are converted in a single process.
+/// In watch mode, files are converted as they are written to an input
+/// directory, until the process is interrupted. In server mode, conversion
+/// requests are served over a Unix domain socket, until the process is
+/// interrupted. In extract mode, cable files are extracted from a cable
+/// library.
 class CableFileConverterApp : public wxAppConsole {
  public:
   /// \brief Constructor.
@@ -43,21 +58,156 @@ class CableFileConverterApp : public wxAppConsole {
   virtual int OnRun();
 
  private:
+  /// \brief Converts all files in the input directory.
+  void RunBatch();
+
+  /// \brief Extracts cable files from the input library.
+  void RunExtract();
+
+  /// \brief Converts all cable records in the input file.
+  void RunRecords();
+
+  /// \brief Serves conversion requests on the socket, until the process is
+  ///   interrupted.
+  void RunServer();
+
+  /// \brief Converts the input file.
+  void RunSingle();
+
+  /// \brief Converts files as they are written to the input directory, until
+  ///   the process is interrupted.
+  void RunWatch();
+
+  /// \var cache_polynomial_limits_
+  ///   The polynomial limit cache, which is shared by all conversions.
+  PolynomialLimitCache cache_polynomial_limits_;
+
+  /// \var converter_
+  ///   The converter, which stores the conversion settings.
+  CableConverter converter_;
+
+  /// \var filepath_cache_
+  ///   The polynomial limit cache filepath. If empty, the cache is not loaded
+  ///   or saved.
+  wxString filepath_cache_;
+
   /// \var filepath_input_
-  ///   The input filepath. This is specified as a command line parameter.
+  ///   The input filepath. This is specified as a command line parameter. In
+  ///   batch mode this is the input directory, and in extract mode this is the
+  ///   cable library.
   wxString filepath_input_;
 
+  /// \var filepath_manifest_
+  ///   The conversion manifest filepath. If empty, all files are converted in
+  ///   batch mode.
+  wxString filepath_manifest_;
+
+  /// \var filepath_metrics_
+  ///   The Prometheus metrics filepath. If empty, no metrics are counted.
+  wxString filepath_metrics_;
+
   /// \var filepath_output_
-  ///   The output filepath. This is specified as a command line parameter.
+  ///   The output filepath. This is specified as a command line parameter. In
+  ///   batch and records mode this is the output directory, or the cable
+  ///   library if the library switch is set.
   wxString filepath_output_;
 
-  /// \var strain_percent_polynomial_limits_
-  ///   The percent strain value for the polynomial limits.
-  double strain_percent_polynomial_limits_;
+  /// \var filepath_plugins_
+  ///   The parser plugin filepath, or a directory of parser plugins. If empty,
+  ///   only the linked parser is used.
+  wxString filepath_plugins_;
+
+  /// \var filepath_socket_
+  ///   The server socket filepath. If not empty, the app serves conversion
+  ///   requests instead of converting the parameter files.
+  wxString filepath_socket_;
+
+  /// \var filepath_trace_
+  ///   The trace filepath. If empty, the conversion stages are not traced.
+  wxString filepath_trace_;
+
+  /// \var is_alloc_stats_
+  ///   An indicator that tells if the heap allocations of each conversion
+  ///   stage are logged.
+  bool is_alloc_stats_;
+
+  /// \var is_batch_
+  ///   An indicator that tells if all files in the input directory are
+  ///   converted.
+  bool is_batch_;
+
+  /// \var is_extract_
+  ///   An indicator that tells if cable files are extracted from the input
+  ///   library.
+  bool is_extract_;
+
+  /// \var is_library_
+  ///   An indicator that tells if batch mode adds the cables to the output
+  ///   library instead of writing a file for each cable.
+  bool is_library_;
+
+  /// \var is_output_writer_
+  ///   An indicator that tells if output files are written through the
+  ///   output writer.
+  bool is_output_writer_;
+
+  /// \var is_pipeline_
+  ///   An indicator that tells if batch mode runs the files through the
+  ///   pipeline stages instead of converting whole files on worker threads.
+  bool is_pipeline_;
+
+  /// \var is_records_
+  ///   An indicator that tells if each cable record in a multi-record input
+  ///   file is converted.
+  bool is_records_;
+
+  /// \var is_watch_
+  ///   An indicator that tells if files are converted as they are written to
+  ///   the input directory.
+  bool is_watch_;
+
+  /// \var manifest_
+  ///   The conversion manifest, which is used to skip unchanged files in
+  ///   batch mode.
+  ConversionManifest manifest_;
 
-  /// \var units_
-  ///   The unit system.
-  units::UnitSystem units_;
+  /// \var metrics_
+  ///   The conversion metrics, which are shared by all conversions and saved
+  ///   periodically if the metrics file option is set.
+  ConversionMetrics metrics_;
+
+  /// \var name_cable_
+  ///   The name of the cable that is extracted. If empty, all cables are
+  ///   extracted.
+  wxString name_cable_;
+
+  /// \var num_jobs_
+  ///   The number of worker threads for batch, watch, and server mode. If less
+  ///   than 1, the number of hardware threads is used.
+  int num_jobs_;
+
+  /// \var seconds_metrics_
+  ///   The time between saves of the metrics file.
+  double seconds_metrics_;
+
+  /// \var output_writer_
+  ///   The output writer settings, which are used if the output I/O or fsync
+  ///   option is set.
+  OutputWriter::Options output_writer_;
+
+  /// \var parser_registry_
+  ///   The parser registry, which is shared by all conversions.
+  ParserRegistry parser_registry_;
+
+  /// \var pipeline_
+  ///   The pipeline settings for batch mode, which are used if the pipeline
+  ///   option is set.
+  BatchConverter::PipelineOptions pipeline_;
+
+  /// \var trace_recorder_
+  ///   The trace recorder, which is shared by all conversions. This records
+  ///   the stages for the trace file and for the allocation statistics.
+  TraceRecorder trace_recorder_;
 };
 
 /// This is an array of command line options.
@@ -65,16 +215,97 @@ static const wxCmdLineEntryDesc cmd_line_desc [] = {
   {wxCMD_LINE_SWITCH, nullptr, "help", "show this help message",
       wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP},
   {wxCMD_LINE_SWITCH, "v", "verbose", "enable verbose logging"},
+  {wxCMD_LINE_SWITCH, "b", "batch", "convert all files in the input directory "
+                                    "to the output directory"},
+  {wxCMD_LINE_SWITCH, "w", "watch", "convert files as they are written to the "
+                                    "input directory, until interrupted"},
+  {wxCMD_LINE_SWITCH, nullptr, "compact", "write the cable file without "
+                                          "indentation"},
+  {wxCMD_LINE_SWITCH, nullptr, "records", "convert each cable record in a "
+                                          "multi-record input file to the "
+                                          "output directory"},
+  {wxCMD_LINE_SWITCH, nullptr, "library", "in batch or records mode, add all "
+                                          "cables to the output library file"},
+  {wxCMD_LINE_SWITCH, nullptr, "extract", "extract cable files from the "
+                                          "input library to the output "
+                                          "directory"},
+  {wxCMD_LINE_SWITCH, nullptr, "alloc-stats", "log the heap allocations of "
+                                              "each conversion stage"},
 
+  {wxCMD_LINE_OPTION, nullptr, "cable", "name of the cable to extract - "
+                                        "defaults to all cables",
+      wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL},
+  {wxCMD_LINE_OPTION, "f", "format", "output format - 'xml' (default) or "
+                                     "'bin'",
+      wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL},
   {wxCMD_LINE_OPTION, "s", "strain", "percent strain for polynomial limits",
       wxCMD_LINE_VAL_DOUBLE, wxCMD_LINE_PARAM_OPTIONAL},
+  {wxCMD_LINE_OPTION, nullptr, "limit-tolerance",
+      "solve polynomial limits using roots to this strain tolerance",
+      wxCMD_LINE_VAL_DOUBLE, wxCMD_LINE_PARAM_OPTIONAL},
+  {wxCMD_LINE_OPTION, nullptr, "limit-cache",
+      "file that stores polynomial limit results between runs",
+      wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL},
+  {wxCMD_LINE_OPTION, nullptr, "limit-cache-size",
+      "maximum number of polynomial limit results that are cached - "
+      "defaults to 100000",
+      wxCMD_LINE_VAL_NUMBER, wxCMD_LINE_PARAM_OPTIONAL},
+  {wxCMD_LINE_OPTION, nullptr, "manifest",
+      "file that records converted files so unchanged files are skipped in "
+      "batch mode",
+      wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL},
+  {wxCMD_LINE_OPTION, nullptr, "metrics-file",
+      "file that stores Prometheus metrics for the textfile collector, which "
+      "is updated while converting",
+      wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL},
+  {wxCMD_LINE_OPTION, nullptr, "metrics-interval",
+      "seconds between updates of the metrics file - defaults to 10",
+      wxCMD_LINE_VAL_DOUBLE, wxCMD_LINE_PARAM_OPTIONAL},
+  {wxCMD_LINE_OPTION, "j", "jobs", "number of worker threads for batch, "
+                                   "watch, or server mode - defaults to the "
+                                   "number of hardware threads",
+      wxCMD_LINE_VAL_NUMBER, wxCMD_LINE_PARAM_OPTIONAL},
+  {wxCMD_LINE_OPTION, nullptr, "pipeline",
+      "in batch mode, overlap the conversion stages with this many threads "
+      "for each stage, as 'read:parse:solve:serialize:write'",
+      wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL},
+  {wxCMD_LINE_OPTION, nullptr, "queue-depth",
+      "maximum number of files waiting between pipeline stages - defaults "
+      "to 4",
+      wxCMD_LINE_VAL_NUMBER, wxCMD_LINE_PARAM_OPTIONAL},
+  {wxCMD_LINE_OPTION, nullptr, "output-io",
+      "write the output files in batches with 'uring' (io_uring, falling "
+      "back to POSIX), 'posix', or 'auto'",
+      wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL},
+  {wxCMD_LINE_OPTION, nullptr, "fsync",
+      "when batched output files are synced to disk - 'none' (default), "
+      "'file', or 'batch'",
+      wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL},
+  {wxCMD_LINE_OPTION, nullptr, "plugins",
+      "parser plugin, or directory of parser plugins, that are sniffed before "
+      "the built-in parser",
+      wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL},
+  {wxCMD_LINE_OPTION, nullptr, "serve",
+      "serve conversion requests on this Unix domain socket, until "
+      "interrupted",
+      wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL},
+  {wxCMD_LINE_OPTION, nullptr, "strain-sweep",
+      "write a polynomial limit table for each strain in 'start:stop:step' "
+      "next to the cable file",
+      wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL},
+  {wxCMD_LINE_OPTION, nullptr, "sweep-format", "limit table format - 'csv' "
+                                               "(default) or 'json'",
+      wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL},
+  {wxCMD_LINE_OPTION, nullptr, "trace",
+      "file that stores Chrome trace events for each conversion stage",
+      wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL},
   {wxCMD_LINE_OPTION, "u", "units", "unit system for generated file - "
                                     "'imperial' (default) or 'metric'",
       wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL},
 
-  {wxCMD_LINE_PARAM, nullptr, nullptr, "input file",
+  {wxCMD_LINE_PARAM, nullptr, nullptr, "input file (or directory)",
       wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL},
-  {wxCMD_LINE_PARAM, nullptr, nullptr, "output file",
+  {wxCMD_LINE_PARAM, nullptr, nullptr, "output file (or directory)",
       wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL},
 
   {wxCMD_LINE_NONE}
@@ -11,6 +11,8 @@
 #include "models/transmissionline/cable.h"
 #include "wx/xml/xml.h"
 
+#include "xml_stream_writer.h"
+
 /// \par OVERVIEW
 ///
 /// This class parses and generates a cable file XML node. The data is
@@ -32,6 +34,15 @@
 ///
 /// This class supports attributing the child XML nodes for various unit
 /// systems and styles.
+///
+/// \par STREAMING
+///
+/// The cable file node can also be written directly to an XmlStreamWriter,
+/// which avoids building any nodes or a document. The cable node is written
+/// from a CableXmlTemplate, which is measured from the common cable XML
+/// handler, so the format stays in sync with the node that CreateNode()
+/// generates. If the cable node has no template, it is generated by the
+/// common handler and replayed.
 class CableFileXmlHandler : public XmlHandler {
  public:
   /// \brief Creates an XML node for a cable file.
@@ -72,6 +83,25 @@ class CableFileXmlHandler : public XmlHandler {
                         const units::UnitSystem& units,
                         const bool& convert,
                         Cable& cable);
+
+  /// \brief Writes a cable file node to a stream writer.
+  /// \param[in] cable
+  ///   The cable.
+  /// \param[in] name
+  ///   The name of the XML node. This will be an attribute for the written
+  ///   node. If empty, no attribute will be written.
+  /// \param[in] system_units
+  ///   The unit system, which is used for attributing child XML nodes.
+  /// \param[in] style_units
+  ///   The unit style, which is used for attributing child XML nodes.
+  /// \param[in,out] writer
+  ///   The stream writer.
+  /// The output is identical to the node generated by CreateNode().
+  static void WriteNode(const Cable& cable,
+                        const std::string& name,
+                        const units::UnitSystem& system_units,
+                        const units::UnitStyle& style_units,
+                        XmlStreamWriter& writer);
 };
 
 #endif  // OTLS_CABLEFILECONVERTER_CABLEFILEXMLHANDLER_H_
@@ -0,0 +1,259 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_CABLELIBRARYREADER_H_
+#define OTLS_CABLEFILECONVERTER_CABLELIBRARYREADER_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "wx/wx.h"
+
+#include "mapped_file.h"
+#include "text_view.h"
+
+/// \par OVERVIEW
+///
+/// This class reads a cable library, which is a single archive that holds
+/// many converted cable files (see CableLibraryWriter).
+///
+/// The index at the end of the library is read once when the library is
+/// opened. Fetching a cable is then a lookup by name or source file, and the
+/// cable file is accessed in place in the mapped library.
+///
+/// \par LAYOUT
+///
+/// All values are little endian:
+/// - Header (16 bytes)
+/// - cable files, each starting on an 8 byte boundary, so binary cable files
+///   can be read in place
+/// - index, which has an IndexEntry for each cable, followed by the name and
+///   source (UTF-8, not terminated), padded to 8 bytes
+/// - Footer (48 bytes)
+///
+/// \par CHECKSUM
+///
+/// The footer contains a checksum of the index, and each index entry contains
+/// a checksum of its cable file. Cable files are verified when they are
+/// fetched, so a corrupt entry does not affect the rest of the library.
+///
+/// \par LIFETIME
+///
+/// The fetched cable files point into the mapped library, so they must not be
+/// used after the reader is closed or destroyed.
+class CableLibraryReader {
+ public:
+  /// \par OVERVIEW
+  ///
+  /// This struct is the library header.
+  struct Header {
+    /// \var magic
+    ///   The library signature, which matches kMagic.
+    char magic[8];
+
+    /// \var version
+    ///   The layout version.
+    uint32_t version;
+
+    /// \var reserved
+    ///   Reserved for future use, and set to zero.
+    uint32_t reserved;
+  };
+
+  /// \par OVERVIEW
+  ///
+  /// This struct is an index entry, which is followed by the name and source.
+  struct IndexEntry {
+    /// \var offset
+    ///   The library offset of the cable file.
+    uint64_t offset;
+
+    /// \var size
+    ///   The cable file size in bytes.
+    uint64_t size;
+
+    /// \var checksum
+    ///   The checksum of the cable file.
+    uint64_t checksum;
+
+    /// \var size_name
+    ///   The name size in bytes.
+    uint32_t size_name;
+
+    /// \var size_source
+    ///   The source size in bytes.
+    uint32_t size_source;
+  };
+
+  /// \par OVERVIEW
+  ///
+  /// This struct is the library footer, which is the last 48 bytes of the
+  /// library.
+  struct Footer {
+    /// \var offset_index
+    ///   The library offset of the index.
+    uint64_t offset_index;
+
+    /// \var size_index
+    ///   The index size in bytes.
+    uint64_t size_index;
+
+    /// \var num_entries
+    ///   The number of index entries.
+    uint64_t num_entries;
+
+    /// \var checksum_index
+    ///   The checksum of the index.
+    uint64_t checksum_index;
+
+    /// \var version
+    ///   The layout version.
+    uint32_t version;
+
+    /// \var reserved
+    ///   Reserved for future use, and set to zero.
+    uint32_t reserved;
+
+    /// \var magic
+    ///   The library signature, which matches kMagic.
+    char magic[8];
+  };
+
+  /// \par OVERVIEW
+  ///
+  /// This struct is a cable in the library.
+  struct Entry {
+    /// \var checksum
+    ///   The checksum of the cable file.
+    uint64_t checksum;
+
+    /// \var name
+    ///   The cable name.
+    std::string name;
+
+    /// \var offset
+    ///   The library offset of the cable file.
+    uint64_t offset;
+
+    /// \var size
+    ///   The cable file size in bytes.
+    uint64_t size;
+
+    /// \var source
+    ///   The filename of the input file the cable was converted from.
+    std::string source;
+  };
+
+  /// \var kMagic
+  ///   The library signature.
+  static const char kMagic[8];
+
+  /// \var kVersion
+  ///   The layout version that is written.
+  static const uint32_t kVersion = 1;
+
+  /// \brief Default constructor.
+  CableLibraryReader();
+
+  /// \brief Destructor.
+  ~CableLibraryReader();
+
+  /// \brief Closes the library.
+  void Close();
+
+  /// \brief Extracts a cable to a file.
+  /// \param[in] entry
+  ///   The library entry.
+  /// \param[in] dir_output
+  ///   The output directory.
+  /// \param[out] filepath_output
+  ///   The output filepath (see FilePathExtract()).
+  /// \param[out] message
+  ///   The error message. This is only populated if the extraction fails.
+  /// \return If the cable was extracted.
+  bool Extract(const Entry& entry, const wxString& dir_output,
+               wxString& filepath_output, wxString& message) const;
+
+  /// \brief Fetches the cable file of an entry.
+  /// \param[in] entry
+  ///   The library entry.
+  /// \param[out] data
+  ///   The cable file, in place in the mapped library.
+  /// \param[out] message
+  ///   The error message. This is only populated if the cable file is
+  ///   corrupt.
+  /// \return If the cable file was fetched.
+  bool Fetch(const Entry& entry, TextView& data, wxString& message) const;
+
+  /// \brief Gets the filepath that an entry is extracted to.
+  /// \param[in] entry
+  ///   The library entry.
+  /// \param[in] dir_output
+  ///   The output directory.
+  /// \return The output filepath. The filename is the source filename, with
+  ///   the extension replaced by the cable file extension. The record number
+  ///   of a source from a multi-record file is appended to the name (ex:
+  ///   'export.txt#42' is extracted to 'export_42.cable'), so the records of
+  ///   a file have different filenames.
+  wxString FilePathExtract(const Entry& entry,
+                           const wxString& dir_output) const;
+
+  /// \brief Finds an entry by cable name.
+  /// \param[in] name
+  ///   The cable name.
+  /// \return The entry, or a nullptr if the name is not in the library. If
+  ///   several cables have the same name, the first one added is returned.
+  const Entry* Find(const std::string& name) const;
+
+  /// \brief Finds an entry by source filename.
+  /// \param[in] source
+  ///   The filename of the input file the cable was converted from.
+  /// \return The entry, or a nullptr if the source is not in the library.
+  const Entry* FindSource(const std::string& source) const;
+
+  /// \brief Maps a library and reads its index.
+  /// \param[in] filepath
+  ///   The filepath.
+  /// \param[out] message
+  ///   The error message. This is only populated if the library is invalid.
+  /// \return If the library is valid.
+  bool Open(const wxString& filepath, wxString& message);
+
+  /// \brief Reads the index of a library that is already in memory.
+  /// \param[in] data
+  ///   The library.
+  /// \param[out] entries
+  ///   The entries, in the order they were added.
+  /// \param[out] offset_index
+  ///   The library offset of the index.
+  /// \param[out] message
+  ///   The error message. This is only populated if the library is invalid.
+  /// \return If the library is valid.
+  static bool ReadIndex(const TextView& data, std::vector<Entry>& entries,
+                        uint64_t& offset_index, wxString& message);
+
+  /// \brief Gets the entries.
+  /// \return The entries, in the order they were added.
+  const std::vector<Entry>& entries() const;
+
+ private:
+  /// \var entries_
+  ///   The entries, in the order they were added.
+  std::vector<Entry> entries_;
+
+  /// \var file_
+  ///   The mapped library.
+  MappedFile file_;
+
+  /// \var names_
+  ///   The entry indexes, keyed by cable name.
+  std::unordered_map<std::string, std::size_t> names_;
+
+  /// \var sources_
+  ///   The entry indexes, keyed by source filename.
+  std::unordered_map<std::string, std::size_t> sources_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_CABLELIBRARYREADER_H_
@@ -0,0 +1,123 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_CABLELIBRARYWRITER_H_
+#define OTLS_CABLEFILECONVERTER_CABLELIBRARYWRITER_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "wx/wx.h"
+
+#include "cable_library_reader.h"
+
+/// \par OVERVIEW
+///
+/// This class writes a cable library, which is a single archive that holds
+/// many converted cable files instead of one file per cable. The layout is
+/// described in CableLibraryReader.
+///
+/// The library is built in a hidden temporary file next to it. Cable files
+/// are appended as they are added, and the index is written and synced when
+/// the library is closed. The temporary file then replaces the library in one
+/// rename. If the library is not closed (ex: the process crashed), or a cable
+/// file could not be written, the library on disk is left unchanged.
+///
+/// \par APPENDING
+///
+/// If the library already exists, the cable files that its index references
+/// are copied to the temporary file, and the old entries are kept. A cable
+/// from a source that is already in the library replaces the old entry. The
+/// old cable file is left in the temporary file as unreferenced bytes, and
+/// is dropped the next time the library is opened, so the library is
+/// compacted on every run and never grows by more than one run of replaced
+/// cables.
+///
+/// \par THREAD SAFETY
+///
+/// Cables can be added from multiple threads.
+class CableLibraryWriter {
+ public:
+  /// \brief Default constructor.
+  CableLibraryWriter();
+
+  /// \brief Destructor.
+  /// The library is closed if it is open.
+  ~CableLibraryWriter();
+
+  /// \brief Adds a cable file.
+  /// \param[in] name
+  ///   The cable name.
+  /// \param[in] source
+  ///   The filename of the input file the cable was converted from.
+  /// \param[in] data
+  ///   The cable file.
+  /// \param[out] message
+  ///   The error message. This is only populated if the cable could not be
+  ///   written.
+  /// \return If the cable was added.
+  bool Add(const std::string& name, const std::string& source,
+           const std::string& data, wxString& message);
+
+  /// \brief Writes the index and closes the library.
+  /// \return If the index was written, and the library was replaced. This is
+  ///   false if any cable file could not be written.
+  bool Close();
+
+  /// \brief Opens a library for writing.
+  /// \param[in] filepath
+  ///   The filepath. If a valid library exists, new cables are appended to
+  ///   it. Otherwise a new library is created.
+  /// \return If the library was opened.
+  bool Open(const wxString& filepath);
+
+  /// \brief Gets the number of entries.
+  /// \return The number of entries.
+  std::size_t num_entries() const;
+
+ private:
+  /// \brief Copy constructor. This is disabled, as the file is owned.
+  CableLibraryWriter(const CableLibraryWriter&);
+
+  /// \brief Assignment operator. This is disabled, as the file is owned.
+  CableLibraryWriter& operator=(const CableLibraryWriter&);
+
+  /// \var entries_
+  ///   The entries, in the order they were added.
+  std::vector<CableLibraryReader::Entry> entries_;
+
+  /// \var file_
+  ///   The library file.
+  std::FILE* file_;
+
+  /// \var filepath_
+  ///   The library filepath.
+  wxString filepath_;
+
+  /// \var filepath_temp_
+  ///   The temporary filepath that the library is built in.
+  wxString filepath_temp_;
+
+  /// \var is_failed_
+  ///   An indicator that tells if a cable file could not be written, which
+  ///   keeps the library from being replaced.
+  bool is_failed_;
+
+  /// \var mutex_
+  ///   The mutex that guards the file and entries.
+  mutable std::mutex mutex_;
+
+  /// \var offset_end_
+  ///   The library offset that the next cable file is written at.
+  uint64_t offset_end_;
+
+  /// \var sources_
+  ///   The entry indexes, keyed by source filename.
+  std::map<std::string, std::size_t> sources_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_CABLELIBRARYWRITER_H_
@@ -0,0 +1,158 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_CABLELIMITTABLE_H_
+#define OTLS_CABLEFILECONVERTER_CABLELIMITTABLE_H_
+
+#include <string>
+#include <vector>
+
+#include "models/base/units.h"
+#include "models/transmissionline/cable.h"
+#include "wx/wx.h"
+
+/// \par OVERVIEW
+///
+/// This class solves the cable polynomial limits over a range of strains.
+///
+/// Each limit is the same value that CablePolynomialSearcher::SolveLimits
+/// gives for a fixed strain, so a table replaces converting the same cable
+/// once for every strain. Disabled components have zero limits.
+///
+/// \par VECTORIZATION
+///
+/// Each polynomial is evaluated over the whole strain range in one pass. When
+/// the processor supports AVX2, four strains are evaluated with one set of
+/// vector instructions. Otherwise, each strain is evaluated with scalar code.
+/// Both paths give the same results.
+///
+/// The polynomials are evaluated in the same order as Polynomial::Y, which
+/// SolveLimits uses for a fixed strain. The powers of each strain are
+/// calculated once with pow() and shared by the polynomials, and the terms
+/// are summed in increasing order of power, so each value rounds the same.
+///
+/// \par OUTPUT
+///
+/// The table is written as CSV, with a header row and a row for each strain,
+/// or as JSON, with an array for each column.
+class CableLimitTable {
+ public:
+  /// \par OVERVIEW
+  ///
+  /// This enum contains the table file formats.
+  enum class Format {
+    kCsv,
+    kJson
+  };
+
+  /// \par OVERVIEW
+  ///
+  /// This struct contains a strain range.
+  struct Range {
+    /// \var start
+    ///   The first percent strain.
+    double start;
+
+    /// \var step
+    ///   The percent strain increase between rows.
+    double step;
+
+    /// \var stop
+    ///   The last percent strain. This is included if the range divides
+    ///   evenly into steps.
+    double stop;
+  };
+
+  /// \var kNumStrainsMax
+  ///   The maximum number of strains in a range.
+  static const int kNumStrainsMax = 100000;
+
+  /// \brief Default constructor.
+  CableLimitTable();
+
+  /// \brief Destructor.
+  ~CableLimitTable();
+
+  /// \brief Gets the table file extension.
+  /// \param[in] format
+  ///   The table file format.
+  /// \return The table file extension, without a leading dot.
+  static wxString Extension(const Format& format);
+
+  /// \brief Gets if the table will be solved using AVX2 instructions.
+  /// \return If the table will be solved using AVX2 instructions.
+  static bool IsVectorized();
+
+  /// \brief Parses a strain range.
+  /// \param[in] str
+  ///   The range, formatted as 'start:stop:step'.
+  /// \param[out] range
+  ///   The range.
+  /// \return If the range is valid.
+  static bool ParseRange(const std::string& str, Range& range);
+
+  /// \brief Solves the polynomial limits at every strain in the range.
+  /// \param[in] cable
+  ///   The cable, in the same units and style that SolveLimits uses.
+  /// \param[in] range
+  ///   The strain range.
+  /// \return If the range is valid.
+  bool Solve(const Cable& cable, const Range& range);
+
+  /// \brief Writes the table.
+  /// \param[in] format
+  ///   The table file format.
+  /// \param[in] units
+  ///   The unit system of the cable, which is written to the JSON table.
+  /// \param[out] buffer
+  ///   The table file.
+  void Write(const Format& format, const units::UnitSystem& units,
+             std::string& buffer) const;
+
+  /// \brief Gets the core creep limits.
+  /// \return The core creep limits, one for each strain.
+  const std::vector<double>& limits_core_creep() const;
+
+  /// \brief Gets the core load-strain limits.
+  /// \return The core load-strain limits, one for each strain.
+  const std::vector<double>& limits_core_loadstrain() const;
+
+  /// \brief Gets the shell creep limits.
+  /// \return The shell creep limits, one for each strain.
+  const std::vector<double>& limits_shell_creep() const;
+
+  /// \brief Gets the shell load-strain limits.
+  /// \return The shell load-strain limits, one for each strain.
+  const std::vector<double>& limits_shell_loadstrain() const;
+
+  /// \brief Gets the percent strains.
+  /// \return The percent strains.
+  const std::vector<double>& strains() const;
+
+ private:
+  /// \var limits_core_creep_
+  ///   The core creep limits, one for each strain.
+  std::vector<double> limits_core_creep_;
+
+  /// \var limits_core_loadstrain_
+  ///   The core load-strain limits, one for each strain.
+  std::vector<double> limits_core_loadstrain_;
+
+  /// \var limits_shell_creep_
+  ///   The shell creep limits, one for each strain.
+  std::vector<double> limits_shell_creep_;
+
+  /// \var limits_shell_loadstrain_
+  ///   The shell load-strain limits, one for each strain.
+  std::vector<double> limits_shell_loadstrain_;
+
+  /// \var name_
+  ///   The cable name.
+  std::string name_;
+
+  /// \var strains_
+  ///   The percent strains.
+  std::vector<double> strains_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_CABLELIMITTABLE_H_
@@ -4,10 +4,15 @@
 #ifndef OTLS_CABLEFILECONVERTER_CABLEPOLYNOMIALSEARCHER_H_
 #define OTLS_CABLEFILECONVERTER_CABLEPOLYNOMIALSEARCHER_H_
 
+#include <cstdint>
+#include <vector>
+
 #include "models/base/point.h"
 #include "models/base/polynomial.h"
 #include "models/transmissionline/cable.h"
 
+#include "polynomial_limit_cache.h"
+
 /// \par OVERVIEW
 ///
 /// This class searches a polynomial segment.
@@ -21,8 +26,29 @@
 /// low, the polynomial won't reflect a significant change to stress. If the
 /// slope is too high, it will exceed the elastic modulus, which causes
 /// unrealistic behavior once the cable is unloaded.
+///
+/// \par SEARCH TYPES
+///
+/// The limits can be found by scanning the polynomial at fixed x steps, or by
+/// solving for the roots of the derivative polynomials. The scan is only
+/// accurate to the step size. The root solver isolates each root between the
+/// critical points of the derivative and bisects to the requested tolerance,
+/// which requires far fewer polynomial evaluations.
 class CablePolynomialSearcher {
  public:
+  /// \par OVERVIEW
+  ///
+  /// This enum contains types of limit searches.
+  enum class SearchType {
+    kRoots,
+    kScan
+  };
+
+  /// \var kToleranceMin
+  ///   The minimum x tolerance for the root search. Smaller tolerances are
+  ///   below the precision of the polynomial evaluation.
+  static const double kToleranceMin;
+
   /// \brief Default constructor.
   CablePolynomialSearcher();
 
@@ -37,25 +63,86 @@ class CablePolynomialSearcher {
   /// \param[in,out] cable
   ///   The cable.
   /// \return The success status.
+  /// This uses a fixed step scan to search for the limits.
   static bool SolveLimits(const double& strain_percent, Cable& cable);
 
+  /// \brief Solves the cable polynomial limits.
+  /// \param[in] strain_percent
+  ///   The percent strain to solve the polynomial limits at. If this is set to
+  ///   -1 the strain will be set to the maximum safe value between 0.0 and 1.0
+  ///   percent strain.
+  /// \param[in] type_search
+  ///   The type of limit search.
+  /// \param[in] tolerance
+  ///   The x tolerance for the root search. This is ignored for the scan.
+  /// \param[in] cache
+  ///   The limit cache. Polynomials that are found in the cache are not
+  ///   searched, and new results are added to it. This can be a nullptr.
+  /// \param[in,out] cable
+  ///   The cable.
+  /// \return The success status.
+  static bool SolveLimits(const double& strain_percent,
+                          const SearchType& type_search,
+                          const double& tolerance,
+                          PolynomialLimitCache* cache,
+                          Cable& cable);
+
+  /// \brief Solves the polynomial limits of many cables at once.
+  /// \param[in] strain_percent
+  ///   The percent strain to solve the polynomial limits at. If this is set to
+  ///   -1 the strain will be set to the maximum safe value between 0.0 and 1.0
+  ///   percent strain.
+  /// \param[in] tolerance
+  ///   The x tolerance. The scan ignores it, but it is part of the cache key,
+  ///   so it must match the tolerance of the single cable scan.
+  /// \param[in] cache
+  ///   The limit cache. Polynomials that are found in the cache are not
+  ///   searched, and new results are added to it. This can be a nullptr.
+  /// \param[in,out] cables
+  ///   The cables, which are solved in place.
+  /// \return The success status.
+  /// This gathers every enabled component polynomial into a
+  /// PolynomialBatchSearcher, so all of the polynomials are scanned in one
+  /// vectorized sweep. The results, and the cache entries, match the single
+  /// cable scan.
+  static bool SolveLimits(const double& strain_percent,
+                          const double& tolerance,
+                          PolynomialLimitCache* cache,
+                          const std::vector<Cable*>& cables);
+
+  /// \brief Gets the number of polynomial limits that could not be solved on
+  ///   the calling thread.
+  /// \return The number of unsolved limits since the thread started. A
+  ///   warning is logged for each one.
+  static int64_t ThreadNumLimitsUnsolved();
+
  private:
   /// \brief Finds the limit point of the cable polynomial segment.
   /// \param[in] polynomial
   ///   The polynomial.
   /// \param[in] name_polynomial
-  ///   The name to use for logging.
+  ///   The name to use for logging. This is only converted to a string when
+  ///   a message is logged.
   /// \param[in] slope_min
   ///   The minimum allowable slope.
   /// \param[in] slope_max
   ///   The maximum allowable slope.
+  /// \param[in] type_search
+  ///   The type of limit search.
+  /// \param[in] tolerance
+  ///   The x tolerance for the root search.
+  /// \param[in] cache
+  ///   The limit cache. This can be a nullptr.
   /// \return The limit point.
   /// This function will check the limit point by inflection and by slope
   /// and will return the most limiting one.
   static Point2d<double> PointLimit(const Polynomial& polynomial,
-                                    const std::string& name_polynomial,
+                                    const char* name_polynomial,
                                     const double& slope_min,
-                                    const double& slope_max);
+                                    const double& slope_max,
+                                    const SearchType& type_search,
+                                    const double& tolerance,
+                                    PolynomialLimitCache* cache);
 
   /// \brief Finds the limit point of the cable polynomial segment by checking
   ///   for inflections.
@@ -96,6 +183,49 @@ class CablePolynomialSearcher {
                                            const double& x_max,
                                            const double& slope_min,
                                            const double& slope_max);
+
+  /// \brief Finds the limit point of the cable polynomial segment by solving
+  ///   for the first turning point.
+  /// \param[in] polynomial
+  ///   The polynomial.
+  /// \param[in] x_min
+  ///   The minimum x value.
+  /// \param[in] x_max
+  ///   The maximum x value.
+  /// \param[in] tolerance
+  ///   The x tolerance of the solved point.
+  /// \return The limit point.
+  /// The limit is the first point where the slope becomes negative. If the
+  /// slope never becomes negative, the maximum x value is returned.
+  static Point2d<double> PointLimitByInflectionRoots(
+      const Polynomial& polynomial,
+      const double& x_min,
+      const double& x_max,
+      const double& tolerance);
+
+  /// \brief Finds the limit point of the cable polynomial segment by solving
+  ///   for the first point where the slope leaves the min/max boundaries.
+  /// \param[in] polynomial
+  ///   The polynomial.
+  /// \param[in] x_min
+  ///   The minimum x value.
+  /// \param[in] x_max
+  ///   The maximum x value.
+  /// \param[in] slope_min
+  ///   The minimum allowable slope.
+  /// \param[in] slope_max
+  ///   The maximum allowable slope.
+  /// \param[in] tolerance
+  ///   The x tolerance of the solved point.
+  /// \return The limit point.
+  /// If the slope never leaves the boundaries, the maximum x value is
+  /// returned.
+  static Point2d<double> PointLimitBySlopeRoots(const Polynomial& polynomial,
+                                                const double& x_min,
+                                                const double& x_max,
+                                                const double& slope_min,
+                                                const double& slope_max,
+                                                const double& tolerance);
 };
 
 #endif  // OTLS_CABLEFILECONVERTER_CABLEPOLYNOMIALSEARCHER_H_
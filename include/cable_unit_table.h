@@ -0,0 +1,174 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_CABLEUNITTABLE_H_
+#define OTLS_CABLEFILECONVERTER_CABLEUNITTABLE_H_
+
+#include <vector>
+
+#include "models/base/units.h"
+#include "models/transmissionline/cable.h"
+
+/// \par OVERVIEW
+///
+/// This class converts cable units with a precomputed factor table.
+///
+/// CableUnitConverter walks the cable and its components once for each
+/// conversion, and looks up the conversion factors for every field each time.
+/// A table stores the combined factors of a unit system conversion followed
+/// by a unit style conversion, so both are applied to every field in a single
+/// pass with one multiply and add.
+///
+/// \par FACTORS
+///
+/// Each field is converted with a scale and an offset, which covers both
+/// scaled units (ex: area) and offset units (ex: temperature). Each
+/// polynomial coefficient has its own scale, as the coefficient units depend
+/// on the power of x.
+///
+/// The factors are measured by converting probe cables with
+/// CableUnitConverter, so they always match it. The table is then checked
+/// against a probe with a different value in every field. If a conversion is
+/// not a scale and offset of each field on its own, no table is made for it,
+/// and CableUnitConverter must be used instead.
+///
+/// \par BATCHES
+///
+/// Many cables can be converted together. Each field is converted for every
+/// cable in one loop, so the factor is loaded once per field instead of once
+/// per cable, and no cable is converted unless all of them can be.
+///
+/// \par THREAD SAFETY
+///
+/// The tables are created once, on first use, and are then only read.
+class CableUnitTable {
+ public:
+  /// \par OVERVIEW
+  ///
+  /// This struct converts a value with a scale and an offset.
+  struct Factor {
+    /// \var offset
+    ///   The offset, which is added after scaling.
+    double offset;
+
+    /// \var scale
+    ///   The scale.
+    double scale;
+  };
+
+  /// \var kNumCoefficientsMax
+  ///   The maximum number of polynomial coefficients that a table converts.
+  static const int kNumCoefficientsMax = 16;
+
+  /// \par OVERVIEW
+  ///
+  /// This struct contains the factors of a cable component.
+  struct ComponentFactors {
+    /// \var coefficient_expansion_linear_thermal
+    ///   The factor for the coefficient of linear thermal expansion.
+    Factor coefficient_expansion_linear_thermal;
+
+    /// \var coefficients_polynomial_creep
+    ///   The scale of each creep polynomial coefficient.
+    double coefficients_polynomial_creep[kNumCoefficientsMax];
+
+    /// \var coefficients_polynomial_loadstrain
+    ///   The scale of each load-strain polynomial coefficient.
+    double coefficients_polynomial_loadstrain[kNumCoefficientsMax];
+
+    /// \var load_limit_polynomial_creep
+    ///   The factor for the creep polynomial load limit.
+    Factor load_limit_polynomial_creep;
+
+    /// \var load_limit_polynomial_loadstrain
+    ///   The factor for the load-strain polynomial load limit.
+    Factor load_limit_polynomial_loadstrain;
+
+    /// \var modulus_compression_elastic_area
+    ///   The factor for the compression elastic area modulus.
+    Factor modulus_compression_elastic_area;
+
+    /// \var modulus_tension_elastic_area
+    ///   The factor for the tension elastic area modulus.
+    Factor modulus_tension_elastic_area;
+  };
+
+  /// \brief Destructor.
+  ~CableUnitTable();
+
+  /// \brief Finds the table for a conversion.
+  /// \param[in] system_from
+  ///   The unit system of the cable, which is in the 'consistent' style.
+  /// \param[in] system_to
+  ///   The converted unit system.
+  /// \param[in] style_to
+  ///   The converted unit style.
+  /// \return The table, or a nullptr if the conversion can't be made with a
+  ///   table. The table matches CableUnitConverter::ConvertUnitSystem()
+  ///   (if the systems are different), followed by
+  ///   CableUnitConverter::ConvertUnitStyleToDifferent() with the converted
+  ///   system (if the style is 'different').
+  static const CableUnitTable* Find(const units::UnitSystem& system_from,
+                                    const units::UnitSystem& system_to,
+                                    const units::UnitStyle& style_to);
+
+  /// \brief Converts a cable.
+  /// \param[in,out] cable
+  ///   The cable.
+  /// \return If the cable was converted. If a polynomial has more than
+  ///   kNumCoefficientsMax coefficients, the cable is not modified.
+  bool Convert(Cable& cable) const;
+
+  /// \brief Converts many cables.
+  /// \param[in,out] cables
+  ///   The cables, which are converted in place.
+  /// \return If all cables were converted. If a polynomial has more than
+  ///   kNumCoefficientsMax coefficients, no cables are modified.
+  bool Convert(const std::vector<Cable*>& cables) const;
+
+ private:
+  /// \brief Default constructor.
+  CableUnitTable();
+
+  /// \brief Measures the table for a conversion.
+  /// \param[in] system_from
+  ///   The unit system of the cable, which is in the 'consistent' style.
+  /// \param[in] system_to
+  ///   The converted unit system.
+  /// \param[in] style_to
+  ///   The converted unit style.
+  /// \return If the conversion can be made with a table.
+  bool Measure(const units::UnitSystem& system_from,
+               const units::UnitSystem& system_to,
+               const units::UnitStyle& style_to);
+
+  /// \var area_physical_
+  ///   The factor for the physical cross-sectional area.
+  Factor area_physical_;
+
+  /// \var component_core_
+  ///   The factors for the core component.
+  ComponentFactors component_core_;
+
+  /// \var component_shell_
+  ///   The factors for the shell component.
+  ComponentFactors component_shell_;
+
+  /// \var diameter_
+  ///   The factor for the diameter.
+  Factor diameter_;
+
+  /// \var strength_rated_
+  ///   The factor for the rated strength.
+  Factor strength_rated_;
+
+  /// \var temperature_properties_components_
+  ///   The factor for the temperature of the component properties.
+  Factor temperature_properties_components_;
+
+  /// \var weight_unit_
+  ///   The factor for the unit weight.
+  Factor weight_unit_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_CABLEUNITTABLE_H_
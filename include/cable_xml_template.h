@@ -0,0 +1,157 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_CABLEXMLTEMPLATE_H_
+#define OTLS_CABLEFILECONVERTER_CABLEXMLTEMPLATE_H_
+
+#include <string>
+#include <vector>
+
+#include "models/base/units.h"
+#include "models/transmissionline/cable.h"
+#include "wx/xml/xml.h"
+
+#include "xml_stream_writer.h"
+
+/// \par OVERVIEW
+///
+/// This class streams a cable XML node directly to an XmlStreamWriter, with
+/// a precomputed template of the node.
+///
+/// The common cable XML handler builds a node tree for every cable, which is
+/// then written and freed. A template stores the elements, attributes, and text
+/// of the node once, along with the cable field and precision of each value, so
+/// a cable is written without building any nodes.
+///
+/// \par MEASUREMENT
+///
+/// The templates are measured by generating nodes for probe cables with the
+/// common cable XML handler, so they always match it. Text that is the same
+/// for two probes with different values in every field is copied as is. Any
+/// other text is matched to the cable field and the precision that generated
+/// it. Only the precision is measured, and values are formatted with the same
+/// helper::DoubleToString() as the handler, so the rounding of any value
+/// matches it. The template is then checked by writing a third probe both
+/// ways and comparing the output byte for byte. If any step fails, no template
+/// is made for it, and the node must be generated by the handler instead.
+///
+/// \par SHAPES
+///
+/// The node structure depends on the number of polynomial coefficients, so a
+/// template is measured for each unit system, unit style, and set of
+/// polynomial sizes, the first time it is needed.
+///
+/// \par THREAD SAFETY
+///
+/// The templates are only read once they are measured, and are never freed,
+/// so they can be used by multiple threads.
+class CableXmlTemplate {
+ public:
+  /// \var kNumCoefficientsMax
+  ///   The maximum number of polynomial coefficients that a template writes.
+  static const int kNumCoefficientsMax = 16;
+
+  /// \brief Destructor.
+  ~CableXmlTemplate();
+
+  /// \brief Finds the template for a cable node.
+  /// \param[in] cable
+  ///   The cable, which sets the polynomial sizes.
+  /// \param[in] name
+  ///   The name of the XML node. Only nodes without a name attribute have
+  ///   templates.
+  /// \param[in] system_units
+  ///   The unit system, which is used for attributing child XML nodes.
+  /// \param[in] style_units
+  ///   The unit style, which is used for attributing child XML nodes.
+  /// \return The template, or a nullptr if the node can't be written with a
+  ///   template. The template matches CableXmlHandler::CreateNode().
+  static const CableXmlTemplate* Find(const Cable& cable,
+                                      const std::string& name,
+                                      const units::UnitSystem& system_units,
+                                      const units::UnitStyle& style_units);
+
+  /// \brief Writes a cable node.
+  /// \param[in] cable
+  ///   The cable, which must have the polynomial sizes of the template.
+  /// \param[in,out] writer
+  ///   The stream writer.
+  void Write(const Cable& cable, XmlStreamWriter& writer) const;
+
+ private:
+  /// \par OVERVIEW
+  ///
+  /// This struct contains a step of the template.
+  struct Op {
+    /// \par OVERVIEW
+    ///
+    /// This enum contains the step types.
+    enum class Type {
+      kAttribute,
+      kEndElement,
+      kStartElement,
+      kText,
+      kTextName,
+      kTextValue
+    };
+
+    /// \var field
+    ///   The index of the cable field that a value is read from.
+    int field;
+
+    /// \var is_fixed
+    ///   An indicator that tells if a value is formatted in fixed notation.
+    bool is_fixed;
+
+    /// \var precision
+    ///   The precision of a value.
+    int precision;
+
+    /// \var text
+    ///   The element name, attribute name, or text.
+    std::string text;
+
+    /// \var type
+    ///   The step type.
+    Type type;
+
+    /// \var value
+    ///   The attribute value.
+    std::string value;
+  };
+
+  /// \brief Default constructor.
+  CableXmlTemplate();
+
+  /// \brief Adds the steps for a node of the first probe.
+  /// \param[in] node_a
+  ///   The node generated for the first probe.
+  /// \param[in] node_b
+  ///   The matching node generated for the second probe.
+  /// \param[in] cable_a
+  ///   The first probe.
+  /// \param[in] cable_b
+  ///   The second probe.
+  /// \return If the nodes could be matched to steps.
+  bool AddNode(const wxXmlNode* node_a, const wxXmlNode* node_b,
+               const Cable& cable_a, const Cable& cable_b);
+
+  /// \brief Measures the template for a cable node.
+  /// \param[in] sizes
+  ///   The core creep, core load-strain, shell creep, and shell load-strain
+  ///   polynomial sizes.
+  /// \param[in] system_units
+  ///   The unit system.
+  /// \param[in] style_units
+  ///   The unit style.
+  /// \return If the node can be written with a template.
+  bool Measure(const std::size_t sizes[4],
+               const units::UnitSystem& system_units,
+               const units::UnitStyle& style_units);
+
+  /// \var ops_
+  ///   The steps, in the order they are written.
+  std::vector<Op> ops_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_CABLEXMLTEMPLATE_H_
@@ -0,0 +1,232 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_CONVERSIONARENA_H_
+#define OTLS_CABLEFILECONVERTER_CONVERSIONARENA_H_
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/// \par OVERVIEW
+///
+/// This class is a bump allocator for the scratch memory of a single
+/// conversion (ex: parse scratch, tokenizer output, XML build state).
+///
+/// Memory is taken from large chunks by advancing a position, and is never
+/// freed on its own. Instead, the whole arena is reset between conversions,
+/// which only rewinds the position to the first chunk. The chunks are kept,
+/// so once the arena has grown to fit the largest conversion, later
+/// conversions do not use the heap at all.
+///
+/// \par CURRENT ARENA
+///
+/// A Scope makes an arena the current arena of the calling thread. Code that
+/// runs during a conversion (ex: a parser) gets it from Current(), and
+/// ArenaAllocator uses it for containers. Anything allocated from the arena
+/// must not be used after the outermost scope ends, as the next scope resets
+/// it.
+///
+/// \par THREAD SAFETY
+///
+/// An arena must only be used by one thread at a time. CableConverter keeps
+/// one arena for each thread.
+class ConversionArena {
+ public:
+  /// \par OVERVIEW
+  ///
+  /// This class makes an arena the current arena of the thread for the
+  /// lifetime of the object. The previous current arena is restored when the
+  /// scope ends, so scopes can be nested.
+  ///
+  /// The arena is only reset by the outermost scope of the arena. A nested
+  /// scope of the same arena keeps the allocations of the scopes around it,
+  /// which are still in use.
+  class Scope {
+   public:
+    /// \brief Constructor.
+    /// \param[in] arena
+    ///   The arena, which is reset if it is not already in a scope.
+    explicit Scope(ConversionArena* arena);
+
+    /// \brief Destructor.
+    ~Scope();
+
+   private:
+    /// \brief Copy constructor. This is not implemented.
+    Scope(const Scope&);
+
+    /// \brief Assignment operator. This is not implemented.
+    Scope& operator=(const Scope&);
+
+    /// \var arena_
+    ///   The arena of the scope.
+    ConversionArena* arena_;
+
+    /// \var previous_
+    ///   The current arena before the scope started.
+    ConversionArena* previous_;
+  };
+
+  /// \var kSizeChunk
+  ///   The default size of a chunk, in bytes. Larger allocations get a chunk
+  ///   of their own size.
+  static const std::size_t kSizeChunk = 64 * 1024;
+
+  /// \brief Default constructor.
+  ConversionArena();
+
+  /// \brief Destructor. This frees all chunks.
+  ~ConversionArena();
+
+  /// \brief Allocates memory.
+  /// \param[in] size
+  ///   The size, in bytes.
+  /// \param[in] alignment
+  ///   The alignment, which must be a power of two that is no larger than
+  ///   the alignment of std::max_align_t.
+  /// \return The memory, which is valid until the arena is reset.
+  void* Allocate(const std::size_t& size, const std::size_t& alignment);
+
+  /// \brief Gets the current arena of the calling thread.
+  /// \return The current arena, or a nullptr if the thread is not in a scope.
+  static ConversionArena* Current();
+
+  /// \brief Releases all allocations. The chunks are kept for reuse.
+  /// This is called by the outermost scope, and must not be called while a
+  /// scope of the arena is open.
+  void Reset();
+
+  /// \brief Gets the number of bytes allocated since the last reset.
+  /// \return The number of bytes allocated since the last reset.
+  std::size_t size_allocated() const;
+
+  /// \brief Gets the total size of the chunks.
+  /// \return The total size of the chunks, in bytes.
+  std::size_t size_reserved() const;
+
+ private:
+  /// \par OVERVIEW
+  ///
+  /// This struct contains a block of memory that allocations are taken from.
+  struct Chunk {
+    /// \var data
+    ///   The memory.
+    char* data;
+
+    /// \var size
+    ///   The size, in bytes.
+    std::size_t size;
+  };
+
+  /// \brief Copy constructor. This is not implemented.
+  ConversionArena(const ConversionArena&);
+
+  /// \brief Assignment operator. This is not implemented.
+  ConversionArena& operator=(const ConversionArena&);
+
+  /// \var chunks_
+  ///   The chunks, in the order they are used.
+  std::vector<Chunk> chunks_;
+
+  /// \var depth_scope_
+  ///   The number of scopes of this arena that are open.
+  int depth_scope_;
+
+  /// \var index_chunk_
+  ///   The index of the chunk that allocations are taken from.
+  std::size_t index_chunk_;
+
+  /// \var pos_
+  ///   The position of the next allocation in the current chunk.
+  std::size_t pos_;
+
+  /// \var size_allocated_
+  ///   The number of bytes allocated since the last reset.
+  std::size_t size_allocated_;
+};
+
+/// \par OVERVIEW
+///
+/// This class is a standard library allocator that takes memory from a
+/// conversion arena.
+///
+/// A default constructed allocator uses the current arena of the thread. If
+/// there is no current arena, the heap is used instead, so containers that
+/// use this allocator also work outside of a conversion. Deallocation from an
+/// arena does nothing, as the memory is released when the arena is reset.
+template<class T>
+class ArenaAllocator {
+ public:
+  typedef T value_type;
+
+  /// \brief Default constructor. This uses the current arena of the thread.
+  ArenaAllocator() : arena_(ConversionArena::Current()) {
+  }
+
+  /// \brief Constructor.
+  /// \param[in] arena
+  ///   The arena. If a nullptr, the heap is used.
+  explicit ArenaAllocator(ConversionArena* arena) : arena_(arena) {
+  }
+
+  /// \brief Converting constructor.
+  template<class U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena()) {
+  }
+
+  /// \brief Allocates memory for objects.
+  /// \param[in] num
+  ///   The number of objects.
+  /// \return The memory.
+  T* allocate(std::size_t num) {
+    if (arena_ == nullptr) {
+      return static_cast<T*>(::operator new(num * sizeof(T)));
+    }
+    return static_cast<T*>(arena_->Allocate(num * sizeof(T), alignof(T)));
+  }
+
+  /// \brief Deallocates memory.
+  /// \param[in] ptr
+  ///   The memory.
+  /// \param[in] num
+  ///   The number of objects.
+  void deallocate(T* ptr, std::size_t num) {
+    static_cast<void>(num);
+    if (arena_ == nullptr) {
+      ::operator delete(ptr);
+    }
+  }
+
+  /// \brief Gets the arena.
+  /// \return The arena, or a nullptr if the heap is used.
+  ConversionArena* arena() const {
+    return arena_;
+  }
+
+ private:
+  /// \var arena_
+  ///   The arena, which is not owned. If a nullptr, the heap is used.
+  ConversionArena* arena_;
+};
+
+/// \brief Compares allocators. Allocators are equal if they use the same
+///   arena, which means they can free each other's memory.
+template<class T, class U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return a.arena() == b.arena();
+}
+
+/// \brief Compares allocators.
+template<class T, class U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return a.arena() != b.arena();
+}
+
+/// \par OVERVIEW
+///
+/// This is a vector that takes memory from the current arena.
+template<class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif  // OTLS_CABLEFILECONVERTER_CONVERSIONARENA_H_
@@ -0,0 +1,167 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_CONVERSIONMANIFEST_H_
+#define OTLS_CABLEFILECONVERTER_CONVERSIONMANIFEST_H_
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "wx/wx.h"
+
+/// \par OVERVIEW
+///
+/// This class records which input files have been converted, so unchanged
+/// files can be skipped when a batch is run again.
+///
+/// Each entry contains the hash of the input file contents, the hash of the
+/// converter settings, and the output filepath and the hash of its contents.
+/// An input is current if all of these still match, which means the output
+/// file exists and has not been modified since it was generated.
+///
+/// \par FILE
+///
+/// The manifest is a text file with one tab separated entry per line. It is
+/// saved to a temporary file that is then renamed over the manifest, so a
+/// crash never leaves a partially written manifest.
+///
+/// \par CHECKPOINTS
+///
+/// Updates are periodically saved while a batch is running. If a run is
+/// interrupted, the next run skips every file that was converted before the
+/// last checkpoint.
+///
+/// A save copies the entries under the lock, and writes, syncs, and renames
+/// the file outside of it, so other threads keep updating the manifest while
+/// it is written. A checkpoint is skipped if another save is already being
+/// written.
+///
+/// \par THREAD SAFETY
+///
+/// All methods are safe to call from multiple threads.
+class ConversionManifest {
+ public:
+  /// \par OVERVIEW
+  ///
+  /// This struct contains the conversion record of an input file.
+  struct Entry {
+    /// \var filepath_output
+    ///   The output filepath.
+    std::string filepath_output;
+
+    /// \var hash_input
+    ///   The hash of the input file contents.
+    uint64_t hash_input;
+
+    /// \var hash_output
+    ///   The hash of the output file contents.
+    uint64_t hash_output;
+
+    /// \var hash_settings
+    ///   The hash of the converter settings.
+    uint64_t hash_settings;
+  };
+
+  /// \brief Default constructor.
+  ConversionManifest();
+
+  /// \brief Destructor.
+  ~ConversionManifest();
+
+  /// \brief Hashes a string.
+  /// \param[in] str
+  ///   The string.
+  /// \return The hash.
+  static uint64_t Hash(const std::string& str);
+
+  /// \brief Hashes the contents of a file.
+  /// \param[in] filepath
+  ///   The filepath.
+  /// \param[out] hash
+  ///   The hash.
+  /// \return If the file could be read.
+  static bool HashFile(const wxString& filepath, uint64_t& hash);
+
+  /// \brief Determines if the output of an input file is current.
+  /// \param[in] filepath_input
+  ///   The input filepath.
+  /// \param[in] hash_input
+  ///   The hash of the input file contents.
+  /// \param[in] hash_settings
+  ///   The hash of the converter settings.
+  /// \param[in] filepath_output
+  ///   The output filepath.
+  /// \return If the manifest entry matches, and the output file is unchanged.
+  bool IsCurrent(const wxString& filepath_input, const uint64_t& hash_input,
+                 const uint64_t& hash_settings,
+                 const wxString& filepath_output) const;
+
+  /// \brief Opens a manifest. Existing entries are loaded, and all saves are
+  ///   made to this file.
+  /// \param[in] filepath
+  ///   The manifest filepath. The file does not need to exist.
+  /// \return The success status. This fails if the file exists but is not a
+  ///   valid manifest.
+  bool Open(const std::string& filepath);
+
+  /// \brief Removes the entry of an input file.
+  /// \param[in] filepath_input
+  ///   The input filepath.
+  /// This should be called if an input fails to convert, so it is not skipped
+  /// on the next run.
+  void Remove(const wxString& filepath_input);
+
+  /// \brief Saves the manifest.
+  /// \return The success status.
+  bool Save();
+
+  /// \brief Updates the entry of an input file. The manifest is saved if the
+  ///   checkpoint interval has elapsed.
+  /// \param[in] filepath_input
+  ///   The input filepath.
+  /// \param[in] entry
+  ///   The entry.
+  void Update(const wxString& filepath_input, const Entry& entry);
+
+  /// \brief Gets the number of entries.
+  /// \return The number of entries.
+  std::size_t size() const;
+
+ private:
+  /// \brief Saves a snapshot of the entries, if they have changed. The save
+  ///   mutex must be locked, and the entry mutex must not be.
+  /// \return The success status.
+  bool SaveSnapshot();
+
+  /// \var entries_
+  ///   The entries, keyed by the UTF-8 encoded input filepath. This is sorted
+  ///   so the file is stable between runs.
+  std::map<std::string, Entry> entries_;
+
+  /// \var filepath_
+  ///   The manifest filepath.
+  std::string filepath_;
+
+  /// \var is_modified_
+  ///   An indicator that tells if the entries have changed since the last
+  ///   save.
+  bool is_modified_;
+
+  /// \var mutex_
+  ///   The mutex that guards all members.
+  mutable std::mutex mutex_;
+
+  /// \var mutex_save_
+  ///   The mutex that serializes saves, so the snapshots are written in the
+  ///   order they are taken.
+  std::mutex mutex_save_;
+
+  /// \var time_saved_
+  ///   The time of the last save.
+  std::chrono::steady_clock::time_point time_saved_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_CONVERSIONMANIFEST_H_
@@ -0,0 +1,268 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_CONVERSIONMETRICS_H_
+#define OTLS_CABLEFILECONVERTER_CONVERSIONMETRICS_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "wx/wx.h"
+
+/// \par OVERVIEW
+///
+/// This class counts conversion metrics, and exports them in the Prometheus
+/// text format.
+///
+/// The metrics are the files that were converted or failed, the latency of
+/// each conversion stage as a histogram, the bytes read and written, and the
+/// polynomial limits that could not be solved.
+///
+/// \par SHARDS
+///
+/// Each thread counts into its own shard, which only that thread writes to,
+/// so counting never contends between threads and doesn't need atomic
+/// read-modify-write instructions. The shards are summed when the metrics are
+/// formatted. A shard is kept after its thread exits, so no counts are lost.
+///
+/// \par EXPORT
+///
+/// The metrics are saved for the node exporter textfile collector. The file
+/// is written to a hidden temporary file in the same directory and renamed,
+/// so the collector never reads a partial file. The file can be saved
+/// periodically on a background thread while a long run is in progress.
+///
+/// \par THREAD SAFETY
+///
+/// All methods are safe to call from multiple threads.
+class ConversionMetrics {
+ public:
+  /// \par OVERVIEW
+  ///
+  /// This enum contains the timed conversion stages.
+  enum class Stage {
+    kRead,
+    kParse,
+    kConvertUnits,
+    kSolveLimits,
+    kSerialize,
+    kWrite
+  };
+
+  /// \var kNumStages
+  ///   The number of timed stages.
+  static const int kNumStages = 6;
+
+  /// \brief Default constructor.
+  ConversionMetrics();
+
+  /// \brief Destructor. This stops the periodic save.
+  ~ConversionMetrics();
+
+  /// \brief Adds bytes that were read from input files.
+  /// \param[in] bytes
+  ///   The number of bytes.
+  void AddBytesRead(const int64_t& bytes);
+
+  /// \brief Adds bytes that were written to output files.
+  /// \param[in] bytes
+  ///   The number of bytes.
+  void AddBytesWritten(const int64_t& bytes);
+
+  /// \brief Adds a file (or record) that finished converting.
+  /// \param[in] is_converted
+  ///   An indicator that tells if the file was converted, or failed.
+  void AddFile(const bool& is_converted);
+
+  /// \brief Adds polynomial limits that could not be solved.
+  /// \param[in] num
+  ///   The number of unsolved limits.
+  void AddLimitsUnsolved(const int64_t& num);
+
+  /// \brief Adds a stage duration to the stage histogram.
+  /// \param[in] stage
+  ///   The stage.
+  /// \param[in] duration
+  ///   The duration.
+  void AddStage(const Stage& stage,
+                const std::chrono::steady_clock::duration& duration);
+
+  /// \brief Formats the metrics in the Prometheus text format.
+  /// \return The formatted metrics.
+  std::string Format() const;
+
+  /// \brief Saves the metrics, replacing the file in one rename.
+  /// \param[in] filepath
+  ///   The filepath. The textfile collector only reads files that end in
+  ///   '.prom'.
+  /// \return The success status.
+  bool Save(const wxString& filepath) const;
+
+  /// \brief Starts saving the metrics periodically on a background thread.
+  /// \param[in] filepath
+  ///   The filepath.
+  /// \param[in] seconds
+  ///   The time between saves.
+  /// This saves the file right away, so it exists as soon as a run starts.
+  void StartSaving(const wxString& filepath, const double& seconds);
+
+  /// \brief Stops the periodic save, and saves the final metrics.
+  /// \return The success status of the final save.
+  bool StopSaving();
+
+ private:
+  /// \var kNumBuckets
+  ///   The number of stage histogram buckets, including the +Inf bucket.
+  static const int kNumBuckets = 17;
+
+  /// \par OVERVIEW
+  ///
+  /// This enum contains the positions of the counters in a shard.
+  enum Counter {
+    kFilesConverted,
+    kFilesFailed,
+    kBytesRead,
+    kBytesWritten,
+    kLimitsUnsolved,
+    kNumCounters
+  };
+
+  /// \par OVERVIEW
+  ///
+  /// This struct contains the counters of one thread.
+  ///
+  /// The values are only written by the owning thread, with relaxed loads and
+  /// stores, so they are read without tearing but cost the same as plain
+  /// integers. Each shard is a separate allocation with a cache line of
+  /// padding after the values, so the values of different threads don't
+  /// share lines.
+  struct Shard {
+    /// \var buckets
+    ///   The stage histogram bucket counts. These are not cumulative.
+    std::atomic<int64_t> buckets[kNumStages][kNumBuckets];
+
+    /// \var counters
+    ///   The file, byte, and limit counters.
+    std::atomic<int64_t> counters[kNumCounters];
+
+    /// \var nanoseconds
+    ///   The total duration of each stage, in nanoseconds.
+    std::atomic<int64_t> nanoseconds[kNumStages];
+
+    /// \var padding
+    ///   The padding that keeps the next allocation off the last value line.
+    char padding[64];
+
+    /// \var thread
+    ///   The id of the owning thread.
+    std::thread::id thread;
+  };
+
+  /// \brief Copy constructor. This is not implemented.
+  ConversionMetrics(const ConversionMetrics&);
+
+  /// \brief Assignment operator. This is not implemented.
+  ConversionMetrics& operator=(const ConversionMetrics&);
+
+  /// \brief Adds to a value of the calling thread's shard.
+  /// \param[in] num
+  ///   The amount to add.
+  /// \param[in,out] value
+  ///   The value, which must be in the calling thread's shard.
+  static void Add(const int64_t& num, std::atomic<int64_t>& value);
+
+  /// \brief Runs the periodic save thread.
+  void RunSaving();
+
+  /// \brief Gets the shard of the calling thread, creating it if needed.
+  /// \return The shard.
+  Shard& ShardThread();
+
+  /// \var filepath_
+  ///   The filepath that is saved periodically.
+  wxString filepath_;
+
+  /// \var id_
+  ///   The id of these metrics, which tells the cached shard of a thread
+  ///   apart from the shard of earlier metrics at the same address.
+  uint64_t id_;
+
+  /// \var is_stopping_
+  ///   An indicator that tells the save thread to stop.
+  bool is_stopping_;
+
+  /// \var mutex_
+  ///   The mutex that guards the shard list and the save thread state.
+  mutable std::mutex mutex_;
+
+  /// \var period_
+  ///   The time between periodic saves.
+  std::chrono::steady_clock::duration period_;
+
+  /// \var shards_
+  ///   The shards of all threads that have counted.
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  /// \var stopping_
+  ///   The condition that wakes the save thread when it is stopped.
+  std::condition_variable stopping_;
+
+  /// \var thread_
+  ///   The periodic save thread.
+  std::thread thread_;
+};
+
+/// \par OVERVIEW
+///
+/// This class times a conversion stage for the lifetime of the object.
+///
+/// If the metrics are a nullptr, nothing is timed, so disabled metrics only
+/// cost a pointer check.
+///
+/// \code
+/// {
+///   MetricsTimer timer(metrics, ConversionMetrics::Stage::kSolveLimits);
+///   CablePolynomialSearcher::SolveLimits(...);
+/// }
+/// \endcode
+class MetricsTimer {
+ public:
+  /// \brief Constructor.
+  /// \param[in] metrics
+  ///   The metrics. This can be a nullptr.
+  /// \param[in] stage
+  ///   The stage.
+  MetricsTimer(ConversionMetrics* metrics,
+               const ConversionMetrics::Stage& stage);
+
+  /// \brief Destructor. This adds the duration to the stage histogram.
+  ~MetricsTimer();
+
+ private:
+  /// \brief Copy constructor. This is not implemented.
+  MetricsTimer(const MetricsTimer&);
+
+  /// \brief Assignment operator. This is not implemented.
+  MetricsTimer& operator=(const MetricsTimer&);
+
+  /// \var metrics_
+  ///   The metrics, which are not owned.
+  ConversionMetrics* metrics_;
+
+  /// \var stage_
+  ///   The stage.
+  ConversionMetrics::Stage stage_;
+
+  /// \var start_
+  ///   The start time.
+  std::chrono::steady_clock::time_point start_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_CONVERSIONMETRICS_H_
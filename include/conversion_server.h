@@ -0,0 +1,155 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_CONVERSIONSERVER_H_
+#define OTLS_CABLEFILECONVERTER_CONVERSIONSERVER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "wx/wx.h"
+
+#include "cable_converter.h"
+
+/// \par OVERVIEW
+///
+/// This class serves conversion requests over a Unix domain socket, until it
+/// is stopped.
+///
+/// Clients that convert many files (such as interactive design tools) connect
+/// to the server instead of starting a new process for each file. The server
+/// keeps a pool of worker threads and the polynomial limit cache warm between
+/// requests.
+///
+/// \par PROTOCOL
+///
+/// A request is a list of 'key=value' header lines that is terminated by an
+/// empty line:
+/// - input: the input filepath, which is read by the server
+/// - length: the number of inline input bytes that follow the empty line,
+///   which are used instead of an input filepath
+/// - name: the filename for inline input (optional)
+/// - units: 'imperial' or 'metric' (optional)
+/// - strain: the percent strain for polynomial limits (optional)
+/// - compact: '1' to write the cable file without indentation (optional)
+/// - format: 'xml' or 'bin' (optional)
+///
+/// The optional settings default to the server settings. The response has the
+/// same format:
+/// - status: 'ok', 'error', or 'busy'
+/// - message: the error message, if the status is not 'ok'
+/// - length: the number of cable file bytes that follow the empty line
+///
+/// A connection can send multiple requests, which are answered in order.
+/// Connections that are idle for 30 seconds are closed.
+///
+/// \par BACKPRESSURE
+///
+/// Accepted connections wait in a bounded queue for a worker thread. If the
+/// queue is full, the connection is answered with a 'busy' status and closed,
+/// so the client can retry instead of waiting an unknown time.
+///
+/// \par PLATFORMS
+///
+/// Unix domain sockets are only supported on POSIX platforms.
+class ConversionServer {
+ public:
+  /// \brief Constructor.
+  /// \param[in] converter
+  ///   The converter that provides the default settings for all requests.
+  ConversionServer(const CableConverter* converter);
+
+  /// \brief Destructor.
+  ~ConversionServer();
+
+  /// \brief Requests that all running servers stop.
+  /// This is safe to call from a signal handler.
+  static void RequestStop();
+
+  /// \brief Serves requests until a stop is requested.
+  /// \param[in] filepath_socket
+  ///   The socket filepath. A stale socket file is replaced, but a socket
+  ///   that another server is listening on is not.
+  /// \param[in] num_jobs
+  ///   The number of worker threads. If this is less than 1, the number of
+  ///   hardware threads is used.
+  /// \return If the server was started.
+  bool Run(const wxString& filepath_socket, const int& num_jobs);
+
+  /// \brief Gets the number of requests that failed.
+  /// \return The number of requests that failed.
+  long num_failed() const;
+
+  /// \brief Gets the number of requests that were served.
+  /// \return The number of requests that were served.
+  long num_served() const;
+
+ private:
+  /// \brief Serves the requests on a connection until it is closed.
+  /// \param[in] socket
+  ///   The connected socket.
+  void ServeConnection(const int& socket);
+
+  /// \brief Serves a request.
+  /// \param[in] headers
+  ///   The request header values, keyed by name.
+  /// \param[in] input
+  ///   The inline input, if the request has a length.
+  /// \param[out] buffer
+  ///   The generated cable file.
+  /// \param[out] message
+  ///   The error message. This is only populated if the request fails.
+  /// \return The success status of the request.
+  bool ServeRequest(const std::map<std::string, std::string>& headers,
+                    const std::string& input, std::string& buffer,
+                    wxString& message);
+
+  /// \brief Serves queued connections until the server is stopped.
+  /// \param[in] log
+  ///   A thread safe log target that the worker logs to directly. This can be
+  ///   a nullptr.
+  /// This is the worker thread entry point.
+  void ServeConnections(wxLog* log);
+
+  /// \var is_stop_requested_
+  ///   An indicator that tells all servers to stop.
+  static std::atomic<bool> is_stop_requested_;
+
+  /// \var condition_
+  ///   The condition that wakes the worker threads.
+  std::condition_variable condition_;
+
+  /// \var converter_
+  ///   The converter that provides the default settings for all requests.
+  const CableConverter* converter_;
+
+  /// \var is_stopping_
+  ///   An indicator that tells the worker threads to exit.
+  std::atomic<bool> is_stopping_;
+
+  /// \var mutex_
+  ///   The mutex that guards the queue.
+  std::mutex mutex_;
+
+  /// \var num_failed_
+  ///   The number of requests that failed.
+  std::atomic<long> num_failed_;
+
+  /// \var num_served_
+  ///   The number of requests that were served.
+  std::atomic<long> num_served_;
+
+  /// \var queue_
+  ///   The accepted sockets waiting for a worker thread.
+  std::deque<int> queue_;
+
+  /// \var size_queue_max_
+  ///   The maximum number of accepted sockets waiting for a worker thread.
+  std::size_t size_queue_max_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_CONVERSIONSERVER_H_
@@ -0,0 +1,112 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_DELIMITERSCANNER_H_
+#define OTLS_CABLEFILECONVERTER_DELIMITERSCANNER_H_
+
+#include <cstdint>
+
+#include "conversion_arena.h"
+#include "text_view.h"
+
+/// \par OVERVIEW
+///
+/// This class finds delimiter positions in a block of text using SIMD
+/// instructions.
+///
+/// A single pass over the block finds every position of the separator and the
+/// boundary (ex: quote) characters. The positions are stored in a compact
+/// index, which can then be used to split and extract fields without searching
+/// the text again.
+///
+/// \par COMPATIBILITY
+///
+/// The split, extract, and separate functions give exactly the same results as
+/// the FileParser helpers, including dropping empty substrings and handling
+/// multi-character separators.
+///
+/// \par MEMORY
+///
+/// The positions and tokens use ArenaAllocator, so during a conversion they
+/// are taken from the conversion arena and are released in one step when the
+/// next file is converted. Outside of a conversion, the heap is used.
+///
+/// \par INSTRUCTION SETS
+///
+/// AVX2 (32 bytes per step) is used if supported by the processor, then SSE2
+/// (16 bytes per step), and otherwise a scalar loop.
+class DelimiterScanner {
+ public:
+  /// \par OVERVIEW
+  ///
+  /// This struct contains the delimiter positions of a block of text.
+  struct FieldIndex {
+    /// \var boundary
+    ///   The boundary string.
+    TextView boundary;
+
+    /// \var positions_boundary
+    ///   The positions of the first boundary character, in increasing order.
+    ArenaVector<uint32_t> positions_boundary;
+
+    /// \var positions_separator
+    ///   The positions of the first separator character, in increasing order.
+    ArenaVector<uint32_t> positions_separator;
+
+    /// \var separator
+    ///   The separator string.
+    TextView separator;
+
+    /// \var text
+    ///   The text that was scanned.
+    TextView text;
+  };
+
+  /// \brief Extracts a string between the first two boundaries.
+  /// \param[in] index
+  ///   The field index.
+  /// \return A view of the extracted string. This matches
+  ///   FileParser::Extract().
+  static TextView Extract(const FieldIndex& index);
+
+  /// \brief Scans a block of text for delimiters.
+  /// \param[in] text
+  ///   The text. This must be smaller than 4 GiB.
+  /// \param[in] separator
+  ///   The separator string. If empty, separators are not scanned.
+  /// \param[in] boundary
+  ///   The boundary string. If empty, boundaries are not scanned.
+  /// \param[out] index
+  ///   The field index.
+  /// \return The success status.
+  static bool Index(const TextView& text,
+                    const TextView& separator,
+                    const TextView& boundary,
+                    FieldIndex& index);
+
+  /// \brief Separates the text at the first separator.
+  /// \param[in] index
+  ///   The field index.
+  /// \param[out] str_left
+  ///   The view to the left of the separator.
+  /// \param[out] str_right
+  ///   The view to the right of the separator.
+  /// \return If the text was separated. This matches FileParser::Separate().
+  static bool Separate(const FieldIndex& index,
+                       TextView& str_left,
+                       TextView& str_right);
+
+  /// \brief Splits the text at the separators.
+  /// \param[in] index
+  ///   The field index.
+  /// \param[out] tokens
+  ///   The substrings. Empty substrings are dropped, which matches
+  ///   FileParser::SubStrings().
+  static void Split(const FieldIndex& index, ArenaVector<TextView>& tokens);
+
+  /// \brief Gets the name of the instruction set that is used.
+  /// \return The name of the instruction set.
+  static const char* InstructionSet();
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_DELIMITERSCANNER_H_
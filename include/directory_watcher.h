@@ -0,0 +1,146 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_DIRECTORYWATCHER_H_
+#define OTLS_CABLEFILECONVERTER_DIRECTORYWATCHER_H_
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "wx/wx.h"
+
+/// \par OVERVIEW
+///
+/// This class watches a directory for files that are created or modified.
+///
+/// \par DEBOUNCING
+///
+/// A file is not reported until it appears to be completely written. This is
+/// when the writer closes it or it is moved into the directory, and no other
+/// changes have been seen for a short settling time. Files that change without
+/// a close event are reported after a longer quiet time.
+///
+/// \par PLATFORMS
+///
+/// On Linux the directory is watched with inotify, so changes are seen as
+/// soon as they happen. Other platforms poll the directory, and report a file
+/// once its size and modification time stop changing.
+///
+/// If the inotify event queue overflows, events are lost, so the directory is
+/// scanned and every file that differs from the version that was last seen is
+/// reported. The version of each file is recorded when it is reported, so
+/// only files whose events were lost are reported again.
+///
+/// Hidden files (starting with '.') and temporary files (ending in '.tmp') are
+/// ignored.
+class DirectoryWatcher {
+ public:
+  /// \brief Default constructor.
+  DirectoryWatcher();
+
+  /// \brief Destructor.
+  ~DirectoryWatcher();
+
+  /// \brief Stops watching the directory.
+  void Close();
+
+  /// \brief Starts watching a directory.
+  /// \param[in] dir
+  ///   The directory.
+  /// \return The success status.
+  bool Open(const wxString& dir);
+
+  /// \brief Waits for files to be ready.
+  /// \param[in] timeout
+  ///   The maximum time to wait.
+  /// \param[out] filepaths
+  ///   The files that are ready. This is cleared first.
+  /// \return If the watch is still valid. This fails if the directory is
+  ///   removed.
+  bool Wait(const std::chrono::milliseconds& timeout,
+            std::vector<wxString>& filepaths);
+
+ private:
+  /// \par OVERVIEW
+  ///
+  /// This struct contains a file that has changed but is not ready yet.
+  struct PendingFile {
+    /// \var is_closed
+    ///   An indicator that tells if the writer has closed the file.
+    bool is_closed;
+
+    /// \var time_changed
+    ///   The time of the last change.
+    std::chrono::steady_clock::time_point time_changed;
+  };
+
+  /// \brief Copy constructor. This is not implemented.
+  DirectoryWatcher(const DirectoryWatcher&);
+
+  /// \brief Assignment operator. This is not implemented.
+  DirectoryWatcher& operator=(const DirectoryWatcher&);
+
+  /// \brief Determines if a file name should be ignored.
+  /// \param[in] name
+  ///   The file name.
+  /// \return If the file should be ignored.
+  static bool IsIgnored(const std::string& name);
+
+  /// \brief Records a change to a file.
+  /// \param[in] name
+  ///   The file name.
+  /// \param[in] is_closed
+  ///   An indicator that tells if the writer has closed the file.
+  void OnChange(const std::string& name, const bool& is_closed);
+
+  /// \brief Moves files that have settled from the pending list.
+  /// \param[out] filepaths
+  ///   The files that are ready.
+  void PopReady(std::vector<wxString>& filepaths);
+
+  /// \brief Reads all available change events.
+  /// \param[in] timeout
+  ///   The maximum time to wait for the first event.
+  /// \return If the watch is still valid.
+  bool ReadEvents(const std::chrono::milliseconds& timeout);
+
+  /// \brief Lists the files in the directory and records any that changed
+  ///   since the last scan. This is used when polling, and when inotify
+  ///   events are lost.
+  /// \param[in] is_recorded
+  ///   An indicator that tells if changes are recorded. If false, only the
+  ///   snapshot is updated.
+  /// \return If the directory still exists.
+  bool Scan(const bool& is_recorded);
+
+  /// \brief Gets the version of a file.
+  /// \param[in] filepath
+  ///   The filepath.
+  /// \return The modification time and size of the file.
+  static std::string Version(const wxString& filepath);
+
+  /// \var dir_
+  ///   The watched directory.
+  wxString dir_;
+
+  /// \var handle_
+  ///   The inotify file descriptor. This is -1 if the directory is polled.
+  int handle_;
+
+  /// \var is_open_
+  ///   An indicator that tells if a directory is being watched.
+  bool is_open_;
+
+  /// \var pending_
+  ///   The files that have changed but are not ready, keyed by file name.
+  std::map<std::string, PendingFile> pending_;
+
+  /// \var snapshot_
+  ///   The version of each file from the last scan, or from when it was last
+  ///   reported, keyed by file name.
+  std::map<std::string, std::string> snapshot_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_DIRECTORYWATCHER_H_
@@ -8,13 +8,111 @@
 
 #include "wx/wx.h"
 
+#include "text_view.h"
+
 /// \todo What is best to use - wxString vs std::string?
 
 /// \par OVERVIEW
 ///
 /// This a general file parser class that contains some helper functions.
+///
+/// \par ZERO-COPY HELPERS
+///
+/// Each string helper has a parallel version that works on text views, such as
+/// the contents of a MappedFile. These return views into the original text
+/// instead of new strings, and the iterators produce lines and tokens one at a
+/// time instead of building a list. The results match the string helpers.
 class FileParser {
  public:
+  /// \par OVERVIEW
+  ///
+  /// This class iterates the lines of a text view.
+  ///
+  /// Lines are separated by a newline. A trailing carriage return is removed
+  /// from each line. The line number is tracked so it can be used with
+  /// FileAndLineNumber().
+  class LineIterator {
+   public:
+    /// \brief Constructor.
+    /// \param[in] text
+    ///   The text, which must outlive the iterator.
+    explicit LineIterator(const TextView& text);
+
+    /// \brief Constructor.
+    /// \param[in] text
+    ///   The text, which must outlive the iterator.
+    /// \param[in] line_number
+    ///   The line number of the line before the text. This is used when the
+    ///   text is a record inside a larger file, so the line numbers match the
+    ///   file.
+    LineIterator(const TextView& text, const int& line_number);
+
+    /// \brief Gets the next line.
+    /// \param[out] line
+    ///   The line.
+    /// \return If a line was found.
+    bool Next(TextView& line);
+
+    /// \brief Gets the line number of the last line that was found.
+    /// \return The line number, starting at 1. This is 0 before the first
+    ///   line is found.
+    int line_number() const;
+
+    /// \brief Gets the position of the next line.
+    /// \return The position of the next line within the text.
+    std::size_t position() const;
+
+   private:
+    /// \var line_number_
+    ///   The line number of the last line that was found.
+    int line_number_;
+
+    /// \var pos_
+    ///   The position of the next line.
+    std::size_t pos_;
+
+    /// \var text_
+    ///   The text.
+    TextView text_;
+  };
+
+  /// \par OVERVIEW
+  ///
+  /// This class iterates the substrings of a text view. It finds the same
+  /// substrings as SubStrings(), including dropping any empty substrings.
+  class TokenIterator {
+   public:
+    /// \brief Constructor.
+    /// \param[in] str
+    ///   The monolithic string, which must outlive the iterator.
+    /// \param[in] separator
+    ///   The separator character(s), which must outlive the iterator.
+    TokenIterator(const TextView& str, const TextView& separator);
+
+    /// \brief Gets the next substring.
+    /// \param[out] token
+    ///   The substring.
+    /// \return If a substring was found.
+    bool Next(TextView& token);
+
+   private:
+    /// \var is_done_
+    ///   An indicator that tells if the last substring has been found.
+    bool is_done_;
+
+    /// \var pos_before_
+    ///   The start position of the next substring.
+    std::size_t pos_before_;
+
+    /// \var separator_
+    ///   The separator character(s).
+    TextView separator_;
+
+    /// \var str_
+    ///   The monolithic string.
+    TextView str_;
+  };
+
   /// \brief Extracts a string.
   /// \param[in] str
   ///   The monolithic string.
@@ -25,6 +123,16 @@ class FileParser {
   ///   an empty string is returned.
   static wxString Extract(const wxString& str, const wxString& boundary);
 
+  /// \brief Extracts a string without copying.
+  /// \param[in] str
+  ///   The monolithic string.
+  /// \param[in] boundary
+  ///   The boundary strings. This defines the start and end extraction
+  ///   positions.
+  /// \return A view of the extracted string. If two boundary characters are
+  ///   not found, an empty view is returned.
+  static TextView Extract(const TextView& str, const TextView& boundary);
+
   /// \brief Gets a formatted string that contains the filepath and line number.
   /// \param[in] filepath
   ///   The filepath.
@@ -51,6 +159,23 @@ class FileParser {
                        wxString& str_left,
                        wxString& str_right);
 
+  /// \brief Separates the string into two separate views without copying.
+  /// \param[in] str
+  ///   The monolithic string.
+  /// \param[in] separator
+  ///   The separator string. This is typically just one character.
+  /// \param[out] str_left
+  ///   The view to the left of the separator.
+  /// \param[out] str_right
+  ///   The view to the right of the separator.
+  /// \return If the string was separated.
+  /// If the separator character occurs more than once in the string, only the
+  /// first once is used.
+  static bool Separate(const TextView& str,
+                       const TextView& separator,
+                       TextView& str_left,
+                       TextView& str_right);
+
   /// \brief Generates a list of substrings from the provided string.
   /// \param[in] str
   ///   The monolithic string.
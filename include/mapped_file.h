@@ -0,0 +1,69 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_MAPPEDFILE_H_
+#define OTLS_CABLEFILECONVERTER_MAPPEDFILE_H_
+
+#include <cstddef>
+
+#include "wx/wx.h"
+
+#include "text_view.h"
+
+/// \par OVERVIEW
+///
+/// This class maps a file into memory as read-only.
+///
+/// The file contents can be accessed without copying them into a separate
+/// buffer. The mapping is released when the object is closed or destroyed, so
+/// any views of the contents must not outlive the object.
+///
+/// \par PLATFORMS
+///
+/// POSIX systems use mmap(), and Windows uses file mapping objects.
+class MappedFile {
+ public:
+  /// \brief Default constructor.
+  MappedFile();
+
+  /// \brief Destructor.
+  ~MappedFile();
+
+  /// \brief Unmaps the file.
+  void Close();
+
+  /// \brief Maps a file into memory.
+  /// \param[in] filepath
+  ///   The filepath.
+  /// \return The success status.
+  bool Open(const wxString& filepath);
+
+  /// \brief Gets if a file is mapped.
+  /// \return If a file is mapped.
+  bool IsOpen() const;
+
+  /// \brief Gets the file contents.
+  /// \return A view of the file contents.
+  TextView contents() const;
+
+ private:
+  /// \brief Copy constructor. This is disabled, as the mapping is owned.
+  MappedFile(const MappedFile&);
+
+  /// \brief Assignment operator. This is disabled, as the mapping is owned.
+  MappedFile& operator=(const MappedFile&);
+
+  /// \var data_
+  ///   The mapped data.
+  const char* data_;
+
+  /// \var is_open_
+  ///   An indicator that tells if a file is mapped.
+  bool is_open_;
+
+  /// \var size_
+  ///   The mapped data size.
+  std::size_t size_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_MAPPEDFILE_H_
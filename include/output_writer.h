@@ -0,0 +1,226 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_OUTPUTWRITER_H_
+#define OTLS_CABLEFILECONVERTER_OUTPUTWRITER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "wx/wx.h"
+
+/// \par OVERVIEW
+///
+/// This class writes batches of output files.
+///
+/// Each file is written to a hidden temporary file next to the output file,
+/// and is then renamed over the output file, so readers never see a partial
+/// file. The files in a batch are written together, so the per-file system
+/// call overhead is shared when many small files are written.
+///
+/// \par BACKENDS
+///
+/// On Linux, io_uring is used if the kernel supports it. All of the files in
+/// a batch are created with one submission, and then the write, sync, close,
+/// and rename of every file are submitted as linked chains in a second
+/// submission. This takes a fixed number of system calls per batch, instead
+/// of several for each file.
+///
+/// Elsewhere, or if io_uring can't be set up (ex: an old kernel, or a
+/// container that blocks it), plain POSIX calls are made for each file. On
+/// Windows, the C runtime is used.
+///
+/// \par SYNC POLICY
+///
+/// The sync policy decides when the files are flushed to disk:
+/// - none: the files are not synced, which is the fastest
+/// - per file: each file is synced before it is renamed, so an output file
+///   is never replaced by an incomplete file after a crash
+/// - per batch: the whole file system is synced once after the batch is
+///   renamed, so the batch is durable when the write returns, at the cost of
+///   one sync instead of one per file
+///
+/// \par STATISTICS
+///
+/// The number of files, bytes, system calls, and the time spent writing are
+/// counted for each writer, and are also added to process-wide totals that
+/// can be logged with LogTotals().
+///
+/// \par THREAD SAFETY
+///
+/// A writer must only be used by one thread at a time. CableConverter keeps
+/// one writer for each thread.
+class OutputWriter {
+ public:
+  /// \par OVERVIEW
+  ///
+  /// This enum contains types of writer backends.
+  enum class Backend {
+    kAuto,
+    kIoUring,
+    kPosix
+  };
+
+  /// \par OVERVIEW
+  ///
+  /// This enum contains types of sync policies.
+  enum class SyncPolicy {
+    kNone,
+    kPerBatch,
+    kPerFile
+  };
+
+  /// \par OVERVIEW
+  ///
+  /// This struct contains a file to be written.
+  struct File {
+    /// \var data
+    ///   The file contents, which must outlive the write.
+    const std::string* data;
+
+    /// \var filepath
+    ///   The output filepath.
+    wxString filepath;
+
+    /// \var is_written
+    ///   An indicator that tells if the file was written and renamed. This is
+    ///   populated by the write.
+    bool is_written;
+  };
+
+  /// \par OVERVIEW
+  ///
+  /// This struct contains the writer settings.
+  struct Options {
+    /// \var backend
+    ///   The requested backend. If io_uring is requested but is not
+    ///   available, the POSIX backend is used.
+    Backend backend;
+
+    /// \var sync
+    ///   The sync policy.
+    SyncPolicy sync;
+  };
+
+  /// \par OVERVIEW
+  ///
+  /// This struct contains writer statistics.
+  struct Stats {
+    /// \var num_batches
+    ///   The number of batches.
+    int64_t num_batches;
+
+    /// \var num_bytes
+    ///   The number of bytes written.
+    int64_t num_bytes;
+
+    /// \var num_files
+    ///   The number of files written.
+    int64_t num_files;
+
+    /// \var num_syscalls
+    ///   The number of system calls. For io_uring, each submission counts as
+    ///   one call.
+    int64_t num_syscalls;
+
+    /// \var seconds
+    ///   The time spent writing, in seconds.
+    double seconds;
+  };
+
+  /// \brief Default constructor.
+  OutputWriter();
+
+  /// \brief Destructor.
+  ~OutputWriter();
+
+  /// \brief Logs the process-wide totals of all writers.
+  static void LogTotals();
+
+  /// \brief Gets the name of a backend.
+  /// \param[in] backend
+  ///   The backend.
+  /// \return The backend name.
+  static wxString NameBackend(const Backend& backend);
+
+  /// \brief Gets the name of a sync policy.
+  /// \param[in] sync
+  ///   The sync policy.
+  /// \return The sync policy name.
+  static wxString NameSync(const SyncPolicy& sync);
+
+  /// \brief Sets up the writer.
+  /// \param[in] options
+  ///   The writer settings.
+  /// If the writer is already set up with the same settings, nothing is
+  /// done.
+  void Open(const Options& options);
+
+  /// \brief Writes a batch of files.
+  /// \param[in,out] files
+  ///   The files. The written indicator of each file is populated.
+  /// \return If all of the files were written.
+  bool Write(std::vector<File>& files);
+
+  /// \brief Gets the backend that is used.
+  /// \return The backend that is used. This is never kAuto once the writer
+  ///   is set up.
+  Backend backend() const;
+
+  /// \brief Gets the writer statistics.
+  /// \return The statistics of this writer.
+  const Stats& stats() const;
+
+ private:
+  /// \par OVERVIEW
+  ///
+  /// This struct contains an io_uring instance. It is only defined where
+  /// io_uring is supported.
+  struct Ring;
+
+  /// \brief Copy constructor. This is disabled, as the ring is owned.
+  OutputWriter(const OutputWriter&);
+
+  /// \brief Assignment operator. This is disabled, as the ring is owned.
+  OutputWriter& operator=(const OutputWriter&);
+
+  /// \brief Syncs the file system of a batch.
+  /// \param[in] files
+  ///   The files.
+  /// \return If the file system was synced.
+  bool SyncBatch(const std::vector<File>& files);
+
+  /// \brief Writes a batch of files using io_uring.
+  /// \param[in,out] files
+  ///   The files.
+  void WriteIoUring(std::vector<File>& files);
+
+  /// \brief Writes a batch of files using POSIX calls, or the C runtime on
+  ///   Windows.
+  /// \param[in,out] files
+  ///   The files.
+  void WritePosix(std::vector<File>& files);
+
+  /// \var backend_
+  ///   The backend that is used.
+  Backend backend_;
+
+  /// \var is_open_
+  ///   An indicator that tells if the writer is set up.
+  bool is_open_;
+
+  /// \var options_
+  ///   The writer settings.
+  Options options_;
+
+  /// \var ring_
+  ///   The io_uring instance. This is a nullptr if io_uring is not used.
+  Ring* ring_;
+
+  /// \var stats_
+  ///   The statistics.
+  Stats stats_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_OUTPUTWRITER_H_
@@ -0,0 +1,226 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_PARSERREGISTRY_H_
+#define OTLS_CABLEFILECONVERTER_PARSERREGISTRY_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "models/base/units.h"
+#include "models/transmissionline/cable.h"
+#include "wx/wx.h"
+
+#include "text_view.h"
+
+class wxDynamicLibrary;
+
+/// \par OVERVIEW
+///
+/// This class holds the input file parsers that are selected at runtime.
+///
+/// Each parser has a sniff function, which recognizes the file format from the
+/// start of the file, and a parse function. The input file is mapped once,
+/// and the same mapping is used to sniff and to parse, so a directory with
+/// mixed formats is converted in a single pass.
+///
+/// \par SELECTION
+///
+/// Parsers are sniffed in the order they are registered, and the first match
+/// is used. A parser without a sniff function matches every file, so it should
+/// be registered last. If no parser matches, the CableConverter falls back to
+/// the ParseCableFile function that is linked into the app.
+///
+/// \par MULTI-RECORD FILES
+///
+/// Some input files hold many cables. A multi-record parser provides a record
+/// marker, which is the start of the first line of each record, and a record
+/// parse function, which parses a single record. The records are found in one
+/// scan of the file, and are then parsed in parallel (see RecordParser).
+///
+/// \par PLUGINS
+///
+/// Parsers can be loaded from shared libraries. A plugin exports a C function
+/// with the name in kNamePluginEntry and the PluginEntryFunction signature,
+/// which registers its parsers. Plugins must be built with the same compiler,
+/// wxWidgets, and OTLS-Models versions as the app.
+///
+/// \par THREAD SAFETY
+///
+/// Parsers must be registered before any conversions start. After that, the
+/// registry is only read, so it can be shared by multiple threads. The parse
+/// functions must be reentrant.
+class ParserRegistry {
+ public:
+  /// \brief Parses a cable file.
+  /// \param[in] filepath
+  ///   The input filepath.
+  /// \param[in] contents
+  ///   The input file contents.
+  /// \param[out] units
+  ///   The unit system that is populated.
+  /// \param[out] cable
+  ///   The cable that is populated.
+  /// \return The status of the file parsing. A true return flag means that no
+  ///   errors were encountered.
+  typedef bool (*ParseFunction)(const wxString& filepath,
+                                const TextView& contents,
+                                units::UnitSystem& units, Cable& cable);
+
+  /// \brief Parses a single cable record from a multi-record file.
+  /// \param[in] filepath
+  ///   The input filepath.
+  /// \param[in] record
+  ///   The record text, which starts with the record marker.
+  /// \param[in] line_number
+  ///   The line number of the line before the record. Diagnostics should add
+  ///   this to the line number within the record, so they match the file (see
+  ///   FileParser::LineIterator).
+  /// \param[out] units
+  ///   The unit system that is populated.
+  /// \param[out] cable
+  ///   The cable that is populated.
+  /// \return The status of the record parsing. A true return flag means that
+  ///   no errors were encountered.
+  typedef bool (*ParseRecordFunction)(const wxString& filepath,
+                                      const TextView& record,
+                                      const int& line_number,
+                                      units::UnitSystem& units, Cable& cable);
+
+  /// \brief Recognizes a file format.
+  /// \param[in] filepath
+  ///   The input filepath. Only the name and extension should be used.
+  /// \param[in] head
+  ///   The start of the file, up to kSizeSniff bytes.
+  /// \return If the parser can parse the file.
+  typedef bool (*SniffFunction)(const wxString& filepath,
+                                const TextView& head);
+
+  /// \par OVERVIEW
+  ///
+  /// This struct contains a registered parser.
+  struct Parser {
+    /// \var marker_record
+    ///   The start of the first line of each record. This is empty if the
+    ///   parser is not a multi-record parser.
+    std::string marker_record;
+
+    /// \var name
+    ///   The parser name, which is shown in the log.
+    std::string name;
+
+    /// \var parse
+    ///   The parse function. This is a nullptr for a multi-record parser.
+    ParseFunction parse;
+
+    /// \var parse_record
+    ///   The record parse function. This is a nullptr if the parser is not a
+    ///   multi-record parser.
+    ParseRecordFunction parse_record;
+
+    /// \var sniff
+    ///   The sniff function. If this is a nullptr, every file matches.
+    SniffFunction sniff;
+  };
+
+  /// \brief Registers the parsers in a plugin.
+  /// \param[in] registry
+  ///   The registry that parsers are added to.
+  /// \return If the plugin registered its parsers.
+  typedef bool (*PluginEntryFunction)(ParserRegistry* registry);
+
+  /// \var kNamePluginEntry
+  ///   The name of the function that each plugin exports.
+  static const char kNamePluginEntry[];
+
+  /// \var kSizeSniff
+  ///   The number of bytes at the start of the file that are sniffed.
+  static const std::size_t kSizeSniff = 4096;
+
+  /// \brief Default constructor.
+  ParserRegistry();
+
+  /// \brief Destructor.
+  /// The plugins are unloaded.
+  ~ParserRegistry();
+
+  /// \brief Describes the registered parsers.
+  /// \return The parser names, in the order they are sniffed.
+  std::string Describe() const;
+
+  /// \brief Loads a plugin and registers its parsers.
+  /// \param[in] filepath
+  ///   The shared library filepath.
+  /// \return If the plugin was loaded and registered its parsers.
+  bool LoadPlugin(const wxString& filepath);
+
+  /// \brief Loads all plugins in a directory.
+  /// \param[in] dir
+  ///   The directory. Only files with the platform shared library extension
+  ///   are loaded.
+  /// \return If all plugins in the directory were loaded.
+  bool LoadPlugins(const wxString& dir);
+
+  /// \brief Registers a parser.
+  /// \param[in] name
+  ///   The parser name.
+  /// \param[in] sniff
+  ///   The sniff function. This can be a nullptr to match every file.
+  /// \param[in] parse
+  ///   The parse function.
+  /// \return If the parser was registered. Names must be unique.
+  bool Register(const std::string& name, SniffFunction sniff,
+                ParseFunction parse);
+
+  /// \brief Registers a multi-record parser.
+  /// \param[in] name
+  ///   The parser name.
+  /// \param[in] sniff
+  ///   The sniff function. This can be a nullptr to match every file.
+  /// \param[in] marker_record
+  ///   The start of the first line of each record (ex: 'name='). This must
+  ///   not be empty.
+  /// \param[in] parse_record
+  ///   The record parse function.
+  /// \return If the parser was registered. Names must be unique.
+  bool RegisterRecords(const std::string& name, SniffFunction sniff,
+                       const std::string& marker_record,
+                       ParseRecordFunction parse_record);
+
+  /// \brief Finds the parser for a file.
+  /// \param[in] filepath
+  ///   The input filepath.
+  /// \param[in] contents
+  ///   The input file contents. Only the first kSizeSniff bytes are sniffed.
+  /// \return The first parser that matches, or a nullptr if none match.
+  const Parser* Sniff(const wxString& filepath,
+                      const TextView& contents) const;
+
+  /// \brief Gets the registered parsers.
+  /// \return The registered parsers, in the order they are sniffed.
+  const std::vector<Parser>& parsers() const;
+
+ private:
+  /// \brief Adds a parser.
+  /// \param[in] parser
+  ///   The parser.
+  /// \return If the parser was added. Names must be unique.
+  bool Add(const Parser& parser);
+
+  /// \brief Copy constructor. This is disabled, as the plugins are owned.
+  ParserRegistry(const ParserRegistry&);
+
+  /// \brief Assignment operator. This is disabled, as the plugins are owned.
+  ParserRegistry& operator=(const ParserRegistry&);
+
+  /// \var libraries_
+  ///   The loaded plugins, which are owned by the registry.
+  std::vector<wxDynamicLibrary*> libraries_;
+
+  /// \var parsers_
+  ///   The registered parsers.
+  std::vector<Parser> parsers_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_PARSERREGISTRY_H_
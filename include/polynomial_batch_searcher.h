@@ -0,0 +1,119 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_POLYNOMIALBATCHSEARCHER_H_
+#define OTLS_CABLEFILECONVERTER_POLYNOMIALBATCHSEARCHER_H_
+
+#include <vector>
+
+#include "models/base/point.h"
+
+/// \par OVERVIEW
+///
+/// This class searches the limit points of many polynomials at once.
+///
+/// The search matches the fixed step scan in CablePolynomialSearcher. Each
+/// polynomial is checked by inflection and by slope, and the most limiting
+/// point is kept.
+///
+/// \par DATA LAYOUT
+///
+/// The coefficients are stored as a structure-of-arrays. Each row contains one
+/// power of x, and each column (lane) contains one polynomial. Polynomials with
+/// a lower degree are padded with zero coefficients.
+///
+/// \par VECTORIZATION
+///
+/// When the processor supports AVX2, four lanes are evaluated at the same
+/// strain sample with one set of vector instructions. The stop conditions are
+/// applied to each lane with a mask, and a block stops once all of its lanes
+/// have stopped. Otherwise, each lane is searched with scalar code. Both paths
+/// give the same results.
+class PolynomialBatchSearcher {
+ public:
+  /// \brief Default constructor.
+  PolynomialBatchSearcher();
+
+  /// \brief Destructor.
+  ~PolynomialBatchSearcher();
+
+  /// \brief Adds a polynomial.
+  /// \param[in] coefficients
+  ///   The polynomial coefficients, in increasing order of power.
+  /// \param[in] slope_min
+  ///   The minimum allowable slope.
+  /// \param[in] slope_max
+  ///   The maximum allowable slope.
+  /// \return The index of the polynomial.
+  int Add(const std::vector<double>& coefficients,
+          const double& slope_min,
+          const double& slope_max);
+
+  /// \brief Clears all polynomials and limits.
+  void Clear();
+
+  /// \brief Gets the limit point of a polynomial.
+  /// \param[in] index
+  ///   The polynomial index.
+  /// \return The limit point. If the limit could not be solved, the point is
+  ///   left at its default (invalid) value.
+  /// This is only valid after searching.
+  Point2d<double> Limit(const int& index) const;
+
+  /// \brief Searches the limit points of all polynomials.
+  /// \param[in] x_min
+  ///   The minimum x value for the inflection search.
+  /// \param[in] x_min_slope
+  ///   The minimum x value for the slope search.
+  /// \param[in] x_step
+  ///   The x step increase between calculation points.
+  /// \param[in] x_max
+  ///   The maximum x value.
+  /// \return If the search parameters are valid.
+  bool Search(const double& x_min,
+              const double& x_min_slope,
+              const double& x_step,
+              const double& x_max);
+
+  /// \brief Gets if the searches will use AVX2 instructions.
+  /// \return If the searches will use AVX2 instructions.
+  static bool IsVectorized();
+
+  /// \brief Gets the number of polynomials.
+  /// \return The number of polynomials.
+  int size() const;
+
+ private:
+  /// \var coefficients_
+  ///   The polynomial coefficients. The outer index is the power of x, and the
+  ///   inner index is the lane.
+  std::vector<std::vector<double>> coefficients_;
+
+  /// \var coefficients_slope_
+  ///   The derivative polynomial coefficients, in the same layout as the
+  ///   polynomial coefficients.
+  std::vector<std::vector<double>> coefficients_slope_;
+
+  /// \var is_valid_
+  ///   An indicator for each lane that tells if the polynomial can be
+  ///   searched. Padding lanes are not valid.
+  std::vector<char> is_valid_;
+
+  /// \var limits_
+  ///   The limit points for each polynomial.
+  std::vector<Point2d<double>> limits_;
+
+  /// \var num_
+  ///   The number of polynomials. This excludes padding lanes.
+  int num_;
+
+  /// \var slopes_max_
+  ///   The maximum allowable slope for each lane.
+  std::vector<double> slopes_max_;
+
+  /// \var slopes_min_
+  ///   The minimum allowable slope for each lane.
+  std::vector<double> slopes_min_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_POLYNOMIALBATCHSEARCHER_H_
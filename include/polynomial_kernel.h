@@ -0,0 +1,90 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_POLYNOMIALKERNEL_H_
+#define OTLS_CABLEFILECONVERTER_POLYNOMIALKERNEL_H_
+
+#include <vector>
+
+#include "models/base/polynomial.h"
+
+/// \par OVERVIEW
+///
+/// This class evaluates a polynomial with a fixed number of coefficients.
+///
+/// The coefficients are copied into a fixed size array when the kernel is
+/// created. Because the size is known at compile time, the compiler can fully
+/// unroll the evaluation and hold the coefficients in registers.
+///
+/// \par EVALUATION
+///
+/// The y and slope values are evaluated together in one pass using Horner's
+/// method.
+template<int kNumCoefficients>
+class PolynomialKernel {
+ public:
+  /// \brief Constructor.
+  /// \param[in] coefficients
+  ///   The polynomial coefficients, in increasing order of power. The size
+  ///   must match the kernel size.
+  explicit PolynomialKernel(const std::vector<double>& coefficients) {
+    for (int i = 0; i < kNumCoefficients; i++) {
+      coefficients_[i] = coefficients[i];
+    }
+  }
+
+  /// \brief Evaluates the polynomial y and slope values.
+  /// \param[in] x
+  ///   The x value.
+  /// \param[out] y
+  ///   The y value.
+  /// \param[out] slope
+  ///   The slope (dy/dx) value.
+  inline void Evaluate(const double& x, double& y, double& slope) const {
+    y = coefficients_[kNumCoefficients - 1];
+    slope = 0;
+    for (int i = kNumCoefficients - 2; 0 <= i; i--) {
+      slope = slope * x + y;
+      y = y * x + coefficients_[i];
+    }
+  }
+
+ private:
+  /// \var coefficients_
+  ///   The polynomial coefficients.
+  double coefficients_[kNumCoefficients];
+};
+
+/// \par OVERVIEW
+///
+/// This class evaluates a polynomial with any number of coefficients. It has
+/// the same interface as the fixed size kernels, but uses the general
+/// polynomial.
+class PolynomialKernelGeneric {
+ public:
+  /// \brief Constructor.
+  /// \param[in] polynomial
+  ///   The polynomial. This must remain valid for the life of the kernel.
+  explicit PolynomialKernelGeneric(const Polynomial& polynomial)
+      : polynomial_(polynomial) {
+  }
+
+  /// \brief Evaluates the polynomial y and slope values.
+  /// \param[in] x
+  ///   The x value.
+  /// \param[out] y
+  ///   The y value.
+  /// \param[out] slope
+  ///   The slope (dy/dx) value.
+  inline void Evaluate(const double& x, double& y, double& slope) const {
+    y = polynomial_.Y(x);
+    slope = polynomial_.Slope(x);
+  }
+
+ private:
+  /// \var polynomial_
+  ///   The polynomial.
+  const Polynomial& polynomial_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_POLYNOMIALKERNEL_H_
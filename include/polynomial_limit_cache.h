@@ -0,0 +1,199 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_POLYNOMIALLIMITCACHE_H_
+#define OTLS_CABLEFILECONVERTER_POLYNOMIALLIMITCACHE_H_
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "models/base/point.h"
+
+/// \par OVERVIEW
+///
+/// This class caches polynomial limit search results.
+///
+/// Many cables share identical components (ex: the same steel core is used
+/// across a whole ACSR family), so the same polynomials are searched over and
+/// over. The cache allows each unique polynomial to be searched only once.
+///
+/// \par KEYS
+///
+/// The key contains everything that affects the search result: the exact
+/// coefficients, the slope boundaries, and the search settings. Doubles are
+/// compared by their bit patterns, so only exact matches are hits.
+///
+/// \par SIZE
+///
+/// The number of entries is capped. Once the cache is full, the least
+/// recently used entry is evicted for each new one, so a long running process
+/// (ex: watch or server mode) keeps the polynomials it is still converting.
+///
+/// \par THREAD SAFETY
+///
+/// All methods are safe to call from multiple threads.
+///
+/// \par FILE
+///
+/// The cache can be saved to and loaded from a text file. Doubles are stored
+/// in hexadecimal floating point notation so they are restored exactly. The
+/// entries are saved from least to most recently used, so the order survives a
+/// load. The file is written to a temporary file that is renamed over it, so
+/// an interrupted save never truncates the previous file.
+class PolynomialLimitCache {
+ public:
+  /// \par OVERVIEW
+  ///
+  /// This struct contains everything that affects a polynomial limit search.
+  struct Key {
+    /// \var coefficients
+    ///   The polynomial coefficients.
+    std::vector<double> coefficients;
+
+    /// \var slope_max
+    ///   The maximum allowable slope.
+    double slope_max;
+
+    /// \var slope_min
+    ///   The minimum allowable slope.
+    double slope_min;
+
+    /// \var tolerance
+    ///   The search tolerance.
+    double tolerance;
+
+    /// \var type_search
+    ///   The search type.
+    int type_search;
+
+    /// \brief Compares keys by bit pattern.
+    bool operator==(const Key& other) const;
+  };
+
+  /// \var kSizeMaxDefault
+  ///   The default maximum number of entries.
+  static const std::size_t kSizeMaxDefault = 100000;
+
+  /// \brief Default constructor.
+  PolynomialLimitCache();
+
+  /// \brief Destructor.
+  ~PolynomialLimitCache();
+
+  /// \brief Clears all entries and counters.
+  void Clear();
+
+  /// \brief Finds a cached limit.
+  /// \param[in] key
+  ///   The key.
+  /// \param[out] limit
+  ///   The cached limit. This is only modified if the key is found.
+  /// \return If the key was found. This also updates the hit/miss counters,
+  ///   and marks the entry as the most recently used.
+  bool Find(const Key& key, Point2d<double>& limit) const;
+
+  /// \brief Inserts a limit.
+  /// \param[in] key
+  ///   The key.
+  /// \param[in] limit
+  ///   The limit.
+  /// If the cache is full, the least recently used entry is evicted.
+  void Insert(const Key& key, const Point2d<double>& limit);
+
+  /// \brief Loads entries from a file.
+  /// \param[in] filepath
+  ///   The filepath.
+  /// \return The success status. Invalid lines are skipped, and the least
+  ///   recently used entries are evicted if the file has more entries than
+  ///   the maximum size.
+  bool Load(const std::string& filepath);
+
+  /// \brief Logs the hit/miss counters to the verbose log.
+  void LogStatistics() const;
+
+  /// \brief Saves all entries to a file, replacing the file in one rename.
+  /// \param[in] filepath
+  ///   The filepath.
+  /// \return The success status. The previous file is kept if the save
+  ///   fails.
+  bool Save(const std::string& filepath) const;
+
+  /// \brief Gets the number of cache hits.
+  /// \return The number of cache hits.
+  long num_hits() const;
+
+  /// \brief Gets the number of cache misses.
+  /// \return The number of cache misses.
+  long num_misses() const;
+
+  /// \brief Gets the number of entries.
+  /// \return The number of entries.
+  std::size_t size() const;
+
+  /// \brief Gets the maximum number of entries.
+  /// \return The maximum number of entries.
+  std::size_t size_max() const;
+
+  /// \brief Sets the maximum number of entries.
+  /// \param[in] size_max
+  ///   The maximum number of entries, which must be at least 1. The least
+  ///   recently used entries are evicted if the cache is larger.
+  void set_size_max(const std::size_t& size_max);
+
+ private:
+  /// \par OVERVIEW
+  ///
+  /// This struct contains a cached limit.
+  struct Entry {
+    /// \var key
+    ///   The key.
+    Key key;
+
+    /// \var limit
+    ///   The limit.
+    Point2d<double> limit;
+  };
+
+  /// \par OVERVIEW
+  ///
+  /// This struct hashes keys by bit pattern.
+  struct KeyHash {
+    /// \brief Gets the hash of the key.
+    std::size_t operator()(const Key& key) const;
+  };
+
+  /// \brief Evicts the least recently used entries until the cache fits the
+  ///   maximum size. The mutex must be locked.
+  void Evict();
+
+  /// \var entries_
+  ///   The cached limits, from most to least recently used. The order is
+  ///   updated by Find(), which is why this is mutable.
+  mutable std::list<Entry> entries_;
+
+  /// \var indexes_
+  ///   The position of each key in the entries.
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> indexes_;
+
+  /// \var mutex_
+  ///   The mutex that guards the entries.
+  mutable std::mutex mutex_;
+
+  /// \var num_hits_
+  ///   The number of cache hits.
+  mutable std::atomic<long> num_hits_;
+
+  /// \var num_misses_
+  ///   The number of cache misses.
+  mutable std::atomic<long> num_misses_;
+
+  /// \var size_max_
+  ///   The maximum number of entries.
+  std::size_t size_max_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_POLYNOMIALLIMITCACHE_H_
@@ -0,0 +1,155 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_RECORDCONVERTER_H_
+#define OTLS_CABLEFILECONVERTER_RECORDCONVERTER_H_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "wx/wx.h"
+
+#include "cable_converter.h"
+#include "cable_library_writer.h"
+#include "record_parser.h"
+
+/// \par OVERVIEW
+///
+/// This class converts all of the cable records in a multi-record input file
+/// to cable files in an output directory.
+///
+/// The input file is mapped once, and is parsed by the multi-record parser in
+/// the converter parser registry (see RecordParser). The parsed cables are
+/// then solved, serialized, and written by a pool of worker threads.
+///
+/// \par OUTPUT FILES
+///
+/// The output filename is the input filename with the record number appended
+/// (ex: 'export_0042.cable'), so cables with the same name don't overwrite
+/// each other.
+///
+/// If a library is set, the cables are added to the library instead, and the
+/// output directory is not used. The library source of each cable is the
+/// input filename with the record number appended (ex: 'export.txt#42').
+///
+/// Each worker claims the records in batches of 32. The cables of a batch are
+/// solved together (see CableConverter::SolveBatch()), and if the converter
+/// has an output writer, their output files are written together.
+///
+/// \par DIAGNOSTICS
+///
+/// Each failure is reported with the input filepath and the line number of
+/// the record.
+class RecordConverter {
+ public:
+  /// \par OVERVIEW
+  ///
+  /// This struct contains the conversion status of a single record.
+  struct RecordStatus {
+    /// \var filepath_output
+    ///   The output filepath.
+    wxString filepath_output;
+
+    /// \var is_converted
+    ///   An indicator that tells if the record was converted successfully.
+    bool is_converted;
+
+    /// \var line_number
+    ///   The line number of the first line of the record.
+    int line_number;
+
+    /// \var message
+    ///   The error message. This is empty if the record was converted.
+    wxString message;
+
+    /// \var name
+    ///   The cable name. This is empty if the record was not parsed.
+    std::string name;
+  };
+
+  /// \brief Constructor.
+  /// \param[in] converter
+  ///   The converter that is shared by all worker threads. It must have a
+  ///   parser registry with a multi-record parser.
+  RecordConverter(const CableConverter* converter);
+
+  /// \brief Destructor.
+  ~RecordConverter();
+
+  /// \brief Logs a summary of the record statuses.
+  /// This should be called after the records have been converted.
+  void LogSummary() const;
+
+  /// \brief Converts all records in the input file.
+  /// \param[in] filepath_input
+  ///   The input filepath.
+  /// \param[in] dir_output
+  ///   The output directory. This is not used if a library is set.
+  /// \param[in] num_jobs
+  ///   The number of worker threads. If this is less than 1, the number of
+  ///   hardware threads is used.
+  /// \return If at least one record was found. Individual record failures do
+  ///   not affect this, and are stored in the record statuses.
+  bool Run(const wxString& filepath_input, const wxString& dir_output,
+           const int& num_jobs);
+
+  /// \brief Sets the library.
+  /// \param[in] library
+  ///   The open library that the cable files are added to. This can be a
+  ///   nullptr to write a cable file for each record.
+  void set_library(CableLibraryWriter* library);
+
+  /// \brief Gets the record statuses.
+  /// \return The record statuses, in file order.
+  const std::vector<RecordStatus>& statuses() const;
+
+ private:
+  /// \brief Converts batches of parsed records until the shared index is
+  ///   exhausted.
+  /// \param[in] log
+  ///   A thread safe log target that the worker logs to directly. If this is
+  ///   a nullptr, messages are buffered by wxWidgets until the main thread
+  ///   flushes them.
+  /// This is the worker thread entry point.
+  void ConvertRecords(wxLog* log);
+
+  /// \brief Writes the output files of a batch of records, and updates the
+  ///   record statuses.
+  /// \param[in,out] conversions
+  ///   The serialized conversions, which are cleared.
+  /// \param[in,out] indexes
+  ///   The record index of each conversion, which are cleared.
+  void WriteRecords(
+      std::vector<std::unique_ptr<CableConverter::Conversion>>& conversions,
+      std::vector<std::size_t>& indexes);
+
+  /// \var converter_
+  ///   The converter that is shared by all worker threads.
+  const CableConverter* converter_;
+
+  /// \var filepath_input_
+  ///   The input filepath.
+  wxString filepath_input_;
+
+  /// \var index_next_
+  ///   The index of the next record to be converted.
+  std::atomic<std::size_t> index_next_;
+
+  /// \var library_
+  ///   The library. This is not owned by the record converter.
+  CableLibraryWriter* library_;
+
+  /// \var results_
+  ///   The parsed records. Each worker thread only modifies the results it
+  ///   has claimed through the shared index.
+  std::vector<RecordParser::Result> results_;
+
+  /// \var statuses_
+  ///   The record statuses. Each worker thread only modifies the statuses it
+  ///   has claimed through the shared index.
+  std::vector<RecordStatus> statuses_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_RECORDCONVERTER_H_
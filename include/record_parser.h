@@ -0,0 +1,111 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_RECORDPARSER_H_
+#define OTLS_CABLEFILECONVERTER_RECORDPARSER_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "models/base/units.h"
+#include "models/transmissionline/cable.h"
+#include "wx/wx.h"
+
+#include "parser_registry.h"
+#include "text_view.h"
+
+/// \par OVERVIEW
+///
+/// This class parses input files that contain many cable records.
+///
+/// \par SPLITTING
+///
+/// The records are found in a single scan of the file. A record starts at each
+/// line that begins with the record marker, and ends where the next record
+/// starts. Text before the first record (ex: a file header) is not part of any
+/// record. The line number of each record is counted during the scan, so the
+/// records can be parsed out of order and still report file line numbers.
+///
+/// \par PARALLEL PARSING
+///
+/// The records are divided into chunks, and a pool of worker threads each
+/// take the next unparsed chunk from a shared index. Each record is parsed
+/// into its own result, so a failure only affects that record. The record
+/// parse function must be reentrant.
+class RecordParser {
+ public:
+  /// \par OVERVIEW
+  ///
+  /// This struct contains a record in a multi-record file.
+  struct Record {
+    /// \var line_number
+    ///   The line number of the line before the record.
+    int line_number;
+
+    /// \var text
+    ///   The record text, which is a view into the file contents.
+    TextView text;
+  };
+
+  /// \par OVERVIEW
+  ///
+  /// This struct contains a parsed record.
+  struct Result {
+    /// \var cable
+    ///   The cable, in 'consistent' units.
+    Cable cable;
+
+    /// \var is_parsed
+    ///   An indicator that tells if the record was parsed without errors.
+    bool is_parsed;
+
+    /// \var message
+    ///   The error message. This is empty if the record was parsed.
+    wxString message;
+
+    /// \var units
+    ///   The unit system of the record.
+    units::UnitSystem units;
+  };
+
+  /// \var kNumRecordsChunk
+  ///   The number of records that a worker thread claims at a time.
+  static const std::size_t kNumRecordsChunk = 32;
+
+  /// \brief Parses records in parallel.
+  /// \param[in] filepath
+  ///   The input filepath, which is used for diagnostics.
+  /// \param[in] records
+  ///   The records.
+  /// \param[in] parse_record
+  ///   The record parse function.
+  /// \param[in] num_jobs
+  ///   The number of worker threads. If this is less than 1, the number of
+  ///   hardware threads is used.
+  /// \param[in] log
+  ///   A thread safe log target that the workers log to directly. If this is
+  ///   a nullptr, worker messages are buffered until the calling thread
+  ///   flushes them.
+  /// \param[out] results
+  ///   The results, in the same order as the records.
+  /// \return If all of the records were parsed without errors.
+  static bool Parse(const wxString& filepath,
+                    const std::vector<Record>& records,
+                    ParserRegistry::ParseRecordFunction parse_record,
+                    const int& num_jobs,
+                    wxLog* log,
+                    std::vector<Result>& results);
+
+  /// \brief Finds the records in a file.
+  /// \param[in] contents
+  ///   The file contents, which must outlive the records.
+  /// \param[in] marker
+  ///   The start of the first line of each record. If this is empty, no
+  ///   records are found.
+  /// \param[out] records
+  ///   The records, in file order.
+  static void Split(const TextView& contents, const TextView& marker,
+                    std::vector<Record>& records);
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_RECORDPARSER_H_
@@ -0,0 +1,52 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_SIMDSUPPORT_H_
+#define OTLS_CABLEFILECONVERTER_SIMDSUPPORT_H_
+
+/// \file
+/// This file defines the SIMD instruction sets that can be used.
+///
+/// SSE2 is part of the x86-64 baseline, so it is always available on that
+/// platform. AVX2 is optional:
+///   - GCC/Clang compile the AVX2 functions with a target attribute, and the
+///     processor support is checked at runtime.
+///   - MSVC can only use AVX2 when the project is built with /arch:AVX2.
+///
+/// Functions that use AVX2 intrinsics must be marked with OTLS_TARGET_AVX2.
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define OTLS_SIMD_AVX2 1
+#define OTLS_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && defined(__AVX2__)
+#define OTLS_SIMD_AVX2 1
+#define OTLS_TARGET_AVX2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define OTLS_SIMD_SSE2 1
+#endif
+
+#if defined(OTLS_SIMD_AVX2) || defined(OTLS_SIMD_SSE2)
+#include <immintrin.h>
+#endif
+
+namespace simd {
+
+/// \brief Gets if the processor supports AVX2 instructions.
+/// \return If the processor supports AVX2 instructions.
+inline bool IsAvx2Supported() {
+#if defined(OTLS_SIMD_AVX2) && defined(__GNUC__)
+  static const bool is_supported = __builtin_cpu_supports("avx2") != 0;
+  return is_supported;
+#elif defined(OTLS_SIMD_AVX2)
+  return true;
+#else
+  return false;
+#endif
+}
+
+}  // namespace simd
+
+#endif  // OTLS_CABLEFILECONVERTER_SIMDSUPPORT_H_
@@ -0,0 +1,149 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_TEXTVIEW_H_
+#define OTLS_CABLEFILECONVERTER_TEXTVIEW_H_
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#include "wx/wx.h"
+
+/// \par OVERVIEW
+///
+/// This class is a non-owning view of a range of characters.
+///
+/// The view does not copy the characters, so the underlying buffer (ex: a
+/// memory-mapped file) must outlive the view. Positions and lengths are passed
+/// by value, as this class is small and inlined.
+class TextView {
+ public:
+  /// \var npos
+  ///   The position that is returned when a search fails.
+  static const std::size_t npos = static_cast<std::size_t>(-1);
+
+  /// \brief Default constructor. Creates an empty view.
+  TextView() : data_(nullptr), size_(0) {
+  }
+
+  /// \brief Constructor.
+  /// \param[in] data
+  ///   The first character.
+  /// \param[in] size
+  ///   The number of characters.
+  TextView(const char* data, const std::size_t& size)
+      : data_(data), size_(size) {
+  }
+
+  /// \brief Constructor.
+  /// \param[in] str
+  ///   A null terminated string.
+  TextView(const char* str) : data_(str), size_(std::strlen(str)) {
+  }
+
+  /// \brief Constructor.
+  /// \param[in] str
+  ///   The string, which must outlive the view.
+  TextView(const std::string& str) : data_(str.data()), size_(str.size()) {
+  }
+
+  /// \brief Compares the characters of two views.
+  bool operator==(const TextView& other) const {
+    return (size_ == other.size_)
+        && ((size_ == 0) || (std::memcmp(data_, other.data_, size_) == 0));
+  }
+
+  /// \brief Compares the characters of two views.
+  bool operator!=(const TextView& other) const {
+    return !(*this == other);
+  }
+
+  /// \brief Gets a character.
+  char operator[](std::size_t pos) const {
+    return data_[pos];
+  }
+
+  /// \brief Gets if the view is empty.
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  /// \brief Finds the first occurrence of a string.
+  /// \param[in] str
+  ///   The string to find.
+  /// \param[in] pos
+  ///   The position to start searching at.
+  /// \return The position of the string, or npos if not found.
+  std::size_t find(const TextView& str, std::size_t pos = 0) const {
+    if ((size_ < pos) || (size_ - pos < str.size_)) {
+      return npos;
+    }
+
+    if (str.size_ == 0) {
+      return pos;
+    }
+
+    const std::size_t pos_last = size_ - str.size_;
+    for (std::size_t i = pos; i <= pos_last; i++) {
+      const void* found = std::memchr(data_ + i, str.data_[0],
+                                      pos_last - i + 1);
+      if (found == nullptr) {
+        return npos;
+      }
+
+      i = static_cast<const char*>(found) - data_;
+      if (std::memcmp(data_ + i, str.data_, str.size_) == 0) {
+        return i;
+      }
+    }
+
+    return npos;
+  }
+
+  /// \brief Gets a sub-view.
+  /// \param[in] pos
+  ///   The start position. If this is past the end, an empty view is
+  ///   returned.
+  /// \param[in] length
+  ///   The maximum number of characters.
+  /// \return The sub-view.
+  TextView substr(std::size_t pos, std::size_t length = npos) const {
+    if (size_ <= pos) {
+      return TextView(data_ + size_, 0);
+    }
+
+    std::size_t size = size_ - pos;
+    if (length < size) {
+      size = length;
+    }
+    return TextView(data_ + pos, size);
+  }
+
+  /// \brief Converts to a string. This copies the characters.
+  /// \return The string.
+  wxString ToString() const {
+    return wxString(data_, size_);
+  }
+
+  /// \brief Gets the first character.
+  const char* data() const {
+    return data_;
+  }
+
+  /// \brief Gets the number of characters.
+  std::size_t size() const {
+    return size_;
+  }
+
+ private:
+  /// \var data_
+  ///   The first character.
+  const char* data_;
+
+  /// \var size_
+  ///   The number of characters.
+  std::size_t size_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_TEXTVIEW_H_
@@ -0,0 +1,196 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_TRACERECORDER_H_
+#define OTLS_CABLEFILECONVERTER_TRACERECORDER_H_
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "wx/wx.h"
+
+#include "allocation_stats.h"
+
+/// \par OVERVIEW
+///
+/// This class records timed spans for the conversion stages.
+///
+/// Each span records the stage name, the file being converted, the thread
+/// that did the work, and the heap allocations that the thread made during the
+/// span. Spans are usually recorded with a TraceSpan.
+///
+/// \par OUTPUT
+///
+/// The spans can be saved as Chrome trace event JSON, which can be viewed in
+/// Perfetto (ui.perfetto.dev) or chrome://tracing. A summary of the time spent
+/// in each stage, or of the allocations made in each stage, can also be
+/// logged.
+///
+/// \par THREAD SAFETY
+///
+/// All methods are safe to call from multiple threads.
+class TraceRecorder {
+ public:
+  /// \par OVERVIEW
+  ///
+  /// This struct contains a recorded span.
+  struct Event {
+    /// \var allocations
+    ///   The number of heap allocations.
+    int64_t allocations;
+
+    /// \var bytes_allocated
+    ///   The number of heap allocated bytes.
+    int64_t bytes_allocated;
+
+    /// \var duration
+    ///   The duration, in microseconds.
+    double duration;
+
+    /// \var filepath
+    ///   The filepath that was being converted. This is UTF-8 encoded.
+    std::string filepath;
+
+    /// \var name
+    ///   The stage name. This must be a string literal.
+    const char* name;
+
+    /// \var start
+    ///   The start time, in microseconds since the recorder was created.
+    double start;
+
+    /// \var thread
+    ///   The thread index. Threads are numbered in the order they first
+    ///   recorded a span, starting at 1.
+    int thread;
+  };
+
+  /// \brief Default constructor.
+  TraceRecorder();
+
+  /// \brief Destructor.
+  ~TraceRecorder();
+
+  /// \brief Clears all events.
+  void Clear();
+
+  /// \brief Logs the mean and maximum allocations and allocated bytes of
+  ///   each stage, and the number of spans that did not allocate.
+  void LogAllocationSummary() const;
+
+  /// \brief Logs the count, total, mean, median, and 99th percentile time of
+  ///   each stage.
+  void LogSummary() const;
+
+  /// \brief Records a span.
+  /// \param[in] name
+  ///   The stage name. This must be a string literal.
+  /// \param[in] filepath
+  ///   The filepath that was being converted.
+  /// \param[in] start
+  ///   The start time.
+  /// \param[in] stop
+  ///   The stop time.
+  /// \param[in] counts
+  ///   The heap allocations made during the span.
+  void Record(const char* name,
+              const wxString& filepath,
+              const std::chrono::steady_clock::time_point& start,
+              const std::chrono::steady_clock::time_point& stop,
+              const AllocationStats::Counts& counts);
+
+  /// \brief Saves the events as Chrome trace event JSON.
+  /// \param[in] filepath
+  ///   The filepath.
+  /// \return The success status.
+  bool Save(const wxString& filepath) const;
+
+  /// \brief Gets a copy of the events.
+  /// \return A copy of the events.
+  std::vector<Event> events() const;
+
+ private:
+  /// \brief Gets the index of the calling thread.
+  /// \return The thread index.
+  /// The mutex must be locked before calling this.
+  int ThreadIndex();
+
+  /// \var events_
+  ///   The recorded events.
+  std::vector<Event> events_;
+
+  /// \var mutex_
+  ///   The mutex that guards the events and threads.
+  mutable std::mutex mutex_;
+
+  /// \var threads_
+  ///   The ids of the threads that have recorded spans. The position in this
+  ///   list is the thread index.
+  std::vector<std::thread::id> threads_;
+
+  /// \var time_start_
+  ///   The time the recorder was created. Event times are relative to this.
+  std::chrono::steady_clock::time_point time_start_;
+};
+
+/// \par OVERVIEW
+///
+/// This class records a span for the lifetime of the object.
+///
+/// If the recorder is a nullptr, nothing is timed or recorded, so a disabled
+/// trace only costs a pointer check. The allocations made by recording nested
+/// spans are not counted in the enclosing span.
+///
+/// \code
+/// {
+///   TraceSpan span(recorder, "SolveLimits", filepath);
+///   CablePolynomialSearcher::SolveLimits(...);
+/// }
+/// \endcode
+class TraceSpan {
+ public:
+  /// \brief Constructor.
+  /// \param[in] recorder
+  ///   The recorder. This can be a nullptr.
+  /// \param[in] name
+  ///   The stage name. This must be a string literal.
+  /// \param[in] filepath
+  ///   The filepath that is being converted. This must outlive the span.
+  TraceSpan(TraceRecorder* recorder, const char* name,
+            const wxString& filepath);
+
+  /// \brief Destructor. This records the span.
+  ~TraceSpan();
+
+ private:
+  /// \brief Copy constructor. This is not implemented.
+  TraceSpan(const TraceSpan&);
+
+  /// \brief Assignment operator. This is not implemented.
+  TraceSpan& operator=(const TraceSpan&);
+
+  /// \var counts_start_
+  ///   The allocation counts of the thread at the start.
+  AllocationStats::Counts counts_start_;
+
+  /// \var filepath_
+  ///   The filepath that is being converted.
+  const wxString* filepath_;
+
+  /// \var name_
+  ///   The stage name.
+  const char* name_;
+
+  /// \var recorder_
+  ///   The recorder, which is not owned.
+  TraceRecorder* recorder_;
+
+  /// \var start_
+  ///   The start time.
+  std::chrono::steady_clock::time_point start_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_TRACERECORDER_H_
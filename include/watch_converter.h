@@ -0,0 +1,173 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_WATCHCONVERTER_H_
+#define OTLS_CABLEFILECONVERTER_WATCHCONVERTER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+
+#include "wx/wx.h"
+
+#include "cable_converter.h"
+
+/// \par OVERVIEW
+///
+/// This class converts files as they are written to an input directory,
+/// until it is stopped.
+///
+/// \par QUEUE
+///
+/// A DirectoryWatcher reports files once they are completely written. The
+/// files are queued and converted by a pool of worker threads. A file that is
+/// already waiting in the queue is not queued twice. A file that changes while
+/// it is being converted is queued again once that conversion finishes, so a
+/// file is never converted by two workers at once.
+///
+/// When started, files that are already in the input directory are queued if
+/// their output file is missing or older than the input file.
+///
+/// \par OUTPUT FILES
+///
+/// The output filename matches the input filename, with the extension replaced
+/// by the converter output extension. Each output is written to a hidden,
+/// uniquely numbered temporary file that is then renamed, so readers of the
+/// output directory never see a partial file.
+///
+/// If another file in the input directory has the same output file (ex:
+/// 'a.txt' and 'a.csv'), the file is not converted, and fails.
+class WatchConverter {
+ public:
+  /// \brief Constructor.
+  /// \param[in] converter
+  ///   The converter that is shared by all worker threads.
+  WatchConverter(const CableConverter* converter);
+
+  /// \brief Destructor.
+  ~WatchConverter();
+
+  /// \brief Requests that all running watches stop.
+  /// This is safe to call from a signal handler.
+  static void RequestStop();
+
+  /// \brief Watches the input directory and converts files until a stop is
+  ///   requested.
+  /// \param[in] dir_input
+  ///   The input directory.
+  /// \param[in] dir_output
+  ///   The output directory. This must be different than the input directory.
+  /// \param[in] num_jobs
+  ///   The number of worker threads. If this is less than 1, the number of
+  ///   hardware threads is used.
+  /// \return If the watch was started. The watch also ends if the input
+  ///   directory is removed.
+  bool Run(const wxString& dir_input, const wxString& dir_output,
+           const int& num_jobs);
+
+  /// \brief Gets the number of files that were converted.
+  /// \return The number of files that were converted.
+  long num_converted() const;
+
+  /// \brief Gets the number of files that failed to convert.
+  /// \return The number of files that failed to convert.
+  long num_failed() const;
+
+ private:
+  /// \brief Converts a file to a temporary file, and renames it to the output
+  ///   file.
+  /// \param[in] filepath_input
+  ///   The input filepath.
+  void ConvertFile(const wxString& filepath_input);
+
+  /// \brief Converts queued files until the watch is stopped.
+  /// \param[in] log
+  ///   A thread safe log target that the worker logs to directly. This can be
+  ///   a nullptr.
+  /// This is the worker thread entry point.
+  void ConvertFiles(wxLog* log);
+
+  /// \brief Queues a file for conversion.
+  /// \param[in] filepath
+  ///   The input filepath.
+  void Enqueue(const wxString& filepath);
+
+  /// \brief Queues the files in the input directory that are newer than their
+  ///   output files.
+  void EnqueueOutdated();
+
+  /// \brief Finds another input file that has the same output file.
+  /// \param[in] filepath_input
+  ///   The input filepath.
+  /// \return The other input filepath, or an empty string if no other input
+  ///   file has the same output file.
+  wxString FilePathInputShared(const wxString& filepath_input) const;
+
+  /// \brief Gets the output filepath for an input file.
+  /// \param[in] filepath_input
+  ///   The input filepath.
+  /// \return The output filepath.
+  wxString FilePathOutput(const wxString& filepath_input) const;
+
+  /// \var is_stop_requested_
+  ///   An indicator that tells all watches to stop.
+  static std::atomic<bool> is_stop_requested_;
+
+  /// \var condition_
+  ///   The condition that wakes the worker threads.
+  std::condition_variable condition_;
+
+  /// \var converter_
+  ///   The converter that is shared by all worker threads.
+  const CableConverter* converter_;
+
+  /// \var converting_
+  ///   The input files that are being converted.
+  std::set<wxString> converting_;
+
+  /// \var dir_input_
+  ///   The input directory.
+  wxString dir_input_;
+
+  /// \var dir_output_
+  ///   The output directory.
+  wxString dir_output_;
+
+  /// \var is_stopping_
+  ///   An indicator that tells the worker threads to exit. This is guarded by
+  ///   the mutex.
+  bool is_stopping_;
+
+  /// \var mutex_
+  ///   The mutex that guards the queue and the file sets.
+  std::mutex mutex_;
+
+  /// \var num_converted_
+  ///   The number of files that were converted.
+  std::atomic<long> num_converted_;
+
+  /// \var num_failed_
+  ///   The number of files that failed to convert.
+  std::atomic<long> num_failed_;
+
+  /// \var num_temp_
+  ///   The number of temporary files that were named.
+  std::atomic<long> num_temp_;
+
+  /// \var queue_
+  ///   The input files waiting to be converted.
+  std::deque<wxString> queue_;
+
+  /// \var queued_
+  ///   The input files in the queue, which is used to prevent duplicates.
+  std::set<wxString> queued_;
+
+  /// \var requeued_
+  ///   The input files that changed while they were being converted, which
+  ///   are queued when their conversions finish.
+  std::set<wxString> requeued_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_WATCHCONVERTER_H_
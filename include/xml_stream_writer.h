@@ -0,0 +1,187 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_CABLEFILECONVERTER_XMLSTREAMWRITER_H_
+#define OTLS_CABLEFILECONVERTER_XMLSTREAMWRITER_H_
+
+#include <string>
+
+#include "wx/wx.h"
+#include "wx/xml/xml.h"
+
+#include "conversion_arena.h"
+
+/// \par OVERVIEW
+///
+/// This class writes an XML document directly to a buffer, without building
+/// an XML node tree first.
+///
+/// \par FORMATTING
+///
+/// The output matches wxXmlDocument::Save() byte for byte: the same XML
+/// declaration, indentation, escaping, and empty element tags are used. If the
+/// indentation step is negative, no indentation is added (compact mode).
+///
+/// \par USAGE
+///
+/// Elements are started, given attributes, filled with text or child
+/// elements, and then ended. Attributes must be added before any content. The
+/// buffer is complete once the root element has been ended.
+///
+/// \par MEMORY
+///
+/// The element names are not copied, as they are read back from the buffer
+/// when the element ends. The open element stack uses ArenaAllocator, so a
+/// writer that is created during a conversion keeps its stack in the
+/// conversion arena, and must not be used after the conversion.
+class XmlStreamWriter {
+ public:
+  /// \brief Constructor.
+  /// \param[in] indentstep
+  ///   The number of spaces to indent each level. If negative, the output is
+  ///   not indented.
+  explicit XmlStreamWriter(const int& indentstep);
+
+  /// \brief Destructor.
+  ~XmlStreamWriter();
+
+  /// \brief Adds an attribute to the current element.
+  /// \param[in] name
+  ///   The attribute name.
+  /// \param[in] value
+  ///   The attribute value, which is escaped.
+  void AddAttribute(const wxString& name, const wxString& value);
+
+  /// \brief Adds an attribute to the current element.
+  /// \param[in] name
+  ///   The attribute name, which is UTF-8 encoded.
+  /// \param[in] value
+  ///   The attribute value, which is UTF-8 encoded and escaped.
+  /// This does not convert through wxString, so nothing is allocated outside
+  /// of the buffer.
+  void AddAttribute(const char* name, const char* value);
+
+  /// \brief Clears the buffer so the writer can be reused.
+  void Clear();
+
+  /// \brief Ends the current element.
+  void EndElement();
+
+  /// \brief Saves the buffer to a file.
+  /// \param[in] filepath
+  ///   The filepath.
+  /// \return The success status.
+  bool Save(const wxString& filepath) const;
+
+  /// \brief Starts a new element.
+  /// \param[in] name
+  ///   The element name.
+  /// If this is the root element, the XML declaration is written first.
+  void StartElement(const wxString& name);
+
+  /// \brief Starts a new element.
+  /// \param[in] name
+  ///   The element name, which is UTF-8 encoded.
+  /// This does not convert through wxString, so nothing is allocated outside
+  /// of the buffer.
+  void StartElement(const char* name);
+
+  /// \brief Moves the buffer out of the writer, without copying it. The
+  ///   writer is then cleared.
+  /// \param[out] buffer
+  ///   The buffer, which is UTF-8 encoded.
+  void TakeBuffer(std::string& buffer);
+
+  /// \brief Writes an existing XML node and all of its children.
+  /// \param[in] node
+  ///   The node.
+  void WriteNode(const wxXmlNode* node);
+
+  /// \brief Writes text content for the current element.
+  /// \param[in] content
+  ///   The text, which is escaped.
+  void WriteText(const wxString& content);
+
+  /// \brief Writes text content for the current element.
+  /// \param[in] content
+  ///   The text, which is UTF-8 encoded and escaped.
+  /// This does not convert through wxString, so nothing is allocated outside
+  /// of the buffer.
+  void WriteText(const char* content);
+
+  /// \brief Gets the buffer.
+  /// \return The buffer, which is UTF-8 encoded.
+  const std::string& buffer() const;
+
+ private:
+  /// \par OVERVIEW
+  ///
+  /// This struct contains the state of an open element.
+  struct ElementState {
+    /// \var is_last_child_text
+    ///   An indicator that tells if the last child was a text node.
+    bool is_last_child_text;
+
+    /// \var is_start_tag_open
+    ///   An indicator that tells if the start tag is still open, which means
+    ///   the element has no children yet.
+    bool is_start_tag_open;
+
+    /// \var pos_name
+    ///   The position of the element name in the buffer, which is in the
+    ///   start tag.
+    std::size_t pos_name;
+
+    /// \var size_name
+    ///   The size of the element name in the buffer.
+    std::size_t size_name;
+  };
+
+  /// \brief Appends a string to the buffer.
+  void Append(const wxString& str);
+
+  /// \brief Appends an escaped string to the buffer.
+  /// \param[in] str
+  ///   The string.
+  /// \param[in] is_attribute
+  ///   An indicator that tells if attribute escaping is used, which also
+  ///   escapes quotes, tabs, and newlines.
+  void AppendEscaped(const wxString& str, const bool& is_attribute);
+
+  /// \brief Appends an escaped UTF-8 string to the buffer.
+  /// \param[in] data
+  ///   The string data.
+  /// \param[in] length
+  ///   The string length, in bytes.
+  /// \param[in] is_attribute
+  ///   An indicator that tells if attribute escaping is used.
+  void AppendEscaped(const char* data, const std::size_t& length,
+                     const bool& is_attribute);
+
+  /// \brief Appends a newline and indentation.
+  void AppendIndentation(const int& indent);
+
+  /// \brief Prepares the current element for a child node.
+  /// \param[in] is_text
+  ///   An indicator that tells if the child is a text node.
+  void BeginChild(const bool& is_text);
+
+  /// \brief Starts a new element, once its name is in the buffer.
+  /// \param[in] pos_name
+  ///   The position of the element name in the buffer.
+  void PushElement(const std::size_t& pos_name);
+
+  /// \var buffer_
+  ///   The output buffer.
+  std::string buffer_;
+
+  /// \var elements_
+  ///   The stack of open elements.
+  ArenaVector<ElementState> elements_;
+
+  /// \var indentstep_
+  ///   The number of spaces to indent each level.
+  int indentstep_;
+};
+
+#endif  // OTLS_CABLEFILECONVERTER_XMLSTREAMWRITER_H_
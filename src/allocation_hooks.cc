@@ -0,0 +1,40 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+// This replaces the global allocation functions so AllocationStats counts
+// every heap allocation. It is only linked into the app and the benchmarks,
+// so programs that link the converter library keep their own allocator.
+
+#include <cstdlib>
+#include <new>
+
+#include "allocation_stats.h"
+
+void* operator new(std::size_t size) {
+  AllocationStats::Count(size);
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void* operator new[](std::size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
@@ -0,0 +1,21 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "allocation_stats.h"
+
+namespace {
+
+/// The allocation counts of the calling thread. This is plain data, so it
+/// can be used by operator new before and after any constructors run.
+thread_local AllocationStats::Counts counts_thread = {0, 0};
+
+}  // namespace
+
+void AllocationStats::Count(const std::size_t& size) {
+  counts_thread.allocations++;
+  counts_thread.bytes += static_cast<int64_t>(size);
+}
+
+AllocationStats::Counts AllocationStats::ThreadCounts() {
+  return counts_thread;
+}
@@ -0,0 +1,268 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "async_log_sink.h"
+
+#include <cstring>
+#include <ctime>
+
+#include "cable_converter.h"
+
+namespace {
+
+/// The number of records the queue holds. This must be a power of two.
+const std::size_t kNumCells = 16384;
+
+/// The time the writer thread sleeps when the queue is empty.
+const std::chrono::milliseconds kTimeIdle(2);
+
+/// The next thread index.
+std::atomic<int> index_thread_next(1);
+
+/// \brief Gets the index of the calling thread.
+/// \return The thread index. Threads are numbered in the order they first
+///   logged, starting at 1.
+int ThreadIndex() {
+  static thread_local int index = 0;
+  if (index == 0) {
+    index = index_thread_next++;
+  }
+  return index;
+}
+
+/// \brief Gets the name of a log level.
+/// \param[in] level
+///   The log level.
+/// \return The level name.
+const char* LevelName(const wxLogLevel& level) {
+  switch (level) {
+    case wxLOG_FatalError:
+      return "Fatal";
+    case wxLOG_Error:
+      return "Error";
+    case wxLOG_Warning:
+      return "Warning";
+    case wxLOG_Message:
+      return "Message";
+    case wxLOG_Status:
+      return "Status";
+    case wxLOG_Info:
+      return "Info";
+    default:
+      return "Debug";
+  }
+}
+
+}  // namespace
+
+AsyncLogSink::AsyncLogSink() {
+  cells_.reset(new Cell[kNumCells]);
+  for (std::size_t i = 0; i < kNumCells; i++) {
+    cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  file_ = nullptr;
+  is_stopping_ = false;
+  num_dropped_ = 0;
+  num_dropped_reported_ = 0;
+  pos_dequeue_ = 0;
+  pos_enqueue_ = 0;
+  pos_written_ = 0;
+}
+
+AsyncLogSink::~AsyncLogSink() {
+  Close();
+}
+
+void AsyncLogSink::Close() {
+  if (file_ == nullptr) {
+    return;
+  }
+
+  // stops the writer thread, and writes anything that was queued since its
+  // last drain
+  is_stopping_ = true;
+  thread_.join();
+  Drain();
+
+  fclose(file_);
+  file_ = nullptr;
+}
+
+void AsyncLogSink::Flush() {
+  wxLog::Flush();
+
+  if (file_ == nullptr) {
+    return;
+  }
+
+  // waits for the writer thread to catch up to the current position
+  const std::size_t pos = pos_enqueue_.load(std::memory_order_acquire);
+  while (pos_written_.load(std::memory_order_acquire) < pos) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+bool AsyncLogSink::Open(const wxString& filepath) {
+  Close();
+
+  file_ = fopen(filepath.c_str(), "a");
+  if (file_ == nullptr) {
+    return false;
+  }
+
+  is_stopping_ = false;
+  thread_ = std::thread(&AsyncLogSink::Run, this);
+  return true;
+}
+
+uint64_t AsyncLogSink::num_dropped() const {
+  return num_dropped_;
+}
+
+void AsyncLogSink::DoLogRecord(wxLogLevel level, const wxString& msg,
+                               const wxLogRecordInfo& info) {
+  Record record;
+  record.input = std::string(
+      CableConverter::ThreadFilePathInput().ToUTF8().data());
+  record.level = level;
+  record.line = info.line;
+  record.message = std::string(msg.ToUTF8().data());
+  record.source = info.filename;
+  record.thread = ThreadIndex();
+  record.time = std::chrono::system_clock::now();
+
+  if (Push(record) == false) {
+    num_dropped_++;
+  }
+}
+
+void AsyncLogSink::Append(const Record& record, std::string& buffer) {
+  // formats the timestamp
+  const std::time_t time = std::chrono::system_clock::to_time_t(record.time);
+  const int milliseconds = static_cast<int>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          record.time.time_since_epoch()).count() % 1000);
+
+  std::tm tm_local;
+#ifdef _WIN32
+  localtime_s(&tm_local, &time);
+#else
+  localtime_r(&time, &tm_local);
+#endif
+
+  char str[64];
+  std::strftime(str, sizeof(str), "%Y-%m-%d %H:%M:%S", &tm_local);
+  buffer += str;
+  snprintf(str, sizeof(str), ".%03d [thread %d] ", milliseconds,
+           record.thread);
+  buffer += str;
+
+  // adds the input file the thread is converting
+  if (record.input.empty() == false) {
+    buffer += '[';
+    buffer += record.input;
+    buffer += "] ";
+  }
+
+  buffer += LevelName(record.level);
+  buffer += ": ";
+  buffer += record.message;
+
+  // adds the source file name and line number
+  if (record.source != nullptr) {
+    const char* name = record.source;
+    for (const char* c = record.source; *c != '\0'; c++) {
+      if ((*c == '/') || (*c == '\\')) {
+        name = c + 1;
+      }
+    }
+
+    snprintf(str, sizeof(str), " (%s:%d)", name, record.line);
+    buffer += str;
+  }
+
+  buffer += '\n';
+}
+
+std::size_t AsyncLogSink::Drain() {
+  std::size_t num_records = 0;
+  Record record;
+  while (Pop(record) == true) {
+    Append(record, buffer_);
+    num_records++;
+  }
+
+  // reports dropped records
+  const uint64_t num_dropped = num_dropped_.load();
+  if (num_dropped_reported_ != num_dropped) {
+    char str[128];
+    snprintf(str, sizeof(str),
+             "Warning: %llu log records were dropped because the log queue "
+             "was full.\n",
+             static_cast<unsigned long long>(num_dropped
+                                             - num_dropped_reported_));
+    buffer_ += str;
+    num_dropped_reported_ = num_dropped;
+  }
+
+  // writes all lines at once
+  if (buffer_.empty() == false) {
+    fwrite(buffer_.data(), 1, buffer_.size(), file_);
+    fflush(file_);
+    buffer_.clear();
+  }
+
+  pos_written_.store(pos_dequeue_, std::memory_order_release);
+  return num_records;
+}
+
+bool AsyncLogSink::Pop(Record& record) {
+  Cell& cell = cells_[pos_dequeue_ & (kNumCells - 1)];
+  const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+  if (sequence != pos_dequeue_ + 1) {
+    return false;
+  }
+
+  record = std::move(cell.record);
+  cell.sequence.store(pos_dequeue_ + kNumCells, std::memory_order_release);
+  pos_dequeue_++;
+  return true;
+}
+
+bool AsyncLogSink::Push(Record& record) {
+  // claims a cell
+  std::size_t pos = pos_enqueue_.load(std::memory_order_relaxed);
+  Cell* cell = nullptr;
+  while (true) {
+    cell = &cells_[pos & (kNumCells - 1)];
+    const std::size_t sequence =
+        cell->sequence.load(std::memory_order_acquire);
+    const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence)
+                                - static_cast<std::ptrdiff_t>(pos);
+    if (diff == 0) {
+      if (pos_enqueue_.compare_exchange_weak(pos, pos + 1,
+                                             std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // the queue is full
+      return false;
+    } else {
+      pos = pos_enqueue_.load(std::memory_order_relaxed);
+    }
+  }
+
+  // fills the cell and publishes it
+  cell->record = std::move(record);
+  cell->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+void AsyncLogSink::Run() {
+  while (is_stopping_.load() == false) {
+    if (Drain() == 0) {
+      std::this_thread::sleep_for(kTimeIdle);
+    }
+  }
+}
@@ -0,0 +1,612 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "batch_converter.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <thread>
+#include <utility>
+
+#include "wx/dir.h"
+#include "wx/filename.h"
+
+#include "async_log_sink.h"
+
+namespace {
+
+/// The maximum number of files that the solve and write stages process as
+/// one batch.
+const std::size_t kNumJobsBatch = 32;
+
+/// The index of the solve stage.
+const int kIndexStageSolve = 2;
+
+/// The maximum number of threads for a pipeline stage.
+const long kNumThreadsStageMax = 256;
+
+/// The pipeline stage names, in order.
+const char* const kNamesStage[] = {
+  "read", "parse", "solve", "serialize", "write"
+};
+
+}  // namespace
+
+BatchConverter::BatchConverter(const CableConverter* converter) {
+  converter_ = converter;
+  hash_settings_ = 0;
+  index_next_ = 0;
+  library_ = nullptr;
+  manifest_ = nullptr;
+  pipeline_ = nullptr;
+}
+
+BatchConverter::~BatchConverter() {
+}
+
+void BatchConverter::LogSummary() const {
+  int num_converted = 0;
+  int num_failed = 0;
+  int num_skipped = 0;
+
+  // logs status of each file
+  for (auto iter = statuses_.cbegin(); iter != statuses_.cend(); iter++) {
+    const FileStatus& status = *iter;
+    if (status.is_skipped == true) {
+      wxLogVerbose("Skipped (unchanged): " + status.filepath_input);
+      num_skipped++;
+    } else if (status.is_converted == true) {
+      wxLogMessage("Converted: " + status.filepath_input);
+      num_converted++;
+    } else {
+      wxLogMessage("Failed: " + status.filepath_input + "  --  "
+                   + status.message);
+      num_failed++;
+    }
+  }
+
+  // logs totals
+  wxString message;
+  message << "Batch summary: " << num_converted << " converted, "
+          << num_skipped << " skipped, " << num_failed << " failed.";
+  wxLogMessage(message);
+}
+
+bool BatchConverter::ParsePipeline(const std::string& str,
+                                   PipelineOptions& options) {
+  int values[kNumStages];
+  const char* pos = str.c_str();
+  for (int i = 0; i < kNumStages; i++) {
+    char* end = nullptr;
+    const long value = std::strtol(pos, &end, 10);
+    if ((end == pos) || (value < 1) || (kNumThreadsStageMax < value)) {
+      return false;
+    }
+
+    // the values are separated by colons, and the last one ends the string
+    const char separator = (i < kNumStages - 1) ? ':' : '\0';
+    if (*end != separator) {
+      return false;
+    }
+    values[i] = static_cast<int>(value);
+    pos = end + 1;
+  }
+
+  for (int i = 0; i < kNumStages; i++) {
+    options.num_threads[i] = values[i];
+  }
+  return true;
+}
+
+bool BatchConverter::Run(const wxString& dir_input,
+                         const wxString& dir_output,
+                         const int& num_jobs) {
+  statuses_.clear();
+  index_next_ = 0;
+
+  // validates directories
+  if (wxFileName::DirExists(dir_input) == false) {
+    wxLogError("Invalid input directory: " + dir_input + ".");
+    return false;
+  }
+
+  if (library_ == nullptr) {
+    if (wxFileName::DirExists(dir_output) == false) {
+      wxLogError("Invalid output directory: " + dir_output + ".");
+      return false;
+    }
+
+    if (wxFileName::IsDirWritable(dir_output) == false) {
+      wxLogError("Insufficient permissions for output directory: "
+                 + dir_output + ".");
+      return false;
+    }
+  }
+
+  // gets input files and creates a status for each
+  // the filepaths are copied before the worker threads start, so the threads
+  // never share a string
+  wxArrayString filepaths;
+  wxDir::GetAllFiles(dir_input, &filepaths, wxEmptyString, wxDIR_FILES);
+  filepaths.Sort();
+
+  statuses_.resize(filepaths.GetCount());
+  for (std::size_t i = 0; i < filepaths.GetCount(); i++) {
+    FileStatus& status = statuses_.at(i);
+    status.filepath_input = filepaths[i];
+
+    wxFileName filename(dir_output, wxFileName(filepaths[i]).GetName());
+    filename.SetExt(converter_->ExtensionOutput());
+    status.filepath_output = filename.GetFullPath();
+
+    status.is_converted = false;
+    status.is_skipped = false;
+  }
+
+  // fails the files that have the same output file (ex: 'a.txt' and 'a.csv'),
+  // as neither one could be told apart from the other afterwards
+  if (library_ == nullptr) {
+    const bool is_case_sensitive = wxFileName::IsCaseSensitive();
+    std::map<wxString, std::size_t> indexes_output;
+    for (std::size_t i = 0; i < statuses_.size(); i++) {
+      FileStatus& status = statuses_.at(i);
+      const wxString key = is_case_sensitive ? status.filepath_output
+                                             : status.filepath_output.Lower();
+      auto result = indexes_output.insert(std::make_pair(key, i));
+      if (result.second == true) {
+        continue;
+      }
+
+      FileStatus& status_other = statuses_.at(result.first->second);
+      status.message = "Output file is shared with: "
+                       + status_other.filepath_input + ".";
+      status_other.message = "Output file is shared with: "
+                             + status.filepath_input + ".";
+    }
+  }
+
+  hash_settings_ = ConversionManifest::Hash(converter_->DescribeSettings());
+
+  wxString message;
+  message << "Converting " << static_cast<int>(statuses_.size())
+          << " files from: " << dir_input;
+  wxLogVerbose(message);
+
+  // workers log directly to the active target if it is thread safe
+  wxLog* log = dynamic_cast<AsyncLogSink*>(wxLog::GetActiveTarget());
+
+  if (pipeline_ != nullptr) {
+    RunPipeline(log);
+    wxLog::FlushActive();
+    return true;
+  }
+
+  // determines the number of worker threads
+  int num_threads = num_jobs;
+  if (num_threads < 1) {
+    num_threads = std::thread::hardware_concurrency();
+  }
+  if (num_threads < 1) {
+    num_threads = 1;
+  }
+  if (static_cast<std::size_t>(num_threads) > statuses_.size()) {
+    num_threads = static_cast<int>(statuses_.size());
+  }
+
+  // runs the worker threads and waits for all to finish
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.push_back(std::thread(&BatchConverter::ConvertFiles, this, log));
+  }
+
+  for (auto iter = threads.begin(); iter != threads.end(); iter++) {
+    iter->join();
+  }
+
+  // log messages from worker threads are either buffered until the main
+  // thread flushes them, or queued in the log target
+  wxLog::FlushActive();
+
+  return true;
+}
+
+void BatchConverter::set_library(CableLibraryWriter* library) {
+  library_ = library;
+}
+
+void BatchConverter::set_manifest(ConversionManifest* manifest) {
+  manifest_ = manifest;
+}
+
+void BatchConverter::set_pipeline(const PipelineOptions* pipeline) {
+  pipeline_ = pipeline;
+}
+
+const std::vector<BatchConverter::FileStatus>&
+    BatchConverter::statuses() const {
+  return statuses_;
+}
+
+bool BatchConverter::ConvertToLibrary(FileStatus& status) const {
+  std::string buffer;
+  std::string name;
+  if (converter_->ConvertToBuffer(status.filepath_input, buffer, name,
+                                  status.message) == false) {
+    return false;
+  }
+
+  const std::string source(
+      wxFileName(status.filepath_input).GetFullName().ToUTF8().data());
+  return library_->Add(name, source, buffer, status.message);
+}
+
+void BatchConverter::ConvertFiles(wxLog* log) {
+  if (log != nullptr) {
+    wxLog::SetThreadActiveTarget(log);
+  }
+
+  while (true) {
+    // claims the next file
+    const std::size_t index = index_next_++;
+    if (statuses_.size() <= index) {
+      break;
+    }
+
+    // skips the file if it failed before converting
+    FileStatus& status = statuses_.at(index);
+    if (status.message.empty() == false) {
+      if (converter_->metrics() != nullptr) {
+        converter_->metrics()->AddFile(false);
+      }
+      continue;
+    }
+
+    // adds the cable to the library instead of writing an output file
+    if (library_ != nullptr) {
+      status.is_converted = ConvertToLibrary(status);
+      if (converter_->metrics() != nullptr) {
+        converter_->metrics()->AddFile(status.is_converted);
+      }
+      continue;
+    }
+
+    // skips the file if the output is current
+    ConversionManifest::Entry entry;
+    bool is_hashed = false;
+    if (manifest_ != nullptr) {
+      is_hashed = ConversionManifest::HashFile(status.filepath_input,
+                                               entry.hash_input);
+      if ((is_hashed == true)
+          && (manifest_->IsCurrent(status.filepath_input, entry.hash_input,
+                                   hash_settings_, status.filepath_output)
+              == true)) {
+        status.is_converted = true;
+        status.is_skipped = true;
+        continue;
+      }
+    }
+
+    // converts
+    status.is_converted = converter_->Convert(status.filepath_input,
+                                              status.filepath_output,
+                                              status.message);
+    if (converter_->metrics() != nullptr) {
+      converter_->metrics()->AddFile(status.is_converted);
+    }
+
+    // records the conversion
+    if (manifest_ != nullptr) {
+      entry.filepath_output =
+          std::string(status.filepath_output.ToUTF8().data());
+      entry.hash_settings = hash_settings_;
+      if ((status.is_converted == true) && (is_hashed == true)
+          && (ConversionManifest::HashFile(status.filepath_output,
+                                           entry.hash_output) == true)) {
+        manifest_->Update(status.filepath_input, entry);
+      } else {
+        manifest_->Remove(status.filepath_input);
+      }
+    }
+  }
+
+  if (log != nullptr) {
+    wxLog::SetThreadActiveTarget(nullptr);
+  }
+}
+
+void BatchConverter::FinishJob(const bool& is_converted, Job& job) {
+  FileStatus& status = statuses_.at(job.index);
+  status.is_converted = is_converted;
+  if (is_converted == false) {
+    status.message = job.conversion.message;
+  }
+
+  if (converter_->metrics() != nullptr) {
+    converter_->metrics()->AddFile(is_converted);
+  }
+
+  // records the conversion
+  if ((manifest_ != nullptr) && (library_ == nullptr)) {
+    ConversionManifest::Entry& entry = job.entry;
+    entry.filepath_output =
+        std::string(status.filepath_output.ToUTF8().data());
+    entry.hash_settings = hash_settings_;
+    if ((is_converted == true) && (job.is_hashed == true)
+        && (ConversionManifest::HashFile(status.filepath_output,
+                                         entry.hash_output) == true)) {
+      manifest_->Update(status.filepath_input, entry);
+    } else {
+      manifest_->Remove(status.filepath_input);
+    }
+  }
+}
+
+void BatchConverter::LogPipelineSummary(const Stage* stages,
+                                        const JobQueue* const* queues,
+                                        const double& seconds) const {
+  // logs the stages, and finds the stage with the highest utilization
+  int index_bottleneck = 0;
+  double utilization_max = -1;
+  for (int i = 0; i < kNumStages; i++) {
+    const Stage& stage = stages[i];
+    const int num_threads = pipeline_->num_threads[i];
+    double utilization = 0;
+    if (0 < seconds) {
+      utilization = stage.seconds_busy / (seconds * num_threads);
+    }
+
+    if (utilization_max < utilization) {
+      utilization_max = utilization;
+      index_bottleneck = i;
+    }
+
+    wxString message;
+    message << "Pipeline stage " << kNamesStage[i] << ": " << num_threads
+            << " threads, " << stage.num_items << " files, "
+            << wxString::Format("%.3f", stage.seconds_busy) << " s busy, "
+            << wxString::Format("%.0f", utilization * 100)
+            << "% utilization";
+    wxLogMessage(message);
+  }
+
+  // logs the queues
+  for (int i = 0; i < kNumStages - 1; i++) {
+    const JobQueue::Stats stats = queues[i]->stats();
+    double depth_mean = 0;
+    if (0 < stats.num_pushes) {
+      depth_mean = static_cast<double>(stats.depth_sum) / stats.num_pushes;
+    }
+
+    wxString message;
+    message << "Pipeline queue " << kNamesStage[i] << "->"
+            << kNamesStage[i + 1] << ": depth max "
+            << static_cast<int>(stats.depth_max) << " mean "
+            << wxString::Format("%.1f", depth_mean) << ", stall "
+            << wxString::Format("%.3f", stats.seconds_stall_push)
+            << " s producer "
+            << wxString::Format("%.3f", stats.seconds_stall_pop)
+            << " s consumer";
+    wxLogMessage(message);
+  }
+
+  wxLogMessage("Pipeline bottleneck: " + wxString(kNamesStage[index_bottleneck])
+               + " stage.");
+}
+
+bool BatchConverter::ProcessJob(const int& index_stage, Job& job) const {
+  CableConverter::Conversion& conversion = job.conversion;
+  if (index_stage == 0) {
+    return converter_->Read(conversion);
+  } else if (index_stage == 1) {
+    return converter_->Parse(conversion);
+  } else if (index_stage == kIndexStageSolve) {
+    return converter_->Solve(conversion);
+  } else if (index_stage == 3) {
+    return converter_->Serialize(conversion);
+  }
+
+  // writes the output file, or adds the cable to the library
+  const FileStatus& status = statuses_.at(job.index);
+  if (library_ == nullptr) {
+    return converter_->Write(status.filepath_output, conversion);
+  }
+
+  const std::string source(
+      wxFileName(status.filepath_input).GetFullName().ToUTF8().data());
+  return library_->Add(conversion.cable.name, source, conversion.buffer,
+                       conversion.message);
+}
+
+void BatchConverter::ProcessJobs(const int& index_stage,
+                                 std::vector<std::unique_ptr<Job>>& jobs,
+                                 std::vector<bool>& statuses) const {
+  // solves the cables of a batch together
+  if ((index_stage == kIndexStageSolve) && (1 < jobs.size())) {
+    std::vector<CableConverter::Conversion*> conversions;
+    for (auto iter = jobs.begin(); iter != jobs.end(); iter++) {
+      conversions.push_back(&(*iter)->conversion);
+    }
+
+    converter_->SolveBatch(conversions, statuses);
+    return;
+  }
+
+  // writes the output files of a batch together
+  if ((index_stage == kNumStages - 1) && (library_ == nullptr)
+      && (1 < jobs.size())) {
+    std::vector<wxString> filepaths_output;
+    std::vector<CableConverter::Conversion*> conversions;
+    for (auto iter = jobs.begin(); iter != jobs.end(); iter++) {
+      Job& job = **iter;
+      filepaths_output.push_back(statuses_.at(job.index).filepath_output);
+      conversions.push_back(&job.conversion);
+    }
+
+    converter_->WriteBatch(filepaths_output, conversions, statuses);
+    return;
+  }
+
+  statuses.clear();
+  for (auto iter = jobs.begin(); iter != jobs.end(); iter++) {
+    statuses.push_back(ProcessJob(index_stage, **iter));
+  }
+}
+
+void BatchConverter::RunPipeline(wxLog* log) {
+  // creates the queues between stages
+  std::size_t depth = 1;
+  if (1 < pipeline_->depth_queue) {
+    depth = static_cast<std::size_t>(pipeline_->depth_queue);
+  }
+
+  std::unique_ptr<JobQueue> queues[kNumStages - 1];
+  for (int i = 0; i < kNumStages - 1; i++) {
+    queues[i].reset(new JobQueue(depth));
+  }
+
+  // creates the stages
+  Stage stages[kNumStages];
+  for (int i = 0; i < kNumStages; i++) {
+    Stage& stage = stages[i];
+    stage.index = i;
+    stage.num_active = pipeline_->num_threads[i];
+    stage.num_items = 0;
+    stage.queue_in = (i == 0) ? nullptr : queues[i - 1].get();
+    stage.queue_out = (i == kNumStages - 1) ? nullptr : queues[i].get();
+    stage.seconds_busy = 0;
+  }
+
+  wxString message;
+  message << "Pipeline threads (read:parse:solve:serialize:write): ";
+  for (int i = 0; i < kNumStages; i++) {
+    message << pipeline_->num_threads[i]
+            << ((i < kNumStages - 1) ? ":" : "");
+  }
+  message << ", queue depth: " << static_cast<int>(depth);
+  wxLogVerbose(message);
+
+  // runs the stage threads and waits for all to finish
+  const auto time_start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumStages; i++) {
+    for (int j = 0; j < pipeline_->num_threads[i]; j++) {
+      threads.push_back(std::thread(&BatchConverter::RunStage, this,
+                                    &stages[i], log));
+    }
+  }
+
+  for (auto iter = threads.begin(); iter != threads.end(); iter++) {
+    iter->join();
+  }
+
+  const double seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - time_start).count();
+
+  const JobQueue* queues_stats[kNumStages - 1];
+  for (int i = 0; i < kNumStages - 1; i++) {
+    queues_stats[i] = queues[i].get();
+  }
+  LogPipelineSummary(stages, queues_stats, seconds);
+}
+
+void BatchConverter::RunStage(Stage* stage, wxLog* log) {
+  if (log != nullptr) {
+    wxLog::SetThreadActiveTarget(log);
+  }
+
+  // cables are always solved in batches, and output files are batched if
+  // the converter has an output writer
+  const bool is_batched = (stage->index == kIndexStageSolve)
+                          || ((stage->queue_out == nullptr)
+                              && (library_ == nullptr)
+                              && (converter_->output_writer() != nullptr));
+
+  while (true) {
+    // gets the next file
+    std::unique_ptr<Job> job;
+    if (stage->queue_in != nullptr) {
+      if (stage->queue_in->Pop(job) == false) {
+        break;
+      }
+    } else {
+      // claims the next file
+      const std::size_t index = index_next_++;
+      if (statuses_.size() <= index) {
+        break;
+      }
+
+      // skips the file if it failed before converting
+      FileStatus& status = statuses_.at(index);
+      if (status.message.empty() == false) {
+        if (converter_->metrics() != nullptr) {
+          converter_->metrics()->AddFile(false);
+        }
+        continue;
+      }
+
+      job.reset(new Job());
+      job->index = index;
+      job->is_hashed = false;
+
+      // skips the file if the output is current
+      if ((manifest_ != nullptr) && (library_ == nullptr)) {
+        job->is_hashed = ConversionManifest::HashFile(status.filepath_input,
+                                                      job->entry.hash_input);
+        if ((job->is_hashed == true)
+            && (manifest_->IsCurrent(status.filepath_input,
+                                     job->entry.hash_input, hash_settings_,
+                                     status.filepath_output) == true)) {
+          status.is_converted = true;
+          status.is_skipped = true;
+          continue;
+        }
+      }
+
+      CableConverter::Begin(status.filepath_input, library_ == nullptr,
+                            job->conversion);
+    }
+
+    // the solve and write stages also take the files that are already
+    // waiting, so they are processed as one batch
+    std::vector<std::unique_ptr<Job>> jobs;
+    jobs.push_back(std::move(job));
+    if (is_batched == true) {
+      while ((jobs.size() < kNumJobsBatch)
+             && (stage->queue_in->TryPop(job) == true)) {
+        jobs.push_back(std::move(job));
+      }
+    }
+
+    // runs the stage
+    std::vector<bool> statuses_processed;
+    const auto time_start = std::chrono::steady_clock::now();
+    ProcessJobs(stage->index, jobs, statuses_processed);
+    const double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - time_start).count();
+    {
+      std::lock_guard<std::mutex> lock(stage->mutex);
+      stage->seconds_busy += seconds;
+      stage->num_items += static_cast<int>(jobs.size());
+    }
+
+    // a failed file leaves the pipeline, and the last stage finishes it
+    for (std::size_t i = 0; i < jobs.size(); i++) {
+      if ((statuses_processed[i] == false) || (stage->queue_out == nullptr)) {
+        FinishJob(statuses_processed[i], *jobs[i]);
+      } else {
+        stage->queue_out->Push(std::move(jobs[i]));
+      }
+    }
+  }
+
+  // the last thread of the stage tells the next stage that no more files are
+  // coming
+  if ((--stage->num_active == 0) && (stage->queue_out != nullptr)) {
+    stage->queue_out->Close();
+  }
+
+  if (log != nullptr) {
+    wxLog::SetThreadActiveTarget(nullptr);
+  }
+}
@@ -0,0 +1,308 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "cable_binary_handler.h"
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+static_assert(sizeof(CableBinaryHandler::Header) == 64,
+              "The binary header layout changed.");
+static_assert(sizeof(CableBinaryHandler::Component) == 64,
+              "The binary component layout changed.");
+static_assert(sizeof(CableBinaryHandler::Record) == 192,
+              "The binary record layout changed.");
+
+/// The offset of the first array, which follows the header and record.
+const uint64_t kOffsetArrays = sizeof(CableBinaryHandler::Header)
+                               + sizeof(CableBinaryHandler::Record);
+
+/// \brief Determines if the platform is little endian.
+/// \return If the platform is little endian.
+bool IsLittleEndian() {
+  const uint16_t value = 1;
+  unsigned char byte;
+  std::memcpy(&byte, &value, 1);
+  return byte == 1;
+}
+
+/// \brief Pads a buffer to an 8 byte boundary.
+/// \param[in,out] buffer
+///   The buffer.
+void Pad(std::string& buffer) {
+  buffer.resize((buffer.size() + 7) / 8 * 8, '\0');
+}
+
+/// \brief Appends a coefficient array to the buffer.
+/// \param[in] coefficients
+///   The coefficients.
+/// \param[out] num
+///   The number of coefficients.
+/// \param[out] offset
+///   The file offset of the coefficients.
+/// \param[in,out] buffer
+///   The buffer.
+void AppendArray(const std::vector<double>& coefficients, uint32_t& num,
+                 uint64_t& offset, std::string& buffer) {
+  num = static_cast<uint32_t>(coefficients.size());
+  offset = buffer.size();
+  if (coefficients.empty() == false) {
+    buffer.append(reinterpret_cast<const char*>(coefficients.data()),
+                  coefficients.size() * sizeof(double));
+  }
+}
+
+/// \brief Copies a component into the binary component, and appends its
+///   coefficient arrays to the buffer.
+/// \param[in] component
+///   The component.
+/// \param[out] record
+///   The binary component.
+/// \param[in,out] buffer
+///   The buffer.
+void AppendComponent(const CableComponent& component,
+                     CableBinaryHandler::Component& record,
+                     std::string& buffer) {
+  record.coefficient_expansion_linear_thermal =
+      component.coefficient_expansion_linear_thermal;
+  record.load_limit_polynomial_creep = component.load_limit_polynomial_creep;
+  record.load_limit_polynomial_loadstrain =
+      component.load_limit_polynomial_loadstrain;
+  record.modulus_compression_elastic_area =
+      component.modulus_compression_elastic_area;
+  record.modulus_tension_elastic_area =
+      component.modulus_tension_elastic_area;
+
+  AppendArray(component.coefficients_polynomial_creep,
+              record.num_coefficients_creep,
+              record.offset_coefficients_creep, buffer);
+  AppendArray(component.coefficients_polynomial_loadstrain,
+              record.num_coefficients_loadstrain,
+              record.offset_coefficients_loadstrain, buffer);
+}
+
+/// \brief Copies a binary component into a component.
+/// \param[in] data
+///   The binary cable file.
+/// \param[in] record
+///   The binary component.
+/// \param[out] component
+///   The component.
+void CopyComponent(const char* data,
+                   const CableBinaryHandler::Component& record,
+                   CableComponent& component) {
+  component.coefficient_expansion_linear_thermal =
+      record.coefficient_expansion_linear_thermal;
+  component.load_limit_polynomial_creep = record.load_limit_polynomial_creep;
+  component.load_limit_polynomial_loadstrain =
+      record.load_limit_polynomial_loadstrain;
+  component.modulus_compression_elastic_area =
+      record.modulus_compression_elastic_area;
+  component.modulus_tension_elastic_area =
+      record.modulus_tension_elastic_area;
+
+  const double* creep = reinterpret_cast<const double*>(
+      data + record.offset_coefficients_creep);
+  component.coefficients_polynomial_creep.assign(
+      creep, creep + record.num_coefficients_creep);
+
+  const double* loadstrain = reinterpret_cast<const double*>(
+      data + record.offset_coefficients_loadstrain);
+  component.coefficients_polynomial_loadstrain.assign(
+      loadstrain, loadstrain + record.num_coefficients_loadstrain);
+}
+
+/// \brief Determines if a range is inside the file and 8 byte aligned.
+/// \param[in] offset
+///   The range offset.
+/// \param[in] size
+///   The range size in bytes.
+/// \param[in] size_file
+///   The file size in bytes.
+/// \param[in] is_aligned
+///   An indicator that tells if the range must be 8 byte aligned.
+/// \return If the range is valid.
+bool IsValidRange(const uint64_t& offset, const uint64_t& size,
+                  const uint64_t& size_file, const bool& is_aligned) {
+  if ((is_aligned == true) && (offset % 8 != 0)) {
+    return false;
+  }
+
+  return (kOffsetArrays <= offset) && (offset <= size_file)
+         && (size <= size_file - offset);
+}
+
+/// \brief Determines if the coefficient arrays of a component are valid.
+/// \param[in] record
+///   The binary component.
+/// \param[in] size_file
+///   The file size in bytes.
+/// \return If the coefficient arrays are valid.
+bool IsValidComponent(const CableBinaryHandler::Component& record,
+                      const uint64_t& size_file) {
+  return IsValidRange(record.offset_coefficients_creep,
+                      record.num_coefficients_creep * sizeof(double),
+                      size_file, true)
+         && IsValidRange(record.offset_coefficients_loadstrain,
+                         record.num_coefficients_loadstrain * sizeof(double),
+                         size_file, true);
+}
+
+}  // namespace
+
+const char CableBinaryHandler::kMagic[8] = {'O', 'T', 'L', 'S', 'C', 'B', 'L',
+                                            '\x1a'};
+
+uint64_t CableBinaryHandler::Checksum(const char* data,
+                                      const std::size_t& size) {
+  uint64_t hash = 14695981039346656037ULL;
+  auto combine = [&hash](const uint64_t& value) {
+    hash ^= value;
+    hash *= 1099511628211ULL;
+  };
+
+  std::size_t pos = 0;
+  for (; pos + 8 <= size; pos += 8) {
+    uint64_t word;
+    std::memcpy(&word, data + pos, 8);
+    combine(word);
+  }
+
+  for (; pos < size; pos++) {
+    combine(static_cast<unsigned char>(data[pos]));
+  }
+
+  combine(static_cast<uint64_t>(size));
+  return hash;
+}
+
+bool CableBinaryHandler::IsBinary(const TextView& data) {
+  return (sizeof(kMagic) <= data.size())
+         && (std::memcmp(data.data(), kMagic, sizeof(kMagic)) == 0);
+}
+
+bool CableBinaryHandler::Parse(const TextView& data, units::UnitSystem& units,
+                               Cable& cable, wxString& message) {
+  if (Validate(data, message) == false) {
+    return false;
+  }
+
+  const Header* header = reinterpret_cast<const Header*>(data.data());
+  if (header->units == 1) {
+    units = units::UnitSystem::kImperial;
+  } else {
+    units = units::UnitSystem::kMetric;
+  }
+
+  Read(data, cable);
+  return true;
+}
+
+void CableBinaryHandler::Read(const TextView& data, Cable& cable) {
+  const Record* record = reinterpret_cast<const Record*>(
+      data.data() + sizeof(Header));
+
+  cable.area_physical = record->area_physical;
+  CopyComponent(data.data(), record->component_core, cable.component_core);
+  CopyComponent(data.data(), record->component_shell, cable.component_shell);
+  cable.diameter = record->diameter;
+  cable.name.assign(data.data() + record->offset_name, record->size_name);
+  cable.strength_rated = record->strength_rated;
+  cable.temperature_properties_components =
+      record->temperature_properties_components;
+  cable.weight_unit = record->weight_unit;
+}
+
+bool CableBinaryHandler::Validate(const TextView& data, wxString& message) {
+  if (IsLittleEndian() == false) {
+    message = "Binary cable files are only supported on little endian "
+              "platforms.";
+    return false;
+  }
+
+  if (reinterpret_cast<uintptr_t>(data.data()) % 8 != 0) {
+    message = "Binary cable file data is not aligned.";
+    return false;
+  }
+
+  if ((data.size() < kOffsetArrays) || (IsBinary(data) == false)) {
+    message = "Invalid binary cable file.";
+    return false;
+  }
+
+  const Header* header = reinterpret_cast<const Header*>(data.data());
+  if (header->version != kVersion) {
+    message = "Unsupported binary cable file version.";
+    return false;
+  }
+
+  // the data is always read in the 'different' unit style, which is the only
+  // style that is written
+  if ((header->size_header != sizeof(Header))
+      || (header->size_file != data.size())
+      || ((header->units != 1) && (header->units != 2))
+      || (header->style != 2)) {
+    message = "Invalid binary cable file header.";
+    return false;
+  }
+
+  if (header->checksum != Checksum(data.data() + sizeof(Header),
+                                   data.size() - sizeof(Header))) {
+    message = "Binary cable file checksum does not match.";
+    return false;
+  }
+
+  const Record* record = reinterpret_cast<const Record*>(
+      data.data() + sizeof(Header));
+  if ((IsValidComponent(record->component_core, data.size()) == false)
+      || (IsValidComponent(record->component_shell, data.size()) == false)
+      || (IsValidRange(record->offset_name, record->size_name, data.size(),
+                       false) == false)) {
+    message = "Invalid binary cable file record.";
+    return false;
+  }
+
+  return true;
+}
+
+void CableBinaryHandler::Write(const Cable& cable,
+                               const units::UnitSystem& units,
+                               std::string& buffer) {
+  // reserves the header and record, which are filled after the arrays are
+  // appended and their offsets are known
+  buffer.assign(kOffsetArrays, '\0');
+
+  Header header;
+  std::memset(&header, 0, sizeof(header));
+  Record record;
+  std::memset(&record, 0, sizeof(record));
+
+  record.area_physical = cable.area_physical;
+  AppendComponent(cable.component_core, record.component_core, buffer);
+  AppendComponent(cable.component_shell, record.component_shell, buffer);
+  record.diameter = cable.diameter;
+  record.strength_rated = cable.strength_rated;
+  record.temperature_properties_components =
+      cable.temperature_properties_components;
+  record.weight_unit = cable.weight_unit;
+
+  record.offset_name = buffer.size();
+  record.size_name = cable.name.size();
+  buffer.append(cable.name);
+  Pad(buffer);
+
+  std::memcpy(&buffer[sizeof(Header)], &record, sizeof(record));
+
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.size_header = sizeof(Header);
+  header.units = (units == units::UnitSystem::kMetric) ? 2 : 1;
+  header.style = 2;
+  header.size_file = buffer.size();
+  header.checksum = Checksum(buffer.data() + sizeof(Header),
+                             buffer.size() - sizeof(Header));
+
+  std::memcpy(&buffer[0], &header, sizeof(header));
+}
@@ -0,0 +1,96 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "cable_binary_reader.h"
+
+CableBinaryReader::CableBinaryReader() {
+  record_ = nullptr;
+  units_ = units::UnitSystem::kNull;
+}
+
+CableBinaryReader::~CableBinaryReader() {
+}
+
+bool CableBinaryReader::Attach(const TextView& data, wxString& message) {
+  record_ = nullptr;
+  units_ = units::UnitSystem::kNull;
+
+  if (CableBinaryHandler::Validate(data, message) == false) {
+    data_ = TextView();
+    return false;
+  }
+
+  data_ = data;
+
+  const CableBinaryHandler::Header* header =
+      reinterpret_cast<const CableBinaryHandler::Header*>(data_.data());
+  if (header->units == 1) {
+    units_ = units::UnitSystem::kImperial;
+  } else {
+    units_ = units::UnitSystem::kMetric;
+  }
+
+  record_ = reinterpret_cast<const CableBinaryHandler::Record*>(
+      data_.data() + sizeof(CableBinaryHandler::Header));
+
+  return true;
+}
+
+void CableBinaryReader::Close() {
+  data_ = TextView();
+  file_.Close();
+  record_ = nullptr;
+  units_ = units::UnitSystem::kNull;
+}
+
+bool CableBinaryReader::Open(const wxString& filepath, wxString& message) {
+  Close();
+
+  if (file_.Open(filepath) == false) {
+    message = "Could not open binary cable file: " + filepath + ".";
+    return false;
+  }
+
+  if (Attach(file_.contents(), message) == false) {
+    file_.Close();
+    return false;
+  }
+
+  return true;
+}
+
+void CableBinaryReader::ToCable(Cable& cable) const {
+  if (record_ == nullptr) {
+    return;
+  }
+
+  CableBinaryHandler::Read(data_, cable);
+}
+
+const double* CableBinaryReader::coefficients_creep(
+    const CableBinaryHandler::Component& component) const {
+  return reinterpret_cast<const double*>(
+      data_.data() + component.offset_coefficients_creep);
+}
+
+const double* CableBinaryReader::coefficients_loadstrain(
+    const CableBinaryHandler::Component& component) const {
+  return reinterpret_cast<const double*>(
+      data_.data() + component.offset_coefficients_loadstrain);
+}
+
+TextView CableBinaryReader::name() const {
+  if (record_ == nullptr) {
+    return TextView();
+  }
+
+  return data_.substr(record_->offset_name, record_->size_name);
+}
+
+const CableBinaryHandler::Record* CableBinaryReader::record() const {
+  return record_;
+}
+
+units::UnitSystem CableBinaryReader::units() const {
+  return units_;
+}
@@ -0,0 +1,903 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "cable_converter.h"
+
+#include <cstdio>
+#include <vector>
+
+#include "appcommon/units/cable_unit_converter.h"
+#include "models/transmissionline/cable.h"
+#include "wx/file.h"
+#include "wx/filename.h"
+
+#include "cable_binary_handler.h"
+#include "cable_file_xml_handler.h"
+#include "cable_polynomial_searcher.h"
+#include "cable_unit_table.h"
+#include "conversion_arena.h"
+#include "mapped_file.h"
+#include "record_parser.h"
+#include "xml_stream_writer.h"
+
+/// \brief Parses a cable file.
+/// \param[in] filepath
+///   The relative or absolute filepath to open and parse.
+/// \param[out] units
+///   The unit system that is populated.
+/// \param[out] cable
+///   The cable that is populated.
+/// \return The status of the file parsing. A true return flag means that no
+///   errors were encountered.
+/// This function is declared here (globally) so a custom parser can be added
+/// onto the project in a modular way. The source code in this class does not
+/// need modified. Instead, create an external file with a matching function
+/// definition. Add the external file to the build process and the linker will
+/// make the connection.
+/// When converting in batch mode this function is called from multiple threads
+/// at once, so it should not modify any global state.
+/// If a parser registry is set, this function is only called for files that
+/// no registered parser recognizes.
+/// Scratch memory for parsing (ex: ArenaVector, DelimiterScanner) is taken
+/// from the conversion arena of the thread, which is reset before the next
+/// file. Nothing that uses it can be kept in the cable.
+extern bool ParseCableFile(const wxString& filepath, units::UnitSystem& units,
+                           Cable& cable);
+
+namespace {
+
+/// \brief Gets the conversion arena of the calling thread.
+/// \return The conversion arena, which is kept for the life of the thread so
+///   its chunks are reused by every file the thread converts.
+ConversionArena& ArenaThread() {
+  static thread_local ConversionArena arena;
+  return arena;
+}
+
+/// The input filepath of the conversion stage that the calling thread is
+/// running, or a nullptr.
+thread_local const wxString* filepath_input_thread = nullptr;
+
+/// \par OVERVIEW
+///
+/// This class sets the input filepath of the calling thread for the lifetime
+/// of the object, and restores the previous one when it ends.
+class ThreadInputScope {
+ public:
+  /// \brief Constructor.
+  /// \param[in] filepath_input
+  ///   The input filepath, which must outlive the scope.
+  explicit ThreadInputScope(const wxString& filepath_input) {
+    previous_ = filepath_input_thread;
+    filepath_input_thread = &filepath_input;
+  }
+
+  /// \brief Destructor.
+  ~ThreadInputScope() {
+    filepath_input_thread = previous_;
+  }
+
+ private:
+  /// \var previous_
+  ///   The input filepath before the scope started.
+  const wxString* previous_;
+};
+
+/// \brief Gets the output writer of the calling thread.
+/// \return The output writer, which is kept for the life of the thread so its
+///   io_uring instance is reused by every batch the thread writes.
+OutputWriter& WriterThread() {
+  static thread_local OutputWriter writer;
+  return writer;
+}
+
+/// \brief Reads one byte of each page of a mapped file, so the pages are read
+///   from the disk (or network) now instead of when they are first parsed.
+/// \param[in] contents
+///   The mapped file contents.
+void ReadPages(const TextView& contents) {
+  const std::size_t kSizePage = 4096;
+  const char* data = contents.data();
+
+  // the sum is volatile so the reads aren't optimized away
+  volatile unsigned char sum = 0;
+  for (std::size_t i = 0; i < contents.size(); i += kSizePage) {
+    sum = sum + static_cast<unsigned char>(data[i]);
+  }
+}
+
+/// \brief Writes a buffer to a file with a single write.
+/// \param[in] filepath
+///   The filepath.
+/// \param[in] buffer
+///   The buffer.
+/// \return If the file was written.
+bool SaveFile(const wxString& filepath, const TextView& buffer) {
+  FILE* file = fopen(filepath.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  const std::size_t size = fwrite(buffer.data(), 1, buffer.size(), file);
+  const bool is_closed = fclose(file) == 0;
+  return (size == buffer.size()) && (is_closed == true);
+}
+
+/// \brief Writes a buffer to a new temporary file.
+/// \param[in] buffer
+///   The buffer.
+/// \return The temporary filepath, or an empty string if the file could not
+///   be written.
+/// The file is created exclusively with a unique name, and is only accessible
+/// by the current user, so another user can't redirect or read it.
+wxString SaveFileTemp(const TextView& buffer) {
+  wxFile file;
+  const wxString filepath = wxFileName::CreateTempFileName(
+      wxFileName(wxFileName::GetTempDir(), "cableconverter").GetFullPath(),
+      &file);
+  if (filepath.empty() == true) {
+    return wxEmptyString;
+  }
+
+  const bool is_written =
+      (file.Write(buffer.data(), buffer.size()) == buffer.size());
+  const bool is_closed = file.Close();
+  if ((is_written == false) || (is_closed == false)) {
+    wxRemoveFile(filepath);
+    return wxEmptyString;
+  }
+
+  return filepath;
+}
+
+}  // namespace
+
+CableConverter::CableConverter() {
+  cache_polynomial_limits_ = nullptr;
+  format_ = Format::kXml;
+  format_limit_table_ = CableLimitTable::Format::kCsv;
+  is_compact_ = false;
+  metrics_ = nullptr;
+  output_writer_ = nullptr;
+  parser_registry_ = nullptr;
+  strain_percent_polynomial_limits_ = -1;
+  strain_sweep_.start = 0;
+  strain_sweep_.step = 0;
+  strain_sweep_.stop = 0;
+  tolerance_polynomial_limits_ = -1;
+  trace_recorder_ = nullptr;
+  units_ = units::UnitSystem::kImperial;
+}
+
+CableConverter::~CableConverter() {
+}
+
+void CableConverter::Begin(const wxString& filepath_input,
+                           const bool& is_table, Conversion& conversion) {
+  conversion.buffer.clear();
+  conversion.cable = Cable();
+  conversion.contents = TextView();
+  conversion.file.Close();
+  conversion.filepath_input = filepath_input;
+  conversion.is_binary = false;
+  conversion.is_table = is_table;
+  conversion.message.clear();
+  conversion.table.clear();
+  conversion.units = units::UnitSystem::kNull;
+}
+
+bool CableConverter::Convert(const wxString& filepath_input,
+                             const wxString& filepath_output,
+                             wxString& message) const {
+  message.clear();
+  TraceSpan span_convert(trace_recorder_, "Convert", filepath_input);
+
+  Conversion conversion;
+  Begin(filepath_input, true, conversion);
+  if ((Generate(conversion) == false)
+      || (Write(filepath_output, conversion) == false)) {
+    message = conversion.message;
+    return false;
+  }
+
+  return true;
+}
+
+bool CableConverter::ConvertToBuffer(const wxString& filepath_input,
+                                     std::string& buffer,
+                                     std::string& name,
+                                     wxString& message) const {
+  buffer.clear();
+  name.clear();
+  message.clear();
+  TraceSpan span_convert(trace_recorder_, "Convert", filepath_input);
+
+  Conversion conversion;
+  Begin(filepath_input, false, conversion);
+  if (Generate(conversion) == false) {
+    message = conversion.message;
+    return false;
+  }
+
+  buffer.swap(conversion.buffer);
+  name = conversion.cable.name;
+  return true;
+}
+
+bool CableConverter::ConvertBuffer(const wxString& name,
+                                   const TextView& input,
+                                   Conversion& conversion) const {
+  TraceSpan span_convert(trace_recorder_, "Convert", name);
+  Begin(name, false, conversion);
+  conversion.contents = input;
+
+  // binary input and input that a registered parser recognizes are parsed
+  // from memory, but the linked parser reads files, so it gets a private
+  // temporary copy of the input
+  wxString filepath_temp;
+  if ((CableBinaryHandler::IsBinary(input) == false)
+      && ((parser_registry_ == nullptr)
+          || (parser_registry_->Sniff(name, input) == nullptr))) {
+    filepath_temp = SaveFileTemp(input);
+    if (filepath_temp.empty() == true) {
+      conversion.message = "Could not write input to a temporary file.";
+      return false;
+    }
+    conversion.filepath_input = filepath_temp;
+  }
+
+  const bool status = (Parse(conversion) == true)
+                      && (Solve(conversion) == true)
+                      && (Serialize(conversion) == true);
+
+  if (filepath_temp.empty() == false) {
+    wxRemoveFile(filepath_temp);
+    conversion.filepath_input = name;
+  }
+
+  return status;
+}
+
+std::string CableConverter::DescribeSettings() const {
+  // doubles are written in hexadecimal so every bit is included
+  // the version must be increased if the generated file format changes
+  char str[256];
+  snprintf(str, sizeof(str),
+           "version=1;compact=%d;format=%d;strain=%a;tolerance=%a;units=%d;"
+           "sweep=%a:%a:%a;table=%d",
+           is_compact_ ? 1 : 0, static_cast<int>(format_),
+           strain_percent_polynomial_limits_,
+           tolerance_polynomial_limits_, static_cast<int>(units_),
+           strain_sweep_.start, strain_sweep_.stop, strain_sweep_.step,
+           static_cast<int>(format_limit_table_));
+
+  // a different parser set may parse a file differently
+  std::string description = str;
+  if (parser_registry_ != nullptr) {
+    description += ";parsers=" + parser_registry_->Describe();
+  }
+  return description;
+}
+
+wxString CableConverter::FilePathLimitTable(
+    const wxString& filepath_output) const {
+  if (strain_sweep_.step <= 0) {
+    return wxEmptyString;
+  }
+
+  wxFileName filename(filepath_output);
+  filename.SetExt(CableLimitTable::Extension(format_limit_table_));
+  return filename.GetFullPath();
+}
+
+wxString CableConverter::ExtensionOutput() const {
+  if (format_ == Format::kBinary) {
+    return "cablebin";
+  } else {
+    return "cable";
+  }
+}
+
+bool CableConverter::Parse(Conversion& conversion) const {
+  const ThreadInputScope scope_input(conversion.filepath_input);
+  const wxString& filepath_input = conversion.filepath_input;
+  Cable& cable = conversion.cable;
+  units::UnitSystem& units = conversion.units;
+
+  // releases the scratch memory of the previous parse on this thread
+  ConversionArena::Scope scope_arena(&ArenaThread());
+
+  // parses input file
+  // the cable should be in 'consistent' units after parsing is finished
+  wxLogVerbose("Parsing input file: " + filepath_input);
+  TraceSpan span(trace_recorder_, "ParseCableFile", filepath_input);
+  MetricsTimer timer(metrics_, ConversionMetrics::Stage::kParse);
+  const TextView contents = conversion.contents;
+
+  // binary cable files were already solved and converted to the 'different'
+  // unit style, so they are only serialized again
+  if (CableBinaryHandler::IsBinary(contents) == true) {
+    conversion.is_binary = true;
+    const bool status = CableBinaryHandler::Parse(contents, units, cable,
+                                                  conversion.message);
+    conversion.file.Close();
+    return status;
+  }
+
+  // sniffs the format, and parses from the same mapping
+  const ParserRegistry::Parser* parser = nullptr;
+  if (parser_registry_ != nullptr) {
+    parser = parser_registry_->Sniff(filepath_input, contents);
+  }
+
+  bool status = false;
+  if ((parser != nullptr) && (parser->parse_record != nullptr)) {
+    // a multi-record parser is used if the file holds a single record
+    wxLogVerbose("Parsing with: " + parser->name);
+    std::vector<RecordParser::Record> records;
+    RecordParser::Split(contents, parser->marker_record, records);
+    if (records.size() != 1) {
+      wxString message;
+      message << "Input file contains " << static_cast<int>(records.size())
+              << " cable records, which must be converted separately.";
+      conversion.message = message;
+      conversion.file.Close();
+      return false;
+    }
+
+    const RecordParser::Record& record = records.front();
+    status = parser->parse_record(filepath_input, record.text,
+                                  record.line_number, units, cable);
+  } else if (parser != nullptr) {
+    wxLogVerbose("Parsing with: " + parser->name);
+    status = parser->parse(filepath_input, contents, units, cable);
+  } else {
+    status = ParseCableFile(filepath_input, units, cable);
+  }
+  conversion.file.Close();
+
+  if (status == false) {
+    conversion.message = "Parsing errors were encountered.";
+    return false;
+  }
+
+  return true;
+}
+
+bool CableConverter::Read(Conversion& conversion) const {
+  const ThreadInputScope scope_input(conversion.filepath_input);
+  const wxString& filepath_input = conversion.filepath_input;
+  TraceSpan span(trace_recorder_, "ReadFile", filepath_input);
+  MetricsTimer timer(metrics_, ConversionMetrics::Stage::kRead);
+
+  // validates input file
+  if (wxFileName::Exists(filepath_input) == false) {
+    conversion.message = "Invalid input filepath: " + filepath_input + ".";
+    return false;
+  }
+
+  if (conversion.file.Open(filepath_input) == false) {
+    conversion.message = "Could not read input file: " + filepath_input
+                         + ".";
+    return false;
+  }
+
+  conversion.contents = conversion.file.contents();
+  ReadPages(conversion.contents);
+  if (metrics_ != nullptr) {
+    metrics_->AddBytesRead(conversion.contents.size());
+  }
+  return true;
+}
+
+bool CableConverter::Serialize(Conversion& conversion) const {
+  const ThreadInputScope scope_input(conversion.filepath_input);
+  // releases the XML build memory of the previous file on this thread
+  ConversionArena::Scope scope_arena(&ArenaThread());
+
+  // binary cable files are serialized in their own unit system
+  TraceSpan span(trace_recorder_, "Serialize", conversion.filepath_input);
+  MetricsTimer timer(metrics_, ConversionMetrics::Stage::kSerialize);
+  if (conversion.is_binary == true) {
+    Serialize(conversion.cable, conversion.units, conversion.buffer);
+  } else {
+    Serialize(conversion.cable, units_, conversion.buffer);
+  }
+
+  return true;
+}
+
+bool CableConverter::Solve(Conversion& conversion) const {
+  const ThreadInputScope scope_input(conversion.filepath_input);
+  // binary cable files are already solved
+  if (conversion.is_binary == true) {
+    if ((conversion.is_table == true) && (0 < strain_sweep_.step)) {
+      wxLogWarning("Limit tables are not generated for binary cable files: "
+                   + conversion.filepath_input + ".");
+    }
+    return true;
+  }
+
+  const std::vector<Conversion*> conversions(1, &conversion);
+  ConvertUnitSystem(conversions);
+  if ((SolveTable(conversion) == false)
+      || (SolveLimits(conversion) == false)) {
+    return false;
+  }
+  ConvertUnitStyle(conversions);
+
+  return true;
+}
+
+bool CableConverter::SolveBatch(const std::vector<Conversion*>& conversions,
+                                std::vector<bool>& statuses) const {
+  statuses.assign(conversions.size(), false);
+
+  // binary cable files are solved on their own, and the rest are converted
+  // to the app unit system together
+  bool status = true;
+  std::vector<Conversion*> conversions_batch;
+  std::vector<std::size_t> indexes;
+  for (std::size_t i = 0; i < conversions.size(); i++) {
+    Conversion& conversion = *conversions.at(i);
+    if (conversion.is_binary == true) {
+      statuses[i] = Solve(conversion);
+      status = status && statuses[i];
+    } else {
+      conversions_batch.push_back(&conversion);
+      indexes.push_back(i);
+    }
+  }
+
+  if (conversions_batch.empty() == true) {
+    return status;
+  }
+
+  ConvertUnitSystem(conversions_batch);
+
+  // solves the limit tables
+  std::vector<Conversion*> conversions_solved;
+  std::vector<std::size_t> indexes_solved;
+  for (std::size_t i = 0; i < conversions_batch.size(); i++) {
+    const ThreadInputScope scope_input(conversions_batch[i]->filepath_input);
+    if (SolveTable(*conversions_batch[i]) == true) {
+      conversions_solved.push_back(conversions_batch[i]);
+      indexes_solved.push_back(indexes[i]);
+    } else {
+      status = false;
+    }
+  }
+
+  // the limits of all cables are scanned together in one sweep, which is
+  // timed as one search, unless the roots search or a fixed strain is used
+  const bool is_scanned = (1 < conversions_solved.size())
+                          && (tolerance_polynomial_limits_ <= 0)
+                          && (strain_percent_polynomial_limits_ == -1);
+  if (is_scanned == true) {
+    std::vector<Cable*> cables;
+    for (auto iter = conversions_solved.cbegin();
+         iter != conversions_solved.cend(); iter++) {
+      cables.push_back(&(*iter)->cable);
+    }
+
+    wxLogVerbose("Solving for polynomial limits.");
+    TraceSpan span(trace_recorder_, "SolveLimits",
+                   conversions_solved.front()->filepath_input);
+    MetricsTimer timer(metrics_, ConversionMetrics::Stage::kSolveLimits);
+    const int64_t num_unsolved =
+        CablePolynomialSearcher::ThreadNumLimitsUnsolved();
+    const bool is_solved = CablePolynomialSearcher::SolveLimits(
+        strain_percent_polynomial_limits_, tolerance_polynomial_limits_,
+        cache_polynomial_limits_, cables);
+
+    // counts the limits that were logged as unsolved
+    if (metrics_ != nullptr) {
+      metrics_->AddLimitsUnsolved(
+          CablePolynomialSearcher::ThreadNumLimitsUnsolved() - num_unsolved);
+    }
+
+    if (is_solved == false) {
+      for (auto iter = conversions_solved.begin();
+           iter != conversions_solved.end(); iter++) {
+        (*iter)->message = "Limit searching errors were encountered.";
+      }
+      return false;
+    }
+  } else {
+    std::size_t num = 0;
+    for (std::size_t i = 0; i < conversions_solved.size(); i++) {
+      const ThreadInputScope scope_input(
+          conversions_solved[i]->filepath_input);
+      if (SolveLimits(*conversions_solved[i]) == true) {
+        conversions_solved[num] = conversions_solved[i];
+        indexes_solved[num] = indexes_solved[i];
+        num++;
+      } else {
+        status = false;
+      }
+    }
+    conversions_solved.resize(num);
+    indexes_solved.resize(num);
+  }
+
+  ConvertUnitStyle(conversions_solved);
+  for (auto iter = indexes_solved.cbegin(); iter != indexes_solved.cend();
+       iter++) {
+    statuses[*iter] = true;
+  }
+
+  return status;
+}
+
+wxString CableConverter::ThreadFilePathInput() {
+  if (filepath_input_thread == nullptr) {
+    return wxEmptyString;
+  }
+
+  return *filepath_input_thread;
+}
+
+bool CableConverter::Write(const wxString& filepath_output,
+                           Conversion& conversion) const {
+  const ThreadInputScope scope_input(conversion.filepath_input);
+  // the output writer writes the output file and table as one batch
+  if (output_writer_ != nullptr) {
+    std::vector<bool> statuses;
+    return WriteBatch(std::vector<wxString>(1, filepath_output),
+                      std::vector<Conversion*>(1, &conversion), statuses);
+  }
+
+  // saves output file with a single write
+  wxLogVerbose("Saving output file: " + filepath_output);
+  TraceSpan span(trace_recorder_, "SaveFile", conversion.filepath_input);
+  MetricsTimer timer(metrics_, ConversionMetrics::Stage::kWrite);
+  if (SaveFile(filepath_output, conversion.buffer) == false) {
+    conversion.message = "Could not save output file: " + filepath_output
+                         + ".";
+    return false;
+  }
+
+  if (metrics_ != nullptr) {
+    metrics_->AddBytesWritten(conversion.buffer.size());
+  }
+
+  // saves the limit table next to the output file
+  if (conversion.table.empty() == false) {
+    const wxString filepath_table = FilePathLimitTable(filepath_output);
+    wxLogVerbose("Saving limit table: " + filepath_table);
+    if (SaveFile(filepath_table, conversion.table) == false) {
+      conversion.message = "Could not save limit table: " + filepath_table
+                           + ".";
+      return false;
+    }
+
+    if (metrics_ != nullptr) {
+      metrics_->AddBytesWritten(conversion.table.size());
+    }
+  }
+
+  return true;
+}
+
+bool CableConverter::WriteBatch(const std::vector<wxString>& filepaths_output,
+                                const std::vector<Conversion*>& conversions,
+                                std::vector<bool>& statuses) const {
+  statuses.assign(conversions.size(), true);
+
+  // writes each conversion on its own
+  bool status = true;
+  if (output_writer_ == nullptr) {
+    for (std::size_t i = 0; i < conversions.size(); i++) {
+      statuses[i] = Write(filepaths_output.at(i), *conversions.at(i));
+      status = status && statuses[i];
+    }
+    return status;
+  }
+
+  // collects the output files and limit tables, and the conversion of each
+  std::vector<OutputWriter::File> files;
+  std::vector<std::size_t> indexes;
+  for (std::size_t i = 0; i < conversions.size(); i++) {
+    const Conversion& conversion = *conversions.at(i);
+    OutputWriter::File file;
+    file.data = &conversion.buffer;
+    file.filepath = filepaths_output.at(i);
+    file.is_written = false;
+    wxLogVerbose("Saving output file: " + file.filepath);
+    files.push_back(file);
+    indexes.push_back(i);
+
+    if (conversion.table.empty() == false) {
+      file.data = &conversion.table;
+      file.filepath = FilePathLimitTable(filepaths_output.at(i));
+      wxLogVerbose("Saving limit table: " + file.filepath);
+      files.push_back(file);
+      indexes.push_back(i);
+    }
+  }
+
+  if (files.empty() == true) {
+    return true;
+  }
+
+  // writes the batch, which is timed as one write
+  OutputWriter& writer = WriterThread();
+  writer.Open(*output_writer_);
+  bool is_written = false;
+  {
+    TraceSpan span(trace_recorder_, "SaveFiles",
+                   conversions.front()->filepath_input);
+    MetricsTimer timer(metrics_, ConversionMetrics::Stage::kWrite);
+    is_written = writer.Write(files);
+  }
+
+  if (metrics_ != nullptr) {
+    for (auto iter = files.cbegin(); iter != files.cend(); iter++) {
+      if (iter->is_written == true) {
+        metrics_->AddBytesWritten(iter->data->size());
+      }
+    }
+  }
+
+  if (is_written == true) {
+    return true;
+  }
+
+  // reports the first file that failed for each conversion
+  for (std::size_t i = 0; i < files.size(); i++) {
+    const OutputWriter::File& file = files[i];
+    const std::size_t index = indexes[i];
+    if ((file.is_written == true) || (statuses[index] == false)) {
+      continue;
+    }
+
+    Conversion& conversion = *conversions.at(index);
+    if (file.data == &conversion.buffer) {
+      conversion.message = "Could not save output file: " + file.filepath
+                           + ".";
+    } else {
+      conversion.message = "Could not save limit table: " + file.filepath
+                           + ".";
+    }
+    statuses[index] = false;
+  }
+
+  return false;
+}
+
+PolynomialLimitCache* CableConverter::cache_polynomial_limits() const {
+  return cache_polynomial_limits_;
+}
+
+CableConverter::Format CableConverter::format() const {
+  return format_;
+}
+
+CableLimitTable::Format CableConverter::format_limit_table() const {
+  return format_limit_table_;
+}
+
+bool CableConverter::is_compact() const {
+  return is_compact_;
+}
+
+ConversionMetrics* CableConverter::metrics() const {
+  return metrics_;
+}
+
+const OutputWriter::Options* CableConverter::output_writer() const {
+  return output_writer_;
+}
+
+const ParserRegistry* CableConverter::parser_registry() const {
+  return parser_registry_;
+}
+
+double CableConverter::strain_percent_polynomial_limits() const {
+  return strain_percent_polynomial_limits_;
+}
+
+CableLimitTable::Range CableConverter::strain_sweep() const {
+  return strain_sweep_;
+}
+
+double CableConverter::tolerance_polynomial_limits() const {
+  return tolerance_polynomial_limits_;
+}
+
+TraceRecorder* CableConverter::trace_recorder() const {
+  return trace_recorder_;
+}
+
+units::UnitSystem CableConverter::units() const {
+  return units_;
+}
+
+void CableConverter::set_cache_polynomial_limits(
+    PolynomialLimitCache* cache_polynomial_limits) {
+  cache_polynomial_limits_ = cache_polynomial_limits;
+}
+
+void CableConverter::set_format(const Format& format) {
+  format_ = format;
+}
+
+void CableConverter::set_format_limit_table(
+    const CableLimitTable::Format& format_limit_table) {
+  format_limit_table_ = format_limit_table;
+}
+
+void CableConverter::set_is_compact(const bool& is_compact) {
+  is_compact_ = is_compact;
+}
+
+void CableConverter::set_metrics(ConversionMetrics* metrics) {
+  metrics_ = metrics;
+}
+
+void CableConverter::set_output_writer(
+    const OutputWriter::Options* output_writer) {
+  output_writer_ = output_writer;
+}
+
+void CableConverter::set_parser_registry(
+    const ParserRegistry* parser_registry) {
+  parser_registry_ = parser_registry;
+}
+
+void CableConverter::set_strain_percent_polynomial_limits(
+    const double& strain_percent_polynomial_limits) {
+  strain_percent_polynomial_limits_ = strain_percent_polynomial_limits;
+}
+
+void CableConverter::set_strain_sweep(
+    const CableLimitTable::Range& strain_sweep) {
+  strain_sweep_ = strain_sweep;
+}
+
+void CableConverter::set_tolerance_polynomial_limits(
+    const double& tolerance_polynomial_limits) {
+  tolerance_polynomial_limits_ = tolerance_polynomial_limits;
+}
+
+void CableConverter::set_trace_recorder(TraceRecorder* trace_recorder) {
+  trace_recorder_ = trace_recorder;
+}
+
+void CableConverter::set_units(const units::UnitSystem& units) {
+  units_ = units;
+}
+
+void CableConverter::ConvertUnitStyle(
+    const std::vector<Conversion*>& conversions) const {
+  // converts to 'different' unit style, with the cables of each unit system
+  // converted together
+  std::vector<bool> is_converted(conversions.size(), false);
+  for (std::size_t i = 0; i < conversions.size(); i++) {
+    if (is_converted[i] == true) {
+      continue;
+    }
+
+    const units::UnitSystem units = conversions[i]->units;
+    std::vector<Cable*> cables;
+    for (std::size_t j = i; j < conversions.size(); j++) {
+      if ((is_converted[j] == false) && (conversions[j]->units == units)) {
+        cables.push_back(&conversions[j]->cable);
+        is_converted[j] = true;
+      }
+    }
+
+    TraceSpan span(trace_recorder_, "ConvertUnitStyleToDifferent",
+                   conversions[i]->filepath_input);
+    MetricsTimer timer(metrics_, ConversionMetrics::Stage::kConvertUnits);
+    const CableUnitTable* table_units = CableUnitTable::Find(
+        units, units, units::UnitStyle::kDifferent);
+    if ((table_units == nullptr) || (table_units->Convert(cables) == false)) {
+      for (auto iter = cables.begin(); iter != cables.end(); iter++) {
+        CableUnitConverter::ConvertUnitStyleToDifferent(units, true, **iter);
+      }
+    }
+  }
+}
+
+void CableConverter::ConvertUnitSystem(
+    const std::vector<Conversion*>& conversions) const {
+  // converts from file to app unit system if necessary, with the cables of
+  // each file unit system converted together
+  std::vector<bool> is_converted(conversions.size(), false);
+  for (std::size_t i = 0; i < conversions.size(); i++) {
+    const units::UnitSystem units = conversions[i]->units;
+    if ((is_converted[i] == true) || (units == units_)) {
+      continue;
+    }
+
+    std::vector<Cable*> cables;
+    for (std::size_t j = i; j < conversions.size(); j++) {
+      if ((is_converted[j] == false) && (conversions[j]->units == units)) {
+        cables.push_back(&conversions[j]->cable);
+        is_converted[j] = true;
+      }
+    }
+
+    TraceSpan span(trace_recorder_, "ConvertUnitSystem",
+                   conversions[i]->filepath_input);
+    MetricsTimer timer(metrics_, ConversionMetrics::Stage::kConvertUnits);
+    const CableUnitTable* table_units = CableUnitTable::Find(
+        units, units_, units::UnitStyle::kConsistent);
+    if ((table_units == nullptr) || (table_units->Convert(cables) == false)) {
+      for (auto iter = cables.begin(); iter != cables.end(); iter++) {
+        CableUnitConverter::ConvertUnitSystem(units, units_, true, **iter);
+      }
+    }
+  }
+}
+
+bool CableConverter::Generate(Conversion& conversion) const {
+  return (Read(conversion) == true) && (Parse(conversion) == true)
+         && (Solve(conversion) == true) && (Serialize(conversion) == true);
+}
+
+void CableConverter::Serialize(const Cable& cable,
+                               const units::UnitSystem& units,
+                               std::string& buffer) const {
+  if (format_ == Format::kBinary) {
+    CableBinaryHandler::Write(cable, units, buffer);
+    return;
+  }
+
+  // the file version is set to 0, as this has to be defined uniquely by the
+  // app that uses it
+  XmlStreamWriter writer(is_compact_ ? -1 : 2);
+  CableFileXmlHandler::WriteNode(cable, "", units::UnitSystem::kImperial,
+                                 units::UnitStyle::kDifferent, writer);
+  writer.TakeBuffer(buffer);
+}
+
+bool CableConverter::SolveLimits(Conversion& conversion) const {
+  // searches for the polynomial limits
+  wxLogVerbose("Solving for polynomial limits.");
+  CablePolynomialSearcher::SearchType type_search =
+      CablePolynomialSearcher::SearchType::kScan;
+  if (0 < tolerance_polynomial_limits_) {
+    type_search = CablePolynomialSearcher::SearchType::kRoots;
+  }
+
+  TraceSpan span(trace_recorder_, "SolveLimits", conversion.filepath_input);
+  MetricsTimer timer(metrics_, ConversionMetrics::Stage::kSolveLimits);
+  const int64_t num_unsolved =
+      CablePolynomialSearcher::ThreadNumLimitsUnsolved();
+  const bool status = CablePolynomialSearcher::SolveLimits(
+      strain_percent_polynomial_limits_, type_search,
+      tolerance_polynomial_limits_, cache_polynomial_limits_,
+      conversion.cable);
+
+  // counts the limits that were logged as unsolved
+  if (metrics_ != nullptr) {
+    metrics_->AddLimitsUnsolved(
+        CablePolynomialSearcher::ThreadNumLimitsUnsolved() - num_unsolved);
+  }
+
+  if (status == false) {
+    conversion.message = "Limit searching errors were encountered.";
+    return false;
+  }
+
+  return true;
+}
+
+bool CableConverter::SolveTable(Conversion& conversion) const {
+  // solves the limit table from the same cable that the limits are solved
+  // from
+  if ((conversion.is_table == true) && (0 < strain_sweep_.step)) {
+    TraceSpan span(trace_recorder_, "SolveLimitTable",
+                   conversion.filepath_input);
+    CableLimitTable limit_table;
+    if (limit_table.Solve(conversion.cable, strain_sweep_) == false) {
+      conversion.message = "Invalid strain sweep.";
+      return false;
+    }
+    limit_table.Write(format_limit_table_, units_, conversion.table);
+  }
+
+  return true;
+}
@@ -0,0 +1,569 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "cable_converter_api.h"
+
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+
+#include "wx/filename.h"
+#include "wx/init.h"
+#include "wx/thread.h"
+#include "wx/wx.h"
+
+#include "cable_converter.h"
+#include "cable_polynomial_searcher.h"
+#include "parser_registry.h"
+#include "polynomial_limit_cache.h"
+
+namespace {
+
+/// \par OVERVIEW
+///
+/// This class runs functions on a persistent helper thread.
+///
+/// The thread is started by the first call and then waits for the next one,
+/// so a call only costs a wake-up instead of creating and joining a thread.
+/// Calls are run one at a time.
+class HelperThread {
+ public:
+  /// \brief Default constructor. The thread is not started.
+  HelperThread() {
+    function_ = nullptr;
+    is_stopping_ = false;
+  }
+
+  /// \brief Destructor. This stops the thread. No call may be running.
+  ~HelperThread() {
+    if (thread_.joinable() == false) {
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      is_stopping_ = true;
+    }
+    condition_.notify_all();
+    thread_.join();
+  }
+
+  /// \brief Runs a function on the helper thread.
+  /// \param[in] function
+  ///   The function, which is run before this returns.
+  void Run(const std::function<void()>& function) {
+    std::lock_guard<std::mutex> lock_run(mutex_run_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (thread_.joinable() == false) {
+      thread_ = std::thread(&HelperThread::Serve, this);
+    }
+
+    function_ = &function;
+    condition_.notify_all();
+    while (function_ != nullptr) {
+      condition_.wait(lock);
+    }
+  }
+
+ private:
+  /// \brief Copy constructor. This is not implemented.
+  HelperThread(const HelperThread&);
+
+  /// \brief Assignment operator. This is not implemented.
+  HelperThread& operator=(const HelperThread&);
+
+  /// \brief Runs functions until the thread is stopped.
+  /// This is the thread entry point.
+  void Serve() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      while ((is_stopping_ == false) && (function_ == nullptr)) {
+        condition_.wait(lock);
+      }
+
+      if (function_ == nullptr) {
+        break;
+      }
+
+      lock.unlock();
+      (*function_)();
+      lock.lock();
+
+      function_ = nullptr;
+      condition_.notify_all();
+    }
+  }
+
+  /// \var condition_
+  ///   The condition that wakes the thread for a function, and the caller
+  ///   when it is done.
+  std::condition_variable condition_;
+
+  /// \var function_
+  ///   The function to run, or a nullptr once it is done.
+  const std::function<void()>* function_;
+
+  /// \var is_stopping_
+  ///   An indicator that tells the thread to exit.
+  bool is_stopping_;
+
+  /// \var mutex_
+  ///   The mutex that guards the function and the stop indicator.
+  std::mutex mutex_;
+
+  /// \var mutex_run_
+  ///   The mutex that lets one call run at a time.
+  std::mutex mutex_run_;
+
+  /// \var thread_
+  ///   The helper thread.
+  std::thread thread_;
+};
+
+}  // namespace
+
+/// \par OVERVIEW
+///
+/// This struct contains a converter and the objects that it uses. None of
+/// them are modified by a conversion, except for the thread safe cache and
+/// helper thread.
+struct OtlsCfcConverter {
+  /// \var cache_polynomial_limits
+  ///   The polynomial limit cache, which is shared by all conversions.
+  PolynomialLimitCache cache_polynomial_limits;
+
+  /// \var converter
+  ///   The converter.
+  CableConverter converter;
+
+  /// \var helper
+  ///   The helper thread that runs calls from the wxWidgets main thread (see
+  ///   RunOffMain()).
+  mutable HelperThread helper;
+
+  /// \var parser_registry
+  ///   The parser registry, which holds the loaded plugins.
+  ParserRegistry parser_registry;
+};
+
+/// \par OVERVIEW
+///
+/// This struct contains a conversion result.
+struct OtlsCfcResult {
+  /// \var cable
+  ///   The solved cable, which points into the conversion cable.
+  OtlsCfcCable cable;
+
+  /// \var conversion
+  ///   The conversion, which holds the generated file and solved cable.
+  CableConverter::Conversion conversion;
+
+  /// \var diagnostics
+  ///   The messages that were logged during the conversion.
+  std::string diagnostics;
+
+  /// \var is_converted
+  ///   An indicator that tells if the conversion succeeded.
+  bool is_converted;
+
+  /// \var message
+  ///   The error message.
+  std::string message;
+
+  /// \var name
+  ///   The cable name.
+  std::string name;
+};
+
+namespace {
+
+/// \par OVERVIEW
+///
+/// This class captures the messages that are logged during a conversion.
+class DiagnosticLog : public wxLog {
+ public:
+  /// \brief Constructor.
+  /// \param[out] diagnostics
+  ///   The diagnostics that messages are appended to.
+  /// The log is set as the target of the calling thread until it is
+  /// destroyed. The calling thread must not be the wxWidgets main thread,
+  /// which ignores thread targets (see RunOffMain()).
+  explicit DiagnosticLog(std::string* diagnostics) {
+    diagnostics_ = diagnostics;
+    log_previous_ = wxLog::SetThreadActiveTarget(this);
+  }
+
+  /// \brief Destructor. This restores the previous target.
+  virtual ~DiagnosticLog() {
+    wxLog::SetThreadActiveTarget(log_previous_);
+  }
+
+ protected:
+  /// \brief Appends a record to the diagnostics.
+  /// \param[in] level
+  ///   The log level.
+  /// \param[in] msg
+  ///   The message.
+  /// \param[in] info
+  ///   The record info, which is not used.
+  /// Verbose and debug records are not captured.
+  virtual void DoLogRecord(wxLogLevel level, const wxString& msg,
+                           const wxLogRecordInfo& info) {
+    const char* name = nullptr;
+    if ((level == wxLOG_FatalError) || (level == wxLOG_Error)) {
+      name = "Error: ";
+    } else if (level == wxLOG_Warning) {
+      name = "Warning: ";
+    } else if (level == wxLOG_Message) {
+      name = "Message: ";
+    } else {
+      return;
+    }
+
+    *diagnostics_ += name;
+    *diagnostics_ += msg.ToUTF8().data();
+    *diagnostics_ += '\n';
+  }
+
+ private:
+  /// \var diagnostics_
+  ///   The diagnostics.
+  std::string* diagnostics_;
+
+  /// \var log_previous_
+  ///   The target that is restored.
+  wxLog* log_previous_;
+};
+
+/// \brief Copies a cable component to the C struct.
+/// \param[in] component
+///   The component.
+/// \param[out] component_c
+///   The C component, which points into the component.
+void CopyComponent(const CableComponent& component,
+                   OtlsCfcCableComponent& component_c) {
+  component_c.coefficient_expansion_linear_thermal =
+      component.coefficient_expansion_linear_thermal;
+  component_c.coefficients_polynomial_creep =
+      component.coefficients_polynomial_creep.data();
+  component_c.coefficients_polynomial_loadstrain =
+      component.coefficients_polynomial_loadstrain.data();
+  component_c.load_limit_polynomial_creep =
+      component.load_limit_polynomial_creep;
+  component_c.load_limit_polynomial_loadstrain =
+      component.load_limit_polynomial_loadstrain;
+  component_c.modulus_compression_elastic_area =
+      component.modulus_compression_elastic_area;
+  component_c.modulus_tension_elastic_area =
+      component.modulus_tension_elastic_area;
+  component_c.num_coefficients_polynomial_creep =
+      component.coefficients_polynomial_creep.size();
+  component_c.num_coefficients_polynomial_loadstrain =
+      component.coefficients_polynomial_loadstrain.size();
+}
+
+/// \brief Finishes a result after the conversion stages have run.
+/// \param[in] converter
+///   The converter.
+/// \param[in] is_converted
+///   An indicator that tells if the conversion succeeded.
+/// \param[in,out] result
+///   The result.
+void FinishResult(const CableConverter& converter, const bool& is_converted,
+                  OtlsCfcResult& result) {
+  CableConverter::Conversion& conversion = result.conversion;
+  result.is_converted = is_converted;
+  if (is_converted == false) {
+    result.message = conversion.message.ToUTF8().data();
+    conversion.buffer.clear();
+    return;
+  }
+
+  // binary input keeps its own unit system
+  const Cable& cable = conversion.cable;
+  units::UnitSystem units = converter.units();
+  if (conversion.is_binary == true) {
+    units = conversion.units;
+  }
+
+  result.name = cable.name;
+  OtlsCfcCable& cable_c = result.cable;
+  cable_c.area_physical = cable.area_physical;
+  CopyComponent(cable.component_core, cable_c.component_core);
+  CopyComponent(cable.component_shell, cable_c.component_shell);
+  cable_c.diameter = cable.diameter;
+  cable_c.name = result.name.c_str();
+  cable_c.strength_rated = cable.strength_rated;
+  cable_c.temperature_properties_components =
+      cable.temperature_properties_components;
+  cable_c.units = (units == units::UnitSystem::kMetric)
+                  ? OTLS_CFC_UNITS_METRIC : OTLS_CFC_UNITS_IMPERIAL;
+  cable_c.weight_unit = cable.weight_unit;
+}
+
+/// \brief Copies a message to a caller buffer.
+/// \param[in] str
+///   The message.
+/// \param[out] buffer
+///   The buffer, or a nullptr.
+/// \param[in] size
+///   The buffer size, including the terminator.
+void CopyMessage(const wxString& str, char* buffer, const size_t& size) {
+  if ((buffer == nullptr) || (size == 0)) {
+    return;
+  }
+
+  const std::string message(str.ToUTF8().data());
+  const size_t length = (message.size() < size) ? message.size() : size - 1;
+  std::memcpy(buffer, message.data(), length);
+  buffer[length] = '\0';
+}
+
+/// \brief Runs a function on a thread that can have its own log target.
+/// \param[in] converter
+///   The converter, whose helper thread is used.
+/// \param[in] function
+///   The function, which is run before this returns.
+/// wxWidgets ignores thread log targets on its main thread, so a call from
+/// that thread is run on the helper thread of the converter instead of
+/// swapping the process log target, which would capture the messages of every
+/// other thread.
+template <typename Function>
+void RunOffMain(const OtlsCfcConverter& converter, const Function& function) {
+  if (wxThread::IsMain() == true) {
+    converter.helper.Run(function);
+  } else {
+    function();
+  }
+}
+
+/// \brief Creates an empty result.
+/// \return The result, or a nullptr if it could not be allocated.
+OtlsCfcResult* CreateResult() {
+  OtlsCfcResult* result = new (std::nothrow) OtlsCfcResult();
+  if (result == nullptr) {
+    return nullptr;
+  }
+
+  std::memset(&result->cable, 0, sizeof(result->cable));
+  result->is_converted = false;
+  return result;
+}
+
+}  // namespace
+
+void otls_cfc_options_init(OtlsCfcOptions* options) {
+  if (options == nullptr) {
+    return;
+  }
+
+  options->format = OTLS_CFC_FORMAT_XML;
+  options->is_compact = 0;
+  options->plugins = nullptr;
+  options->strain_percent_polynomial_limits = -1;
+  options->tolerance_polynomial_limits = -1;
+  options->units = OTLS_CFC_UNITS_IMPERIAL;
+}
+
+OtlsCfcConverter* otls_cfc_converter_create(const OtlsCfcOptions* options,
+                                            char* message,
+                                            size_t size_message) {
+  OtlsCfcOptions options_default;
+  otls_cfc_options_init(&options_default);
+  if (options == nullptr) {
+    options = &options_default;
+  }
+
+  // validates the options
+  if ((options->format != OTLS_CFC_FORMAT_XML)
+      && (options->format != OTLS_CFC_FORMAT_BINARY)) {
+    CopyMessage("Invalid format.", message, size_message);
+    return nullptr;
+  }
+
+  if ((options->units != OTLS_CFC_UNITS_IMPERIAL)
+      && (options->units != OTLS_CFC_UNITS_METRIC)) {
+    CopyMessage("Invalid units.", message, size_message);
+    return nullptr;
+  }
+
+  // a zero or negative tolerance selects the scan
+  if ((0 < options->tolerance_polynomial_limits)
+      && (options->tolerance_polynomial_limits
+          < CablePolynomialSearcher::kToleranceMin)) {
+    CopyMessage("Invalid limit tolerance.", message, size_message);
+    return nullptr;
+  }
+
+  // the wxWidgets base library is reference counted, so it is initialized
+  // for each converter, and is only cleaned up with the last one
+  if (wxInitialize() == false) {
+    CopyMessage("Could not initialize wxWidgets.", message, size_message);
+    return nullptr;
+  }
+
+  OtlsCfcConverter* converter = new (std::nothrow) OtlsCfcConverter();
+  if (converter == nullptr) {
+    wxUninitialize();
+    CopyMessage("Could not allocate the converter.", message, size_message);
+    return nullptr;
+  }
+
+  // loads the parser plugins, capturing the load errors
+  if (options->plugins != nullptr) {
+    std::string diagnostics;
+    bool status = false;
+    RunOffMain(*converter, [&]() {
+      DiagnosticLog log(&diagnostics);
+      const wxString filepath = wxString::FromUTF8(options->plugins);
+      if (wxFileName::DirExists(filepath) == true) {
+        status = converter->parser_registry.LoadPlugins(filepath);
+      } else {
+        status = converter->parser_registry.LoadPlugin(filepath);
+      }
+    });
+
+    if (status == false) {
+      delete converter;
+      wxUninitialize();
+      CopyMessage("Invalid parser plugins. " + wxString::FromUTF8(
+                      diagnostics.c_str()), message, size_message);
+      return nullptr;
+    }
+    converter->converter.set_parser_registry(&converter->parser_registry);
+  }
+
+  // applies the options
+  CableConverter& cable_converter = converter->converter;
+  cable_converter.set_cache_polynomial_limits(
+      &converter->cache_polynomial_limits);
+  cable_converter.set_format(options->format == OTLS_CFC_FORMAT_BINARY
+                             ? CableConverter::Format::kBinary
+                             : CableConverter::Format::kXml);
+  cable_converter.set_is_compact(options->is_compact != 0);
+  cable_converter.set_strain_percent_polynomial_limits(
+      options->strain_percent_polynomial_limits);
+  cable_converter.set_tolerance_polynomial_limits(
+      options->tolerance_polynomial_limits);
+  cable_converter.set_units(options->units == OTLS_CFC_UNITS_METRIC
+                            ? units::UnitSystem::kMetric
+                            : units::UnitSystem::kImperial);
+
+  return converter;
+}
+
+void otls_cfc_converter_destroy(OtlsCfcConverter* converter) {
+  if (converter == nullptr) {
+    return;
+  }
+
+  delete converter;
+  wxUninitialize();
+}
+
+OtlsCfcResult* otls_cfc_convert_buffer(const OtlsCfcConverter* converter,
+                                       const char* name, const void* data,
+                                       size_t size) {
+  OtlsCfcResult* result = CreateResult();
+  if (result == nullptr) {
+    return nullptr;
+  }
+
+  if ((converter == nullptr) || ((data == nullptr) && (size != 0))) {
+    result->message = "Invalid converter or input.";
+    return result;
+  }
+
+  bool status = false;
+  RunOffMain(*converter, [&]() {
+    DiagnosticLog log(&result->diagnostics);
+    const wxString name_input =
+        (name == nullptr) ? wxString("input") : wxString::FromUTF8(name);
+    const TextView input(static_cast<const char*>(data), size);
+    status = converter->converter.ConvertBuffer(name_input, input,
+                                                result->conversion);
+  });
+
+  FinishResult(converter->converter, status, *result);
+  return result;
+}
+
+OtlsCfcResult* otls_cfc_convert_file(const OtlsCfcConverter* converter,
+                                     const char* filepath) {
+  OtlsCfcResult* result = CreateResult();
+  if (result == nullptr) {
+    return nullptr;
+  }
+
+  if ((converter == nullptr) || (filepath == nullptr)) {
+    result->message = "Invalid converter or input filepath.";
+    return result;
+  }
+
+  // runs the same stages as ConvertToBuffer(), keeping the solved cable
+  bool status = false;
+  RunOffMain(*converter, [&]() {
+    DiagnosticLog log(&result->diagnostics);
+    const CableConverter& cable_converter = converter->converter;
+    CableConverter::Conversion& conversion = result->conversion;
+    CableConverter::Begin(wxString::FromUTF8(filepath), false, conversion);
+    status = (cable_converter.Read(conversion) == true)
+             && (cable_converter.Parse(conversion) == true)
+             && (cable_converter.Solve(conversion) == true)
+             && (cable_converter.Serialize(conversion) == true);
+  });
+
+  FinishResult(converter->converter, status, *result);
+  return result;
+}
+
+void otls_cfc_result_destroy(OtlsCfcResult* result) {
+  delete result;
+}
+
+const OtlsCfcCable* otls_cfc_result_cable(const OtlsCfcResult* result) {
+  if ((result == nullptr) || (result->is_converted == false)) {
+    return nullptr;
+  }
+  return &result->cable;
+}
+
+const char* otls_cfc_result_diagnostics(const OtlsCfcResult* result) {
+  if (result == nullptr) {
+    return "";
+  }
+  return result->diagnostics.c_str();
+}
+
+int otls_cfc_result_is_converted(const OtlsCfcResult* result) {
+  if (result == nullptr) {
+    return 0;
+  }
+  return (result->is_converted == true) ? 1 : 0;
+}
+
+const char* otls_cfc_result_message(const OtlsCfcResult* result) {
+  if (result == nullptr) {
+    return "Invalid result.";
+  }
+  return result->message.c_str();
+}
+
+const char* otls_cfc_result_output(const OtlsCfcResult* result,
+                                   size_t* size) {
+  if (result == nullptr) {
+    if (size != nullptr) {
+      *size = 0;
+    }
+    return "";
+  }
+
+  if (size != nullptr) {
+    *size = result->conversion.buffer.size();
+  }
+  return result->conversion.buffer.c_str();
+}
@@ -3,33 +3,36 @@
 
 #include "cable_file_converter_app.h"
 
-#include "appcommon/units/cable_unit_converter.h"
+#include <csignal>
+#include <map>
+#include <string>
+#include <vector>
+
 #include "wx/filename.h"
 #include "wx/stdpaths.h"
-#include "wx/xml/xml.h"
 
-#include "cable_file_xml_handler.h"
+#include "async_log_sink.h"
+#include "batch_converter.h"
+#include "cable_library_reader.h"
+#include "cable_library_writer.h"
 #include "cable_polynomial_searcher.h"
+#include "conversion_server.h"
+#include "record_converter.h"
+#include "watch_converter.h"
 
-/// \brief Parses a cable file.
-/// \param[in] filepath
-///   The relative or absolute filepath to open and parse.
-/// \param[out] units
-///   The unit system that is populated.
-/// \param[out] cable
-///   The cable that is populated.
-/// \return The status of the file parsing. A true return flag means that no
-///   errors were encountered.
-/// This function is declared here (globally) so a custom parser can be added
-/// onto the project in a modular way. The source code in this class does not
-/// need modified. Instead, create an external file with a matching function
-/// definition. Add the external file to the build process and the linker will
-/// make the connection.
-extern bool ParseCableFile(const wxString& filepath, units::UnitSystem& units,
-                           Cable& cable);
+IMPLEMENT_APP(CableFileConverterApp)
 
+namespace {
 
-IMPLEMENT_APP(CableFileConverterApp)
+/// \brief Stops the watch or server when the process is interrupted.
+/// \param[in] signal
+///   The signal number, which is not used.
+void OnSignalStop(int /*signal*/) {
+  ConversionServer::RequestStop();
+  WatchConverter::RequestStop();
+}
+
+}  // namespace
 
 CableFileConverterApp::CableFileConverterApp() {
 }
@@ -44,24 +47,272 @@ bool CableFileConverterApp::OnCmdLineParsed(wxCmdLineParser& parser) {
     wxLog::SetVerbose(true);
   }
 
+  if (parser.Found("batch")) {
+    is_batch_ = true;
+  }
+
+  if (parser.Found("watch")) {
+    is_watch_ = true;
+  }
+
+  if ((is_batch_ == true) && (is_watch_ == true)) {
+    wxLogError("The batch and watch switches can't be combined. Exiting.");
+    return false;
+  }
+
+  if (parser.Found("records")) {
+    if ((is_batch_ == true) || (is_watch_ == true)) {
+      wxLogError("The records switch can't be combined with the batch or "
+                 "watch switches. Exiting.");
+      return false;
+    }
+    is_records_ = true;
+  }
+
+  if (parser.Found("library")) {
+    if ((is_batch_ == false) && (is_records_ == false)) {
+      wxLogError("The library switch requires the batch or records switch. "
+                 "Exiting.");
+      return false;
+    }
+    is_library_ = true;
+  }
+
+  if (parser.Found("extract")) {
+    if ((is_batch_ == true) || (is_watch_ == true) || (is_records_ == true)) {
+      wxLogError("The extract switch can't be combined with the batch, "
+                 "records, or watch switches. Exiting.");
+      return false;
+    }
+    is_extract_ = true;
+  }
+
+  if (parser.Found("compact")) {
+    converter_.set_is_compact(true);
+  }
+
+  if (parser.Found("alloc-stats")) {
+    is_alloc_stats_ = true;
+  }
+
   // captures the command line options
   wxString option_str;
   double option_num;
+  long option_long;
   if (parser.Found("strain", &option_num) == true) {
-    strain_percent_polynomial_limits_ = option_num;
+    converter_.set_strain_percent_polynomial_limits(option_num);
   } else if (parser.Found("units", &option_str) == true) {
     if (option_str == "imperial") {
-      units_ = units::UnitSystem::kImperial;
+      converter_.set_units(units::UnitSystem::kImperial);
     } else if (option_str == "metric") {
-      units_ = units::UnitSystem::kMetric;
+      converter_.set_units(units::UnitSystem::kMetric);
     } else {
       wxLogError("Invalid units option. Exiting.");
       return false;
     }
   }
 
+  if (parser.Found("cable", &option_str) == true) {
+    if (is_extract_ == false) {
+      wxLogError("The cable option requires the extract switch. Exiting.");
+      return false;
+    }
+    name_cable_ = option_str;
+  }
+
+  if (parser.Found("format", &option_str) == true) {
+    if (option_str == "xml") {
+      converter_.set_format(CableConverter::Format::kXml);
+    } else if (option_str == "bin") {
+      converter_.set_format(CableConverter::Format::kBinary);
+    } else {
+      wxLogError("Invalid format option. Exiting.");
+      return false;
+    }
+  }
+
+  if (parser.Found("limit-tolerance", &option_num) == true) {
+    if (option_num < CablePolynomialSearcher::kToleranceMin) {
+      wxLogError("Invalid limit tolerance option. Exiting.");
+      return false;
+    }
+    converter_.set_tolerance_polynomial_limits(option_num);
+  }
+
+  if (parser.Found("limit-cache", &option_str) == true) {
+    filepath_cache_ = option_str;
+  }
+
+  if (parser.Found("limit-cache-size", &option_long) == true) {
+    if (option_long < 1) {
+      wxLogError("Invalid limit cache size option. Exiting.");
+      return false;
+    }
+    cache_polynomial_limits_.set_size_max(
+        static_cast<std::size_t>(option_long));
+  }
+
+  if (parser.Found("manifest", &option_str) == true) {
+    if (is_library_ == true) {
+      wxLogError("The manifest option can't be combined with the library "
+                 "switch. Exiting.");
+      return false;
+    }
+    filepath_manifest_ = option_str;
+  }
+
+  if (parser.Found("metrics-file", &option_str) == true) {
+    filepath_metrics_ = option_str;
+  }
+
+  if (parser.Found("metrics-interval", &option_num) == true) {
+    if (filepath_metrics_.empty() == true) {
+      wxLogError("The metrics interval option requires the metrics file "
+                 "option. Exiting.");
+      return false;
+    }
+
+    if (option_num <= 0) {
+      wxLogError("Invalid metrics interval option. Exiting.");
+      return false;
+    }
+    seconds_metrics_ = option_num;
+  }
+
+  if (parser.Found("jobs", &option_long) == true) {
+    if (option_long < 1) {
+      wxLogError("Invalid jobs option. Exiting.");
+      return false;
+    }
+    num_jobs_ = static_cast<int>(option_long);
+  }
+
+  if (parser.Found("pipeline", &option_str) == true) {
+    if (is_batch_ == false) {
+      wxLogError("The pipeline option requires the batch switch. Exiting.");
+      return false;
+    }
+
+    if (num_jobs_ != -1) {
+      wxLogError("The pipeline option can't be combined with the jobs "
+                 "option. Exiting.");
+      return false;
+    }
+
+    if (BatchConverter::ParsePipeline(option_str.ToStdString(), pipeline_)
+        == false) {
+      wxLogError("Invalid pipeline option. Exiting.");
+      return false;
+    }
+    is_pipeline_ = true;
+  }
+
+  if (parser.Found("queue-depth", &option_long) == true) {
+    if (is_pipeline_ == false) {
+      wxLogError("The queue depth option requires the pipeline option. "
+                 "Exiting.");
+      return false;
+    }
+
+    if (option_long < 1) {
+      wxLogError("Invalid queue depth option. Exiting.");
+      return false;
+    }
+    pipeline_.depth_queue = static_cast<int>(option_long);
+  }
+
+  if (parser.Found("plugins", &option_str) == true) {
+    filepath_plugins_ = option_str;
+  }
+
+  if (parser.Found("serve", &option_str) == true) {
+    if ((is_batch_ == true) || (is_watch_ == true) || (is_extract_ == true)
+        || (is_records_ == true)) {
+      wxLogError("The serve option can't be combined with the batch, watch, "
+                 "extract, or records switches. Exiting.");
+      return false;
+    }
+    filepath_socket_ = option_str;
+  }
+
+  if (parser.Found("strain-sweep", &option_str) == true) {
+    if ((is_library_ == true) || (is_extract_ == true)
+        || (filepath_socket_.empty() == false)) {
+      wxLogError("The strain sweep option can't be combined with the library "
+                 "or extract switches, or the serve option. Exiting.");
+      return false;
+    }
+
+    CableLimitTable::Range range;
+    if (CableLimitTable::ParseRange(option_str.ToStdString(), range)
+        == false) {
+      wxLogError("Invalid strain sweep option. Exiting.");
+      return false;
+    }
+    converter_.set_strain_sweep(range);
+  }
+
+  if (parser.Found("sweep-format", &option_str) == true) {
+    if (option_str == "csv") {
+      converter_.set_format_limit_table(CableLimitTable::Format::kCsv);
+    } else if (option_str == "json") {
+      converter_.set_format_limit_table(CableLimitTable::Format::kJson);
+    } else {
+      wxLogError("Invalid sweep format option. Exiting.");
+      return false;
+    }
+  }
+
+  if (parser.Found("trace", &option_str) == true) {
+    filepath_trace_ = option_str;
+  }
+
+  if (parser.Found("output-io", &option_str) == true) {
+    if (option_str == "auto") {
+      output_writer_.backend = OutputWriter::Backend::kAuto;
+    } else if (option_str == "posix") {
+      output_writer_.backend = OutputWriter::Backend::kPosix;
+    } else if (option_str == "uring") {
+      output_writer_.backend = OutputWriter::Backend::kIoUring;
+    } else {
+      wxLogError("Invalid output I/O option. Exiting.");
+      return false;
+    }
+    is_output_writer_ = true;
+  }
+
+  if (parser.Found("fsync", &option_str) == true) {
+    if (option_str == "none") {
+      output_writer_.sync = OutputWriter::SyncPolicy::kNone;
+    } else if (option_str == "file") {
+      output_writer_.sync = OutputWriter::SyncPolicy::kPerFile;
+    } else if (option_str == "batch") {
+      output_writer_.sync = OutputWriter::SyncPolicy::kPerBatch;
+    } else {
+      wxLogError("Invalid fsync option. Exiting.");
+      return false;
+    }
+    is_output_writer_ = true;
+  }
+
+  // the output writer only writes cable files to the output directory
+  if ((is_output_writer_ == true)
+      && ((is_library_ == true) || (is_extract_ == true)
+          || (is_watch_ == true) || (filepath_socket_.empty() == false))) {
+    wxLogError("The output I/O and fsync options can't be combined with the "
+               "library, extract, or watch switches, or the serve option. "
+               "Exiting.");
+    return false;
+  }
+
   // captures the command line parameters
-  if (parser.GetParamCount() == 2) {
+  // the server gets its input and output files from the requests
+  if (filepath_socket_.empty() == false) {
+    if (parser.GetParamCount() != 0) {
+      wxLogError("Invalid number of parameters. Exiting.");
+      return false;
+    }
+  } else if (parser.GetParamCount() == 2) {
     filepath_input_ = parser.GetParam(0);
     filepath_output_ = parser.GetParam(1);
   } else {
@@ -74,10 +325,31 @@ bool CableFileConverterApp::OnCmdLineParsed(wxCmdLineParser& parser) {
 
 bool CableFileConverterApp::OnInit() {
   // initializes variables
+  filepath_cache_ = "";
   filepath_input_ = "";
+  filepath_manifest_ = "";
+  filepath_metrics_ = "";
   filepath_output_ = "";
-  strain_percent_polynomial_limits_ = -1;
-  units_ = units::UnitSystem::kImperial;
+  filepath_plugins_ = "";
+  filepath_socket_ = "";
+  filepath_trace_ = "";
+  is_alloc_stats_ = false;
+  is_batch_ = false;
+  is_extract_ = false;
+  is_library_ = false;
+  is_output_writer_ = false;
+  is_pipeline_ = false;
+  is_records_ = false;
+  is_watch_ = false;
+  name_cable_ = "";
+  num_jobs_ = -1;
+  seconds_metrics_ = 10;
+  output_writer_.backend = OutputWriter::Backend::kAuto;
+  output_writer_.sync = OutputWriter::SyncPolicy::kNone;
+  pipeline_.depth_queue = 4;
+  for (int i = 0; i < BatchConverter::kNumStages; i++) {
+    pipeline_.num_threads[i] = 1;
+  }
 
   // redirects log to a file in the executable directory
   wxFileName filepath(wxStandardPaths::Get().GetExecutablePath());
@@ -85,10 +357,12 @@ bool CableFileConverterApp::OnInit() {
   filepath.SetExt("log");
   wxString str_filepath = filepath.GetFullPath();
 
-  FILE* file_log;
-  file_log = fopen(str_filepath.c_str(), "a");
-  wxLogStderr* log = new wxLogStderr(file_log);
-  wxLog::SetActiveTarget(log);
+  AsyncLogSink* log = new AsyncLogSink();
+  if (log->Open(str_filepath) == true) {
+    delete wxLog::SetActiveTarget(log);
+  } else {
+    delete log;
+  }
 
   // initializes command line
   if (wxAppConsole::OnInit() == false) {
@@ -110,66 +384,328 @@ void CableFileConverterApp::OnInitCmdLine(wxCmdLineParser& parser) {
 }
 
 int CableFileConverterApp::OnRun() {
+  // loads the polynomial limit cache
+  converter_.set_cache_polynomial_limits(&cache_polynomial_limits_);
+  if ((filepath_cache_.empty() == false)
+      && (wxFileName::FileExists(filepath_cache_) == true)) {
+    wxLogVerbose("Loading polynomial limit cache: " + filepath_cache_);
+    cache_polynomial_limits_.Load(filepath_cache_.ToStdString());
+  }
+
+  // loads the parser plugins
+  if (filepath_plugins_.empty() == false) {
+    wxLogVerbose("Loading parser plugins: " + filepath_plugins_);
+    bool status = false;
+    if (wxFileName::DirExists(filepath_plugins_) == true) {
+      status = parser_registry_.LoadPlugins(filepath_plugins_);
+    } else {
+      status = parser_registry_.LoadPlugin(filepath_plugins_);
+    }
+
+    if (status == false) {
+      wxLogError("Invalid parser plugins. Exiting.");
+      return 0;
+    }
+    converter_.set_parser_registry(&parser_registry_);
+  }
+
+  // enables tracing, which also records the allocations of each stage
+  if ((filepath_trace_.empty() == false) || (is_alloc_stats_ == true)) {
+    converter_.set_trace_recorder(&trace_recorder_);
+  }
+
+  // enables the output writer
+  if (is_output_writer_ == true) {
+    wxLogVerbose("Output writer: "
+                 + OutputWriter::NameBackend(output_writer_.backend)
+                 + ", fsync " + OutputWriter::NameSync(output_writer_.sync));
+    converter_.set_output_writer(&output_writer_);
+  }
+
+  // counts metrics, and saves them periodically while converting
+  if (filepath_metrics_.empty() == false) {
+    wxLogVerbose("Saving metrics file: " + filepath_metrics_);
+    converter_.set_metrics(&metrics_);
+    metrics_.StartSaving(filepath_metrics_, seconds_metrics_);
+  }
+
+  // converts files
+  {
+    TraceSpan span(converter_.trace_recorder(), "Run", filepath_input_);
+    if (is_batch_ == true) {
+      RunBatch();
+    } else if (is_extract_ == true) {
+      RunExtract();
+    } else if (is_records_ == true) {
+      RunRecords();
+    } else if (is_watch_ == true) {
+      RunWatch();
+    } else if (filepath_socket_.empty() == false) {
+      RunServer();
+    } else {
+      RunSingle();
+    }
+  }
+
+  // saves the final metrics
+  if ((filepath_metrics_.empty() == false)
+      && (metrics_.StopSaving() == false)) {
+    wxLogWarning("Could not save metrics file: " + filepath_metrics_ + ".");
+  }
+
+  // logs the output writer syscalls and throughput
+  if (is_output_writer_ == true) {
+    OutputWriter::LogTotals();
+  }
+
+  // saves the trace
+  if (filepath_trace_.empty() == false) {
+    trace_recorder_.LogSummary();
+    wxLogVerbose("Saving trace file: " + filepath_trace_);
+    if (trace_recorder_.Save(filepath_trace_) == false) {
+      wxLogWarning("Could not save trace file: " + filepath_trace_ + ".");
+    }
+  }
+
+  // logs the allocations of each stage
+  if (is_alloc_stats_ == true) {
+    trace_recorder_.LogAllocationSummary();
+  }
+
+  // saves the polynomial limit cache
+  cache_polynomial_limits_.LogStatistics();
+  if (filepath_cache_.empty() == false) {
+    wxLogVerbose("Saving polynomial limit cache: " + filepath_cache_);
+    if (cache_polynomial_limits_.Save(filepath_cache_.ToStdString())
+        == false) {
+      wxLogWarning("Could not save polynomial limit cache: "
+                   + filepath_cache_ + ".");
+    }
+  }
+
+  // exits application
+  return 0;
+}
+
+void CableFileConverterApp::RunBatch() {
+  BatchConverter batch(&converter_);
+
+  // opens the manifest
+  if (filepath_manifest_.empty() == false) {
+    wxLogVerbose("Opening conversion manifest: " + filepath_manifest_);
+    if (manifest_.Open(filepath_manifest_.ToStdString()) == false) {
+      wxLogError("Invalid conversion manifest: " + filepath_manifest_
+                 + ". Exiting.");
+      return;
+    }
+    batch.set_manifest(&manifest_);
+  }
+
+  // opens the library, which replaces the output directory
+  CableLibraryWriter library;
+  if (is_library_ == true) {
+    wxLogVerbose("Opening cable library: " + filepath_output_);
+    if (library.Open(filepath_output_) == false) {
+      wxLogError("Invalid cable library: " + filepath_output_ + ". Exiting.");
+      return;
+    }
+    batch.set_library(&library);
+  }
+
+  // runs the files through the pipeline stages
+  if (is_pipeline_ == true) {
+    batch.set_pipeline(&pipeline_);
+  }
+
+  // converts all files in the input directory
+  if (batch.Run(filepath_input_, filepath_output_, num_jobs_) == false) {
+    wxLogError("Batch conversion could not be started. Exiting.");
+    return;
+  }
+
+  batch.LogSummary();
+
+  // writes the library index
+  if ((is_library_ == true) && (library.Close() == false)) {
+    wxLogError("Could not save cable library: " + filepath_output_ + ".");
+  }
+
+  // saves the manifest
+  if (filepath_manifest_.empty() == false) {
+    wxLogVerbose("Saving conversion manifest: " + filepath_manifest_);
+    if (manifest_.Save() == false) {
+      wxLogWarning("Could not save conversion manifest: "
+                   + filepath_manifest_ + ".");
+    }
+  }
+}
+
+void CableFileConverterApp::RunExtract() {
+  // opens the library
+  CableLibraryReader library;
   wxString message;
+  if (library.Open(filepath_input_, message) == false) {
+    wxLogError(message + " Exiting.");
+    return;
+  }
 
-  // validates input file
-  if (wxFileName::Exists(filepath_input_) == false) {
-    wxLogError("Invalid input filepath. Exiting.");
-    return 0;
+  // validates output directory
+  if (wxFileName::DirExists(filepath_output_) == false) {
+    wxLogError("Invalid output directory. Exiting.");
+    return;
+  }
+
+  if (wxFileName::IsDirWritable(filepath_output_) == false) {
+    wxLogError("Insufficient permissions for output directory: "
+               + filepath_output_ + ". Exiting.");
+    return;
+  }
+
+  // selects the cables
+  std::vector<const CableLibraryReader::Entry*> entries;
+  if (name_cable_.empty() == false) {
+    const CableLibraryReader::Entry* entry =
+        library.Find(std::string(name_cable_.ToUTF8().data()));
+    if (entry == nullptr) {
+      wxLogError("Cable is not in the library: " + name_cable_
+                 + ". Exiting.");
+      return;
+    }
+    entries.push_back(entry);
+  } else {
+    for (auto iter = library.entries().cbegin();
+         iter != library.entries().cend(); iter++) {
+      entries.push_back(&(*iter));
+    }
+  }
+
+  // finds the cables that have the same output file (ex: sources 'a.txt'
+  // and 'a.csv'), which are not extracted, as neither could be told apart
+  // from the other afterwards
+  const bool is_case_sensitive = wxFileName::IsCaseSensitive();
+  std::map<wxString, int> counts_output;
+  for (auto iter = entries.cbegin(); iter != entries.cend(); iter++) {
+    const wxString filepath =
+        library.FilePathExtract(**iter, filepath_output_);
+    counts_output[is_case_sensitive ? filepath : filepath.Lower()]++;
+  }
+
+  // extracts the cables
+  int num_failed = 0;
+  for (auto iter = entries.cbegin(); iter != entries.cend(); iter++) {
+    const wxString filepath_extract =
+        library.FilePathExtract(**iter, filepath_output_);
+    if (1 < counts_output[is_case_sensitive ? filepath_extract
+                                            : filepath_extract.Lower()]) {
+      wxLogMessage("Failed: " + wxString::FromUTF8((*iter)->name.c_str())
+                   + "  --  Output file is shared with another cable: "
+                   + filepath_extract + ".");
+      num_failed++;
+      continue;
+    }
+
+    wxString filepath;
+    if (library.Extract(**iter, filepath_output_, filepath, message)
+        == true) {
+      wxLogVerbose("Extracted: " + filepath);
+    } else {
+      wxLogMessage("Failed: " + wxString::FromUTF8((*iter)->name.c_str())
+                   + "  --  " + message);
+      num_failed++;
+    }
   }
 
+  message.clear();
+  message << "Extract summary: "
+          << static_cast<int>(entries.size()) - num_failed << " extracted, "
+          << num_failed << " failed.";
+  wxLogMessage(message);
+}
+
+void CableFileConverterApp::RunRecords() {
+  RecordConverter records(&converter_);
+
+  // opens the library, which replaces the output directory
+  CableLibraryWriter library;
+  if (is_library_ == true) {
+    wxLogVerbose("Opening cable library: " + filepath_output_);
+    if (library.Open(filepath_output_) == false) {
+      wxLogError("Invalid cable library: " + filepath_output_ + ". Exiting.");
+      return;
+    }
+    records.set_library(&library);
+  }
+
+  // converts all records in the input file
+  if (records.Run(filepath_input_, filepath_output_, num_jobs_) == false) {
+    wxLogError("Record conversion could not be started. Exiting.");
+    return;
+  }
+
+  records.LogSummary();
+
+  // writes the library index
+  if ((is_library_ == true) && (library.Close() == false)) {
+    wxLogError("Could not save cable library: " + filepath_output_ + ".");
+  }
+}
+
+void CableFileConverterApp::RunServer() {
+  ConversionServer server(&converter_);
+
+  // stops the server on ctrl-c or a terminate request, so the caches and trace
+  // are still saved
+  std::signal(SIGINT, OnSignalStop);
+  std::signal(SIGTERM, OnSignalStop);
+
+  if (server.Run(filepath_socket_, num_jobs_) == false) {
+    wxLogError("Server could not be started. Exiting.");
+  }
+
+  std::signal(SIGINT, SIG_DFL);
+  std::signal(SIGTERM, SIG_DFL);
+}
+
+void CableFileConverterApp::RunSingle() {
   // validates output file directory
   wxFileName filename(filepath_output_);
   if (wxFileName::DirExists(filename.GetPath()) == false) {
     wxLogError("Invalid output directory. Exiting.");
-    return 0;
+    return;
   }
 
   if (wxFileName::IsDirWritable(filename.GetPath()) == false) {
     wxLogError("Insufficient permissions for output directory: "
                + filename.GetPath() + ". Exiting.");
-    return 0;
+    return;
   }
 
-  // initializes data to be filled when parsing occurs
-  Cable cable;
-  units::UnitSystem units = units::UnitSystem::kNull;
-
-  // parses input file
-  // the cable should be in 'consistent' units after parsing is finished
-  wxLogVerbose("Parsing input file: " + filepath_input_);
-  if (ParseCableFile(filepath_input_, units, cable) == false) {
-    wxLogError("Parsing errors were encountered. Exiting.");
-    return 0;
-  }
-
-  // converts from file to app unit system if necessary
-  if (units_ != units) {
-    CableUnitConverter::ConvertUnitSystem(units, units_, true, cable);
+  // converts the input file
+  wxString message;
+  const bool is_converted = converter_.Convert(filepath_input_,
+                                               filepath_output_, message);
+  if (converter_.metrics() != nullptr) {
+    converter_.metrics()->AddFile(is_converted);
   }
 
-  // searches for the polynomial limits
-  wxLogVerbose("Solving for polynomial limits.");
-  if (CablePolynomialSearcher::SolveLimits(strain_percent_polynomial_limits_,
-                                           cable) == false) {
-    wxLogError("Limit searching errors were encountered. Exiting.");
-    return 0;
+  if (is_converted == false) {
+    wxLogError(message + " Exiting.");
+    return;
   }
+}
 
-  // converts to 'different' unit style
-  CableUnitConverter::ConvertUnitStyleToDifferent(units, true, cable);
+void CableFileConverterApp::RunWatch() {
+  WatchConverter watch(&converter_);
 
-  // generates output file
-  // the file version is set to 0, as this has to be defined uniquely by the
-  // app that uses it
-  wxLogVerbose("Saving output file: " + filepath_output_);
-  wxXmlNode* root = CableFileXmlHandler::CreateNode(
-      cable, "", units::UnitSystem::kImperial, units::UnitStyle::kDifferent);
+  // stops the watch on ctrl-c or a terminate request, so the caches and trace
+  // are still saved
+  std::signal(SIGINT, OnSignalStop);
+  std::signal(SIGTERM, OnSignalStop);
 
-  wxXmlDocument doc;
-  doc.SetRoot(root);
-  doc.Save(filepath_output_, 2);
+  if (watch.Run(filepath_input_, filepath_output_, num_jobs_) == false) {
+    wxLogError("Watch could not be started. Exiting.");
+  }
 
-  // exits application
-  return 0;
+  std::signal(SIGINT, SIG_DFL);
+  std::signal(SIGTERM, SIG_DFL);
 }
@@ -5,6 +5,8 @@
 
 #include "appcommon/xml/cable_xml_handler.h"
 
+#include "cable_xml_template.h"
+
 wxXmlNode* CableFileXmlHandler::CreateNode(
     const Cable& cable,
     const std::string& name,
@@ -45,3 +47,39 @@ bool CableFileXmlHandler::ParseNode(
     Cable& cable) {
   // parsing isn't needed for this app
 }
+
+void CableFileXmlHandler::WriteNode(
+    const Cable& cable,
+    const std::string& name,
+    const units::UnitSystem& system_units,
+    const units::UnitStyle& style_units,
+    XmlStreamWriter& writer) {
+  // writes the cable file root element
+  writer.StartElement("cable_file");
+  writer.AddAttribute("version", "0");
+
+  if (system_units == units::UnitSystem::kImperial) {
+    writer.AddAttribute("units", "Imperial");
+  } else if (system_units == units::UnitSystem::kMetric) {
+    writer.AddAttribute("units", "Metric");
+  }
+
+  if (name != "") {
+    writer.AddAttribute("name", name);
+  }
+
+  // writes the cable node from its template, or replays the node from the
+  // common handler if it has no template
+  const CableXmlTemplate* node_template =
+      CableXmlTemplate::Find(cable, name, system_units, style_units);
+  if (node_template != nullptr) {
+    node_template->Write(cable, writer);
+  } else {
+    wxXmlNode* node_element = CableXmlHandler::CreateNode(
+        cable, name, system_units, style_units);
+    writer.WriteNode(node_element);
+    delete node_element;
+  }
+
+  writer.EndElement();
+}
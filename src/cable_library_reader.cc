@@ -0,0 +1,261 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "cable_library_reader.h"
+
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include "wx/filename.h"
+
+#include "cable_binary_handler.h"
+
+namespace {
+
+static_assert(sizeof(CableLibraryReader::Header) == 16,
+              "The library header layout changed.");
+static_assert(sizeof(CableLibraryReader::IndexEntry) == 32,
+              "The library index entry layout changed.");
+static_assert(sizeof(CableLibraryReader::Footer) == 48,
+              "The library footer layout changed.");
+
+/// \brief Rounds a size up to an 8 byte boundary.
+/// \param[in] size
+///   The size.
+/// \return The padded size.
+uint64_t Pad(const uint64_t& size) {
+  return (size + 7) / 8 * 8;
+}
+
+}  // namespace
+
+const char CableLibraryReader::kMagic[8] = {'O', 'T', 'L', 'S', 'L', 'I', 'B',
+                                            '\x1a'};
+
+CableLibraryReader::CableLibraryReader() {
+}
+
+CableLibraryReader::~CableLibraryReader() {
+}
+
+void CableLibraryReader::Close() {
+  entries_.clear();
+  names_.clear();
+  sources_.clear();
+  file_.Close();
+}
+
+bool CableLibraryReader::Extract(const Entry& entry,
+                                 const wxString& dir_output,
+                                 wxString& filepath_output,
+                                 wxString& message) const {
+  TextView data;
+  if (Fetch(entry, data, message) == false) {
+    return false;
+  }
+
+  filepath_output = FilePathExtract(entry, dir_output);
+
+  std::FILE* file = std::fopen(filepath_output.mb_str(), "wb");
+  if (file == nullptr) {
+    message = "Could not write output file: " + filepath_output + ".";
+    return false;
+  }
+
+  const bool is_written =
+      std::fwrite(data.data(), 1, data.size(), file) == data.size();
+  if ((std::fclose(file) != 0) || (is_written == false)) {
+    message = "Could not write output file: " + filepath_output + ".";
+    return false;
+  }
+
+  return true;
+}
+
+bool CableLibraryReader::Fetch(const Entry& entry, TextView& data,
+                               wxString& message) const {
+  // the entry range was validated when the index was read
+  data = file_.contents().substr(static_cast<std::size_t>(entry.offset),
+                                 static_cast<std::size_t>(entry.size));
+  if (CableBinaryHandler::Checksum(data.data(), data.size())
+      != entry.checksum) {
+    data = TextView();
+    message = "Library entry checksum does not match: "
+              + wxString::FromUTF8(entry.name.c_str()) + ".";
+    return false;
+  }
+
+  return true;
+}
+
+wxString CableLibraryReader::FilePathExtract(
+    const Entry& entry, const wxString& dir_output) const {
+  // splits the record number from the source of a multi-record file
+  std::string source = entry.source;
+  std::string suffix;
+  const std::size_t pos = source.rfind('#');
+  if (pos != std::string::npos) {
+    suffix = "_" + source.substr(pos + 1);
+    source.erase(pos);
+  }
+
+  wxFileName filename(dir_output,
+                      wxFileName(wxString::FromUTF8(source.c_str())).GetName()
+                      + wxString::FromUTF8(suffix.c_str()));
+
+  // the extension only depends on the file signature, which the entry range
+  // always contains
+  const TextView data = file_.contents().substr(
+      static_cast<std::size_t>(entry.offset),
+      static_cast<std::size_t>(entry.size));
+  if (CableBinaryHandler::IsBinary(data) == true) {
+    filename.SetExt("cablebin");
+  } else {
+    filename.SetExt("cable");
+  }
+
+  return filename.GetFullPath();
+}
+
+const CableLibraryReader::Entry* CableLibraryReader::Find(
+    const std::string& name) const {
+  auto iter = names_.find(name);
+  if (iter == names_.end()) {
+    return nullptr;
+  }
+
+  return &entries_[iter->second];
+}
+
+const CableLibraryReader::Entry* CableLibraryReader::FindSource(
+    const std::string& source) const {
+  auto iter = sources_.find(source);
+  if (iter == sources_.end()) {
+    return nullptr;
+  }
+
+  return &entries_[iter->second];
+}
+
+bool CableLibraryReader::Open(const wxString& filepath, wxString& message) {
+  Close();
+
+  if (file_.Open(filepath) == false) {
+    message = "Could not read library: " + filepath + ".";
+    return false;
+  }
+
+  uint64_t offset_index = 0;
+  if (ReadIndex(file_.contents(), entries_, offset_index, message) == false) {
+    Close();
+    return false;
+  }
+
+  names_.reserve(entries_.size());
+  sources_.reserve(entries_.size());
+  for (std::size_t i = 0; i < entries_.size(); i++) {
+    // keeps the first entry for duplicate names
+    names_.insert(std::make_pair(entries_[i].name, i));
+    sources_[entries_[i].source] = i;
+  }
+
+  return true;
+}
+
+bool CableLibraryReader::ReadIndex(const TextView& data,
+                                   std::vector<Entry>& entries,
+                                   uint64_t& offset_index,
+                                   wxString& message) {
+  entries.clear();
+  offset_index = 0;
+
+  const uint16_t value = 1;
+  unsigned char byte;
+  std::memcpy(&byte, &value, 1);
+  if (byte != 1) {
+    message = "Cable libraries are only supported on little endian "
+              "platforms.";
+    return false;
+  }
+
+  // validates the header and footer
+  if (data.size() < sizeof(Header) + sizeof(Footer)) {
+    message = "Invalid cable library.";
+    return false;
+  }
+
+  Header header;
+  std::memcpy(&header, data.data(), sizeof(header));
+  Footer footer;
+  std::memcpy(&footer, data.data() + data.size() - sizeof(footer),
+              sizeof(footer));
+  if ((std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+      || (std::memcmp(footer.magic, kMagic, sizeof(kMagic)) != 0)) {
+    message = "Invalid cable library.";
+    return false;
+  }
+
+  if ((header.version != kVersion) || (footer.version != kVersion)) {
+    message = "Unsupported cable library version.";
+    return false;
+  }
+
+  const uint64_t size_data = data.size() - sizeof(Footer);
+  if ((footer.offset_index < sizeof(Header))
+      || (size_data < footer.offset_index)
+      || (footer.size_index != size_data - footer.offset_index)
+      || (footer.size_index / sizeof(IndexEntry) < footer.num_entries)) {
+    message = "Invalid cable library footer.";
+    return false;
+  }
+
+  const char* index = data.data() + footer.offset_index;
+  if (CableBinaryHandler::Checksum(index, footer.size_index)
+      != footer.checksum_index) {
+    message = "Cable library index checksum does not match.";
+    return false;
+  }
+
+  // reads the index entries
+  entries.resize(static_cast<std::size_t>(footer.num_entries));
+  uint64_t pos = 0;
+  for (auto iter = entries.begin(); iter != entries.end(); iter++) {
+    IndexEntry record;
+    if ((footer.size_index < pos)
+        || (footer.size_index - pos < sizeof(record))) {
+      entries.clear();
+      message = "Invalid cable library index.";
+      return false;
+    }
+    std::memcpy(&record, index + pos, sizeof(record));
+    pos += sizeof(record);
+
+    const uint64_t size_strings =
+        static_cast<uint64_t>(record.size_name) + record.size_source;
+    if ((footer.size_index - pos < size_strings)
+        || (record.offset < sizeof(Header))
+        || (footer.offset_index < record.offset)
+        || (footer.offset_index - record.offset < record.size)) {
+      entries.clear();
+      message = "Invalid cable library index.";
+      return false;
+    }
+
+    Entry& entry = *iter;
+    entry.checksum = record.checksum;
+    entry.name.assign(index + pos, record.size_name);
+    entry.offset = record.offset;
+    entry.size = record.size;
+    entry.source.assign(index + pos + record.size_name, record.size_source);
+    pos = Pad(pos + size_strings);
+  }
+
+  offset_index = footer.offset_index;
+  return true;
+}
+
+const std::vector<CableLibraryReader::Entry>&
+    CableLibraryReader::entries() const {
+  return entries_;
+}
@@ -0,0 +1,268 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "cable_library_writer.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "wx/filename.h"
+
+#include "cable_binary_handler.h"
+#include "mapped_file.h"
+
+namespace {
+
+/// The padding that aligns cable files and index entries to 8 bytes.
+const char kPadding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+/// \brief Rounds a size up to an 8 byte boundary.
+/// \param[in] size
+///   The size.
+/// \return The padded size.
+uint64_t Pad(const uint64_t& size) {
+  return (size + 7) / 8 * 8;
+}
+
+/// \brief Flushes a file and syncs it to disk.
+/// \param[in] file
+///   The file.
+/// \return If the file was synced.
+bool Sync(std::FILE* file) {
+  if (std::fflush(file) != 0) {
+    return false;
+  }
+#ifdef _WIN32
+  return _commit(_fileno(file)) == 0;
+#else
+  return fsync(fileno(file)) == 0;
+#endif
+}
+
+}  // namespace
+
+CableLibraryWriter::CableLibraryWriter() {
+  file_ = nullptr;
+  is_failed_ = false;
+  offset_end_ = 0;
+}
+
+CableLibraryWriter::~CableLibraryWriter() {
+  Close();
+}
+
+bool CableLibraryWriter::Add(const std::string& name,
+                             const std::string& source,
+                             const std::string& data,
+                             wxString& message) {
+  // the checksum is calculated before locking, so workers only wait on the
+  // write
+  CableLibraryReader::Entry entry;
+  entry.checksum = CableBinaryHandler::Checksum(data.data(), data.size());
+  entry.name = name;
+  entry.size = data.size();
+  entry.source = source;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (file_ == nullptr) {
+    message = "The cable library is not open.";
+    return false;
+  }
+
+  if (is_failed_ == true) {
+    message = "A previous write to the cable library failed: " + filepath_
+              + ".";
+    return false;
+  }
+
+  // offset_end_ is always 8 byte aligned, so only the tail is padded
+  // a partial write leaves the file position unknown, so the library is
+  // failed and is not committed when it is closed
+  entry.offset = offset_end_;
+  const std::size_t size_padding =
+      static_cast<std::size_t>(Pad(data.size()) - data.size());
+  if ((std::fwrite(data.data(), 1, data.size(), file_) != data.size())
+      || (std::fwrite(kPadding, 1, size_padding, file_) != size_padding)) {
+    is_failed_ = true;
+    message = "Could not write to cable library: " + filepath_ + ".";
+    return false;
+  }
+  offset_end_ += data.size() + size_padding;
+
+  // replaces the entry from the same source
+  auto iter = sources_.find(source);
+  if (iter != sources_.end()) {
+    entries_[iter->second] = entry;
+  } else {
+    sources_[source] = entries_.size();
+    entries_.push_back(entry);
+  }
+
+  return true;
+}
+
+bool CableLibraryWriter::Close() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (file_ == nullptr) {
+    return true;
+  }
+
+  // builds the index
+  std::string index;
+  for (auto iter = entries_.cbegin(); iter != entries_.cend(); iter++) {
+    const CableLibraryReader::Entry& entry = *iter;
+
+    CableLibraryReader::IndexEntry record;
+    std::memset(&record, 0, sizeof(record));
+    record.offset = entry.offset;
+    record.size = entry.size;
+    record.checksum = entry.checksum;
+    record.size_name = static_cast<uint32_t>(entry.name.size());
+    record.size_source = static_cast<uint32_t>(entry.source.size());
+
+    index.append(reinterpret_cast<const char*>(&record), sizeof(record));
+    index.append(entry.name);
+    index.append(entry.source);
+    index.resize(static_cast<std::size_t>(Pad(index.size())), '\0');
+  }
+
+  CableLibraryReader::Footer footer;
+  std::memset(&footer, 0, sizeof(footer));
+  footer.offset_index = offset_end_;
+  footer.size_index = index.size();
+  footer.num_entries = entries_.size();
+  footer.checksum_index = CableBinaryHandler::Checksum(index.data(),
+                                                       index.size());
+  footer.version = CableLibraryReader::kVersion;
+  std::memcpy(footer.magic, CableLibraryReader::kMagic,
+              sizeof(CableLibraryReader::kMagic));
+
+  // writes and syncs the index and footer, and replaces the library with the
+  // temporary file, unless a cable file could not be written
+  bool status = (is_failed_ == false)
+      && (std::fwrite(index.data(), 1, index.size(), file_) == index.size())
+      && (std::fwrite(&footer, 1, sizeof(footer), file_) == sizeof(footer))
+      && (Sync(file_) == true);
+  if (std::fclose(file_) != 0) {
+    status = false;
+  }
+
+  if (status == true) {
+    status = wxRenameFile(filepath_temp_, filepath_, true);
+  }
+
+  if (status == false) {
+    wxRemoveFile(filepath_temp_);
+    wxLogError("Could not write cable library index: " + filepath_ + ".");
+  } else {
+    wxString message;
+    message << "Cable library entries: " << entries_.size();
+    wxLogVerbose(message);
+  }
+
+  file_ = nullptr;
+  entries_.clear();
+  is_failed_ = false;
+  sources_.clear();
+  offset_end_ = 0;
+
+  return status;
+}
+
+bool CableLibraryWriter::Open(const wxString& filepath) {
+  Close();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  filepath_ = filepath;
+
+  // the library is built in a hidden temporary file, and replaces the library
+  // in one rename when it is closed, so the library on disk is always valid
+  const wxFileName filename(filepath);
+  filepath_temp_ =
+      wxFileName(filename.GetPath(), "." + filename.GetFullName() + ".tmp")
+          .GetFullPath();
+
+  file_ = std::fopen(filepath_temp_.mb_str(), "wb");
+  if (file_ == nullptr) {
+    wxLogError("Could not create cable library: " + filepath + ".");
+    return false;
+  }
+
+  // writes the header
+  CableLibraryReader::Header header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, CableLibraryReader::kMagic,
+              sizeof(CableLibraryReader::kMagic));
+  header.version = CableLibraryReader::kVersion;
+  if (std::fwrite(&header, 1, sizeof(header), file_) != sizeof(header)) {
+    wxLogError("Could not create cable library: " + filepath + ".");
+    std::fclose(file_);
+    file_ = nullptr;
+    wxRemoveFile(filepath_temp_);
+    return false;
+  }
+
+  offset_end_ = sizeof(header);
+
+  if (wxFileName::FileExists(filepath) == false) {
+    return true;
+  }
+
+  // copies only the cable files that the index of the existing library
+  // references, so cable files that were replaced are dropped and the
+  // library doesn't grow with each run
+  uint64_t offset_index = 0;
+  wxString message;
+  MappedFile file;
+  bool status = file.Open(filepath);
+  if (status == false) {
+    message = "Could not read cable library:";
+  } else {
+    status = CableLibraryReader::ReadIndex(file.contents(), entries_,
+                                           offset_index, message);
+  }
+
+  for (auto iter = entries_.begin();
+       (status == true) && (iter != entries_.end()); iter++) {
+    CableLibraryReader::Entry& entry = *iter;
+    const std::size_t size = static_cast<std::size_t>(entry.size);
+    const std::size_t size_padding =
+        static_cast<std::size_t>(Pad(entry.size) - entry.size);
+    const char* data = file.contents().data() + entry.offset;
+    if ((std::fwrite(data, 1, size, file_) != size)
+        || (std::fwrite(kPadding, 1, size_padding, file_) != size_padding)) {
+      status = false;
+      message = "Could not copy cable library:";
+      break;
+    }
+
+    entry.offset = offset_end_;
+    offset_end_ += size + size_padding;
+  }
+
+  if (status == false) {
+    wxLogError(message + " " + filepath);
+    std::fclose(file_);
+    file_ = nullptr;
+    wxRemoveFile(filepath_temp_);
+    entries_.clear();
+    offset_end_ = 0;
+    return false;
+  }
+
+  for (std::size_t i = 0; i < entries_.size(); i++) {
+    sources_[entries_[i].source] = i;
+  }
+
+  return true;
+}
+
+std::size_t CableLibraryWriter::num_entries() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
@@ -0,0 +1,346 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "cable_limit_table.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "models/base/helper.h"
+#include "models/sagtension/sag_tension_cable.h"
+
+#include "simd_support.h"
+
+namespace {
+
+/// \brief Appends a string with JSON escaping.
+/// \param[in] str
+///   The UTF-8 encoded string.
+/// \param[in,out] buffer
+///   The buffer.
+void AppendJsonString(const std::string& str, std::string& buffer) {
+  buffer += '"';
+  for (auto iter = str.cbegin(); iter != str.cend(); iter++) {
+    const char c = *iter;
+    if ((c == '"') || (c == '\\')) {
+      buffer += '\\';
+      buffer += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      buffer += escaped;
+    } else {
+      buffer += c;
+    }
+  }
+  buffer += '"';
+}
+
+/// \brief Appends a JSON array member.
+/// \param[in] name
+///   The member name.
+/// \param[in] values
+///   The values.
+/// \param[in] format
+///   The printf format of each value.
+/// \param[in,out] buffer
+///   The buffer.
+void AppendJsonArray(const char* name, const std::vector<double>& values,
+                     const char* format, std::string& buffer) {
+  char str[64];
+  buffer += "  \"";
+  buffer += name;
+  buffer += "\": [";
+  for (std::size_t i = 0; i < values.size(); i++) {
+    if (i != 0) {
+      buffer += ", ";
+    }
+    snprintf(str, sizeof(str), format, values[i]);
+    buffer += str;
+  }
+  buffer += "]";
+}
+
+/// \brief Calculates the powers of each strain.
+/// \param[in] strains
+///   The percent strains.
+/// \param[in] num_powers
+///   The number of powers, starting at zero.
+/// \param[out] powers
+///   The powers. The strains of each power are stored together, so power i of
+///   strain j is at (i * number of strains + j).
+/// Each power is calculated with pow(), the same as Polynomial::Y, so each
+/// polynomial term is identical to it. The powers are shared by every
+/// polynomial of the cable.
+void SolvePowers(const std::vector<double>& strains,
+                 const std::size_t& num_powers, std::vector<double>& powers) {
+  const std::size_t num = strains.size();
+  powers.resize(num_powers * num);
+  for (std::size_t i = 0; i < num_powers; i++) {
+    for (std::size_t j = 0; j < num; j++) {
+      powers[i * num + j] = std::pow(strains[j], static_cast<double>(i));
+    }
+  }
+}
+
+/// \brief Evaluates a polynomial at each strain using scalar code.
+/// \param[in] coefficients
+///   The polynomial coefficients, in increasing order of power.
+/// \param[in] powers
+///   The powers of the strains (see SolvePowers).
+/// \param[in] pos
+///   The index of the first strain to evaluate.
+/// \param[in] num
+///   The number of strains.
+/// \param[out] y
+///   The polynomial values.
+/// The terms are summed in increasing order of power, the same as
+/// Polynomial::Y, so the values are identical to it.
+void EvaluateScalar(const std::vector<double>& coefficients,
+                    const double* powers, const std::size_t& pos,
+                    const std::size_t& num, double* y) {
+  const std::size_t num_coefficients = coefficients.size();
+  for (std::size_t j = pos; j < num; j++) {
+    double value = 0;
+    for (std::size_t i = 0; i < num_coefficients; i++) {
+      value = value + coefficients[i] * powers[i * num + j];
+    }
+    y[j] = value;
+  }
+}
+
+#ifdef OTLS_SIMD_AVX2
+
+/// \brief Evaluates a polynomial at four strains at a time using AVX2.
+/// \param[in] coefficients
+///   The polynomial coefficients, in increasing order of power.
+/// \param[in] powers
+///   The powers of the strains (see SolvePowers).
+/// \param[in] num
+///   The number of strains.
+/// \param[out] y
+///   The polynomial values.
+/// \return The number of strains that were evaluated, which is a multiple of
+///   four. The remaining strains must be evaluated with scalar code.
+/// The multiply and add are separate instructions, so each lane rounds the
+/// same as the scalar code.
+OTLS_TARGET_AVX2
+std::size_t EvaluateAvx2(const std::vector<double>& coefficients,
+                         const double* powers, const std::size_t& num,
+                         double* y) {
+  const std::size_t num_coefficients = coefficients.size();
+  std::size_t j = 0;
+  for (; j + 4 <= num; j += 4) {
+    __m256d value = _mm256_setzero_pd();
+    for (std::size_t i = 0; i < num_coefficients; i++) {
+      const __m256d power = _mm256_loadu_pd(powers + i * num + j);
+      value = _mm256_add_pd(
+          value, _mm256_mul_pd(_mm256_set1_pd(coefficients[i]), power));
+    }
+    _mm256_storeu_pd(y + j, value);
+  }
+  return j;
+}
+
+#endif  // OTLS_SIMD_AVX2
+
+/// \brief Solves the limits of a polynomial at each strain.
+/// \param[in] coefficients
+///   The polynomial coefficients, in increasing order of power.
+/// \param[in] is_enabled
+///   An indicator that tells if the component is enabled. If not, the limits
+///   are zero.
+/// \param[in] powers
+///   The powers of the strains (see SolvePowers), which must include every
+///   power of the polynomial.
+/// \param[in] num
+///   The number of strains.
+/// \param[out] limits
+///   The limits, rounded the same as SolveLimits.
+void SolveColumn(const std::vector<double>& coefficients,
+                 const bool& is_enabled, const std::vector<double>& powers,
+                 const std::size_t& num, std::vector<double>& limits) {
+  limits.assign(num, 0);
+  if (is_enabled == false) {
+    return;
+  }
+
+  std::size_t pos = 0;
+#ifdef OTLS_SIMD_AVX2
+  if (CableLimitTable::IsVectorized() == true) {
+    pos = EvaluateAvx2(coefficients, powers.data(), num, limits.data());
+  }
+#endif
+  EvaluateScalar(coefficients, powers.data(), pos, num, limits.data());
+
+  for (std::size_t i = 0; i < num; i++) {
+    limits[i] = helper::Round(limits[i], 1);
+  }
+}
+
+}  // namespace
+
+CableLimitTable::CableLimitTable() {
+}
+
+CableLimitTable::~CableLimitTable() {
+}
+
+wxString CableLimitTable::Extension(const Format& format) {
+  if (format == Format::kJson) {
+    return "limits.json";
+  } else {
+    return "limits.csv";
+  }
+}
+
+bool CableLimitTable::IsVectorized() {
+  return simd::IsAvx2Supported();
+}
+
+bool CableLimitTable::ParseRange(const std::string& str, Range& range) {
+  double values[3];
+  const char* pos = str.c_str();
+  for (int i = 0; i < 3; i++) {
+    char* end = nullptr;
+    values[i] = std::strtod(pos, &end);
+    if ((end == pos) || (std::isfinite(values[i]) == false)) {
+      return false;
+    }
+
+    // the values are separated by colons, and the last one ends the string
+    const char separator = (i < 2) ? ':' : '\0';
+    if (*end != separator) {
+      return false;
+    }
+    pos = end + 1;
+  }
+
+  range.start = values[0];
+  range.stop = values[1];
+  range.step = values[2];
+
+  if ((range.step <= 0) || (range.stop < range.start)) {
+    return false;
+  }
+
+  return (range.stop - range.start) / range.step < kNumStrainsMax;
+}
+
+bool CableLimitTable::Solve(const Cable& cable, const Range& range) {
+  strains_.clear();
+  name_ = cable.name;
+
+  if ((range.step <= 0) || (range.stop < range.start)
+      || (kNumStrainsMax <= (range.stop - range.start) / range.step)) {
+    return false;
+  }
+
+  // each strain is calculated from the start, so steps don't accumulate
+  // rounding errors, and a stop that is a whole number of steps is included
+  const std::size_t num = static_cast<std::size_t>(
+      std::floor((range.stop - range.start) / range.step + 1e-9)) + 1;
+  strains_.resize(num);
+  for (std::size_t i = 0; i < num; i++) {
+    strains_[i] = range.start + range.step * static_cast<double>(i);
+  }
+
+  // determines which components are enabled, the same as SolveLimits
+  SagTensionCable cable_sagtension;
+  cable_sagtension.set_cable_base(&cable);
+  const bool is_enabled_core =
+      cable_sagtension.IsEnabled(SagTensionCable::ComponentType::kCore);
+  const bool is_enabled_shell =
+      cable_sagtension.IsEnabled(SagTensionCable::ComponentType::kShell);
+
+  // calculates the strain powers once for all of the polynomials
+  const std::vector<double>* polynomials[4] = {
+      &cable.component_core.coefficients_polynomial_creep,
+      &cable.component_core.coefficients_polynomial_loadstrain,
+      &cable.component_shell.coefficients_polynomial_creep,
+      &cable.component_shell.coefficients_polynomial_loadstrain};
+  std::size_t num_powers = 0;
+  for (int i = 0; i < 4; i++) {
+    num_powers = std::max(num_powers, polynomials[i]->size());
+  }
+
+  std::vector<double> powers;
+  SolvePowers(strains_, num_powers, powers);
+
+  SolveColumn(*polynomials[0], is_enabled_core, powers, num,
+              limits_core_creep_);
+  SolveColumn(*polynomials[1], is_enabled_core, powers, num,
+              limits_core_loadstrain_);
+  SolveColumn(*polynomials[2], is_enabled_shell, powers, num,
+              limits_shell_creep_);
+  SolveColumn(*polynomials[3], is_enabled_shell, powers, num,
+              limits_shell_loadstrain_);
+
+  return true;
+}
+
+void CableLimitTable::Write(const Format& format,
+                            const units::UnitSystem& units,
+                            std::string& buffer) const {
+  buffer.clear();
+
+  if (format == Format::kJson) {
+    buffer.reserve(200 + strains_.size() * 60);
+    buffer += "{\n  \"cable\": ";
+    AppendJsonString(name_, buffer);
+    buffer += ",\n  \"units\": ";
+    if (units == units::UnitSystem::kMetric) {
+      buffer += "\"metric\"";
+    } else {
+      buffer += "\"imperial\"";
+    }
+    buffer += ",\n";
+    AppendJsonArray("strain_percent", strains_, "%.10g", buffer);
+    buffer += ",\n";
+    AppendJsonArray("core_creep", limits_core_creep_, "%.1f", buffer);
+    buffer += ",\n";
+    AppendJsonArray("core_loadstrain", limits_core_loadstrain_, "%.1f",
+                    buffer);
+    buffer += ",\n";
+    AppendJsonArray("shell_creep", limits_shell_creep_, "%.1f", buffer);
+    buffer += ",\n";
+    AppendJsonArray("shell_loadstrain", limits_shell_loadstrain_, "%.1f",
+                    buffer);
+    buffer += "\n}\n";
+    return;
+  }
+
+  // writes csv
+  buffer.reserve(80 + strains_.size() * 50);
+  buffer += "strain_percent,core_creep,core_loadstrain,shell_creep,"
+            "shell_loadstrain\n";
+  char str[160];
+  for (std::size_t i = 0; i < strains_.size(); i++) {
+    snprintf(str, sizeof(str), "%.10g,%.1f,%.1f,%.1f,%.1f\n", strains_[i],
+             limits_core_creep_[i], limits_core_loadstrain_[i],
+             limits_shell_creep_[i], limits_shell_loadstrain_[i]);
+    buffer += str;
+  }
+}
+
+const std::vector<double>& CableLimitTable::limits_core_creep() const {
+  return limits_core_creep_;
+}
+
+const std::vector<double>& CableLimitTable::limits_core_loadstrain() const {
+  return limits_core_loadstrain_;
+}
+
+const std::vector<double>& CableLimitTable::limits_shell_creep() const {
+  return limits_shell_creep_;
+}
+
+const std::vector<double>& CableLimitTable::limits_shell_loadstrain() const {
+  return limits_shell_loadstrain_;
+}
+
+const std::vector<double>& CableLimitTable::strains() const {
+  return strains_;
+}
@@ -3,12 +3,299 @@
 
 #include "cable_polynomial_searcher.h"
 
+#include <algorithm>
 #include <limits>
+#include <vector>
 
 #include "models/base/helper.h"
 #include "models/sagtension/sag_tension_cable.h"
 #include "wx/wx.h"
 
+#include "polynomial_batch_searcher.h"
+#include "polynomial_kernel.h"
+
+namespace {
+
+/// The number of polynomial limits that could not be solved on the thread.
+thread_local int64_t num_limits_unsolved = 0;
+
+/// \brief Evaluates a polynomial using Horner's method.
+/// \param[in] coefficients
+///   The polynomial coefficients, in increasing order of power.
+/// \param[in] x
+///   The x value.
+/// \return The y value.
+double Evaluate(const std::vector<double>& coefficients, const double& x) {
+  double y = 0;
+  for (auto iter = coefficients.crbegin(); iter != coefficients.crend();
+       iter++) {
+    y = y * x + *iter;
+  }
+  return y;
+}
+
+/// \brief Gets the derivative of a polynomial.
+/// \param[in] coefficients
+///   The polynomial coefficients, in increasing order of power.
+/// \return The derivative polynomial coefficients.
+std::vector<double> Derivative(const std::vector<double>& coefficients) {
+  std::vector<double> derivative;
+  for (std::size_t i = 1; i < coefficients.size(); i++) {
+    derivative.push_back(coefficients.at(i) * i);
+  }
+  return derivative;
+}
+
+/// \brief Bisects an interval that contains a sign change.
+/// \param[in] coefficients
+///   The polynomial coefficients.
+/// \param[in] x_low
+///   The low x value.
+/// \param[in] x_high
+///   The high x value.
+/// \param[in] tolerance
+///   The x tolerance.
+/// \return The low x value of the final interval. The y value at this point
+///   has the same sign as the y value at the original low x value.
+/// The bisection also stops if the interval can't be split any further, so a
+/// tolerance below the spacing of doubles near the root still ends.
+double Bisect(const std::vector<double>& coefficients, double x_low,
+              double x_high, const double& tolerance) {
+  const bool is_negative_low = Evaluate(coefficients, x_low) < 0;
+  while (tolerance < (x_high - x_low)) {
+    const double x_mid = (x_low + x_high) / 2;
+    if ((x_mid == x_low) || (x_mid == x_high)) {
+      break;
+    }
+
+    if ((Evaluate(coefficients, x_mid) < 0) == is_negative_low) {
+      x_low = x_mid;
+    } else {
+      x_high = x_mid;
+    }
+  }
+  return x_low;
+}
+
+/// \brief Solves for the real roots of a polynomial within an interval.
+/// \param[in] coefficients
+///   The polynomial coefficients.
+/// \param[in] x_min
+///   The minimum x value.
+/// \param[in] x_max
+///   The maximum x value.
+/// \param[in] tolerance
+///   The x tolerance.
+/// \return The roots, in increasing order.
+/// The roots of the derivative split the interval into monotonic segments,
+/// which can contain at most one root each. The derivative roots are solved
+/// recursively, so any polynomial degree is supported.
+std::vector<double> Roots(const std::vector<double>& coefficients,
+                          const double& x_min, const double& x_max,
+                          const double& tolerance) {
+  std::vector<double> roots;
+
+  // a constant has no isolated roots
+  std::size_t size = coefficients.size();
+  while ((0 < size) && (coefficients.at(size - 1) == 0)) {
+    size--;
+  }
+  if (size <= 1) {
+    return roots;
+  }
+
+  const std::vector<double> polynomial(coefficients.cbegin(),
+                                       coefficients.cbegin() + size);
+
+  // gets the monotonic segment boundaries
+  std::vector<double> bounds = Roots(Derivative(polynomial), x_min, x_max,
+                                     tolerance);
+  bounds.insert(bounds.begin(), x_min);
+  bounds.push_back(x_max);
+
+  // bisects each segment that has a sign change
+  for (std::size_t i = 1; i < bounds.size(); i++) {
+    const double x_low = bounds.at(i - 1);
+    const double x_high = bounds.at(i);
+    if ((Evaluate(polynomial, x_low) < 0)
+        != (Evaluate(polynomial, x_high) < 0)) {
+      roots.push_back(Bisect(polynomial, x_low, x_high, tolerance));
+    }
+  }
+
+  return roots;
+}
+
+/// \brief Solves for the first point where a polynomial becomes negative.
+/// \param[in] coefficients
+///   The polynomial coefficients.
+/// \param[in] x_min
+///   The minimum x value.
+/// \param[in] x_max
+///   The maximum x value.
+/// \param[in] tolerance
+///   The x tolerance.
+/// \return The last x value (within tolerance) before the polynomial becomes
+///   negative. If the polynomial never becomes negative, the maximum x value
+///   is returned.
+double XFirstNegative(const std::vector<double>& coefficients,
+                      const double& x_min, const double& x_max,
+                      const double& tolerance) {
+  if (Evaluate(coefficients, x_min) < 0) {
+    return x_min;
+  }
+
+  // gets the monotonic segment boundaries
+  std::vector<double> bounds = Roots(Derivative(coefficients), x_min, x_max,
+                                     tolerance);
+  bounds.push_back(x_max);
+
+  // finds the first segment that ends negative
+  double x_low = x_min;
+  for (auto iter = bounds.cbegin(); iter != bounds.cend(); iter++) {
+    const double x_high = *iter;
+    if (Evaluate(coefficients, x_high) < 0) {
+      return Bisect(coefficients, x_low, x_high, tolerance);
+    }
+    x_low = x_high;
+  }
+
+  return x_max;
+}
+
+/// \brief Scans a polynomial at discrete points for an inflection.
+/// \param[in] kernel
+///   The polynomial kernel.
+/// \param[in] x_min
+///   The minimum x value.
+/// \param[in] x_step
+///   The x step increase between calculation points.
+/// \param[in] x_max
+///   The maximum x value.
+/// \return The limit point.
+template<typename Kernel>
+Point2d<double> ScanByInflection(const Kernel& kernel,
+                                 const double& x_min,
+                                 const double& x_step,
+                                 const double& x_max) {
+  // initializes x, y, and slope values
+  double x1 = -999999;
+  double y1 = -999999;
+
+  double x2 = x_min;
+  double y2;
+  double s;
+  kernel.Evaluate(x2, y2, s);
+
+  // initializes counters
+  unsigned int i = 0;
+  const unsigned int i_max = std::numeric_limits<unsigned int>::max();
+
+  // starts searching polynomial at discrete points
+  while (x2 <= x_max) {
+    // calculates new x values
+    x1 = x2;
+    x2 += x_step;
+
+    // calculates new y values
+    y1 = y2;
+    kernel.Evaluate(x2, y2, s);
+
+    // checks that y value is increasing
+    if (y2 < y1) {
+      break;
+    }
+
+    // increments
+    i++;
+    if (i_max <= i) {
+      break;
+    }
+  }
+
+  // returns value
+  Point2d<double> point;
+  if (i < i_max) {
+    point.x = x1;
+    point.y = y1;
+  }
+  return point;
+}
+
+/// \brief Scans a polynomial at discrete points for a slope that is outside
+///   of the min/max boundaries.
+/// \param[in] kernel
+///   The polynomial kernel.
+/// \param[in] x_min
+///   The minimum x value.
+/// \param[in] x_step
+///   The x step increase between calculation points.
+/// \param[in] x_max
+///   The maximum x value.
+/// \param[in] slope_min
+///   The minimum allowable slope.
+/// \param[in] slope_max
+///   The maximum allowable slope.
+/// \return The limit point.
+template<typename Kernel>
+Point2d<double> ScanBySlope(const Kernel& kernel,
+                            const double& x_min,
+                            const double& x_step,
+                            const double& x_max,
+                            const double& slope_min,
+                            const double& slope_max) {
+  // initializes x, y, and slope values
+  double x1 = -999999;
+  double y1 = -999999;
+
+  double x2 = x_min;
+  double y2;
+  double s = -999999;
+  kernel.Evaluate(x2, y2, s);
+
+  // initializes counters
+  unsigned int i = 0;
+  const unsigned int i_max = std::numeric_limits<unsigned int>::max();
+
+  // start searching polynomial at discrete points
+  while (x2 <= x_max) {
+    // calculates new x values
+    x1 = x2;
+    x2 += x_step;
+
+    // calculates new y and slope values
+    y1 = y2;
+    kernel.Evaluate(x2, y2, s);
+
+    // checks against min/max
+    if (s < slope_min) {
+      break;
+    }
+
+    if (slope_max < s) {
+      break;
+    }
+
+    // increments
+    i++;
+    if (i_max <= i) {
+      break;
+    }
+  }
+
+  // returns value
+  Point2d<double> point;
+  if (i < i_max) {
+    point.x = x1;
+    point.y = y1;
+  }
+  return point;
+}
+
+}  // namespace
+
+const double CablePolynomialSearcher::kToleranceMin = 1e-12;
+
 CablePolynomialSearcher::CablePolynomialSearcher() {
 }
 
@@ -19,6 +306,14 @@ CablePolynomialSearcher::~CablePolynomialSearcher() {
 /// polynomial units are used for searching (% strain, virtual stress).
 bool CablePolynomialSearcher::SolveLimits(const double& strain_percent,
                                           Cable& cable) {
+  return SolveLimits(strain_percent, SearchType::kScan, 0, nullptr, cable);
+}
+
+bool CablePolynomialSearcher::SolveLimits(const double& strain_percent,
+                                          const SearchType& type_search,
+                                          const double& tolerance,
+                                          PolynomialLimitCache* cache,
+                                          Cable& cable) {
   // creates a sag-tension cable to help determine which components are enabled
   SagTensionCable cable_sagtension;
   cable_sagtension.set_cable_base(&cable);
@@ -41,7 +336,8 @@ bool CablePolynomialSearcher::SolveLimits(const double& strain_percent,
         &cable.component_core.coefficients_polynomial_creep);
 
     if (strain_percent == -1) {
-      limit = PointLimit(polynomial, "core creep", slope_min, slope_max);
+      limit = PointLimit(polynomial, "core creep", slope_min, slope_max,
+                         type_search, tolerance, cache);
     } else {
       limit.x = strain_percent;
       limit.y = polynomial.Y(strain_percent);
@@ -56,7 +352,7 @@ bool CablePolynomialSearcher::SolveLimits(const double& strain_percent,
 
     if (strain_percent == -1) {
       limit = PointLimit(polynomial, "core stress-strain",
-                         slope_min, slope_max);
+                         slope_min, slope_max, type_search, tolerance, cache);
     } else {
       limit.x = strain_percent;
       limit.y = polynomial.Y(strain_percent);
@@ -82,7 +378,8 @@ bool CablePolynomialSearcher::SolveLimits(const double& strain_percent,
         &cable.component_shell.coefficients_polynomial_creep);
 
     if (strain_percent == -1) {
-      limit = PointLimit(polynomial, "shell creep", slope_min, slope_max);
+      limit = PointLimit(polynomial, "shell creep", slope_min, slope_max,
+                         type_search, tolerance, cache);
     } else {
       limit.x = strain_percent;
       limit.y = polynomial.Y(strain_percent);
@@ -97,7 +394,7 @@ bool CablePolynomialSearcher::SolveLimits(const double& strain_percent,
 
     if (strain_percent == -1) {
       limit = PointLimit(polynomial, "shell stress-strain",
-                         slope_min, slope_max);
+                         slope_min, slope_max, type_search, tolerance, cache);
     } else {
       limit.x = strain_percent;
       limit.y = polynomial.Y(strain_percent);
@@ -116,45 +413,205 @@ bool CablePolynomialSearcher::SolveLimits(const double& strain_percent,
   return true;
 }
 
+bool CablePolynomialSearcher::SolveLimits(const double& strain_percent,
+                                          const double& tolerance,
+                                          PolynomialLimitCache* cache,
+                                          const std::vector<Cable*>& cables) {
+  // evaluates fixed strain limits directly, as no searching is needed
+  if (strain_percent != -1) {
+    bool status = true;
+    for (auto iter = cables.begin(); iter != cables.end(); iter++) {
+      if (SolveLimits(strain_percent, **iter) == false) {
+        status = false;
+      }
+    }
+    return status;
+  }
+
+  // maps a polynomial to its cable limit, which is either cached or searched
+  // by the batch searcher
+  struct LimitTarget {
+    int index;
+    PolynomialLimitCache::Key key;
+    Point2d<double> limit;
+    std::string name;
+    double* load_limit;
+  };
+
+  // adds all enabled component polynomials that are not cached to the batch
+  // searcher
+  PolynomialBatchSearcher searcher;
+  std::vector<LimitTarget> targets;
+  auto add = [&](const std::vector<double>& coefficients,
+                 const double& slope_min, const double& slope_max,
+                 const std::string& name, double* load_limit) {
+    LimitTarget target;
+    target.index = -1;
+    target.name = name;
+    target.load_limit = load_limit;
+    if (cache != nullptr) {
+      // the key matches the single cable scan, so both share results
+      target.key.coefficients = coefficients;
+      target.key.slope_max = slope_max;
+      target.key.slope_min = slope_min;
+      target.key.tolerance = tolerance;
+      target.key.type_search = static_cast<int>(SearchType::kScan);
+      if (cache->Find(target.key, target.limit) == true) {
+        targets.push_back(target);
+        return;
+      }
+    }
+
+    target.index = searcher.Add(coefficients, slope_min, slope_max);
+    targets.push_back(target);
+  };
+
+  for (auto iter = cables.begin(); iter != cables.end(); iter++) {
+    Cable& cable = **iter;
+
+    SagTensionCable cable_sagtension;
+    cable_sagtension.set_cable_base(&cable);
+
+    // adds core polynomials
+    CableComponent& core = cable.component_core;
+    if (cable_sagtension.IsEnabled(SagTensionCable::ComponentType::kCore)) {
+      const double slope_min = 1000;
+      const double slope_max = core.modulus_tension_elastic_area / 100;
+      add(core.coefficients_polynomial_creep, slope_min, slope_max,
+          cable.name + " core creep", &core.load_limit_polynomial_creep);
+      add(core.coefficients_polynomial_loadstrain, slope_min, slope_max,
+          cable.name + " core stress-strain",
+          &core.load_limit_polynomial_loadstrain);
+    } else {
+      core.load_limit_polynomial_creep = 0;
+      core.load_limit_polynomial_loadstrain = 0;
+    }
+
+    // adds shell polynomials
+    CableComponent& shell = cable.component_shell;
+    if (cable_sagtension.IsEnabled(SagTensionCable::ComponentType::kShell)) {
+      const double slope_min = 1000;
+      const double slope_max = shell.modulus_tension_elastic_area / 100;
+      add(shell.coefficients_polynomial_creep, slope_min, slope_max,
+          cable.name + " shell creep", &shell.load_limit_polynomial_creep);
+      add(shell.coefficients_polynomial_loadstrain, slope_min, slope_max,
+          cable.name + " shell stress-strain",
+          &shell.load_limit_polynomial_loadstrain);
+    } else {
+      shell.load_limit_polynomial_creep = 0;
+      shell.load_limit_polynomial_loadstrain = 0;
+    }
+  }
+
+  // searches all polynomials using the same parameters as PointLimit()
+  if (searcher.Search(0.0, 0.2, 0.001, 1.0) == false) {
+    return false;
+  }
+
+  // transfers the limits to the cables, and caches the searched results,
+  // including failures
+  for (auto iter = targets.begin(); iter != targets.end(); iter++) {
+    LimitTarget& target = *iter;
+    if (target.index != -1) {
+      target.limit = searcher.Limit(target.index);
+      if (cache != nullptr) {
+        cache->Insert(target.key, target.limit);
+      }
+    }
+
+    const Point2d<double>& limit = target.limit;
+    if (limit.x == -999999) {
+      wxString message = "Could not solve for " + target.name +
+                         " polynomial limit.";
+      wxLogWarning(message);
+      num_limits_unsolved++;
+    }
+
+    *target.load_limit = helper::Round(limit.y, 1);
+  }
+
+  return true;
+}
+
+int64_t CablePolynomialSearcher::ThreadNumLimitsUnsolved() {
+  return num_limits_unsolved;
+}
+
 Point2d<double> CablePolynomialSearcher::PointLimit(
     const Polynomial& polynomial,
-    const std::string& name_polynomial,
+    const char* name_polynomial,
     const double& slope_min,
-    const double& slope_max) {
+    const double& slope_max,
+    const SearchType& type_search,
+    const double& tolerance,
+    PolynomialLimitCache* cache) {
   // defines search parameters
   const double x_min = 0.0;
   const double x_max = 1.0;
   const double x_step = 0.001;
 
-  // gets limit by inflection
-  Point2d<double> limit_inflection = PointLimitByInflection(polynomial,
-                                                            x_min,
-                                                            x_step,
-                                                            x_max);
+  // checks the cache for a previous result
+  PolynomialLimitCache::Key key;
+  Point2d<double> limit;
+  bool is_cached = false;
+  if ((cache != nullptr) && (polynomial.coefficients() != nullptr)) {
+    key.coefficients = *polynomial.coefficients();
+    key.slope_max = slope_max;
+    key.slope_min = slope_min;
+    key.tolerance = tolerance;
+    key.type_search = static_cast<int>(type_search);
+    is_cached = cache->Find(key, limit);
+  }
 
-  Point2d<double> limit_slope = PointLimitBySlope(polynomial,
-                                                  0.2, x_step, x_max,
-                                                  slope_min, slope_max);
+  if (is_cached == false) {
+    // gets limit by inflection and slope
+    Point2d<double> limit_inflection;
+    Point2d<double> limit_slope;
+    if (type_search == SearchType::kRoots) {
+      limit_inflection = PointLimitByInflectionRoots(polynomial, x_min, x_max,
+                                                     tolerance);
+      limit_slope = PointLimitBySlopeRoots(polynomial, 0.2, x_max,
+                                           slope_min, slope_max, tolerance);
+    } else {
+      limit_inflection = PointLimitByInflection(polynomial, x_min, x_step,
+                                                x_max);
+      limit_slope = PointLimitBySlope(polynomial, 0.2, x_step, x_max,
+                                      slope_min, slope_max);
+    }
 
-  // compares and determines most limiting
-  Point2d<double> limit;
-  if ((limit_inflection.x == -999999) || (limit_slope.x == -999999)) {
-    wxString message = "Could not solve for " + name_polynomial +
-                       " polynomial limit.";
+    // compares and determines most limiting
+    if ((limit_inflection.x == -999999) || (limit_slope.x == -999999)) {
+      limit = Point2d<double>();
+    } else if (limit_inflection.x <= limit_slope.x) {
+      limit = limit_inflection;
+    } else {
+      limit = limit_slope;
+    }
+
+    // caches the result, including failures
+    if ((cache != nullptr) && (polynomial.coefficients() != nullptr)) {
+      cache->Insert(key, limit);
+    }
+  }
+
+  if (limit.x == -999999) {
+    wxString message = wxString("Could not solve for ") + name_polynomial
+                       + " polynomial limit.";
     wxLogWarning(message);
+    num_limits_unsolved++;
     return Point2d<double>();
-  } else if (limit_inflection.x <= limit_slope.x) {
-    limit = limit_inflection;
-  } else {
-    limit = limit_slope;
   }
 
   // logs result
-  wxString message;
-  message = name_polynomial + " limit = ("
-            + helper::DoubleToString(limit.x, 5, true) + ", "
-            + helper::DoubleToString(limit.y, 1, true) + ")";
-  wxLogVerbose(message);
+  // the message is only formatted if verbose logging is enabled, as this is
+  // called for every polynomial
+  if (wxLog::GetVerbose() == true) {
+    wxString message;
+    message = std::string(name_polynomial) + " limit = ("
+              + helper::DoubleToString(limit.x, 5, true) + ", "
+              + helper::DoubleToString(limit.y, 1, true) + ")";
+    wxLogVerbose(message);
+  }
 
   return limit;
 }
@@ -177,46 +634,28 @@ Point2d<double> CablePolynomialSearcher::PointLimitByInflection(
     return Point2d<double>();
   }
 
-  // initializes x and y values
-  double x1 = -999999;
-  double y1 = -999999;
-
-  double x2 = x_min;
-  double y2 = polynomial.Y(x2);
-
-  // initializes counters
-  unsigned int i = 0;
-  const unsigned int i_max = std::numeric_limits<unsigned int>::max();
-
-  // starts searching polynomial at discrete points
-  while (x2 <= x_max) {
-    // calculates new x values
-    x1 = x2;
-    x2 += x_step;
-
-    // calculates new y values
-    y1 = y2;
-    y2 = polynomial.Y(x2);
-
-    // checks that y value is increasing
-    if (y2 < y1) {
-      break;
-    }
-
-    // increments
-    i++;
-    if (i_max <= i) {
-      break;
-    }
-  }
-
-  // returns value
-  Point2d<double> point;
-  if (i < i_max) {
-    point.x = x1;
-    point.y = y1;
+  // selects a fixed size kernel if one matches the polynomial
+  const std::vector<double>& coefficients = *polynomial.coefficients();
+  switch (coefficients.size()) {
+    case 2:
+      return ScanByInflection(PolynomialKernel<2>(coefficients),
+                              x_min, x_step, x_max);
+    case 3:
+      return ScanByInflection(PolynomialKernel<3>(coefficients),
+                              x_min, x_step, x_max);
+    case 4:
+      return ScanByInflection(PolynomialKernel<4>(coefficients),
+                              x_min, x_step, x_max);
+    case 5:
+      return ScanByInflection(PolynomialKernel<5>(coefficients),
+                              x_min, x_step, x_max);
+    case 6:
+      return ScanByInflection(PolynomialKernel<6>(coefficients),
+                              x_min, x_step, x_max);
+    default:
+      return ScanByInflection(PolynomialKernelGeneric(polynomial),
+                              x_min, x_step, x_max);
   }
-  return point;
 }
 
 Point2d<double> CablePolynomialSearcher::PointLimitBySlope(
@@ -226,8 +665,6 @@ Point2d<double> CablePolynomialSearcher::PointLimitBySlope(
     const double& x_max,
     const double& slope_min,
     const double& slope_max) {
-  wxString message;
-
   // validates
   if (polynomial.Validate(false) == false) {
     return Point2d<double>();
@@ -242,53 +679,102 @@ Point2d<double> CablePolynomialSearcher::PointLimitBySlope(
     return Point2d<double>();
   }
 
-  // initializes x, y, and slope values
-  double x1 = -999999;
-  double y1 = -999999;
+  // selects a fixed size kernel if one matches the polynomial
+  const std::vector<double>& coefficients = *polynomial.coefficients();
+  switch (coefficients.size()) {
+    case 2:
+      return ScanBySlope(PolynomialKernel<2>(coefficients),
+                         x_min, x_step, x_max, slope_min, slope_max);
+    case 3:
+      return ScanBySlope(PolynomialKernel<3>(coefficients),
+                         x_min, x_step, x_max, slope_min, slope_max);
+    case 4:
+      return ScanBySlope(PolynomialKernel<4>(coefficients),
+                         x_min, x_step, x_max, slope_min, slope_max);
+    case 5:
+      return ScanBySlope(PolynomialKernel<5>(coefficients),
+                         x_min, x_step, x_max, slope_min, slope_max);
+    case 6:
+      return ScanBySlope(PolynomialKernel<6>(coefficients),
+                         x_min, x_step, x_max, slope_min, slope_max);
+    default:
+      return ScanBySlope(PolynomialKernelGeneric(polynomial),
+                         x_min, x_step, x_max, slope_min, slope_max);
+  }
+}
 
-  double x2 = x_min;
-  double y2 = polynomial.Y(x2);
+Point2d<double> CablePolynomialSearcher::PointLimitByInflectionRoots(
+    const Polynomial& polynomial,
+    const double& x_min,
+    const double& x_max,
+    const double& tolerance) {
+  // validates
+  if (polynomial.Validate(false) == false) {
+    return Point2d<double>();
+  }
 
-  double s = -999999;
+  if (x_max < x_min) {
+    return Point2d<double>();
+  }
 
-  // initializes counters
-  unsigned int i = 0;
-  const unsigned int i_max = std::numeric_limits<unsigned int>::max();
+  if (tolerance <= 0) {
+    return Point2d<double>();
+  }
 
-  // start searching polynomial at discrete points
-  while (x2 <= x_max) {
-    // calculates new x values
-    x1 = x2;
-    x2 += x_step;
+  // solves for the first point where the slope becomes negative
+  const std::vector<double> slope = Derivative(*polynomial.coefficients());
 
-    // calculates new y values
-    y1 = y2;
-    y2 = polynomial.Y(x2);
+  Point2d<double> point;
+  point.x = XFirstNegative(slope, x_min, x_max, tolerance);
+  point.y = polynomial.Y(point.x);
+  return point;
+}
+
+Point2d<double> CablePolynomialSearcher::PointLimitBySlopeRoots(
+    const Polynomial& polynomial,
+    const double& x_min,
+    const double& x_max,
+    const double& slope_min,
+    const double& slope_max,
+    const double& tolerance) {
+  // validates
+  if (polynomial.Validate(false) == false) {
+    return Point2d<double>();
+  }
 
-    // calculates new slope value
-    s = polynomial.Slope(x2);
+  if (x_max < x_min) {
+    return Point2d<double>();
+  }
 
-    // checks against min/max
-    if (s < slope_min) {
-      break;
-    }
+  if (tolerance <= 0) {
+    return Point2d<double>();
+  }
 
-    if (slope_max < s) {
-      break;
-    }
+  // creates polynomials that are negative when the slope is out of bounds
+  // (slope - slope_min) and (slope_max - slope)
+  std::vector<double> slope_above_min =
+      Derivative(*polynomial.coefficients());
+  if (slope_above_min.empty() == true) {
+    slope_above_min.push_back(0);
+  }
 
-    // increments
-    i++;
-    if (i_max <= i) {
-      break;
-    }
+  std::vector<double> slope_below_max = slope_above_min;
+  for (auto iter = slope_below_max.begin(); iter != slope_below_max.end();
+       iter++) {
+    *iter = -*iter;
   }
 
-  // returns value
+  slope_above_min.front() -= slope_min;
+  slope_below_max.front() += slope_max;
+
+  // solves for the first point that either slope boundary is exceeded
+  const double x_slope_min = XFirstNegative(slope_above_min, x_min, x_max,
+                                            tolerance);
+  const double x_slope_max = XFirstNegative(slope_below_max, x_min, x_max,
+                                            tolerance);
+
   Point2d<double> point;
-  if (i < i_max) {
-    point.x = x1;
-    point.y = y1;
-  }
+  point.x = std::min(x_slope_min, x_slope_max);
+  point.y = polynomial.Y(point.x);
   return point;
 }
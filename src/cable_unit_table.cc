@@ -0,0 +1,467 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "cable_unit_table.h"
+
+#include <cmath>
+#include <cstddef>
+
+#include "appcommon/units/cable_unit_converter.h"
+
+namespace {
+
+/// \brief Converts a value.
+/// \param[in] factor
+///   The factor.
+/// \param[in,out] value
+///   The value.
+inline void Apply(const CableUnitTable::Factor& factor, double& value) {
+  value = value * factor.scale + factor.offset;
+}
+
+/// \brief Converts polynomial coefficients.
+/// \param[in] scales
+///   The scale of each coefficient.
+/// \param[in,out] coefficients
+///   The coefficients.
+inline void ApplyCoefficients(const double* scales,
+                              std::vector<double>& coefficients) {
+  for (std::size_t i = 0; i < coefficients.size(); i++) {
+    coefficients[i] *= scales[i];
+  }
+}
+
+/// \brief Converts a component.
+/// \param[in] factors
+///   The component factors.
+/// \param[in,out] component
+///   The component.
+void ApplyComponent(const CableUnitTable::ComponentFactors& factors,
+                    CableComponent& component) {
+  Apply(factors.coefficient_expansion_linear_thermal,
+        component.coefficient_expansion_linear_thermal);
+  ApplyCoefficients(factors.coefficients_polynomial_creep,
+                    component.coefficients_polynomial_creep);
+  ApplyCoefficients(factors.coefficients_polynomial_loadstrain,
+                    component.coefficients_polynomial_loadstrain);
+  Apply(factors.load_limit_polynomial_creep,
+        component.load_limit_polynomial_creep);
+  Apply(factors.load_limit_polynomial_loadstrain,
+        component.load_limit_polynomial_loadstrain);
+  Apply(factors.modulus_compression_elastic_area,
+        component.modulus_compression_elastic_area);
+  Apply(factors.modulus_tension_elastic_area,
+        component.modulus_tension_elastic_area);
+}
+
+/// \brief Converts a cable with CableUnitConverter.
+/// \param[in] system_from
+///   The unit system of the cable, which is in the 'consistent' style.
+/// \param[in] system_to
+///   The converted unit system.
+/// \param[in] style_to
+///   The converted unit style.
+/// \param[in,out] cable
+///   The cable.
+void ConvertReference(const units::UnitSystem& system_from,
+                      const units::UnitSystem& system_to,
+                      const units::UnitStyle& style_to, Cable& cable) {
+  if (system_from != system_to) {
+    CableUnitConverter::ConvertUnitSystem(system_from, system_to, true,
+                                          cable);
+  }
+
+  if (style_to == units::UnitStyle::kDifferent) {
+    CableUnitConverter::ConvertUnitStyleToDifferent(system_to, true, cable);
+  }
+}
+
+/// \brief Determines if the coefficients are short enough for a table.
+/// \param[in] component
+///   The component.
+/// \return If the coefficients are short enough for a table.
+bool IsTableSize(const CableComponent& component) {
+  const std::size_t num_max = CableUnitTable::kNumCoefficientsMax;
+  return (component.coefficients_polynomial_creep.size() <= num_max)
+         && (component.coefficients_polynomial_loadstrain.size() <= num_max);
+}
+
+/// \brief Fills a probe component.
+/// \param[in] value
+///   The value of the first field. Each following field is increased by
+///   the step.
+/// \param[in] step
+///   The increase between fields.
+/// \param[in] num_coefficients
+///   The number of coefficients in each polynomial.
+/// \param[out] component
+///   The component.
+/// \return The value of the next field.
+double FillComponent(const double& value, const double& step,
+                     const std::size_t& num_coefficients,
+                     CableComponent& component) {
+  double x = value;
+  auto next = [&x, &step]() {
+    const double current = x;
+    x += step;
+    return current;
+  };
+
+  component.coefficient_expansion_linear_thermal = next();
+  component.coefficients_polynomial_creep.resize(num_coefficients);
+  for (std::size_t i = 0; i < num_coefficients; i++) {
+    component.coefficients_polynomial_creep[i] = next();
+  }
+  component.coefficients_polynomial_loadstrain.resize(num_coefficients);
+  for (std::size_t i = 0; i < num_coefficients; i++) {
+    component.coefficients_polynomial_loadstrain[i] = next();
+  }
+  component.load_limit_polynomial_creep = next();
+  component.load_limit_polynomial_loadstrain = next();
+  component.modulus_compression_elastic_area = next();
+  component.modulus_tension_elastic_area = next();
+  return x;
+}
+
+/// \brief Fills a probe cable.
+/// \param[in] value
+///   The value of the first field. Each following field is increased by
+///   the step.
+/// \param[in] step
+///   The increase between fields.
+/// \param[in] num_coefficients
+///   The number of coefficients in each polynomial.
+/// \param[out] cable
+///   The cable.
+void FillCable(const double& value, const double& step,
+               const std::size_t& num_coefficients, Cable& cable) {
+  double x = value;
+  cable.area_physical = x;
+  x += step;
+  x = FillComponent(x, step, num_coefficients, cable.component_core);
+  x = FillComponent(x, step, num_coefficients, cable.component_shell);
+  cable.diameter = x;
+  x += step;
+  cable.name = "probe";
+  cable.strength_rated = x;
+  x += step;
+  cable.temperature_properties_components = x;
+  x += step;
+  cable.weight_unit = x;
+}
+
+/// \brief Measures a factor from the converted zero and one probes.
+/// \param[in] zero
+///   The converted value of zero.
+/// \param[in] one
+///   The converted value of one.
+/// \return The factor.
+CableUnitTable::Factor MeasureFactor(const double& zero, const double& one) {
+  CableUnitTable::Factor factor;
+  factor.offset = zero;
+  factor.scale = one - zero;
+  return factor;
+}
+
+/// \brief Measures the factors of a component.
+/// \param[in] zero
+///   The converted zero probe.
+/// \param[in] one
+///   The converted one probe.
+/// \param[out] factors
+///   The factors.
+/// \return If the coefficients are scaled without an offset.
+bool MeasureComponent(const CableComponent& zero, const CableComponent& one,
+                      CableUnitTable::ComponentFactors& factors) {
+  factors.coefficient_expansion_linear_thermal =
+      MeasureFactor(zero.coefficient_expansion_linear_thermal,
+                    one.coefficient_expansion_linear_thermal);
+  factors.load_limit_polynomial_creep =
+      MeasureFactor(zero.load_limit_polynomial_creep,
+                    one.load_limit_polynomial_creep);
+  factors.load_limit_polynomial_loadstrain =
+      MeasureFactor(zero.load_limit_polynomial_loadstrain,
+                    one.load_limit_polynomial_loadstrain);
+  factors.modulus_compression_elastic_area =
+      MeasureFactor(zero.modulus_compression_elastic_area,
+                    one.modulus_compression_elastic_area);
+  factors.modulus_tension_elastic_area =
+      MeasureFactor(zero.modulus_tension_elastic_area,
+                    one.modulus_tension_elastic_area);
+
+  const std::size_t num = CableUnitTable::kNumCoefficientsMax;
+  if ((zero.coefficients_polynomial_creep.size() != num)
+      || (zero.coefficients_polynomial_loadstrain.size() != num)
+      || (one.coefficients_polynomial_creep.size() != num)
+      || (one.coefficients_polynomial_loadstrain.size() != num)) {
+    return false;
+  }
+
+  for (std::size_t i = 0; i < num; i++) {
+    if ((zero.coefficients_polynomial_creep[i] != 0)
+        || (zero.coefficients_polynomial_loadstrain[i] != 0)) {
+      return false;
+    }
+    factors.coefficients_polynomial_creep[i] =
+        one.coefficients_polynomial_creep[i];
+    factors.coefficients_polynomial_loadstrain[i] =
+        one.coefficients_polynomial_loadstrain[i];
+  }
+
+  return true;
+}
+
+/// \brief Determines if two values match within floating point tolerance.
+/// \param[in] a
+///   The first value.
+/// \param[in] b
+///   The second value.
+/// \return If the values match.
+bool IsMatch(const double& a, const double& b) {
+  return std::fabs(a - b) <= 1e-9 * std::fmax(1.0, std::fabs(b));
+}
+
+/// \brief Determines if two components match within floating point
+///   tolerance.
+/// \param[in] a
+///   The first component.
+/// \param[in] b
+///   The second component.
+/// \return If the components match.
+bool IsMatch(const CableComponent& a, const CableComponent& b) {
+  if ((a.coefficients_polynomial_creep.size()
+       != b.coefficients_polynomial_creep.size())
+      || (a.coefficients_polynomial_loadstrain.size()
+          != b.coefficients_polynomial_loadstrain.size())) {
+    return false;
+  }
+
+  for (std::size_t i = 0; i < a.coefficients_polynomial_creep.size(); i++) {
+    if (IsMatch(a.coefficients_polynomial_creep[i],
+                b.coefficients_polynomial_creep[i]) == false) {
+      return false;
+    }
+  }
+
+  for (std::size_t i = 0; i < a.coefficients_polynomial_loadstrain.size();
+       i++) {
+    if (IsMatch(a.coefficients_polynomial_loadstrain[i],
+                b.coefficients_polynomial_loadstrain[i]) == false) {
+      return false;
+    }
+  }
+
+  return IsMatch(a.coefficient_expansion_linear_thermal,
+                 b.coefficient_expansion_linear_thermal)
+         && IsMatch(a.load_limit_polynomial_creep,
+                    b.load_limit_polynomial_creep)
+         && IsMatch(a.load_limit_polynomial_loadstrain,
+                    b.load_limit_polynomial_loadstrain)
+         && IsMatch(a.modulus_compression_elastic_area,
+                    b.modulus_compression_elastic_area)
+         && IsMatch(a.modulus_tension_elastic_area,
+                    b.modulus_tension_elastic_area);
+}
+
+/// \brief Gets the table index of a unit system.
+/// \param[in] system
+///   The unit system.
+/// \return The index, or -1 if the unit system is not set.
+int IndexSystem(const units::UnitSystem& system) {
+  if (system == units::UnitSystem::kImperial) {
+    return 0;
+  } else if (system == units::UnitSystem::kMetric) {
+    return 1;
+  } else {
+    return -1;
+  }
+}
+
+}  // namespace
+
+CableUnitTable::CableUnitTable() {
+}
+
+CableUnitTable::~CableUnitTable() {
+}
+
+bool CableUnitTable::Convert(Cable& cable) const {
+  if ((IsTableSize(cable.component_core) == false)
+      || (IsTableSize(cable.component_shell) == false)) {
+    return false;
+  }
+
+  Apply(area_physical_, cable.area_physical);
+  ApplyComponent(component_core_, cable.component_core);
+  ApplyComponent(component_shell_, cable.component_shell);
+  Apply(diameter_, cable.diameter);
+  Apply(strength_rated_, cable.strength_rated);
+  Apply(temperature_properties_components_,
+        cable.temperature_properties_components);
+  Apply(weight_unit_, cable.weight_unit);
+  return true;
+}
+
+bool CableUnitTable::Convert(const std::vector<Cable*>& cables) const {
+  for (auto iter = cables.cbegin(); iter != cables.cend(); iter++) {
+    if ((IsTableSize((*iter)->component_core) == false)
+        || (IsTableSize((*iter)->component_shell) == false)) {
+      return false;
+    }
+  }
+
+  // converts one field of every cable at a time, so each loop applies the
+  // same scale and offset
+  const std::size_t num = cables.size();
+  Cable* const* data = cables.data();
+
+  auto convert = [data, num](const Factor& factor, double Cable::* field) {
+    const double scale = factor.scale;
+    const double offset = factor.offset;
+    for (std::size_t i = 0; i < num; i++) {
+      data[i]->*field = data[i]->*field * scale + offset;
+    }
+  };
+
+  auto convert_component = [data, num](const Factor& factor,
+                                        CableComponent Cable::* component,
+                                        double CableComponent::* field) {
+    const double scale = factor.scale;
+    const double offset = factor.offset;
+    for (std::size_t i = 0; i < num; i++) {
+      double& value = (data[i]->*component).*field;
+      value = value * scale + offset;
+    }
+  };
+
+  convert(area_physical_, &Cable::area_physical);
+  convert(diameter_, &Cable::diameter);
+  convert(strength_rated_, &Cable::strength_rated);
+  convert(temperature_properties_components_,
+          &Cable::temperature_properties_components);
+  convert(weight_unit_, &Cable::weight_unit);
+
+  CableComponent Cable::* components[2] = {&Cable::component_core,
+                                           &Cable::component_shell};
+  const ComponentFactors* factors[2] = {&component_core_, &component_shell_};
+  for (int k = 0; k < 2; k++) {
+    CableComponent Cable::* component = components[k];
+    const ComponentFactors& factors_component = *factors[k];
+    convert_component(factors_component.coefficient_expansion_linear_thermal,
+                      component,
+                      &CableComponent::coefficient_expansion_linear_thermal);
+    convert_component(factors_component.load_limit_polynomial_creep,
+                      component, &CableComponent::load_limit_polynomial_creep);
+    convert_component(factors_component.load_limit_polynomial_loadstrain,
+                      component,
+                      &CableComponent::load_limit_polynomial_loadstrain);
+    convert_component(factors_component.modulus_compression_elastic_area,
+                      component,
+                      &CableComponent::modulus_compression_elastic_area);
+    convert_component(factors_component.modulus_tension_elastic_area,
+                      component,
+                      &CableComponent::modulus_tension_elastic_area);
+
+    // the coefficients are already stored contiguously for each cable
+    for (std::size_t i = 0; i < num; i++) {
+      CableComponent& component_cable = data[i]->*component;
+      ApplyCoefficients(factors_component.coefficients_polynomial_creep,
+                        component_cable.coefficients_polynomial_creep);
+      ApplyCoefficients(factors_component.coefficients_polynomial_loadstrain,
+                        component_cable.coefficients_polynomial_loadstrain);
+    }
+  }
+
+  return true;
+}
+
+const CableUnitTable* CableUnitTable::Find(
+    const units::UnitSystem& system_from,
+    const units::UnitSystem& system_to,
+    const units::UnitStyle& style_to) {
+  // the tables are measured once, and indexed by system from, system to, and
+  // style
+  struct Tables {
+    CableUnitTable tables[8];
+    bool is_valid[8];
+  };
+
+  static const Tables* tables = []() {
+    Tables* result = new Tables();
+    const units::UnitSystem systems[2] = {units::UnitSystem::kImperial,
+                                          units::UnitSystem::kMetric};
+    const units::UnitStyle styles[2] = {units::UnitStyle::kConsistent,
+                                        units::UnitStyle::kDifferent};
+    for (int i = 0; i < 8; i++) {
+      result->is_valid[i] = result->tables[i].Measure(
+          systems[i / 4], systems[(i / 2) % 2], styles[i % 2]);
+    }
+    return result;
+  }();
+
+  const int index_from = IndexSystem(system_from);
+  const int index_to = IndexSystem(system_to);
+  int index_style = -1;
+  if (style_to == units::UnitStyle::kConsistent) {
+    index_style = 0;
+  } else if (style_to == units::UnitStyle::kDifferent) {
+    index_style = 1;
+  }
+
+  if ((index_from < 0) || (index_to < 0) || (index_style < 0)) {
+    return nullptr;
+  }
+
+  const int index = index_from * 4 + index_to * 2 + index_style;
+  if (tables->is_valid[index] == false) {
+    return nullptr;
+  }
+  return &tables->tables[index];
+}
+
+bool CableUnitTable::Measure(const units::UnitSystem& system_from,
+                             const units::UnitSystem& system_to,
+                             const units::UnitStyle& style_to) {
+  // measures the scale and offset of every field from a zero and a one probe
+  const std::size_t num_coefficients = kNumCoefficientsMax;
+  Cable zero;
+  FillCable(0, 0, num_coefficients, zero);
+  ConvertReference(system_from, system_to, style_to, zero);
+
+  Cable one;
+  FillCable(1, 0, num_coefficients, one);
+  ConvertReference(system_from, system_to, style_to, one);
+
+  area_physical_ = MeasureFactor(zero.area_physical, one.area_physical);
+  if ((MeasureComponent(zero.component_core, one.component_core,
+                        component_core_) == false)
+      || (MeasureComponent(zero.component_shell, one.component_shell,
+                           component_shell_) == false)) {
+    return false;
+  }
+  diameter_ = MeasureFactor(zero.diameter, one.diameter);
+  strength_rated_ = MeasureFactor(zero.strength_rated, one.strength_rated);
+  temperature_properties_components_ =
+      MeasureFactor(zero.temperature_properties_components,
+                    one.temperature_properties_components);
+  weight_unit_ = MeasureFactor(zero.weight_unit, one.weight_unit);
+
+  // checks the table against a probe with a different value in every field
+  // and shorter polynomials, which catches fields that depend on each other
+  Cable expected;
+  FillCable(3.25, 1.5, 5, expected);
+  Cable actual = expected;
+  ConvertReference(system_from, system_to, style_to, expected);
+  if (Convert(actual) == false) {
+    return false;
+  }
+
+  return IsMatch(actual.area_physical, expected.area_physical)
+         && IsMatch(actual.component_core, expected.component_core)
+         && IsMatch(actual.component_shell, expected.component_shell)
+         && IsMatch(actual.diameter, expected.diameter)
+         && IsMatch(actual.strength_rated, expected.strength_rated)
+         && IsMatch(actual.temperature_properties_components,
+                    expected.temperature_properties_components)
+         && IsMatch(actual.weight_unit, expected.weight_unit);
+}
@@ -0,0 +1,417 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "cable_xml_template.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+
+#include "appcommon/xml/cable_xml_handler.h"
+#include "models/base/helper.h"
+
+namespace {
+
+/// The maximum number of number fields in a cable.
+const int kNumFieldsMax =
+    5 + 2 * (5 + 2 * CableXmlTemplate::kNumCoefficientsMax);
+
+/// \brief Visits the number fields of a component, in a fixed order.
+/// \param[in,out] component
+///   The component.
+/// \param[in,out] function
+///   The function that is called with each field.
+template <typename ComponentType, typename Function>
+void VisitComponent(ComponentType& component, Function& function) {
+  function(component.coefficient_expansion_linear_thermal);
+  for (std::size_t i = 0; i < component.coefficients_polynomial_creep.size();
+       i++) {
+    function(component.coefficients_polynomial_creep[i]);
+  }
+  for (std::size_t i = 0;
+       i < component.coefficients_polynomial_loadstrain.size(); i++) {
+    function(component.coefficients_polynomial_loadstrain[i]);
+  }
+  function(component.load_limit_polynomial_creep);
+  function(component.load_limit_polynomial_loadstrain);
+  function(component.modulus_compression_elastic_area);
+  function(component.modulus_tension_elastic_area);
+}
+
+/// \brief Visits the number fields of a cable, in a fixed order.
+/// \param[in,out] cable
+///   The cable.
+/// \param[in,out] function
+///   The function that is called with each field.
+template <typename CableType, typename Function>
+void VisitCable(CableType& cable, Function& function) {
+  function(cable.area_physical);
+  VisitComponent(cable.component_core, function);
+  VisitComponent(cable.component_shell, function);
+  function(cable.diameter);
+  function(cable.strength_rated);
+  function(cable.temperature_properties_components);
+  function(cable.weight_unit);
+}
+
+/// \brief Fills a probe cable.
+/// \param[in] sizes
+///   The core creep, core load-strain, shell creep, and shell load-strain
+///   polynomial sizes.
+/// \param[in] value
+///   The function that gets the value of a field from its index.
+/// \param[in] name
+///   The cable name.
+/// \param[out] cable
+///   The cable.
+template <typename Function>
+void FillProbe(const std::size_t sizes[4], const Function& value,
+               const std::string& name, Cable& cable) {
+  cable.component_core.coefficients_polynomial_creep.resize(sizes[0]);
+  cable.component_core.coefficients_polynomial_loadstrain.resize(sizes[1]);
+  cable.component_shell.coefficients_polynomial_creep.resize(sizes[2]);
+  cable.component_shell.coefficients_polynomial_loadstrain.resize(sizes[3]);
+  cable.name = name;
+
+  int index = 0;
+  auto fill = [&value, &index](double& field) {
+    field = value(index);
+    index++;
+  };
+  VisitCable(cable, fill);
+}
+
+/// \brief Gets the number fields of a cable.
+/// \param[in] cable
+///   The cable.
+/// \param[out] values
+///   The values, which must hold kNumFieldsMax values.
+/// \return The number of fields.
+int Fields(const Cable& cable, double* values) {
+  int num = 0;
+  auto get = [values, &num](const double& field) {
+    values[num] = field;
+    num++;
+  };
+  VisitCable(cable, get);
+  return num;
+}
+
+/// \brief Finds the precision that formats a value to a text.
+/// \param[in] value
+///   The value.
+/// \param[in] text
+///   The text.
+/// \param[out] precision
+///   The precision.
+/// \param[out] is_fixed
+///   An indicator that tells if the value is formatted in fixed notation.
+/// \return If a precision was found.
+/// The value is formatted with the same helper as the cable XML handler, so
+/// the rounding always matches it.
+bool FindPrecision(const double& value, const std::string& text,
+                   int& precision, bool& is_fixed) {
+  const bool fixeds[2] = {true, false};
+  for (int i = 0; i < 2; i++) {
+    for (int p = 0; p <= 17; p++) {
+      if (helper::DoubleToString(value, p, fixeds[i]) == text) {
+        precision = p;
+        is_fixed = fixeds[i];
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/// \brief Writes a cable name as text.
+/// \param[in] name
+///   The name.
+/// \param[in,out] writer
+///   The stream writer.
+void WriteName(const std::string& name, XmlStreamWriter& writer) {
+  // an ASCII name is the same in UTF-8, so it isn't converted
+  for (std::size_t i = 0; i < name.size(); i++) {
+    const unsigned char c = static_cast<unsigned char>(name[i]);
+    if ((c == 0) || (0x80 <= c)) {
+      writer.WriteText(wxString(name));
+      return;
+    }
+  }
+  writer.WriteText(name.c_str());
+}
+
+}  // namespace
+
+CableXmlTemplate::CableXmlTemplate() {
+}
+
+CableXmlTemplate::~CableXmlTemplate() {
+}
+
+const CableXmlTemplate* CableXmlTemplate::Find(
+    const Cable& cable,
+    const std::string& name,
+    const units::UnitSystem& system_units,
+    const units::UnitStyle& style_units) {
+  if (name.empty() == false) {
+    return nullptr;
+  }
+
+  const std::size_t sizes[4] = {
+      cable.component_core.coefficients_polynomial_creep.size(),
+      cable.component_core.coefficients_polynomial_loadstrain.size(),
+      cable.component_shell.coefficients_polynomial_creep.size(),
+      cable.component_shell.coefficients_polynomial_loadstrain.size()};
+
+  // the key packs the unit system, unit style, and polynomial sizes
+  const uint64_t num_sizes = kNumCoefficientsMax + 1;
+  uint64_t key = static_cast<uint64_t>(static_cast<int>(system_units)) * 16
+                 + static_cast<uint64_t>(static_cast<int>(style_units));
+  for (int i = 0; i < 4; i++) {
+    if (kNumCoefficientsMax < sizes[i]) {
+      return nullptr;
+    }
+    key = key * num_sizes + sizes[i];
+  }
+
+  // the last template of each thread is kept, as the cables in a batch
+  // usually have the same shape
+  static thread_local uint64_t key_last = UINT64_MAX;
+  static thread_local const CableXmlTemplate* template_last = nullptr;
+  if (key == key_last) {
+    return template_last;
+  }
+
+  // the templates are measured once, and are never freed
+  static std::mutex mutex;
+  static std::map<uint64_t, const CableXmlTemplate*>* templates =
+      new std::map<uint64_t, const CableXmlTemplate*>();
+
+  const CableXmlTemplate* result = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto iter = templates->find(key);
+    if (iter != templates->end()) {
+      result = iter->second;
+    } else {
+      CableXmlTemplate* measured = new CableXmlTemplate();
+      if (measured->Measure(sizes, system_units, style_units) == false) {
+        delete measured;
+        measured = nullptr;
+      }
+      (*templates)[key] = measured;
+      result = measured;
+    }
+  }
+
+  key_last = key;
+  template_last = result;
+  return result;
+}
+
+void CableXmlTemplate::Write(const Cable& cable,
+                             XmlStreamWriter& writer) const {
+  double values[kNumFieldsMax];
+  Fields(cable, values);
+
+  for (auto iter = ops_.cbegin(); iter != ops_.cend(); iter++) {
+    const Op& op = *iter;
+    switch (op.type) {
+      case Op::Type::kAttribute:
+        writer.AddAttribute(op.text.c_str(), op.value.c_str());
+        break;
+      case Op::Type::kEndElement:
+        writer.EndElement();
+        break;
+      case Op::Type::kStartElement:
+        writer.StartElement(op.text.c_str());
+        break;
+      case Op::Type::kText:
+        writer.WriteText(op.text.c_str());
+        break;
+      case Op::Type::kTextName:
+        WriteName(cable.name, writer);
+        break;
+      case Op::Type::kTextValue:
+        writer.WriteText(helper::DoubleToString(values[op.field],
+                                                op.precision, op.is_fixed)
+                             .c_str());
+        break;
+    }
+  }
+}
+
+bool CableXmlTemplate::AddNode(const wxXmlNode* node_a,
+                               const wxXmlNode* node_b,
+                               const Cable& cable_a, const Cable& cable_b) {
+  if (node_a->GetType() != node_b->GetType()) {
+    return false;
+  }
+
+  Op op;
+  op.field = -1;
+  op.is_fixed = true;
+  op.precision = 0;
+
+  if (node_a->GetType() == wxXML_TEXT_NODE) {
+    const wxString& content_a = node_a->GetContent();
+    const wxString& content_b = node_b->GetContent();
+    op.text = content_a.ToUTF8().data();
+
+    // text that doesn't change with the cable is copied
+    if (content_a == content_b) {
+      op.type = Op::Type::kText;
+      ops_.push_back(op);
+      return true;
+    }
+
+    if ((content_a == wxString(cable_a.name))
+        && (content_b == wxString(cable_b.name))) {
+      op.type = Op::Type::kTextName;
+      ops_.push_back(op);
+      return true;
+    }
+
+    // finds the field with the nearest value, as the probe fields are far
+    // apart
+    char* end = nullptr;
+    const double value = std::strtod(op.text.c_str(), &end);
+    if ((end == op.text.c_str()) || (*end != '\0')) {
+      return false;
+    }
+
+    double values_a[kNumFieldsMax];
+    double values_b[kNumFieldsMax];
+    const int num = Fields(cable_a, values_a);
+    Fields(cable_b, values_b);
+    for (int i = 0; i < num; i++) {
+      if ((op.field == -1) || (std::fabs(value - values_a[i])
+                               < std::fabs(value - values_a[op.field]))) {
+        op.field = i;
+      }
+    }
+
+    // the precision must also generate the text of the second probe
+    bool is_fixed = true;
+    int precision = 0;
+    if ((op.field == -1)
+        || (FindPrecision(values_a[op.field], op.text, op.precision,
+                          op.is_fixed) == false)
+        || (FindPrecision(values_b[op.field],
+                          std::string(content_b.ToUTF8().data()), precision,
+                          is_fixed) == false)
+        || (is_fixed != op.is_fixed) || (precision != op.precision)) {
+      return false;
+    }
+
+    op.text.clear();
+    op.type = Op::Type::kTextValue;
+    ops_.push_back(op);
+    return true;
+  }
+
+  if (node_a->GetType() != wxXML_ELEMENT_NODE) {
+    return false;
+  }
+
+  if (node_a->GetName() != node_b->GetName()) {
+    return false;
+  }
+
+  op.text = node_a->GetName().ToUTF8().data();
+  op.type = Op::Type::kStartElement;
+  ops_.push_back(op);
+
+  // attributes are only generated from the unit system and style, so they
+  // must match
+  const wxXmlAttribute* attribute_a = node_a->GetAttributes();
+  const wxXmlAttribute* attribute_b = node_b->GetAttributes();
+  while ((attribute_a != nullptr) && (attribute_b != nullptr)) {
+    if ((attribute_a->GetName() != attribute_b->GetName())
+        || (attribute_a->GetValue() != attribute_b->GetValue())) {
+      return false;
+    }
+
+    op.text = attribute_a->GetName().ToUTF8().data();
+    op.type = Op::Type::kAttribute;
+    op.value = attribute_a->GetValue().ToUTF8().data();
+    ops_.push_back(op);
+
+    attribute_a = attribute_a->GetNext();
+    attribute_b = attribute_b->GetNext();
+  }
+
+  if ((attribute_a != nullptr) || (attribute_b != nullptr)) {
+    return false;
+  }
+
+  const wxXmlNode* child_a = node_a->GetChildren();
+  const wxXmlNode* child_b = node_b->GetChildren();
+  while ((child_a != nullptr) && (child_b != nullptr)) {
+    if (AddNode(child_a, child_b, cable_a, cable_b) == false) {
+      return false;
+    }
+
+    child_a = child_a->GetNext();
+    child_b = child_b->GetNext();
+  }
+
+  if ((child_a != nullptr) || (child_b != nullptr)) {
+    return false;
+  }
+
+  op.text.clear();
+  op.type = Op::Type::kEndElement;
+  op.value.clear();
+  ops_.push_back(op);
+  return true;
+}
+
+bool CableXmlTemplate::Measure(const std::size_t sizes[4],
+                               const units::UnitSystem& system_units,
+                               const units::UnitStyle& style_units) {
+  // matches the nodes of two probes with a different value in every field,
+  // which are far enough apart that each text has a single nearest field
+  Cable probe_a;
+  FillProbe(sizes, [](const int& index) {
+    return 1000.0 * (index + 1) + 0.123456789012345;
+  }, "probe-a", probe_a);
+
+  Cable probe_b;
+  FillProbe(sizes, [](const int& index) {
+    return -1000.0 * (index + 1) - 0.987654321098765;
+  }, "probe-b", probe_b);
+
+  wxXmlNode* node_a = CableXmlHandler::CreateNode(probe_a, "", system_units,
+                                                  style_units);
+  wxXmlNode* node_b = CableXmlHandler::CreateNode(probe_b, "", system_units,
+                                                  style_units);
+  const bool is_matched = (node_a != nullptr) && (node_b != nullptr)
+                          && (AddNode(node_a, node_b, probe_a, probe_b)
+                              == true);
+  delete node_a;
+  delete node_b;
+  if (is_matched == false) {
+    return false;
+  }
+
+  // checks the template against a probe with small, zero, and negative
+  // values, and a name that is escaped
+  Cable probe_c;
+  FillProbe(sizes, [](const int& index) {
+    return (index % 7 - 3) * 12.3456789 + index * 0.0625;
+  }, "probe <c> & \"d\"", probe_c);
+
+  XmlStreamWriter writer_expected(2);
+  wxXmlNode* node_c = CableXmlHandler::CreateNode(probe_c, "", system_units,
+                                                  style_units);
+  writer_expected.WriteNode(node_c);
+  delete node_c;
+
+  XmlStreamWriter writer_actual(2);
+  Write(probe_c, writer_actual);
+  return writer_actual.buffer() == writer_expected.buffer();
+}
@@ -0,0 +1,101 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "conversion_arena.h"
+
+#include <cstdint>
+
+namespace {
+
+/// The current arena of the calling thread.
+thread_local ConversionArena* arena_current = nullptr;
+
+}  // namespace
+
+ConversionArena::Scope::Scope(ConversionArena* arena) {
+  arena_ = arena;
+  previous_ = arena_current;
+
+  // only the outermost scope resets the arena, as the scopes around a
+  // nested scope still use their allocations
+  if (arena_->depth_scope_ == 0) {
+    arena_->Reset();
+  }
+  arena_->depth_scope_++;
+  arena_current = arena_;
+}
+
+ConversionArena::Scope::~Scope() {
+  arena_->depth_scope_--;
+  arena_current = previous_;
+}
+
+ConversionArena::ConversionArena() {
+  depth_scope_ = 0;
+  index_chunk_ = 0;
+  pos_ = 0;
+  size_allocated_ = 0;
+}
+
+ConversionArena::~ConversionArena() {
+  for (auto iter = chunks_.cbegin(); iter != chunks_.cend(); iter++) {
+    ::operator delete(iter->data);
+  }
+}
+
+void* ConversionArena::Allocate(const std::size_t& size,
+                                const std::size_t& alignment) {
+  // searches the chunks from the current one for enough space
+  while (index_chunk_ < chunks_.size()) {
+    const Chunk& chunk = chunks_[index_chunk_];
+    const std::uintptr_t address =
+        reinterpret_cast<std::uintptr_t>(chunk.data) + pos_;
+    const std::size_t padding =
+        (alignment - (address & (alignment - 1))) & (alignment - 1);
+    if (pos_ + padding + size <= chunk.size) {
+      void* ptr = chunk.data + pos_ + padding;
+      pos_ += padding + size;
+      size_allocated_ += size;
+      return ptr;
+    }
+
+    // the rest of the chunk is left unused until the next reset
+    index_chunk_++;
+    pos_ = 0;
+  }
+
+  // adds a chunk, which is at least large enough for the allocation
+  // operator new aligns to the largest fundamental type, so no padding is
+  // needed at the start of a chunk
+  Chunk chunk;
+  chunk.size = (size < kSizeChunk) ? kSizeChunk : size;
+  chunk.data = static_cast<char*>(::operator new(chunk.size));
+  chunks_.push_back(chunk);
+
+  index_chunk_ = chunks_.size() - 1;
+  pos_ = size;
+  size_allocated_ += size;
+  return chunk.data;
+}
+
+ConversionArena* ConversionArena::Current() {
+  return arena_current;
+}
+
+void ConversionArena::Reset() {
+  index_chunk_ = 0;
+  pos_ = 0;
+  size_allocated_ = 0;
+}
+
+std::size_t ConversionArena::size_allocated() const {
+  return size_allocated_;
+}
+
+std::size_t ConversionArena::size_reserved() const {
+  std::size_t size = 0;
+  for (auto iter = chunks_.cbegin(); iter != chunks_.cend(); iter++) {
+    size += iter->size;
+  }
+  return size;
+}
@@ -0,0 +1,320 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "conversion_manifest.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "mapped_file.h"
+
+namespace {
+
+/// The file header, which identifies the format version.
+const char* kFileHeader = "# conversion manifest v1";
+
+/// The time between checkpoint saves.
+const std::chrono::seconds kTimeCheckpoint(5);
+
+/// \brief Hashes bytes using the FNV-1a algorithm, eight bytes at a time.
+/// \param[in] data
+///   The data.
+/// \param[in] size
+///   The number of bytes.
+/// \return The hash.
+uint64_t HashBytes(const char* data, const std::size_t& size) {
+  uint64_t hash = 14695981039346656037ULL;
+  auto combine = [&hash](const uint64_t& value) {
+    hash ^= value;
+    hash *= 1099511628211ULL;
+  };
+
+  std::size_t pos = 0;
+  for (; pos + 8 <= size; pos += 8) {
+    uint64_t word;
+    std::memcpy(&word, data + pos, 8);
+    combine(word);
+  }
+
+  for (; pos < size; pos++) {
+    combine(static_cast<unsigned char>(data[pos]));
+  }
+
+  // includes the size so trailing zero bytes change the hash
+  combine(static_cast<uint64_t>(size));
+  return hash;
+}
+
+/// \brief Parses a hexadecimal hash.
+/// \param[in] str
+///   The string.
+/// \param[out] hash
+///   The hash.
+/// \return If the string was parsed.
+bool ParseHash(const std::string& str, uint64_t& hash) {
+  if ((str.empty() == true) || (16 < str.size())) {
+    return false;
+  }
+
+  return std::sscanf(str.c_str(), "%" SCNx64, &hash) == 1;
+}
+
+/// \brief Replaces a file with new contents in one rename.
+/// \param[in] filepath
+///   The filepath.
+/// \param[in] buffer
+///   The file contents.
+/// \return The success status. The previous file is kept if this fails.
+/// The contents are written and synced to a temporary file, which is renamed
+/// over the file. The directory is then synced, so the rename survives a
+/// crash too.
+bool SaveFile(const std::string& filepath, const std::string& buffer) {
+  // writes and syncs a temporary file
+  const std::string filepath_temp = filepath + ".tmp";
+  FILE* file = fopen(filepath_temp.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  bool status = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+  status = (fflush(file) == 0) && status;
+#ifdef _WIN32
+  status = (_commit(_fileno(file)) == 0) && status;
+#else
+  status = (fsync(fileno(file)) == 0) && status;
+#endif
+  status = (fclose(file) == 0) && status;
+  if (status == false) {
+    wxRemoveFile(filepath_temp);
+    return false;
+  }
+
+  // replaces the file
+  if (wxRenameFile(filepath_temp, filepath, true) == false) {
+    return false;
+  }
+
+#ifndef _WIN32
+  // syncs the directory entry of the rename
+  std::string dir = ".";
+  const std::size_t pos = filepath.rfind('/');
+  if (pos == 0) {
+    dir = "/";
+  } else if (pos != std::string::npos) {
+    dir = filepath.substr(0, pos);
+  }
+
+  const int fd = open(dir.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return false;
+  }
+  status = fsync(fd) == 0;
+  status = (close(fd) == 0) && status;
+#endif
+
+  return status;
+}
+
+}  // namespace
+
+ConversionManifest::ConversionManifest() {
+  is_modified_ = false;
+  time_saved_ = std::chrono::steady_clock::now();
+}
+
+ConversionManifest::~ConversionManifest() {
+}
+
+uint64_t ConversionManifest::Hash(const std::string& str) {
+  return HashBytes(str.data(), str.size());
+}
+
+bool ConversionManifest::HashFile(const wxString& filepath, uint64_t& hash) {
+  MappedFile file;
+  if (file.Open(filepath) == false) {
+    return false;
+  }
+
+  hash = HashBytes(file.contents().data(), file.contents().size());
+  return true;
+}
+
+bool ConversionManifest::IsCurrent(const wxString& filepath_input,
+                                   const uint64_t& hash_input,
+                                   const uint64_t& hash_settings,
+                                   const wxString& filepath_output) const {
+  // compares the entry
+  uint64_t hash_output = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto iter =
+        entries_.find(std::string(filepath_input.ToUTF8().data()));
+    if (iter == entries_.cend()) {
+      return false;
+    }
+
+    const Entry& entry = iter->second;
+    if ((entry.hash_input != hash_input)
+        || (entry.hash_settings != hash_settings)
+        || (entry.filepath_output != filepath_output.ToUTF8().data())) {
+      return false;
+    }
+
+    hash_output = entry.hash_output;
+  }
+
+  // verifies the output file still exists and is unchanged
+  uint64_t hash = 0;
+  if (HashFile(filepath_output, hash) == false) {
+    return false;
+  }
+
+  return hash == hash_output;
+}
+
+bool ConversionManifest::Open(const std::string& filepath) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  filepath_ = filepath;
+  is_modified_ = false;
+  time_saved_ = std::chrono::steady_clock::now();
+
+  // a missing manifest is the same as an empty one
+  std::ifstream file(filepath.c_str());
+  if (file.is_open() == false) {
+    return true;
+  }
+
+  // validates header
+  std::string line;
+  if (!std::getline(file, line) || (line != kFileHeader)) {
+    wxLogWarning("Invalid conversion manifest file: "
+                 + wxString(filepath) + ".");
+    return false;
+  }
+
+  // reads an entry from each line
+  // format: input, output, input hash, settings hash, output hash (tab
+  // separated)
+  while (std::getline(file, line)) {
+    std::string fields[5];
+    std::size_t pos_start = 0;
+    int num_fields = 0;
+    while (num_fields < 5) {
+      const std::size_t pos_end = line.find('\t', pos_start);
+      fields[num_fields] = line.substr(pos_start, pos_end - pos_start);
+      num_fields++;
+      if (pos_end == std::string::npos) {
+        break;
+      }
+      pos_start = pos_end + 1;
+    }
+
+    Entry entry;
+    entry.filepath_output = fields[1];
+    if ((num_fields == 5)
+        && (fields[0].empty() == false)
+        && (ParseHash(fields[2], entry.hash_input) == true)
+        && (ParseHash(fields[3], entry.hash_settings) == true)
+        && (ParseHash(fields[4], entry.hash_output) == true)) {
+      entries_[fields[0]] = entry;
+    }
+  }
+
+  return true;
+}
+
+void ConversionManifest::Remove(const wxString& filepath_input) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (entries_.erase(std::string(filepath_input.ToUTF8().data())) != 0) {
+    is_modified_ = true;
+  }
+}
+
+bool ConversionManifest::Save() {
+  std::lock_guard<std::mutex> lock_save(mutex_save_);
+  return SaveSnapshot();
+}
+
+void ConversionManifest::Update(const wxString& filepath_input,
+                                const Entry& entry) {
+  bool is_checkpoint = false;
+  std::string filepath;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[std::string(filepath_input.ToUTF8().data())] = entry;
+    is_modified_ = true;
+
+    // claims the checkpoint, so only one thread saves it
+    const auto time_now = std::chrono::steady_clock::now();
+    if (kTimeCheckpoint <= time_now - time_saved_) {
+      time_saved_ = time_now;
+      is_checkpoint = true;
+      filepath = filepath_;
+    }
+  }
+
+  // saves the checkpoint, unless another save is already being written
+  if (is_checkpoint == true) {
+    std::unique_lock<std::mutex> lock_save(mutex_save_, std::try_to_lock);
+    if ((lock_save.owns_lock() == true) && (SaveSnapshot() == false)) {
+      wxLogWarning("Could not save conversion manifest checkpoint: "
+                   + wxString(filepath) + ".");
+    }
+  }
+}
+
+std::size_t ConversionManifest::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+bool ConversionManifest::SaveSnapshot() {
+  // generates the file contents from a snapshot of the entries
+  std::string buffer;
+  std::string filepath;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    time_saved_ = std::chrono::steady_clock::now();
+    if (is_modified_ == false) {
+      return true;
+    }
+
+    filepath = filepath_;
+    if (filepath.empty() == true) {
+      return false;
+    }
+
+    buffer = std::string(kFileHeader) + "\n";
+    for (auto iter = entries_.cbegin(); iter != entries_.cend(); iter++) {
+      const Entry& entry = iter->second;
+      char str_hashes[64];
+      snprintf(str_hashes, sizeof(str_hashes),
+               "%016" PRIx64 "\t%016" PRIx64 "\t%016" PRIx64,
+               entry.hash_input, entry.hash_settings, entry.hash_output);
+
+      buffer += iter->first + "\t" + entry.filepath_output + "\t"
+                + str_hashes + "\n";
+    }
+
+    // updates made while the file is written mark the manifest again
+    is_modified_ = false;
+  }
+
+  if (SaveFile(filepath, buffer) == false) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_modified_ = true;
+    return false;
+  }
+
+  return true;
+}
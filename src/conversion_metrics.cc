@@ -0,0 +1,324 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "conversion_metrics.h"
+
+#include <cstdio>
+
+#include "wx/filename.h"
+
+namespace {
+
+/// The upper bounds of the stage histogram buckets, in seconds. The last
+/// bucket (+Inf) has no bound.
+const double kBoundsBucket[] = {0.00005, 0.0001, 0.00025, 0.0005, 0.001,
+                                0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25,
+                                0.5, 1, 2.5, 10};
+
+/// The stage label values, in stage order.
+const char* const kNamesStage[] = {"read", "parse", "convert_units",
+                                   "solve_limits", "serialize", "write"};
+
+/// The number of metrics that have been created. This is used to give each
+/// metrics object a unique id.
+std::atomic<uint64_t> num_metrics(0);
+
+/// \brief Appends the help and type lines of a metric.
+/// \param[in] name
+///   The metric name.
+/// \param[in] type
+///   The metric type.
+/// \param[in] help
+///   The help text.
+/// \param[in,out] buffer
+///   The buffer.
+void AppendHeader(const char* name, const char* type, const char* help,
+                  std::string& buffer) {
+  buffer += "# HELP ";
+  buffer += name;
+  buffer += ' ';
+  buffer += help;
+  buffer += "\n# TYPE ";
+  buffer += name;
+  buffer += ' ';
+  buffer += type;
+  buffer += '\n';
+}
+
+}  // namespace
+
+ConversionMetrics::ConversionMetrics() {
+  id_ = ++num_metrics;
+  is_stopping_ = false;
+  period_ = std::chrono::seconds(10);
+}
+
+ConversionMetrics::~ConversionMetrics() {
+  StopSaving();
+}
+
+void ConversionMetrics::AddBytesRead(const int64_t& bytes) {
+  Add(bytes, ShardThread().counters[kBytesRead]);
+}
+
+void ConversionMetrics::AddBytesWritten(const int64_t& bytes) {
+  Add(bytes, ShardThread().counters[kBytesWritten]);
+}
+
+void ConversionMetrics::AddFile(const bool& is_converted) {
+  if (is_converted == true) {
+    Add(1, ShardThread().counters[kFilesConverted]);
+  } else {
+    Add(1, ShardThread().counters[kFilesFailed]);
+  }
+}
+
+void ConversionMetrics::AddLimitsUnsolved(const int64_t& num) {
+  Add(num, ShardThread().counters[kLimitsUnsolved]);
+}
+
+void ConversionMetrics::AddStage(
+    const Stage& stage,
+    const std::chrono::steady_clock::duration& duration) {
+  const int index_stage = static_cast<int>(stage);
+  const double seconds = std::chrono::duration<double>(duration).count();
+
+  // finds the first bucket that holds the duration
+  int index_bucket = 0;
+  while ((index_bucket < kNumBuckets - 1)
+         && (kBoundsBucket[index_bucket] < seconds)) {
+    index_bucket++;
+  }
+
+  Shard& shard = ShardThread();
+  Add(1, shard.buckets[index_stage][index_bucket]);
+  Add(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(),
+      shard.nanoseconds[index_stage]);
+}
+
+std::string ConversionMetrics::Format() const {
+  // sums the shards
+  int64_t buckets[kNumStages][kNumBuckets] = {};
+  int64_t counters[kNumCounters] = {};
+  int64_t nanoseconds[kNumStages] = {};
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto iter = shards_.cbegin(); iter != shards_.cend(); iter++) {
+      const Shard& shard = **iter;
+      for (int i = 0; i < kNumStages; i++) {
+        for (int j = 0; j < kNumBuckets; j++) {
+          buckets[i][j] +=
+              shard.buckets[i][j].load(std::memory_order_relaxed);
+        }
+        nanoseconds[i] += shard.nanoseconds[i].load(std::memory_order_relaxed);
+      }
+
+      for (int i = 0; i < kNumCounters; i++) {
+        counters[i] += shard.counters[i].load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // formats the counters
+  std::string buffer;
+  char str[256];
+
+  AppendHeader("cableconverter_files_total", "counter",
+               "Input files (or records) that finished converting, by "
+               "result.", buffer);
+  snprintf(str, sizeof(str),
+           "cableconverter_files_total{result=\"converted\"} %lld\n"
+           "cableconverter_files_total{result=\"failed\"} %lld\n",
+           static_cast<long long>(counters[kFilesConverted]),
+           static_cast<long long>(counters[kFilesFailed]));
+  buffer += str;
+
+  AppendHeader("cableconverter_read_bytes_total", "counter",
+               "Bytes read from input files.", buffer);
+  snprintf(str, sizeof(str), "cableconverter_read_bytes_total %lld\n",
+           static_cast<long long>(counters[kBytesRead]));
+  buffer += str;
+
+  AppendHeader("cableconverter_written_bytes_total", "counter",
+               "Bytes written to output files and limit tables.", buffer);
+  snprintf(str, sizeof(str), "cableconverter_written_bytes_total %lld\n",
+           static_cast<long long>(counters[kBytesWritten]));
+  buffer += str;
+
+  AppendHeader("cableconverter_limits_unsolved_total", "counter",
+               "Polynomial limits that could not be solved, which are "
+               "logged as 'Could not solve for ... polynomial limit.'",
+               buffer);
+  snprintf(str, sizeof(str), "cableconverter_limits_unsolved_total %lld\n",
+           static_cast<long long>(counters[kLimitsUnsolved]));
+  buffer += str;
+
+  // formats the stage histograms, with cumulative buckets
+  AppendHeader("cableconverter_stage_duration_seconds", "histogram",
+               "Time spent in each conversion stage.", buffer);
+  for (int i = 0; i < kNumStages; i++) {
+    int64_t count = 0;
+    for (int j = 0; j < kNumBuckets; j++) {
+      count += buckets[i][j];
+      if (j < kNumBuckets - 1) {
+        snprintf(str, sizeof(str),
+                 "cableconverter_stage_duration_seconds_bucket{stage=\"%s\","
+                 "le=\"%g\"} %lld\n",
+                 kNamesStage[i], kBoundsBucket[j],
+                 static_cast<long long>(count));
+      } else {
+        snprintf(str, sizeof(str),
+                 "cableconverter_stage_duration_seconds_bucket{stage=\"%s\","
+                 "le=\"+Inf\"} %lld\n",
+                 kNamesStage[i], static_cast<long long>(count));
+      }
+      buffer += str;
+    }
+
+    snprintf(str, sizeof(str),
+             "cableconverter_stage_duration_seconds_sum{stage=\"%s\"} %.9f\n"
+             "cableconverter_stage_duration_seconds_count{stage=\"%s\"} "
+             "%lld\n",
+             kNamesStage[i], nanoseconds[i] / 1e9, kNamesStage[i],
+             static_cast<long long>(count));
+    buffer += str;
+  }
+
+  return buffer;
+}
+
+bool ConversionMetrics::Save(const wxString& filepath) const {
+  const std::string buffer = Format();
+
+  // the temporary file is hidden, and in the same directory so the rename
+  // does not move the file across file systems
+  const wxFileName filename(filepath);
+  const wxString filepath_temp =
+      wxFileName(filename.GetPath(), "." + filename.GetFullName() + ".tmp")
+          .GetFullPath();
+
+  FILE* file = fopen(filepath_temp.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  const std::size_t size = fwrite(buffer.data(), 1, buffer.size(), file);
+  const bool is_closed = fclose(file) == 0;
+  if ((size != buffer.size()) || (is_closed == false)
+      || (wxRenameFile(filepath_temp, filepath, true) == false)) {
+    wxRemoveFile(filepath_temp);
+    return false;
+  }
+
+  return true;
+}
+
+void ConversionMetrics::StartSaving(const wxString& filepath,
+                                    const double& seconds) {
+  StopSaving();
+
+  filepath_ = filepath;
+  is_stopping_ = false;
+  period_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(seconds));
+
+  if (Save(filepath_) == false) {
+    wxLogWarning("Could not save metrics file: " + filepath_ + ".");
+  }
+  thread_ = std::thread(&ConversionMetrics::RunSaving, this);
+}
+
+bool ConversionMetrics::StopSaving() {
+  if (thread_.joinable() == false) {
+    return true;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  stopping_.notify_all();
+  thread_.join();
+
+  return Save(filepath_);
+}
+
+void ConversionMetrics::Add(const int64_t& num, std::atomic<int64_t>& value) {
+  // only the owning thread writes the value, so it doesn't need an atomic
+  // increment
+  value.store(value.load(std::memory_order_relaxed) + num,
+              std::memory_order_relaxed);
+}
+
+void ConversionMetrics::RunSaving() {
+  // a failure is only logged once until a save succeeds again, so a missing
+  // directory doesn't flood the log
+  bool is_failed = false;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    if (stopping_.wait_for(lock, period_, [this] { return is_stopping_; })
+        == true) {
+      break;
+    }
+
+    // formatting locks the shard list, so the lock is released while saving
+    lock.unlock();
+    const bool status = Save(filepath_);
+    if ((status == false) && (is_failed == false)) {
+      wxLogWarning("Could not save metrics file: " + filepath_ + ".");
+    }
+    is_failed = status == false;
+    lock.lock();
+  }
+}
+
+ConversionMetrics::Shard& ConversionMetrics::ShardThread() {
+  // caches the shard of the calling thread, so only the first count of each
+  // thread locks the mutex
+  static thread_local uint64_t id_cached = 0;
+  static thread_local Shard* shard_cached = nullptr;
+  if (id_cached == id_) {
+    return *shard_cached;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const std::thread::id thread = std::this_thread::get_id();
+  Shard* shard = nullptr;
+  for (auto iter = shards_.cbegin(); iter != shards_.cend(); iter++) {
+    if ((*iter)->thread == thread) {
+      shard = iter->get();
+      break;
+    }
+  }
+
+  // the shard is value initialized, which zeroes the values
+  if (shard == nullptr) {
+    shards_.push_back(std::unique_ptr<Shard>(new Shard()));
+    shard = shards_.back().get();
+    shard->thread = thread;
+  }
+
+  id_cached = id_;
+  shard_cached = shard;
+  return *shard;
+}
+
+MetricsTimer::MetricsTimer(ConversionMetrics* metrics,
+                           const ConversionMetrics::Stage& stage) {
+  metrics_ = metrics;
+  if (metrics_ == nullptr) {
+    return;
+  }
+
+  stage_ = stage;
+  start_ = std::chrono::steady_clock::now();
+}
+
+MetricsTimer::~MetricsTimer() {
+  if (metrics_ == nullptr) {
+    return;
+  }
+
+  metrics_->AddStage(stage_, std::chrono::steady_clock::now() - start_);
+}
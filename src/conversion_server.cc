@@ -0,0 +1,570 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "conversion_server.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "wx/filename.h"
+
+#include "async_log_sink.h"
+
+namespace {
+
+/// The number of accepted sockets that can wait for each worker thread.
+const std::size_t kNumQueuedPerThread = 4;
+
+/// The maximum size of a request header line.
+const std::size_t kSizeLineMax = 4096;
+
+/// The maximum size of inline input.
+const std::size_t kSizeInputMax = 64 * 1024 * 1024;
+
+/// The time a connection can be idle before it is closed.
+const std::chrono::milliseconds kTimeIdle(30000);
+
+/// The time between checks for a stop request while waiting on a socket.
+const int kTimePollMs = 200;
+
+#ifndef _WIN32
+#ifdef MSG_NOSIGNAL
+/// The send flags, which keep a closed client from raising SIGPIPE.
+const int kFlagsSend = MSG_NOSIGNAL;
+#else
+const int kFlagsSend = 0;
+#endif
+
+/// \brief Formats a response.
+/// \param[in] status
+///   The response status.
+/// \param[in] message
+///   The error message. Line breaks are replaced with spaces.
+/// \param[in] buffer
+///   The cable file.
+/// \return The response header and body.
+std::string FormatResponse(const std::string& status,
+                           const wxString& message,
+                           const std::string& buffer) {
+  std::string response = "status=" + status + "\n";
+  if (message.empty() == false) {
+    std::string str = message.ToStdString();
+    for (auto iter = str.begin(); iter != str.end(); iter++) {
+      if ((*iter == '\n') || (*iter == '\r')) {
+        *iter = ' ';
+      }
+    }
+    response += "message=" + str + "\n";
+  }
+  response += "length=" + std::to_string(buffer.size()) + "\n\n";
+  response += buffer;
+  return response;
+}
+
+/// \brief Receives more bytes from a socket.
+/// \param[in] socket
+///   The socket.
+/// \param[in] is_stopping
+///   An indicator that tells if the server is stopping.
+/// \param[in,out] buffer
+///   The buffer that received bytes are appended to.
+/// \return If any bytes were received. This is false if the connection was
+///   closed, was idle too long, or the server is stopping.
+bool Receive(const int& socket, const std::atomic<bool>& is_stopping,
+             std::string& buffer) {
+  const auto time_end = std::chrono::steady_clock::now() + kTimeIdle;
+  while (is_stopping == false) {
+    if (time_end < std::chrono::steady_clock::now()) {
+      return false;
+    }
+
+    pollfd descriptor;
+    descriptor.fd = socket;
+    descriptor.events = POLLIN;
+    descriptor.revents = 0;
+    const int num_ready = poll(&descriptor, 1, kTimePollMs);
+    if (num_ready == 0) {
+      continue;
+    } else if (num_ready < 0) {
+      return false;
+    }
+
+    char chunk[65536];
+    const ssize_t size = recv(socket, chunk, sizeof(chunk), 0);
+    if (size <= 0) {
+      return false;
+    }
+
+    buffer.append(chunk, size);
+    return true;
+  }
+
+  return false;
+}
+
+/// \brief Reads a line from a socket.
+/// \param[in] socket
+///   The socket.
+/// \param[in] is_stopping
+///   An indicator that tells if the server is stopping.
+/// \param[in,out] buffer
+///   The bytes that were received but not yet read.
+/// \param[out] line
+///   The line, without the line break.
+/// \return If a line was read.
+bool ReadLine(const int& socket, const std::atomic<bool>& is_stopping,
+              std::string& buffer, std::string& line) {
+  std::size_t pos = 0;
+  while (true) {
+    const std::size_t pos_end = buffer.find('\n', pos);
+    if (pos_end != std::string::npos) {
+      line.assign(buffer, 0, pos_end);
+      buffer.erase(0, pos_end + 1);
+      if ((line.empty() == false) && (line.back() == '\r')) {
+        line.pop_back();
+      }
+      return true;
+    }
+
+    if (kSizeLineMax < buffer.size()) {
+      return false;
+    }
+
+    pos = buffer.size();
+    if (Receive(socket, is_stopping, buffer) == false) {
+      return false;
+    }
+  }
+}
+
+/// \brief Reads a fixed number of bytes from a socket.
+/// \param[in] socket
+///   The socket.
+/// \param[in] is_stopping
+///   An indicator that tells if the server is stopping.
+/// \param[in] size
+///   The number of bytes to read.
+/// \param[in,out] buffer
+///   The bytes that were received but not yet read.
+/// \param[out] bytes
+///   The bytes that were read.
+/// \return If all of the bytes were read.
+bool ReadBytes(const int& socket, const std::atomic<bool>& is_stopping,
+               const std::size_t& size, std::string& buffer,
+               std::string& bytes) {
+  while (buffer.size() < size) {
+    if (Receive(socket, is_stopping, buffer) == false) {
+      return false;
+    }
+  }
+
+  bytes.assign(buffer, 0, size);
+  buffer.erase(0, size);
+  return true;
+}
+
+/// \brief Sends all bytes to a socket.
+/// \param[in] socket
+///   The socket.
+/// \param[in] data
+///   The bytes to send.
+/// \return If all of the bytes were sent.
+bool SendAll(const int& socket, const std::string& data) {
+  std::size_t pos = 0;
+  while (pos < data.size()) {
+    const ssize_t size = send(socket, data.data() + pos, data.size() - pos,
+                              kFlagsSend);
+    if (size <= 0) {
+      return false;
+    }
+    pos += size;
+  }
+
+  return true;
+}
+#endif
+
+}  // namespace
+
+std::atomic<bool> ConversionServer::is_stop_requested_(false);
+
+ConversionServer::ConversionServer(const CableConverter* converter) {
+  converter_ = converter;
+  is_stopping_ = false;
+  num_failed_ = 0;
+  num_served_ = 0;
+  size_queue_max_ = kNumQueuedPerThread;
+}
+
+ConversionServer::~ConversionServer() {
+}
+
+void ConversionServer::RequestStop() {
+  is_stop_requested_ = true;
+}
+
+bool ConversionServer::Run(const wxString& filepath_socket,
+                           const int& num_jobs) {
+#ifdef _WIN32
+  wxLogError("The conversion server is not supported on this platform.");
+  return false;
+#else
+  const std::string path = filepath_socket.ToStdString();
+
+  sockaddr_un address;
+  address.sun_family = AF_UNIX;
+  if ((path.empty() == true) || (sizeof(address.sun_path) <= path.size())) {
+    wxLogError("Invalid socket filepath: " + filepath_socket + ".");
+    return false;
+  }
+  std::snprintf(address.sun_path, sizeof(address.sun_path), "%s",
+                path.c_str());
+
+  // replaces a stale socket file, but not one that a server is listening on
+  // or a file that is not a socket
+  struct stat status;
+  if (stat(path.c_str(), &status) == 0) {
+    if (S_ISSOCK(status.st_mode) == false) {
+      wxLogError("The socket filepath is an existing file: " + filepath_socket
+                 + ".");
+      return false;
+    }
+
+    const int socket_probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    const bool is_listening =
+        connect(socket_probe, reinterpret_cast<sockaddr*>(&address),
+                sizeof(address)) == 0;
+    close(socket_probe);
+
+    if (is_listening == true) {
+      wxLogError("A server is already listening on: " + filepath_socket
+                 + ".");
+      return false;
+    }
+    unlink(path.c_str());
+  }
+
+  // creates the listening socket
+  const int socket_listen = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (socket_listen == -1) {
+    wxLogError("Could not create socket.");
+    return false;
+  }
+  fcntl(socket_listen, F_SETFD, FD_CLOEXEC);
+
+  // only the current user can connect, so the socket file is created without
+  // group or other permissions, and is never accessible to them
+  const mode_t mask = umask(S_IRWXG | S_IRWXO);
+  const bool is_bound = bind(socket_listen,
+                             reinterpret_cast<sockaddr*>(&address),
+                             sizeof(address)) == 0;
+  umask(mask);
+
+  if ((is_bound == false) || (listen(socket_listen, 64) != 0)) {
+    wxLogError("Could not listen on socket: " + filepath_socket + ".");
+    close(socket_listen);
+    return false;
+  }
+
+  // determines the number of worker threads
+  int num_threads = num_jobs;
+  if (num_threads < 1) {
+    num_threads = std::thread::hardware_concurrency();
+  }
+  if (num_threads < 1) {
+    num_threads = 1;
+  }
+
+  is_stopping_ = false;
+  size_queue_max_ = kNumQueuedPerThread * num_threads;
+
+  // workers log directly to the active target if it is thread safe
+  wxLog* log = dynamic_cast<AsyncLogSink*>(wxLog::GetActiveTarget());
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.push_back(std::thread(&ConversionServer::ServeConnections, this,
+                                  log));
+  }
+
+  wxLogMessage("Serving on: " + filepath_socket);
+
+  // accepts connections
+  while (is_stop_requested_ == false) {
+    pollfd descriptor;
+    descriptor.fd = socket_listen;
+    descriptor.events = POLLIN;
+    descriptor.revents = 0;
+    if (0 < poll(&descriptor, 1, kTimePollMs)) {
+      const int socket_client = accept(socket_listen, nullptr, nullptr);
+      if (socket_client != -1) {
+        fcntl(socket_client, F_SETFD, FD_CLOEXEC);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (queue_.size() < size_queue_max_) {
+          queue_.push_back(socket_client);
+          lock.unlock();
+          condition_.notify_one();
+        } else {
+          lock.unlock();
+          SendAll(socket_client,
+                  FormatResponse("busy", "The server is busy.", ""));
+          close(socket_client);
+        }
+      }
+    }
+
+    // shows messages from the worker threads if they are buffered
+    wxLog::FlushActive();
+  }
+
+  // stops the worker threads after their current requests
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  condition_.notify_all();
+
+  for (auto iter = threads.begin(); iter != threads.end(); iter++) {
+    iter->join();
+  }
+
+  for (auto iter = queue_.cbegin(); iter != queue_.cend(); iter++) {
+    close(*iter);
+  }
+  queue_.clear();
+
+  close(socket_listen);
+  unlink(path.c_str());
+
+  wxLog::FlushActive();
+
+  wxString message;
+  message << "Server summary: " << num_served_.load() << " served, "
+          << num_failed_.load() << " failed.";
+  wxLogMessage(message);
+
+  return true;
+#endif
+}
+
+long ConversionServer::num_failed() const {
+  return num_failed_;
+}
+
+long ConversionServer::num_served() const {
+  return num_served_;
+}
+
+void ConversionServer::ServeConnection(const int& socket) {
+#ifndef _WIN32
+  std::string buffer;
+  std::string line;
+  while (true) {
+    // reads the request header
+    std::map<std::string, std::string> headers;
+    bool is_valid = true;
+    while (true) {
+      if (ReadLine(socket, is_stopping_, buffer, line) == false) {
+        close(socket);
+        return;
+      }
+
+      if (line.empty() == true) {
+        break;
+      }
+
+      const std::size_t pos = line.find('=');
+      if (pos == std::string::npos) {
+        is_valid = false;
+      } else {
+        headers[line.substr(0, pos)] = line.substr(pos + 1);
+      }
+    }
+
+    // empty requests are ignored, so clients can check the connection
+    if (headers.empty() == true) {
+      continue;
+    }
+
+    // the connection is closed after a framing error, as the start of the
+    // next request can't be found
+    const auto iter_length = headers.find("length");
+    std::size_t size_input = 0;
+    if ((is_valid == true) && (iter_length != headers.cend())) {
+      char* end = nullptr;
+      const unsigned long long value =
+          std::strtoull(iter_length->second.c_str(), &end, 10);
+      if ((iter_length->second.empty() == true) || (*end != '\0')
+          || (kSizeInputMax < value)) {
+        is_valid = false;
+      }
+      size_input = static_cast<std::size_t>(value);
+    }
+
+    if (is_valid == false) {
+      SendAll(socket, FormatResponse("error", "Invalid request header.", ""));
+      num_failed_++;
+      break;
+    }
+
+    std::string input;
+    if (ReadBytes(socket, is_stopping_, size_input, buffer, input) == false) {
+      break;
+    }
+
+    // serves the request
+    const auto time_start = std::chrono::steady_clock::now();
+
+    std::string output;
+    wxString message;
+    std::string response;
+    const bool is_converted =
+        ServeRequest(headers, input, output, message);
+    if (is_converted == true) {
+      response = FormatResponse("ok", "", output);
+      num_served_++;
+    } else {
+      response = FormatResponse("error", message, "");
+      num_failed_++;
+    }
+
+    if (converter_->metrics() != nullptr) {
+      converter_->metrics()->AddFile(is_converted);
+    }
+
+    const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - time_start);
+    wxString str;
+    str << "Served request in " << duration.count() / 1000.0 << " ms.";
+    wxLogVerbose(str);
+
+    if (SendAll(socket, response) == false) {
+      break;
+    }
+  }
+
+  close(socket);
+#endif
+}
+
+bool ConversionServer::ServeRequest(
+    const std::map<std::string, std::string>& headers,
+    const std::string& input, std::string& buffer, wxString& message) {
+  // copies the default settings and applies the request settings
+  CableConverter converter(*converter_);
+
+  auto iter = headers.find("units");
+  if (iter != headers.cend()) {
+    if (iter->second == "imperial") {
+      converter.set_units(units::UnitSystem::kImperial);
+    } else if (iter->second == "metric") {
+      converter.set_units(units::UnitSystem::kMetric);
+    } else {
+      message = "Invalid units: " + iter->second + ".";
+      return false;
+    }
+  }
+
+  iter = headers.find("strain");
+  if (iter != headers.cend()) {
+    char* end = nullptr;
+    const double value = std::strtod(iter->second.c_str(), &end);
+    if ((iter->second.empty() == true) || (*end != '\0')) {
+      message = "Invalid strain: " + iter->second + ".";
+      return false;
+    }
+    converter.set_strain_percent_polynomial_limits(value);
+  }
+
+  iter = headers.find("compact");
+  if (iter != headers.cend()) {
+    if ((iter->second != "0") && (iter->second != "1")) {
+      message = "Invalid compact: " + iter->second + ".";
+      return false;
+    }
+    converter.set_is_compact(iter->second == "1");
+  }
+
+  iter = headers.find("format");
+  if (iter != headers.cend()) {
+    if (iter->second == "xml") {
+      converter.set_format(CableConverter::Format::kXml);
+    } else if (iter->second == "bin") {
+      converter.set_format(CableConverter::Format::kBinary);
+    } else {
+      message = "Invalid format: " + iter->second + ".";
+      return false;
+    }
+  }
+
+  // converts the input file, or the inline input directly from memory
+  iter = headers.find("input");
+  if (iter != headers.cend()) {
+    const wxString filepath = wxString::FromUTF8(iter->second.c_str());
+    std::string name_cable;
+    return converter.ConvertToBuffer(filepath, buffer, name_cable, message);
+  } else if (headers.find("length") != headers.cend()) {
+    wxString name = "input";
+    iter = headers.find("name");
+    if (iter != headers.cend()) {
+      name = wxFileName(wxString::FromUTF8(iter->second.c_str()))
+                 .GetFullName();
+    }
+
+    CableConverter::Conversion conversion;
+    if (converter.ConvertBuffer(name, TextView(input.data(), input.size()),
+                                conversion) == false) {
+      message = conversion.message;
+      return false;
+    }
+
+    buffer.swap(conversion.buffer);
+    return true;
+  } else {
+    message = "The request has no input or length.";
+    return false;
+  }
+}
+
+void ConversionServer::ServeConnections(wxLog* log) {
+  if (log != nullptr) {
+    wxLog::SetThreadActiveTarget(log);
+  }
+
+  while (true) {
+    // waits for the next connection
+    int socket = -1;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while ((is_stopping_ == false) && (queue_.empty() == true)) {
+        condition_.wait(lock);
+      }
+
+      if (is_stopping_ == true) {
+        break;
+      }
+
+      socket = queue_.front();
+      queue_.pop_front();
+    }
+
+    ServeConnection(socket);
+  }
+
+  if (log != nullptr) {
+    wxLog::SetThreadActiveTarget(nullptr);
+  }
+}
@@ -0,0 +1,306 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "delimiter_scanner.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "simd_support.h"
+
+namespace {
+
+/// \brief Gets the index of the lowest set bit.
+/// \param[in] mask
+///   The mask, which must not be zero.
+inline uint32_t LowestBit(const uint32_t& mask) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<uint32_t>(index);
+#else
+  return static_cast<uint32_t>(__builtin_ctz(mask));
+#endif
+}
+
+/// \brief Appends the positions of the set bits in a mask.
+/// \param[in] mask
+///   The mask, where each bit is a byte in the block.
+/// \param[in] offset
+///   The position of the first byte in the block.
+/// \param[out] positions
+///   The positions.
+inline void AppendPositions(uint32_t mask, const uint32_t& offset,
+                            ArenaVector<uint32_t>& positions) {
+  while (mask != 0) {
+    positions.push_back(offset + LowestBit(mask));
+    mask &= mask - 1;
+  }
+}
+
+/// \brief Scans bytes using scalar code.
+void ScanScalar(const char* data, const uint32_t& begin, const uint32_t& end,
+                const char& c_separator, const bool& is_separator,
+                const char& c_boundary, const bool& is_boundary,
+                ArenaVector<uint32_t>& positions_separator,
+                ArenaVector<uint32_t>& positions_boundary) {
+  for (uint32_t i = begin; i < end; i++) {
+    const char c = data[i];
+    if ((is_separator == true) && (c == c_separator)) {
+      positions_separator.push_back(i);
+    }
+    if ((is_boundary == true) && (c == c_boundary)) {
+      positions_boundary.push_back(i);
+    }
+  }
+}
+
+#ifdef OTLS_SIMD_SSE2
+
+/// \brief Scans 16 byte blocks using SSE2 code.
+/// \return The position after the last full block.
+uint32_t ScanSse2(const char* data, const uint32_t& size,
+                  const char& c_separator, const bool& is_separator,
+                  const char& c_boundary, const bool& is_boundary,
+                  ArenaVector<uint32_t>& positions_separator,
+                  ArenaVector<uint32_t>& positions_boundary) {
+  const __m128i separator = _mm_set1_epi8(c_separator);
+  const __m128i boundary = _mm_set1_epi8(c_boundary);
+
+  uint32_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m128i block = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(data + i));
+    if (is_separator == true) {
+      const uint32_t mask = static_cast<uint32_t>(
+          _mm_movemask_epi8(_mm_cmpeq_epi8(block, separator)));
+      AppendPositions(mask, i, positions_separator);
+    }
+    if (is_boundary == true) {
+      const uint32_t mask = static_cast<uint32_t>(
+          _mm_movemask_epi8(_mm_cmpeq_epi8(block, boundary)));
+      AppendPositions(mask, i, positions_boundary);
+    }
+  }
+  return i;
+}
+
+#endif  // OTLS_SIMD_SSE2
+
+#ifdef OTLS_SIMD_AVX2
+
+/// \brief Scans 32 byte blocks using AVX2 code.
+/// \return The position after the last full block.
+OTLS_TARGET_AVX2
+uint32_t ScanAvx2(const char* data, const uint32_t& size,
+                  const char& c_separator, const bool& is_separator,
+                  const char& c_boundary, const bool& is_boundary,
+                  ArenaVector<uint32_t>& positions_separator,
+                  ArenaVector<uint32_t>& positions_boundary) {
+  const __m256i separator = _mm256_set1_epi8(c_separator);
+  const __m256i boundary = _mm256_set1_epi8(c_boundary);
+
+  uint32_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const __m256i block = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(data + i));
+    if (is_separator == true) {
+      const uint32_t mask = static_cast<uint32_t>(
+          _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, separator)));
+      AppendPositions(mask, i, positions_separator);
+    }
+    if (is_boundary == true) {
+      const uint32_t mask = static_cast<uint32_t>(
+          _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, boundary)));
+      AppendPositions(mask, i, positions_boundary);
+    }
+  }
+  return i;
+}
+
+#endif  // OTLS_SIMD_AVX2
+
+/// \brief Finds the first full match of a delimiter string.
+/// \param[in] text
+///   The text.
+/// \param[in] delimiter
+///   The delimiter string.
+/// \param[in] positions
+///   The positions of the first delimiter character.
+/// \param[in,out] index_position
+///   The position index to start searching at. This is updated to the index
+///   of the match.
+/// \param[in] pos_min
+///   The minimum text position of the match.
+/// \return The text position of the match, or npos if not found.
+/// This finds the same match as TextView::find(delimiter, pos_min).
+std::size_t FindMatch(const TextView& text, const TextView& delimiter,
+                      const ArenaVector<uint32_t>& positions,
+                      std::size_t& index_position,
+                      const std::size_t& pos_min) {
+  for (; index_position < positions.size(); index_position++) {
+    const std::size_t pos = positions[index_position];
+    if (pos < pos_min) {
+      continue;
+    }
+
+    if (text.size() - pos < delimiter.size()) {
+      return TextView::npos;
+    }
+
+    if (text.substr(pos, delimiter.size()) == delimiter) {
+      return pos;
+    }
+  }
+
+  return TextView::npos;
+}
+
+}  // namespace
+
+TextView DelimiterScanner::Extract(const FieldIndex& index) {
+  if (index.boundary.empty() == true) {
+    return TextView();
+  }
+
+  // finds start position
+  std::size_t index_position = 0;
+  std::size_t pos_start = FindMatch(index.text, index.boundary,
+                                    index.positions_boundary, index_position,
+                                    0);
+  if (pos_start == TextView::npos) {
+    return TextView();
+  }
+  pos_start++;
+
+  // finds end position
+  const std::size_t pos_end = FindMatch(index.text, index.boundary,
+                                        index.positions_boundary,
+                                        index_position, pos_start);
+  if (pos_end == TextView::npos) {
+    return TextView();
+  }
+
+  // extracts
+  return index.text.substr(pos_start, pos_end - pos_start);
+}
+
+bool DelimiterScanner::Index(const TextView& text,
+                             const TextView& separator,
+                             const TextView& boundary,
+                             FieldIndex& index) {
+  index.boundary = boundary;
+  index.positions_boundary.clear();
+  index.positions_separator.clear();
+  index.separator = separator;
+  index.text = text;
+
+  // validates
+  if (static_cast<std::size_t>(UINT32_MAX) < text.size()) {
+    return false;
+  }
+
+  const char* data = text.data();
+  const uint32_t size = static_cast<uint32_t>(text.size());
+  const bool is_separator = separator.empty() == false;
+  const bool is_boundary = boundary.empty() == false;
+  const char c_separator = is_separator ? separator[0] : '\0';
+  const char c_boundary = is_boundary ? boundary[0] : '\0';
+
+  // scans full blocks with the widest instruction set, and then the
+  // remaining bytes with scalar code
+  uint32_t pos = 0;
+#ifdef OTLS_SIMD_AVX2
+  if (simd::IsAvx2Supported() == true) {
+    pos = ScanAvx2(data, size, c_separator, is_separator,
+                   c_boundary, is_boundary,
+                   index.positions_separator, index.positions_boundary);
+  }
+#endif
+#ifdef OTLS_SIMD_SSE2
+  if (pos == 0) {
+    pos = ScanSse2(data, size, c_separator, is_separator,
+                   c_boundary, is_boundary,
+                   index.positions_separator, index.positions_boundary);
+  }
+#endif
+  ScanScalar(data, pos, size, c_separator, is_separator,
+             c_boundary, is_boundary,
+             index.positions_separator, index.positions_boundary);
+
+  return true;
+}
+
+bool DelimiterScanner::Separate(const FieldIndex& index,
+                                TextView& str_left,
+                                TextView& str_right) {
+  // clears output views
+  str_left = TextView();
+  str_right = TextView();
+
+  // finds separator position
+  // an empty separator matches at the start, the same as find()
+  std::size_t index_position = 0;
+  std::size_t pos = 0;
+  if (index.separator.empty() == false) {
+    pos = FindMatch(index.text, index.separator, index.positions_separator,
+                    index_position, 0);
+  }
+  if (pos == TextView::npos) {
+    return false;
+  }
+
+  // creates left and right views
+  str_left = index.text.substr(0, pos);
+  str_right = index.text.substr(pos + 1);
+
+  return true;
+}
+
+void DelimiterScanner::Split(const FieldIndex& index,
+                             ArenaVector<TextView>& tokens) {
+  tokens.clear();
+
+  // an empty separator matches at every position, so every substring is
+  // empty and dropped, the same as FileParser::SubStrings()
+  if (index.separator.empty() == true) {
+    return;
+  }
+
+  // creates substrings between separators and skips empty substrings
+  std::size_t index_position = 0;
+  std::size_t pos_before = 0;
+  std::size_t pos = FindMatch(index.text, index.separator,
+                              index.positions_separator, index_position,
+                              pos_before);
+  while (pos != TextView::npos) {
+    const TextView sub_str = index.text.substr(pos_before, pos - pos_before);
+    if (sub_str.empty() == false) {
+      tokens.push_back(sub_str);
+    }
+
+    pos_before = pos + 1;
+    pos = FindMatch(index.text, index.separator, index.positions_separator,
+                    index_position, pos_before);
+  }
+
+  // adds last substring
+  const TextView sub_str = index.text.substr(pos_before);
+  if (sub_str.empty() == false) {
+    tokens.push_back(sub_str);
+  }
+}
+
+const char* DelimiterScanner::InstructionSet() {
+#ifdef OTLS_SIMD_AVX2
+  if (simd::IsAvx2Supported() == true) {
+    return "avx2";
+  }
+#endif
+#ifdef OTLS_SIMD_SSE2
+  return "sse2";
+#else
+  return "scalar";
+#endif
+}
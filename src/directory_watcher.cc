@@ -0,0 +1,261 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "directory_watcher.h"
+
+#include <algorithm>
+#include <thread>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "wx/dir.h"
+#include "wx/filename.h"
+
+namespace {
+
+/// The time a closed file must be unchanged before it is ready.
+const std::chrono::milliseconds kTimeSettleClosed(50);
+
+/// The time a file that was not closed must be unchanged before it is ready.
+const std::chrono::milliseconds kTimeSettleOpen(2000);
+
+/// The time a polled file must be unchanged before it is ready.
+const std::chrono::milliseconds kTimeSettlePoll(500);
+
+/// The time between directory polls.
+const std::chrono::milliseconds kTimePoll(250);
+
+}  // namespace
+
+DirectoryWatcher::DirectoryWatcher() {
+  handle_ = -1;
+  is_open_ = false;
+}
+
+DirectoryWatcher::~DirectoryWatcher() {
+  Close();
+}
+
+void DirectoryWatcher::Close() {
+#ifdef __linux__
+  if (handle_ != -1) {
+    close(handle_);
+  }
+#endif
+
+  handle_ = -1;
+  is_open_ = false;
+  pending_.clear();
+  snapshot_.clear();
+}
+
+bool DirectoryWatcher::Open(const wxString& dir) {
+  Close();
+  dir_ = dir;
+
+#ifdef __linux__
+  handle_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (handle_ == -1) {
+    return false;
+  }
+
+  const uint32_t mask = IN_CLOSE_WRITE | IN_CREATE | IN_MODIFY | IN_MOVED_TO
+                        | IN_DELETE_SELF | IN_MOVE_SELF;
+  if (inotify_add_watch(handle_, dir.fn_str(), mask) == -1) {
+    Close();
+    return false;
+  }
+#endif
+
+  // the snapshot is only compared on Linux if the event queue overflows
+  if (Scan(false) == false) {
+    Close();
+    return false;
+  }
+
+  is_open_ = true;
+  return true;
+}
+
+bool DirectoryWatcher::Wait(const std::chrono::milliseconds& timeout,
+                            std::vector<wxString>& filepaths) {
+  filepaths.clear();
+  if (is_open_ == false) {
+    return false;
+  }
+
+  // wakes up early enough to report pending files once they settle
+  std::chrono::milliseconds timeout_events = timeout;
+  if (pending_.empty() == false) {
+    timeout_events = std::min(timeout_events, kTimeSettleClosed);
+  }
+
+  const bool is_valid = ReadEvents(timeout_events);
+  PopReady(filepaths);
+  if (is_valid == false) {
+    is_open_ = false;
+  }
+  return is_valid;
+}
+
+bool DirectoryWatcher::IsIgnored(const std::string& name) {
+  if (name.empty() == true) {
+    return true;
+  }
+
+  if (name[0] == '.') {
+    return true;
+  }
+
+  const std::string extension = ".tmp";
+  if ((extension.size() <= name.size())
+      && (name.compare(name.size() - extension.size(), extension.size(),
+                       extension) == 0)) {
+    return true;
+  }
+
+  return false;
+}
+
+void DirectoryWatcher::OnChange(const std::string& name,
+                                const bool& is_closed) {
+  if (IsIgnored(name) == true) {
+    return;
+  }
+
+  PendingFile& file = pending_[name];
+  file.is_closed = is_closed;
+  file.time_changed = std::chrono::steady_clock::now();
+}
+
+void DirectoryWatcher::PopReady(std::vector<wxString>& filepaths) {
+  const std::chrono::steady_clock::time_point now =
+      std::chrono::steady_clock::now();
+
+  for (auto iter = pending_.begin(); iter != pending_.end();) {
+    const PendingFile& file = iter->second;
+
+    std::chrono::milliseconds time_settle = kTimeSettlePoll;
+    if (handle_ != -1) {
+      time_settle = file.is_closed ? kTimeSettleClosed : kTimeSettleOpen;
+    }
+
+    if (time_settle <= now - file.time_changed) {
+      wxFileName filename(dir_, wxString::FromUTF8(iter->first.c_str()));
+      filepaths.push_back(filename.GetFullPath());
+
+      // the polled snapshot is already current, but an inotify snapshot is
+      // updated as each file is reported, so an overflow rescan only reports
+      // files whose events were lost
+      if (handle_ != -1) {
+        if (wxFileName::FileExists(filepaths.back()) == true) {
+          snapshot_[iter->first] = Version(filepaths.back());
+        } else {
+          snapshot_.erase(iter->first);
+        }
+      }
+
+      iter = pending_.erase(iter);
+    } else {
+      iter++;
+    }
+  }
+}
+
+bool DirectoryWatcher::ReadEvents(const std::chrono::milliseconds& timeout) {
+#ifdef __linux__
+  // waits for the first event
+  pollfd descriptor;
+  descriptor.fd = handle_;
+  descriptor.events = POLLIN;
+  descriptor.revents = 0;
+  const int status = poll(&descriptor, 1, static_cast<int>(timeout.count()));
+  if (status <= 0) {
+    return true;
+  }
+
+  // reads all available events
+  alignas(inotify_event) char buffer[16384];
+  bool is_overflowed = false;
+  while (true) {
+    const ssize_t size = read(handle_, buffer, sizeof(buffer));
+    if (size <= 0) {
+      break;
+    }
+
+    for (ssize_t pos = 0; pos < size;) {
+      const inotify_event* event =
+          reinterpret_cast<const inotify_event*>(buffer + pos);
+      pos += sizeof(inotify_event) + event->len;
+
+      if ((event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) != 0) {
+        return false;
+      }
+
+      if ((event->mask & IN_Q_OVERFLOW) != 0) {
+        is_overflowed = true;
+        continue;
+      }
+
+      if (((event->mask & IN_ISDIR) != 0) || (event->len == 0)) {
+        continue;
+      }
+
+      const bool is_closed =
+          (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) != 0;
+      OnChange(std::string(event->name), is_closed);
+    }
+  }
+
+  // events were dropped, so the directory is rescanned for files that
+  // changed since the last scan
+  if (is_overflowed == true) {
+    return Scan(true);
+  }
+
+  return true;
+#else
+  std::this_thread::sleep_for(std::min(timeout, kTimePoll));
+  return Scan(true);
+#endif
+}
+
+bool DirectoryWatcher::Scan(const bool& is_recorded) {
+  if (wxFileName::DirExists(dir_) == false) {
+    return false;
+  }
+
+  wxArrayString filepaths;
+  wxDir::GetAllFiles(dir_, &filepaths, wxEmptyString, wxDIR_FILES);
+
+  std::map<std::string, std::string> snapshot;
+  for (std::size_t i = 0; i < filepaths.GetCount(); i++) {
+    const wxFileName filename(filepaths[i]);
+    const std::string name(filename.GetFullName().ToUTF8().data());
+    const std::string str_modified = Version(filepaths[i]);
+    snapshot[name] = str_modified;
+
+    if (is_recorded == true) {
+      const auto iter = snapshot_.find(name);
+      if ((iter == snapshot_.end()) || (iter->second != str_modified)) {
+        OnChange(name, false);
+      }
+    }
+  }
+
+  snapshot_.swap(snapshot);
+  return true;
+}
+
+std::string DirectoryWatcher::Version(const wxString& filepath) {
+  // the modification time and size identify the file version
+  const wxFileName filename(filepath);
+  wxString modified;
+  modified << filename.GetModificationTime().GetValue().ToString() << ":"
+           << wxFileName::GetSize(filepath).ToString();
+  return std::string(modified.ToUTF8().data());
+}
@@ -3,6 +3,83 @@
 
 #include "file_parser.h"
 
+FileParser::LineIterator::LineIterator(const TextView& text) {
+  line_number_ = 0;
+  pos_ = 0;
+  text_ = text;
+}
+
+FileParser::LineIterator::LineIterator(const TextView& text,
+                                       const int& line_number) {
+  line_number_ = line_number;
+  pos_ = 0;
+  text_ = text;
+}
+
+bool FileParser::LineIterator::Next(TextView& line) {
+  if (text_.size() <= pos_) {
+    return false;
+  }
+
+  // finds the end of the line
+  std::size_t pos_end = text_.find("\n", pos_);
+  std::size_t pos_next = pos_end + 1;
+  if (pos_end == TextView::npos) {
+    pos_end = text_.size();
+    pos_next = pos_end;
+  }
+
+  // removes a trailing carriage return
+  std::size_t length = pos_end - pos_;
+  if ((0 < length) && (text_[pos_end - 1] == '\r')) {
+    length--;
+  }
+
+  line = text_.substr(pos_, length);
+  pos_ = pos_next;
+  line_number_++;
+  return true;
+}
+
+int FileParser::LineIterator::line_number() const {
+  return line_number_;
+}
+
+std::size_t FileParser::LineIterator::position() const {
+  return pos_;
+}
+
+FileParser::TokenIterator::TokenIterator(const TextView& str,
+                                         const TextView& separator) {
+  is_done_ = false;
+  pos_before_ = 0;
+  separator_ = separator;
+  str_ = str;
+}
+
+bool FileParser::TokenIterator::Next(TextView& token) {
+  // searches string for separators and skips empty substrings
+  while (is_done_ == false) {
+    const std::size_t pos = str_.find(separator_, pos_before_);
+    TextView sub_str;
+    if (pos == TextView::npos) {
+      // gets last substring
+      sub_str = str_.substr(pos_before_);
+      is_done_ = true;
+    } else {
+      sub_str = str_.substr(pos_before_, pos - pos_before_);
+      pos_before_ = pos + 1;
+    }
+
+    if (sub_str.empty() == false) {
+      token = sub_str;
+      return true;
+    }
+  }
+
+  return false;
+}
+
 wxString FileParser::Extract(const wxString& str, const wxString& boundary) {
   // finds start position
   int pos_start = str.find(boundary) + 1;
@@ -21,6 +98,24 @@ wxString FileParser::Extract(const wxString& str, const wxString& boundary) {
   return str.substr(pos_start, length);
 }
 
+TextView FileParser::Extract(const TextView& str, const TextView& boundary) {
+  // finds start position
+  std::size_t pos_start = str.find(boundary);
+  if (pos_start == TextView::npos) {
+    return TextView();
+  }
+  pos_start++;
+
+  // finds end position
+  const std::size_t pos_end = str.find(boundary, pos_start);
+  if (pos_end == TextView::npos) {
+    return TextView();
+  }
+
+  // extracts
+  return str.substr(pos_start, pos_end - pos_start);
+}
+
 wxString FileParser::FileAndLineNumber(const wxString& filepath,
                                        const int& line_number) {
   wxString str_num;
@@ -49,6 +144,25 @@ bool FileParser::Separate(const wxString& str, const wxString& separator,
   return true;
 }
 
+bool FileParser::Separate(const TextView& str, const TextView& separator,
+                          TextView& str_left, TextView& str_right) {
+  // clears output views
+  str_left = TextView();
+  str_right = TextView();
+
+  // finds separator position
+  const std::size_t pos = str.find(separator);
+  if (pos == TextView::npos) {
+    return false;
+  }
+
+  // creates left and right views
+  str_left = str.substr(0, pos);
+  str_right = str.substr(pos + 1);
+
+  return true;
+}
+
 std::list<wxString> FileParser::SubStrings(const wxString& str,
                                            const wxString& separator) {
   // declares list of strings
@@ -0,0 +1,119 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() {
+  data_ = nullptr;
+  is_open_ = false;
+  size_ = 0;
+}
+
+MappedFile::~MappedFile() {
+  Close();
+}
+
+void MappedFile::Close() {
+  if (is_open_ == false) {
+    return;
+  }
+
+  // empty files are never mapped
+  if (data_ != nullptr) {
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+#else
+    munmap(const_cast<char*>(data_), size_);
+#endif
+  }
+
+  data_ = nullptr;
+  is_open_ = false;
+  size_ = 0;
+}
+
+bool MappedFile::Open(const wxString& filepath) {
+  Close();
+
+#ifdef _WIN32
+  HANDLE file = CreateFileW(filepath.wc_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  LARGE_INTEGER size;
+  if (GetFileSizeEx(file, &size) == 0) {
+    CloseHandle(file);
+    return false;
+  }
+
+  if (size.QuadPart != 0) {
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0,
+                                        nullptr);
+    if (mapping == nullptr) {
+      CloseHandle(file);
+      return false;
+    }
+
+    // the view keeps the mapping alive, so both handles can be closed
+    data_ = static_cast<const char*>(
+        MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(mapping);
+    if (data_ == nullptr) {
+      CloseHandle(file);
+      return false;
+    }
+  }
+  CloseHandle(file);
+
+  size_ = static_cast<std::size_t>(size.QuadPart);
+#else
+  const int file = open(filepath.fn_str(), O_RDONLY);
+  if (file == -1) {
+    return false;
+  }
+
+  struct stat status;
+  if (fstat(file, &status) != 0) {
+    close(file);
+    return false;
+  }
+
+  if (status.st_size != 0) {
+    void* data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    if (data == MAP_FAILED) {
+      close(file);
+      return false;
+    }
+
+    // the file is read front to back by the parsers
+    madvise(data, status.st_size, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(data);
+  }
+  close(file);
+
+  size_ = static_cast<std::size_t>(status.st_size);
+#endif
+
+  is_open_ = true;
+  return true;
+}
+
+bool MappedFile::IsOpen() const {
+  return is_open_;
+}
+
+TextView MappedFile::contents() const {
+  return TextView(data_, size_);
+}
@@ -0,0 +1,837 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "output_writer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// kernel headers before Linux 5.1 don't have io_uring, so the header is only
+// included if it exists
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+// the operations are enums, so the headers are checked for a feature flag
+// from the same release (Linux 5.12) as the rename operation
+#if defined(__NR_io_uring_setup) && defined(IORING_FEAT_NATIVE_WORKERS)
+#define OTLS_IO_URING
+#endif
+#endif
+#endif
+
+#include "wx/filename.h"
+
+namespace {
+
+/// The largest file that is written with a single io_uring write.
+const std::size_t kSizeWriteRingMax = std::size_t(1) << 30;
+
+/// The process-wide totals of all writers.
+OutputWriter::Stats stats_total = {0, 0, 0, 0, 0};
+
+/// The mutex that guards the totals.
+std::mutex mutex_total;
+
+/// \brief Gets the hidden temporary filepath for an output file. The
+///   temporary file is in the same directory, so the rename does not move the
+///   file across file systems.
+/// \param[in] filepath
+///   The output filepath.
+/// \return The temporary filepath.
+std::string FilePathTemp(const wxString& filepath) {
+  const wxFileName filename(filepath);
+  return std::string(
+      wxFileName(filename.GetPath(), "." + filename.GetFullName() + ".tmp")
+          .GetFullPath().mb_str());
+}
+
+#ifndef _WIN32
+/// \brief Writes a buffer to a file descriptor, repeating partial writes.
+/// \param[in] fd
+///   The file descriptor.
+/// \param[in] data
+///   The buffer.
+/// \param[in,out] num_syscalls
+///   The number of system calls, which is incremented for each write.
+/// \return If the whole buffer was written.
+bool WriteAll(const int& fd, const std::string& data, int64_t& num_syscalls) {
+  std::size_t pos = 0;
+  while (pos < data.size()) {
+    const ssize_t size = write(fd, data.data() + pos, data.size() - pos);
+    num_syscalls++;
+    if (size < 0) {
+      return false;
+    }
+    pos += static_cast<std::size_t>(size);
+  }
+  return true;
+}
+#endif
+
+}  // namespace
+
+#ifdef OTLS_IO_URING
+/// The number of submission queue entries in a ring.
+static const unsigned kNumEntriesRing = 256;
+
+/// The number of operations that are linked for each file.
+static const unsigned kNumOpsFile = 4;
+
+struct OutputWriter::Ring {
+  /// \brief Destructor. This unmaps the rings and closes the instance.
+  ~Ring() {
+    if (sqes != nullptr) {
+      munmap(sqes, size_sqes);
+    }
+    if ((ptr_cq != nullptr) && (ptr_cq != ptr_sq)) {
+      munmap(ptr_cq, size_cq);
+    }
+    if (ptr_sq != nullptr) {
+      munmap(ptr_sq, size_sq);
+    }
+    if (0 <= fd) {
+      close(fd);
+    }
+  }
+
+  /// \brief Sets up an io_uring instance.
+  /// \param[in,out] num_syscalls
+  ///   The number of system calls, which is incremented for each call.
+  /// \return The ring, or a nullptr if io_uring or one of the operations that
+  ///   the writer uses is not supported.
+  static Ring* Create(int64_t& num_syscalls);
+
+  /// \brief Reaps a completion.
+  /// \param[out] user_data
+  ///   The user data of the completed operation.
+  /// \param[out] result
+  ///   The result of the completed operation.
+  /// \return If a completion was available.
+  bool Reap(uint64_t& user_data, int& result) {
+    const unsigned head = *cq_head;
+    if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+      return false;
+    }
+
+    const io_uring_cqe& cqe = cqes[head & *cq_mask];
+    user_data = cqe.user_data;
+    result = cqe.res;
+    __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+
+  /// \brief Gets the next submission queue entry.
+  /// \return The entry, which is cleared.
+  io_uring_sqe* Next() {
+    const unsigned index = tail & *sq_mask;
+    io_uring_sqe* sqe = &sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sq_array[index] = index;
+    tail++;
+    num_pending++;
+    return sqe;
+  }
+
+  /// \brief Submits the pending entries and waits for completions.
+  /// \param[in] num_complete
+  ///   The number of completions to wait for.
+  /// \param[in,out] num_syscalls
+  ///   The number of system calls, which is incremented for each submission.
+  /// \return If the entries were submitted.
+  bool Submit(const unsigned& num_complete, int64_t& num_syscalls) {
+    __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+    while (true) {
+      const int status = static_cast<int>(syscall(
+          __NR_io_uring_enter, fd, num_pending, num_complete,
+          IORING_ENTER_GETEVENTS, nullptr, 0));
+      num_syscalls++;
+      if (0 <= status) {
+        num_pending -= static_cast<unsigned>(status);
+        if (num_pending == 0) {
+          return true;
+        }
+      } else if (errno != EINTR) {
+        return false;
+      }
+    }
+  }
+
+  /// \brief Reaps a completion, waiting for one if none are available.
+  /// \param[out] user_data
+  ///   The user data of the completed operation.
+  /// \param[out] result
+  ///   The result of the completed operation.
+  /// \param[in,out] num_syscalls
+  ///   The number of system calls, which is incremented for each wait.
+  /// \return If a completion was reaped. This only fails if the ring is
+  ///   broken.
+  bool ReapWait(uint64_t& user_data, int& result, int64_t& num_syscalls) {
+    while (Reap(user_data, result) == false) {
+      const int status = static_cast<int>(syscall(
+          __NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+      num_syscalls++;
+      if ((status < 0) && (errno != EINTR)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// \var cq_head
+  ///   The completion queue head, which is advanced by the writer.
+  unsigned* cq_head;
+
+  /// \var cq_mask
+  ///   The completion queue index mask.
+  unsigned* cq_mask;
+
+  /// \var cq_tail
+  ///   The completion queue tail, which is advanced by the kernel.
+  unsigned* cq_tail;
+
+  /// \var cqes
+  ///   The completion queue entries.
+  io_uring_cqe* cqes;
+
+  /// \var fd
+  ///   The io_uring file descriptor.
+  int fd;
+
+  /// \var num_pending
+  ///   The number of entries that have not been submitted.
+  unsigned num_pending;
+
+  /// \var ptr_cq
+  ///   The mapped completion queue ring.
+  void* ptr_cq;
+
+  /// \var ptr_sq
+  ///   The mapped submission queue ring.
+  void* ptr_sq;
+
+  /// \var size_cq
+  ///   The size of the mapped completion queue ring.
+  std::size_t size_cq;
+
+  /// \var size_sq
+  ///   The size of the mapped submission queue ring.
+  std::size_t size_sq;
+
+  /// \var size_sqes
+  ///   The size of the mapped submission queue entries.
+  std::size_t size_sqes;
+
+  /// \var sq_array
+  ///   The submission queue index array.
+  unsigned* sq_array;
+
+  /// \var sq_mask
+  ///   The submission queue index mask.
+  unsigned* sq_mask;
+
+  /// \var sq_tail
+  ///   The submission queue tail, which is advanced by the writer.
+  unsigned* sq_tail;
+
+  /// \var sqes
+  ///   The submission queue entries.
+  io_uring_sqe* sqes;
+
+  /// \var tail
+  ///   The local submission queue tail, which is published on submission.
+  unsigned tail;
+};
+
+OutputWriter::Ring* OutputWriter::Ring::Create(int64_t& num_syscalls) {
+  io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+  const int fd = static_cast<int>(
+      syscall(__NR_io_uring_setup, kNumEntriesRing, &params));
+  num_syscalls++;
+  if (fd < 0) {
+    return nullptr;
+  }
+
+  OutputWriter::Ring* ring = new OutputWriter::Ring();
+  ring->fd = fd;
+  ring->num_pending = 0;
+  ring->ptr_cq = nullptr;
+  ring->ptr_sq = nullptr;
+  ring->sqes = nullptr;
+
+  // maps the rings, which share one mapping on newer kernels
+  ring->size_sq = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  ring->size_cq = params.cq_off.cqes
+                  + params.cq_entries * sizeof(io_uring_cqe);
+  const bool is_single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if ((is_single == true) && (ring->size_sq < ring->size_cq)) {
+    ring->size_sq = ring->size_cq;
+  }
+
+  void* ptr = mmap(nullptr, ring->size_sq, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  num_syscalls++;
+  if (ptr == MAP_FAILED) {
+    delete ring;
+    return nullptr;
+  }
+  ring->ptr_sq = ptr;
+
+  if (is_single == true) {
+    ring->ptr_cq = ring->ptr_sq;
+  } else {
+    ptr = mmap(nullptr, ring->size_cq, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    num_syscalls++;
+    if (ptr == MAP_FAILED) {
+      delete ring;
+      return nullptr;
+    }
+    ring->ptr_cq = ptr;
+  }
+
+  ring->size_sqes = params.sq_entries * sizeof(io_uring_sqe);
+  ptr = mmap(nullptr, ring->size_sqes, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  num_syscalls++;
+  if (ptr == MAP_FAILED) {
+    delete ring;
+    return nullptr;
+  }
+  ring->sqes = static_cast<io_uring_sqe*>(ptr);
+
+  char* sq = static_cast<char*>(ring->ptr_sq);
+  ring->sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+  ring->sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+  ring->sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+  ring->tail = *ring->sq_tail;
+
+  char* cq = static_cast<char*>(ring->ptr_cq);
+  ring->cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+  ring->cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+  ring->cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+  ring->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+  // checks that the kernel supports every operation that is submitted
+  const unsigned kNumOpsProbe = 256;
+  std::vector<char> buffer(sizeof(io_uring_probe)
+                           + kNumOpsProbe * sizeof(io_uring_probe_op));
+  io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+  const int status = static_cast<int>(syscall(
+      __NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe,
+      kNumOpsProbe));
+  num_syscalls++;
+  if (status < 0) {
+    delete ring;
+    return nullptr;
+  }
+
+  const int ops[] = {IORING_OP_OPENAT, IORING_OP_WRITE, IORING_OP_FSYNC,
+                     IORING_OP_CLOSE, IORING_OP_RENAMEAT};
+  for (const int op : ops) {
+    if ((probe->last_op < op)
+        || ((probe->ops[op].flags & IO_URING_OP_SUPPORTED) == 0)) {
+      delete ring;
+      return nullptr;
+    }
+  }
+
+  return ring;
+}
+
+namespace {
+
+/// \brief Closes and removes the temporary files of a group that could not
+///   be written with io_uring.
+/// \param[in] fds
+///   The file descriptors of the temporary files. Files that were not opened
+///   are -1.
+/// \param[in] filepaths_temp
+///   The temporary filepaths.
+/// \param[in,out] num_syscalls
+///   The number of system calls, which is incremented for each call.
+void CleanUpGroup(const std::vector<int>& fds,
+                  const std::vector<std::string>& filepaths_temp,
+                  int64_t& num_syscalls) {
+  for (std::size_t i = 0; i < fds.size(); i++) {
+    if (0 <= fds[i]) {
+      close(fds[i]);
+      num_syscalls++;
+    }
+    unlink(filepaths_temp[i].c_str());
+    num_syscalls++;
+  }
+}
+
+}  // namespace
+#endif
+
+OutputWriter::OutputWriter() {
+  backend_ = Backend::kPosix;
+  is_open_ = false;
+  options_.backend = Backend::kAuto;
+  options_.sync = SyncPolicy::kNone;
+  ring_ = nullptr;
+
+  stats_.num_batches = 0;
+  stats_.num_bytes = 0;
+  stats_.num_files = 0;
+  stats_.num_syscalls = 0;
+  stats_.seconds = 0;
+}
+
+OutputWriter::~OutputWriter() {
+#ifdef OTLS_IO_URING
+  delete ring_;
+#endif
+}
+
+void OutputWriter::LogTotals() {
+  Stats stats;
+  {
+    std::lock_guard<std::mutex> lock(mutex_total);
+    stats = stats_total;
+  }
+
+  if (stats.num_files == 0) {
+    return;
+  }
+
+  const double megabytes = stats.num_bytes / (1024.0 * 1024.0);
+  double throughput = 0;
+  if (0 < stats.seconds) {
+    throughput = megabytes / stats.seconds;
+  }
+
+  wxString message;
+  message << "Output writes: " << static_cast<long>(stats.num_files)
+          << " files in " << static_cast<long>(stats.num_batches)
+          << " batches, " << wxString::Format("%.2f", megabytes) << " MB in "
+          << wxString::Format("%.3f", stats.seconds) << " s ("
+          << wxString::Format("%.1f", throughput) << " MB/s), "
+          << static_cast<long>(stats.num_syscalls) << " system calls ("
+          << wxString::Format("%.2f", static_cast<double>(stats.num_syscalls)
+                                      / stats.num_files)
+          << " per file)";
+  wxLogMessage(message);
+}
+
+wxString OutputWriter::NameBackend(const Backend& backend) {
+  if (backend == Backend::kIoUring) {
+    return "io_uring";
+  } else if (backend == Backend::kPosix) {
+    return "posix";
+  } else {
+    return "auto";
+  }
+}
+
+wxString OutputWriter::NameSync(const SyncPolicy& sync) {
+  if (sync == SyncPolicy::kPerBatch) {
+    return "batch";
+  } else if (sync == SyncPolicy::kPerFile) {
+    return "file";
+  } else {
+    return "none";
+  }
+}
+
+void OutputWriter::Open(const Options& options) {
+  if ((is_open_ == true) && (options_.backend == options.backend)
+      && (options_.sync == options.sync)) {
+    return;
+  }
+
+#ifdef OTLS_IO_URING
+  delete ring_;
+  ring_ = nullptr;
+#endif
+
+  options_ = options;
+  is_open_ = true;
+  backend_ = Backend::kPosix;
+
+  if (options.backend == Backend::kPosix) {
+    return;
+  }
+
+#ifdef OTLS_IO_URING
+  ring_ = Ring::Create(stats_.num_syscalls);
+  if (ring_ != nullptr) {
+    backend_ = Backend::kIoUring;
+    return;
+  }
+#endif
+
+  // explains the fallback once, as each thread has a writer
+  if (options.backend == Backend::kIoUring) {
+    static std::once_flag flag;
+    std::call_once(flag, [] {
+      wxLogWarning("io_uring is not available. Output files are written "
+                   "with POSIX calls.");
+    });
+  }
+}
+
+bool OutputWriter::Write(std::vector<File>& files) {
+  const auto time_start = std::chrono::steady_clock::now();
+  const int64_t num_syscalls_start = stats_.num_syscalls;
+
+  for (auto iter = files.begin(); iter != files.end(); iter++) {
+    iter->is_written = false;
+  }
+
+  // an io_uring write length is 32 bits, so very large files are written
+  // with POSIX calls, which repeat partial writes
+  bool is_ring = backend_ == Backend::kIoUring;
+  for (auto iter = files.cbegin(); iter != files.cend(); iter++) {
+    if (kSizeWriteRingMax < iter->data->size()) {
+      is_ring = false;
+    }
+  }
+
+  if (is_ring == true) {
+    WriteIoUring(files);
+  } else {
+    WritePosix(files);
+  }
+
+  // syncs the whole batch at once
+  bool status = true;
+  if ((options_.sync == SyncPolicy::kPerBatch) && (files.empty() == false)
+      && (SyncBatch(files) == false)) {
+    for (auto iter = files.begin(); iter != files.end(); iter++) {
+      iter->is_written = false;
+    }
+  }
+
+  // updates the statistics
+  Stats stats_batch = {1, 0, 0, 0, 0};
+  for (auto iter = files.cbegin(); iter != files.cend(); iter++) {
+    if (iter->is_written == true) {
+      stats_batch.num_bytes += static_cast<int64_t>(iter->data->size());
+      stats_batch.num_files++;
+    } else {
+      status = false;
+    }
+  }
+  stats_batch.num_syscalls = stats_.num_syscalls - num_syscalls_start;
+  stats_batch.seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - time_start).count();
+
+  stats_.num_batches += stats_batch.num_batches;
+  stats_.num_bytes += stats_batch.num_bytes;
+  stats_.num_files += stats_batch.num_files;
+  stats_.seconds += stats_batch.seconds;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_total);
+    stats_total.num_batches += stats_batch.num_batches;
+    stats_total.num_bytes += stats_batch.num_bytes;
+    stats_total.num_files += stats_batch.num_files;
+    stats_total.num_syscalls += stats_batch.num_syscalls;
+    stats_total.seconds += stats_batch.seconds;
+  }
+
+  return status;
+}
+
+OutputWriter::Backend OutputWriter::backend() const {
+  return backend_;
+}
+
+const OutputWriter::Stats& OutputWriter::stats() const {
+  return stats_;
+}
+
+bool OutputWriter::SyncBatch(const std::vector<File>& files) {
+#ifdef _WIN32
+  // there is no unprivileged file system sync on Windows, so the files were
+  // committed as they were written
+  static_cast<void>(files);
+  return true;
+#elif defined(__linux__)
+  // syncs the file system of the first file, as the batch outputs share a
+  // directory
+  const wxString dir = wxFileName(files.front().filepath).GetPath();
+  const int fd = open(dir.empty() ? "." : static_cast<const char*>(
+                          dir.mb_str()),
+                      O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  stats_.num_syscalls++;
+  if (fd < 0) {
+    return false;
+  }
+
+  const bool status = syncfs(fd) == 0;
+  close(fd);
+  stats_.num_syscalls += 2;
+  return status;
+#else
+  static_cast<void>(files);
+  sync();
+  stats_.num_syscalls++;
+  return true;
+#endif
+}
+
+void OutputWriter::WriteIoUring(std::vector<File>& files) {
+#ifdef OTLS_IO_URING
+  // the files are written in groups that fit in the ring
+  const std::size_t kNumFilesGroup = kNumEntriesRing / kNumOpsFile;
+  const bool is_sync_file = options_.sync == SyncPolicy::kPerFile;
+
+  std::vector<std::string> filepaths;
+  std::vector<std::string> filepaths_temp;
+  std::vector<int> fds;
+  std::vector<int> results;
+  std::size_t index_failed = files.size();
+  for (std::size_t begin = 0; begin < files.size(); begin += kNumFilesGroup) {
+    std::size_t end = begin + kNumFilesGroup;
+    if (files.size() < end) {
+      end = files.size();
+    }
+    const std::size_t num = end - begin;
+
+    // the paths must stay valid until the operations complete
+    filepaths.resize(num);
+    filepaths_temp.resize(num);
+    for (std::size_t i = 0; i < num; i++) {
+      filepaths[i] = std::string(files[begin + i].filepath.mb_str());
+      filepaths_temp[i] = FilePathTemp(files[begin + i].filepath);
+    }
+
+    // creates all of the temporary files in one submission
+    fds.assign(num, -1);
+    for (std::size_t i = 0; i < num; i++) {
+      io_uring_sqe* sqe = ring_->Next();
+      sqe->opcode = IORING_OP_OPENAT;
+      sqe->fd = AT_FDCWD;
+      sqe->addr = reinterpret_cast<uint64_t>(filepaths_temp[i].c_str());
+      sqe->len = 0644;
+      sqe->open_flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+      sqe->user_data = i;
+    }
+
+    if (ring_->Submit(static_cast<unsigned>(num), stats_.num_syscalls)
+        == false) {
+      CleanUpGroup(fds, filepaths_temp, stats_.num_syscalls);
+      index_failed = begin;
+      break;
+    }
+
+    // reaps every open completion, so none are left for the next group
+    uint64_t user_data = 0;
+    int result = 0;
+    bool is_reaped = true;
+    for (std::size_t i = 0; i < num; i++) {
+      if (ring_->ReapWait(user_data, result, stats_.num_syscalls) == false) {
+        is_reaped = false;
+        break;
+      }
+      if (user_data < num) {
+        fds[user_data] = result;
+      }
+    }
+
+    if (is_reaped == false) {
+      CleanUpGroup(fds, filepaths_temp, stats_.num_syscalls);
+      index_failed = begin;
+      break;
+    }
+
+    // writes, syncs, closes, and renames each file as a linked chain, so a
+    // failed step cancels the rest of the chain
+    unsigned num_ops = 0;
+    for (std::size_t i = 0; i < num; i++) {
+      if (fds[i] < 0) {
+        continue;
+      }
+
+      const std::string& data = *files[begin + i].data;
+      io_uring_sqe* sqe = ring_->Next();
+      sqe->opcode = IORING_OP_WRITE;
+      sqe->fd = fds[i];
+      sqe->addr = reinterpret_cast<uint64_t>(data.data());
+      sqe->len = static_cast<uint32_t>(data.size());
+      sqe->off = 0;
+      sqe->flags = IOSQE_IO_LINK;
+      sqe->user_data = i * kNumOpsFile + 0;
+
+      if (is_sync_file == true) {
+        sqe = ring_->Next();
+        sqe->opcode = IORING_OP_FSYNC;
+        sqe->fd = fds[i];
+        sqe->flags = IOSQE_IO_LINK;
+        sqe->user_data = i * kNumOpsFile + 1;
+      }
+
+      sqe = ring_->Next();
+      sqe->opcode = IORING_OP_CLOSE;
+      sqe->fd = fds[i];
+      sqe->flags = IOSQE_IO_LINK;
+      sqe->user_data = i * kNumOpsFile + 2;
+
+      sqe = ring_->Next();
+      sqe->opcode = IORING_OP_RENAMEAT;
+      sqe->fd = AT_FDCWD;
+      sqe->addr = reinterpret_cast<uint64_t>(filepaths_temp[i].c_str());
+      sqe->len = AT_FDCWD;
+      sqe->addr2 = reinterpret_cast<uint64_t>(filepaths[i].c_str());
+      sqe->user_data = i * kNumOpsFile + 3;
+
+      num_ops += (is_sync_file == true) ? 4 : 3;
+    }
+
+    if (num_ops == 0) {
+      continue;
+    }
+
+    // the temporary files of the group are removed before the group is
+    // written again with POSIX calls
+    if (ring_->Submit(num_ops, stats_.num_syscalls) == false) {
+      CleanUpGroup(fds, filepaths_temp, stats_.num_syscalls);
+      index_failed = begin;
+      break;
+    }
+
+    // an operation without a completion counts as a failure, and a skipped
+    // sync counts as a success
+    results.assign(num * kNumOpsFile, -ECANCELED);
+    if (is_sync_file == false) {
+      for (std::size_t i = 0; i < num; i++) {
+        results[i * kNumOpsFile + 1] = 0;
+      }
+    }
+
+    for (unsigned i = 0; i < num_ops; i++) {
+      if (ring_->ReapWait(user_data, result, stats_.num_syscalls) == false) {
+        is_reaped = false;
+        break;
+      }
+      if (user_data < results.size()) {
+        results[user_data] = result;
+      }
+    }
+
+    // the files that were already closed are not closed again
+    if (is_reaped == false) {
+      for (std::size_t i = 0; i < num; i++) {
+        if (results[i * kNumOpsFile + 2] == 0) {
+          fds[i] = -1;
+        }
+      }
+      CleanUpGroup(fds, filepaths_temp, stats_.num_syscalls);
+      index_failed = begin;
+      break;
+    }
+
+    for (std::size_t i = 0; i < num; i++) {
+      if (fds[i] < 0) {
+        continue;
+      }
+
+      const int* result_file = &results[i * kNumOpsFile];
+      File& file = files[begin + i];
+      file.is_written =
+          (result_file[0] == static_cast<int>(file.data->size()))
+          && (result_file[1] == 0) && (result_file[2] == 0)
+          && (result_file[3] == 0);
+
+      // cleans up a broken chain, where the close may have been cancelled
+      if (file.is_written == false) {
+        if (result_file[2] == -ECANCELED) {
+          close(fds[i]);
+          stats_.num_syscalls++;
+        }
+        unlink(filepaths_temp[i].c_str());
+        stats_.num_syscalls++;
+      }
+    }
+  }
+
+  // a submission can only fail if the ring is broken, so the ring is dropped
+  // and the rest of the batch is written with POSIX calls
+  if (index_failed < files.size()) {
+    wxLogWarning("io_uring submission failed. Output files are written with "
+                 "POSIX calls.");
+    delete ring_;
+    ring_ = nullptr;
+    backend_ = Backend::kPosix;
+
+    std::vector<File> files_posix(files.begin() + index_failed, files.end());
+    WritePosix(files_posix);
+    for (std::size_t i = 0; i < files_posix.size(); i++) {
+      files[index_failed + i].is_written = files_posix[i].is_written;
+    }
+  }
+#else
+  WritePosix(files);
+#endif
+}
+
+void OutputWriter::WritePosix(std::vector<File>& files) {
+  for (auto iter = files.begin(); iter != files.end(); iter++) {
+    File& file = *iter;
+    const std::string filepath_temp = FilePathTemp(file.filepath);
+
+#ifdef _WIN32
+    // the C runtime is used, and the files are committed unless no sync is
+    // requested
+    FILE* stream = fopen(filepath_temp.c_str(), "wb");
+    stats_.num_syscalls++;
+    if (stream == nullptr) {
+      continue;
+    }
+
+    bool status = fwrite(file.data->data(), 1, file.data->size(), stream)
+                  == file.data->size();
+    stats_.num_syscalls++;
+    if (options_.sync != SyncPolicy::kNone) {
+      status = (fflush(stream) == 0) && (_commit(_fileno(stream)) == 0)
+               && status;
+      stats_.num_syscalls++;
+    }
+    status = (fclose(stream) == 0) && status;
+    stats_.num_syscalls++;
+#else
+    const int fd = open(filepath_temp.c_str(),
+                        O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    stats_.num_syscalls++;
+    if (fd < 0) {
+      continue;
+    }
+
+    bool status = WriteAll(fd, *file.data, stats_.num_syscalls);
+    if ((status == true) && (options_.sync == SyncPolicy::kPerFile)) {
+      status = fsync(fd) == 0;
+      stats_.num_syscalls++;
+    }
+    status = (close(fd) == 0) && status;
+    stats_.num_syscalls++;
+#endif
+
+    // replaces the output file
+    if (status == true) {
+      status = wxRenameFile(filepath_temp, file.filepath, true);
+      stats_.num_syscalls++;
+    }
+
+    if (status == false) {
+      wxRemoveFile(filepath_temp);
+      stats_.num_syscalls++;
+    }
+
+    file.is_written = status;
+  }
+}
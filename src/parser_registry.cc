@@ -0,0 +1,157 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "parser_registry.h"
+
+#include "wx/dir.h"
+#include "wx/dynlib.h"
+#include "wx/filename.h"
+
+const char ParserRegistry::kNamePluginEntry[] = "RegisterCableParsers";
+
+ParserRegistry::ParserRegistry() {
+}
+
+ParserRegistry::~ParserRegistry() {
+  // the parsers point into the plugins, so they are removed first
+  parsers_.clear();
+
+  for (auto iter = libraries_.begin(); iter != libraries_.end(); iter++) {
+    delete *iter;
+  }
+}
+
+std::string ParserRegistry::Describe() const {
+  std::string str;
+  for (auto iter = parsers_.cbegin(); iter != parsers_.cend(); iter++) {
+    if (iter != parsers_.cbegin()) {
+      str += ",";
+    }
+    str += iter->name;
+  }
+  return str;
+}
+
+bool ParserRegistry::LoadPlugin(const wxString& filepath) {
+  wxDynamicLibrary* library = new wxDynamicLibrary();
+  if (library->Load(filepath) == false) {
+    wxLogError("Could not load parser plugin: " + filepath + ".");
+    delete library;
+    return false;
+  }
+
+  PluginEntryFunction entry = reinterpret_cast<PluginEntryFunction>(
+      library->GetSymbol(kNamePluginEntry));
+  if (entry == nullptr) {
+    wxLogError("Parser plugin does not export " + wxString(kNamePluginEntry)
+               + ": " + filepath + ".");
+    delete library;
+    return false;
+  }
+
+  // the library is kept loaded even if registration fails, as some parsers
+  // may already point into it
+  libraries_.push_back(library);
+
+  const std::size_t num_parsers = parsers_.size();
+  if (entry(this) == false) {
+    wxLogError("Parser plugin could not register its parsers: " + filepath
+               + ".");
+    return false;
+  }
+
+  for (std::size_t i = num_parsers; i < parsers_.size(); i++) {
+    wxLogVerbose("Registered parser: " + wxString(parsers_[i].name) + " ("
+                 + filepath + ")");
+  }
+
+  return true;
+}
+
+bool ParserRegistry::LoadPlugins(const wxString& dir) {
+  wxArrayString filepaths;
+  wxDir::GetAllFiles(dir, &filepaths,
+                     "*" + wxDynamicLibrary::GetDllExt(wxDL_MODULE),
+                     wxDIR_FILES);
+
+  // sorts so the sniff order is the same on every run
+  filepaths.Sort();
+
+  bool status = true;
+  for (std::size_t i = 0; i < filepaths.GetCount(); i++) {
+    if (LoadPlugin(filepaths[i]) == false) {
+      status = false;
+    }
+  }
+
+  return status;
+}
+
+bool ParserRegistry::Register(const std::string& name, SniffFunction sniff,
+                              ParseFunction parse) {
+  if ((name.empty() == true) || (parse == nullptr)) {
+    wxLogError("Invalid parser: " + name + ".");
+    return false;
+  }
+
+  Parser parser;
+  parser.name = name;
+  parser.parse = parse;
+  parser.parse_record = nullptr;
+  parser.sniff = sniff;
+  return Add(parser);
+}
+
+bool ParserRegistry::RegisterRecords(const std::string& name,
+                                     SniffFunction sniff,
+                                     const std::string& marker_record,
+                                     ParseRecordFunction parse_record) {
+  if ((name.empty() == true) || (parse_record == nullptr)) {
+    wxLogError("Invalid parser: " + name + ".");
+    return false;
+  }
+
+  // an empty marker would start a record on every line
+  if (marker_record.empty() == true) {
+    wxLogError("Invalid record marker for parser: " + name + ".");
+    return false;
+  }
+
+  Parser parser;
+  parser.marker_record = marker_record;
+  parser.name = name;
+  parser.parse = nullptr;
+  parser.parse_record = parse_record;
+  parser.sniff = sniff;
+  return Add(parser);
+}
+
+const ParserRegistry::Parser* ParserRegistry::Sniff(
+    const wxString& filepath,
+    const TextView& contents) const {
+  const TextView head = contents.substr(0, kSizeSniff);
+
+  for (auto iter = parsers_.cbegin(); iter != parsers_.cend(); iter++) {
+    if ((iter->sniff == nullptr) || (iter->sniff(filepath, head) == true)) {
+      return &(*iter);
+    }
+  }
+
+  return nullptr;
+}
+
+const std::vector<ParserRegistry::Parser>& ParserRegistry::parsers() const {
+  return parsers_;
+}
+
+bool ParserRegistry::Add(const Parser& parser) {
+  for (auto iter = parsers_.cbegin(); iter != parsers_.cend(); iter++) {
+    if (iter->name == parser.name) {
+      wxLogError("Parser is already registered: " + parser.name + ".");
+      return false;
+    }
+  }
+
+  parsers_.push_back(parser);
+  return true;
+}
@@ -0,0 +1,398 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "polynomial_batch_searcher.h"
+
+#include "simd_support.h"
+
+namespace {
+
+/// The number of lanes in a vector block.
+const std::size_t kNumLanesBlock = 4;
+
+/// The maximum number of coefficient rows that can be held in registers by the
+/// vector kernel. Higher degree polynomials use the scalar kernel.
+const std::size_t kNumRowsMax = 16;
+
+/// \par OVERVIEW
+///
+/// This struct contains the data that is shared by the search kernels.
+struct SweepData {
+  /// \var coefficients
+  ///   The coefficient rows that are evaluated.
+  std::vector<const double*> coefficients;
+
+  /// \var coefficients_slope
+  ///   The slope coefficient rows. This is only used for slope searches.
+  std::vector<const double*> coefficients_slope;
+
+  /// \var is_slope
+  ///   An indicator that tells if the slope condition is checked. Otherwise,
+  ///   the inflection condition is checked.
+  bool is_slope;
+
+  /// \var is_valid
+  ///   The valid indicator for each lane.
+  const char* is_valid;
+
+  /// \var slopes_max
+  ///   The maximum slope for each lane.
+  const double* slopes_max;
+
+  /// \var slopes_min
+  ///   The minimum slope for each lane.
+  const double* slopes_min;
+
+  /// \var x_limits
+  ///   The limit x value for each lane.
+  double* x_limits;
+
+  /// \var x_max
+  ///   The maximum x value.
+  double x_max;
+
+  /// \var x_min
+  ///   The minimum x value.
+  double x_min;
+
+  /// \var x_step
+  ///   The x step.
+  double x_step;
+
+  /// \var y_limits
+  ///   The limit y value for each lane.
+  double* y_limits;
+};
+
+/// \brief Evaluates a lane polynomial using Horner's method.
+double EvaluateLane(const std::vector<const double*>& rows,
+                    const std::size_t& lane, const double& x) {
+  double y = 0;
+  for (std::size_t k = rows.size(); 0 < k; k--) {
+    y = y * x + rows[k - 1][lane];
+  }
+  return y;
+}
+
+/// \brief Searches a single lane using scalar code.
+/// This follows the same steps as the CablePolynomialSearcher scan.
+void SweepLaneScalar(const SweepData& data, const std::size_t& lane) {
+  double x1 = -999999;
+  double y1 = -999999;
+
+  if (data.is_valid[lane] != 0) {
+    double x2 = data.x_min;
+    double y2 = EvaluateLane(data.coefficients, lane, x2);
+
+    while (x2 <= data.x_max) {
+      // calculates new x and y values
+      x1 = x2;
+      x2 += data.x_step;
+
+      y1 = y2;
+      y2 = EvaluateLane(data.coefficients, lane, x2);
+
+      // checks stop condition
+      if (data.is_slope == true) {
+        const double s = EvaluateLane(data.coefficients_slope, lane, x2);
+        if ((s < data.slopes_min[lane]) || (data.slopes_max[lane] < s)) {
+          break;
+        }
+      } else if (y2 < y1) {
+        break;
+      }
+    }
+  }
+
+  data.x_limits[lane] = x1;
+  data.y_limits[lane] = y1;
+}
+
+#ifdef OTLS_SIMD_AVX2
+
+/// \brief Evaluates a block of lane polynomials using Horner's method.
+OTLS_TARGET_AVX2
+inline __m256d EvaluateBlock(const __m256d* rows, const std::size_t& num_rows,
+                             const __m256d& x) {
+  __m256d y = _mm256_setzero_pd();
+  for (std::size_t k = num_rows; 0 < k; k--) {
+    y = _mm256_add_pd(_mm256_mul_pd(y, x), rows[k - 1]);
+  }
+  return y;
+}
+
+/// \brief Searches a block of lanes using AVX2 code.
+/// Each lane stops independently. The stopped lanes are masked out, and the
+/// block is finished once every lane has stopped.
+OTLS_TARGET_AVX2
+void SweepBlockAvx2(const SweepData& data, const std::size_t& lane) {
+  // loads coefficients into registers
+  const std::size_t num_rows = data.coefficients.size();
+  __m256d rows[kNumRowsMax];
+  for (std::size_t k = 0; k < num_rows; k++) {
+    rows[k] = _mm256_loadu_pd(data.coefficients[k] + lane);
+  }
+
+  const std::size_t num_rows_slope = data.coefficients_slope.size();
+  __m256d rows_slope[kNumRowsMax];
+  __m256d slopes_min = _mm256_setzero_pd();
+  __m256d slopes_max = _mm256_setzero_pd();
+  if (data.is_slope == true) {
+    for (std::size_t k = 0; k < num_rows_slope; k++) {
+      rows_slope[k] = _mm256_loadu_pd(data.coefficients_slope[k] + lane);
+    }
+    slopes_min = _mm256_loadu_pd(data.slopes_min + lane);
+    slopes_max = _mm256_loadu_pd(data.slopes_max + lane);
+  }
+
+  // initializes the active lane mask
+  __m256d active = _mm256_cmp_pd(
+      _mm256_set_pd(data.is_valid[lane + 3], data.is_valid[lane + 2],
+                    data.is_valid[lane + 1], data.is_valid[lane]),
+      _mm256_setzero_pd(), _CMP_NEQ_OQ);
+
+  // initializes x and y values
+  __m256d x_limits = _mm256_set1_pd(-999999);
+  __m256d y_limits = _mm256_set1_pd(-999999);
+
+  double x1 = -999999;
+  __m256d y1 = _mm256_set1_pd(-999999);
+
+  double x2 = data.x_min;
+  __m256d y2 = EvaluateBlock(rows, num_rows, _mm256_set1_pd(x2));
+
+  // searches until the max x value, or until all lanes have stopped
+  while ((x2 <= data.x_max) && (_mm256_movemask_pd(active) != 0)) {
+    // calculates new x and y values
+    x1 = x2;
+    x2 += data.x_step;
+
+    const __m256d x2_block = _mm256_set1_pd(x2);
+    y1 = y2;
+    y2 = EvaluateBlock(rows, num_rows, x2_block);
+
+    // checks stop condition
+    __m256d stop;
+    if (data.is_slope == true) {
+      const __m256d s = EvaluateBlock(rows_slope, num_rows_slope, x2_block);
+      stop = _mm256_or_pd(_mm256_cmp_pd(s, slopes_min, _CMP_LT_OQ),
+                          _mm256_cmp_pd(slopes_max, s, _CMP_LT_OQ));
+    } else {
+      stop = _mm256_cmp_pd(y2, y1, _CMP_LT_OQ);
+    }
+
+    // stores the limits of newly stopped lanes and masks them out
+    const __m256d stopped = _mm256_and_pd(stop, active);
+    x_limits = _mm256_blendv_pd(x_limits, _mm256_set1_pd(x1), stopped);
+    y_limits = _mm256_blendv_pd(y_limits, y1, stopped);
+    active = _mm256_andnot_pd(stop, active);
+  }
+
+  // stores the limits of lanes that never stopped
+  x_limits = _mm256_blendv_pd(x_limits, _mm256_set1_pd(x1), active);
+  y_limits = _mm256_blendv_pd(y_limits, y1, active);
+
+  _mm256_storeu_pd(data.x_limits + lane, x_limits);
+  _mm256_storeu_pd(data.y_limits + lane, y_limits);
+}
+
+#endif  // OTLS_SIMD_AVX2
+
+/// \brief Searches all lanes.
+/// \param[in] data
+///   The sweep data.
+/// \param[in] num_lanes
+///   The number of lanes. This must be a multiple of the block size.
+void Sweep(const SweepData& data, const std::size_t& num_lanes) {
+#ifdef OTLS_SIMD_AVX2
+  if ((PolynomialBatchSearcher::IsVectorized() == true)
+      && (data.coefficients.size() <= kNumRowsMax)) {
+    for (std::size_t lane = 0; lane < num_lanes; lane += kNumLanesBlock) {
+      SweepBlockAvx2(data, lane);
+    }
+    return;
+  }
+#endif
+
+  for (std::size_t lane = 0; lane < num_lanes; lane++) {
+    SweepLaneScalar(data, lane);
+  }
+}
+
+}  // namespace
+
+PolynomialBatchSearcher::PolynomialBatchSearcher() {
+  num_ = 0;
+}
+
+PolynomialBatchSearcher::~PolynomialBatchSearcher() {
+}
+
+int PolynomialBatchSearcher::Add(const std::vector<double>& coefficients,
+                                 const double& slope_min,
+                                 const double& slope_max) {
+  const std::size_t lane = num_;
+
+  // removes any padding lanes from a previous search
+  if (is_valid_.size() != lane) {
+    for (auto iter = coefficients_.begin(); iter != coefficients_.end();
+         iter++) {
+      iter->resize(lane);
+    }
+    for (auto iter = coefficients_slope_.begin();
+         iter != coefficients_slope_.end(); iter++) {
+      iter->resize(lane);
+    }
+    is_valid_.resize(lane);
+    slopes_min_.resize(lane);
+    slopes_max_.resize(lane);
+  }
+
+  // adds rows if this polynomial has a higher degree
+  while (coefficients_.size() < coefficients.size()) {
+    coefficients_.push_back(std::vector<double>(lane, 0));
+  }
+
+  while ((coefficients_slope_.size() + 1) < coefficients.size()) {
+    coefficients_slope_.push_back(std::vector<double>(lane, 0));
+  }
+
+  // adds a column to each row
+  for (std::size_t k = 0; k < coefficients_.size(); k++) {
+    double coefficient = 0;
+    if (k < coefficients.size()) {
+      coefficient = coefficients.at(k);
+    }
+    coefficients_.at(k).push_back(coefficient);
+  }
+
+  for (std::size_t k = 0; k < coefficients_slope_.size(); k++) {
+    double coefficient = 0;
+    if ((k + 1) < coefficients.size()) {
+      coefficient = coefficients.at(k + 1) * (k + 1);
+    }
+    coefficients_slope_.at(k).push_back(coefficient);
+  }
+
+  if (coefficients.empty() == true) {
+    is_valid_.push_back(0);
+  } else {
+    is_valid_.push_back(1);
+  }
+
+  slopes_min_.push_back(slope_min);
+  slopes_max_.push_back(slope_max);
+
+  limits_.push_back(Point2d<double>());
+
+  return num_++;
+}
+
+void PolynomialBatchSearcher::Clear() {
+  coefficients_.clear();
+  coefficients_slope_.clear();
+  is_valid_.clear();
+  limits_.clear();
+  num_ = 0;
+  slopes_max_.clear();
+  slopes_min_.clear();
+}
+
+Point2d<double> PolynomialBatchSearcher::Limit(const int& index) const {
+  return limits_.at(index);
+}
+
+bool PolynomialBatchSearcher::Search(const double& x_min,
+                                     const double& x_min_slope,
+                                     const double& x_step,
+                                     const double& x_max) {
+  // validates
+  if ((x_max < x_min) || (x_max < x_min_slope)) {
+    return false;
+  }
+
+  if (x_step <= 0) {
+    return false;
+  }
+
+  if (num_ == 0) {
+    return true;
+  }
+
+  // pads the lanes to a multiple of the block size
+  // padding lanes are not valid, so they are never searched
+  std::size_t num_lanes = is_valid_.size();
+  while ((num_lanes % kNumLanesBlock) != 0) {
+    num_lanes++;
+  }
+
+  for (auto iter = coefficients_.begin(); iter != coefficients_.end();
+       iter++) {
+    iter->resize(num_lanes, 0);
+  }
+  for (auto iter = coefficients_slope_.begin();
+       iter != coefficients_slope_.end(); iter++) {
+    iter->resize(num_lanes, 0);
+  }
+  is_valid_.resize(num_lanes, 0);
+  slopes_min_.resize(num_lanes, 0);
+  slopes_max_.resize(num_lanes, 0);
+
+  // initializes sweep data
+  SweepData data;
+  for (auto iter = coefficients_.cbegin(); iter != coefficients_.cend();
+       iter++) {
+    data.coefficients.push_back(iter->data());
+  }
+  for (auto iter = coefficients_slope_.cbegin();
+       iter != coefficients_slope_.cend(); iter++) {
+    data.coefficients_slope.push_back(iter->data());
+  }
+  data.is_valid = is_valid_.data();
+  data.slopes_max = slopes_max_.data();
+  data.slopes_min = slopes_min_.data();
+  data.x_max = x_max;
+  data.x_step = x_step;
+
+  // searches by inflection
+  std::vector<double> x_inflection(num_lanes);
+  std::vector<double> y_inflection(num_lanes);
+  data.is_slope = false;
+  data.x_min = x_min;
+  data.x_limits = x_inflection.data();
+  data.y_limits = y_inflection.data();
+  Sweep(data, num_lanes);
+
+  // searches by slope
+  std::vector<double> x_slope(num_lanes);
+  std::vector<double> y_slope(num_lanes);
+  data.is_slope = true;
+  data.x_min = x_min_slope;
+  data.x_limits = x_slope.data();
+  data.y_limits = y_slope.data();
+  Sweep(data, num_lanes);
+
+  // compares and determines most limiting
+  for (int i = 0; i < num_; i++) {
+    Point2d<double>& limit = limits_.at(i);
+    if ((x_inflection.at(i) == -999999) || (x_slope.at(i) == -999999)) {
+      limit = Point2d<double>();
+    } else if (x_inflection.at(i) <= x_slope.at(i)) {
+      limit.x = x_inflection.at(i);
+      limit.y = y_inflection.at(i);
+    } else {
+      limit.x = x_slope.at(i);
+      limit.y = y_slope.at(i);
+    }
+  }
+
+  return true;
+}
+
+bool PolynomialBatchSearcher::IsVectorized() {
+  return simd::IsAvx2Supported();
+}
+
+int PolynomialBatchSearcher::size() const {
+  return num_;
+}
@@ -0,0 +1,292 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "polynomial_limit_cache.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "wx/wx.h"
+
+namespace {
+
+/// The file header, which identifies the file and format version.
+const char* kFileHeader = "# polynomial limit cache v1";
+
+/// \brief Gets the bit pattern of a double.
+uint64_t Bits(const double& value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+/// \brief Appends a double in hexadecimal floating point notation.
+void WriteDouble(const double& value, std::string& str) {
+  char buffer[64];
+  std::snprintf(buffer, sizeof(buffer), " %a", value);
+  str += buffer;
+}
+
+/// \brief Reads a double in hexadecimal floating point notation.
+bool ReadDouble(std::istream& stream, double& value) {
+  std::string str;
+  if (!(stream >> str)) {
+    return false;
+  }
+
+  char* end = nullptr;
+  value = std::strtod(str.c_str(), &end);
+  return *end == '\0';
+}
+
+}  // namespace
+
+bool PolynomialLimitCache::Key::operator==(const Key& other) const {
+  if (coefficients.size() != other.coefficients.size()) {
+    return false;
+  }
+
+  for (std::size_t i = 0; i < coefficients.size(); i++) {
+    if (Bits(coefficients.at(i)) != Bits(other.coefficients.at(i))) {
+      return false;
+    }
+  }
+
+  return (Bits(slope_max) == Bits(other.slope_max))
+      && (Bits(slope_min) == Bits(other.slope_min))
+      && (Bits(tolerance) == Bits(other.tolerance))
+      && (type_search == other.type_search);
+}
+
+std::size_t PolynomialLimitCache::KeyHash::operator()(const Key& key) const {
+  // combines the bit patterns using the FNV-1a algorithm
+  uint64_t hash = 14695981039346656037ULL;
+  auto combine = [&hash](const uint64_t& value) {
+    hash ^= value;
+    hash *= 1099511628211ULL;
+  };
+
+  for (auto iter = key.coefficients.cbegin(); iter != key.coefficients.cend();
+       iter++) {
+    combine(Bits(*iter));
+  }
+  combine(Bits(key.slope_max));
+  combine(Bits(key.slope_min));
+  combine(Bits(key.tolerance));
+  combine(static_cast<uint64_t>(key.type_search));
+
+  return static_cast<std::size_t>(hash);
+}
+
+PolynomialLimitCache::PolynomialLimitCache() {
+  num_hits_ = 0;
+  num_misses_ = 0;
+  size_max_ = kSizeMaxDefault;
+}
+
+PolynomialLimitCache::~PolynomialLimitCache() {
+}
+
+void PolynomialLimitCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  indexes_.clear();
+  num_hits_ = 0;
+  num_misses_ = 0;
+}
+
+bool PolynomialLimitCache::Find(const Key& key, Point2d<double>& limit) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto iter = indexes_.find(key);
+  if (iter == indexes_.end()) {
+    num_misses_++;
+    return false;
+  }
+
+  // moves the entry to the front, which doesn't invalidate any positions
+  num_hits_++;
+  entries_.splice(entries_.begin(), entries_, iter->second);
+  limit = iter->second->limit;
+  return true;
+}
+
+void PolynomialLimitCache::Insert(const Key& key,
+                                  const Point2d<double>& limit) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // updates an existing entry
+  auto iter = indexes_.find(key);
+  if (iter != indexes_.end()) {
+    entries_.splice(entries_.begin(), entries_, iter->second);
+    iter->second->limit = limit;
+    return;
+  }
+
+  Entry entry;
+  entry.key = key;
+  entry.limit = limit;
+  entries_.push_front(entry);
+  indexes_[key] = entries_.begin();
+  Evict();
+}
+
+bool PolynomialLimitCache::Load(const std::string& filepath) {
+  std::ifstream file(filepath.c_str());
+  if (file.is_open() == false) {
+    return false;
+  }
+
+  // validates header
+  std::string line;
+  if (!std::getline(file, line) || (line != kFileHeader)) {
+    wxLogWarning("Invalid polynomial limit cache file: "
+                 + wxString(filepath) + ".");
+    return false;
+  }
+
+  // reads an entry from each line
+  // format: size coefficients... slope_min slope_max type tolerance x y
+  std::lock_guard<std::mutex> lock(mutex_);
+  while (std::getline(file, line)) {
+    std::istringstream stream(line);
+
+    std::size_t size = 0;
+    if (!(stream >> size) || (64 < size)) {
+      continue;
+    }
+
+    Key key;
+    key.coefficients.resize(size);
+    bool is_valid = true;
+    for (std::size_t i = 0; i < size; i++) {
+      is_valid = is_valid && ReadDouble(stream, key.coefficients.at(i));
+    }
+
+    Point2d<double> limit;
+    is_valid = is_valid
+        && ReadDouble(stream, key.slope_min)
+        && ReadDouble(stream, key.slope_max)
+        && (stream >> key.type_search)
+        && ReadDouble(stream, key.tolerance)
+        && ReadDouble(stream, limit.x)
+        && ReadDouble(stream, limit.y);
+
+    if (is_valid == false) {
+      continue;
+    }
+
+    // the file is ordered from least to most recently used, so each entry
+    // is put in front of the ones before it
+    auto iter = indexes_.find(key);
+    if (iter != indexes_.end()) {
+      entries_.erase(iter->second);
+    }
+
+    Entry entry;
+    entry.key = key;
+    entry.limit = limit;
+    entries_.push_front(entry);
+    indexes_[key] = entries_.begin();
+  }
+
+  Evict();
+  return true;
+}
+
+void PolynomialLimitCache::LogStatistics() const {
+  wxString message;
+  message << "Polynomial limit cache: " << num_hits_.load() << " hits, "
+          << num_misses_.load() << " misses, "
+          << static_cast<unsigned long>(size()) << " entries.";
+  wxLogVerbose(message);
+}
+
+bool PolynomialLimitCache::Save(const std::string& filepath) const {
+  // generates the file contents, from least to most recently used
+  // format: size coefficients... slope_min slope_max type tolerance x y
+  std::string buffer = std::string(kFileHeader) + "\n";
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto iter = entries_.crbegin(); iter != entries_.crend(); iter++) {
+      const Key& key = iter->key;
+      const Point2d<double>& limit = iter->limit;
+
+      buffer += std::to_string(key.coefficients.size());
+      for (auto it = key.coefficients.cbegin();
+           it != key.coefficients.cend(); it++) {
+        WriteDouble(*it, buffer);
+      }
+      WriteDouble(key.slope_min, buffer);
+      WriteDouble(key.slope_max, buffer);
+      buffer += " " + std::to_string(key.type_search);
+      WriteDouble(key.tolerance, buffer);
+      WriteDouble(limit.x, buffer);
+      WriteDouble(limit.y, buffer);
+      buffer += "\n";
+    }
+  }
+
+  // writes and syncs a temporary file
+  const std::string filepath_temp = filepath + ".tmp";
+  FILE* file = fopen(filepath_temp.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  bool status = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+  status = (fflush(file) == 0) && status;
+#ifdef _WIN32
+  status = (_commit(_fileno(file)) == 0) && status;
+#else
+  status = (fsync(fileno(file)) == 0) && status;
+#endif
+  status = (fclose(file) == 0) && status;
+  if (status == false) {
+    wxRemoveFile(filepath_temp);
+    return false;
+  }
+
+  // replaces the cache file
+  return wxRenameFile(filepath_temp, filepath, true);
+}
+
+long PolynomialLimitCache::num_hits() const {
+  return num_hits_;
+}
+
+long PolynomialLimitCache::num_misses() const {
+  return num_misses_;
+}
+
+std::size_t PolynomialLimitCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+std::size_t PolynomialLimitCache::size_max() const {
+  return size_max_;
+}
+
+void PolynomialLimitCache::set_size_max(const std::size_t& size_max) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_max_ = size_max;
+  Evict();
+}
+
+void PolynomialLimitCache::Evict() {
+  while (size_max_ < entries_.size()) {
+    indexes_.erase(entries_.back().key);
+    entries_.pop_back();
+  }
+}
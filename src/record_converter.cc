@@ -0,0 +1,340 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "record_converter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#include "wx/filename.h"
+
+#include "async_log_sink.h"
+#include "conversion_metrics.h"
+#include "file_parser.h"
+#include "mapped_file.h"
+#include "trace_recorder.h"
+
+namespace {
+
+/// The number of records that a worker solves and writes as one batch.
+const std::size_t kNumRecordsBatch = 32;
+
+}  // namespace
+
+RecordConverter::RecordConverter(const CableConverter* converter) {
+  converter_ = converter;
+  index_next_ = 0;
+  library_ = nullptr;
+}
+
+RecordConverter::~RecordConverter() {
+}
+
+void RecordConverter::LogSummary() const {
+  int num_converted = 0;
+  int num_failed = 0;
+
+  // logs status of each record
+  for (auto iter = statuses_.cbegin(); iter != statuses_.cend(); iter++) {
+    const RecordStatus& status = *iter;
+    const wxString location =
+        FileParser::FileAndLineNumber(filepath_input_, status.line_number);
+    if (status.is_converted == true) {
+      wxLogVerbose("Converted: " + location + status.name);
+      num_converted++;
+    } else {
+      wxLogMessage("Failed: " + location + status.message);
+      num_failed++;
+    }
+  }
+
+  // logs totals
+  wxString message;
+  message << "Record summary: " << num_converted << " converted, "
+          << num_failed << " failed.";
+  wxLogMessage(message);
+}
+
+bool RecordConverter::Run(const wxString& filepath_input,
+                          const wxString& dir_output,
+                          const int& num_jobs) {
+  filepath_input_ = filepath_input;
+  index_next_ = 0;
+  results_.clear();
+  statuses_.clear();
+
+  // validates output directory
+  if (library_ == nullptr) {
+    if (wxFileName::DirExists(dir_output) == false) {
+      wxLogError("Invalid output directory: " + dir_output + ".");
+      return false;
+    }
+
+    if (wxFileName::IsDirWritable(dir_output) == false) {
+      wxLogError("Insufficient permissions for output directory: "
+                 + dir_output + ".");
+      return false;
+    }
+  }
+
+  // maps the input file, which stays open until all records are parsed
+  ConversionMetrics* metrics = converter_->metrics();
+  MappedFile file;
+  {
+    MetricsTimer timer(metrics, ConversionMetrics::Stage::kRead);
+    if (file.Open(filepath_input) == false) {
+      wxLogError("Could not read input file: " + filepath_input + ".");
+      return false;
+    }
+  }
+
+  if (metrics != nullptr) {
+    metrics->AddBytesRead(file.contents().size());
+  }
+
+  // finds the multi-record parser
+  const ParserRegistry* registry = converter_->parser_registry();
+  const ParserRegistry::Parser* parser = nullptr;
+  if (registry != nullptr) {
+    parser = registry->Sniff(filepath_input, file.contents());
+  }
+
+  if ((parser == nullptr) || (parser->parse_record == nullptr)) {
+    wxLogError("No multi-record parser matches the input file: "
+               + filepath_input + ".");
+    return false;
+  }
+
+  // workers log directly to the active target if it is thread safe
+  wxLog* log = dynamic_cast<AsyncLogSink*>(wxLog::GetActiveTarget());
+
+  // the split and the parse are timed together as the parse stage of the file
+  std::vector<RecordParser::Record> records;
+  {
+    MetricsTimer timer(metrics, ConversionMetrics::Stage::kParse);
+
+    // finds the records in a single scan
+    {
+      TraceSpan span(converter_->trace_recorder(), "SplitRecords",
+                     filepath_input);
+      RecordParser::Split(file.contents(), parser->marker_record, records);
+    }
+
+    if (records.empty() == true) {
+      wxLogError("No cable records were found in the input file: "
+                 + filepath_input + ".");
+      return false;
+    }
+
+    wxString message;
+    message << "Parsing " << static_cast<int>(records.size())
+            << " cable records with: " << parser->name;
+    wxLogVerbose(message);
+
+    // parses the records in parallel
+    TraceSpan span(converter_->trace_recorder(), "ParseRecords",
+                   filepath_input);
+    RecordParser::Parse(filepath_input, records, parser->parse_record,
+                        num_jobs, log, results_);
+  }
+  file.Close();
+
+  // creates a status for each record
+  // the record numbers are zero padded, so the files sort in file order
+  const wxString name_input = wxFileName(filepath_input).GetName();
+  char buffer[32];
+  const int num_digits = std::snprintf(buffer, sizeof(buffer), "%d",
+                                       static_cast<int>(records.size()));
+  statuses_.resize(records.size());
+  for (std::size_t i = 0; i < records.size(); i++) {
+    RecordStatus& status = statuses_.at(i);
+    const RecordParser::Result& result = results_.at(i);
+
+    std::snprintf(buffer, sizeof(buffer), "_%0*d", num_digits,
+                  static_cast<int>(i + 1));
+    wxFileName filename(dir_output, name_input + buffer);
+    filename.SetExt(converter_->ExtensionOutput());
+    status.filepath_output = filename.GetFullPath();
+
+    status.is_converted = false;
+    status.line_number = records.at(i).line_number + 1;
+    status.message = result.message;
+    status.name = result.cable.name;
+  }
+
+  // determines the number of worker threads
+  int num_threads = num_jobs;
+  if (num_threads < 1) {
+    num_threads = std::thread::hardware_concurrency();
+  }
+  if (num_threads < 1) {
+    num_threads = 1;
+  }
+  if (static_cast<std::size_t>(num_threads) > statuses_.size()) {
+    num_threads = static_cast<int>(statuses_.size());
+  }
+
+  // runs the worker threads and waits for all to finish
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.push_back(
+        std::thread(&RecordConverter::ConvertRecords, this, log));
+  }
+
+  for (auto iter = threads.begin(); iter != threads.end(); iter++) {
+    iter->join();
+  }
+
+  wxLog::FlushActive();
+
+  return true;
+}
+
+void RecordConverter::set_library(CableLibraryWriter* library) {
+  library_ = library;
+}
+
+const std::vector<RecordConverter::RecordStatus>&
+    RecordConverter::statuses() const {
+  return statuses_;
+}
+
+void RecordConverter::ConvertRecords(wxLog* log) {
+  if (log != nullptr) {
+    wxLog::SetThreadActiveTarget(log);
+  }
+
+  // output files are written in batches if the converter has an output
+  // writer
+  const bool is_batched = (library_ == nullptr)
+                          && (converter_->output_writer() != nullptr);
+
+  while (true) {
+    // claims the next batch of records
+    const std::size_t index_begin = index_next_.fetch_add(kNumRecordsBatch);
+    if (statuses_.size() <= index_begin) {
+      break;
+    }
+    const std::size_t index_end = std::min(index_begin + kNumRecordsBatch,
+                                           statuses_.size());
+
+    // starts a conversion for each parsed record
+    std::vector<std::unique_ptr<CableConverter::Conversion>> conversions;
+    std::vector<CableConverter::Conversion*> conversions_batch;
+    std::vector<std::size_t> indexes;
+    for (std::size_t index = index_begin; index < index_end; index++) {
+      // skips records that could not be parsed
+      RecordParser::Result& result = results_.at(index);
+      if (result.is_parsed == false) {
+        if (converter_->metrics() != nullptr) {
+          converter_->metrics()->AddFile(false);
+        }
+        continue;
+      }
+
+      // limit tables are only written next to output files
+      std::unique_ptr<CableConverter::Conversion> conversion(
+          new CableConverter::Conversion());
+      CableConverter::Begin(filepath_input_, library_ == nullptr,
+                            *conversion);
+      conversion->cable = std::move(result.cable);
+      conversion->units = result.units;
+      conversions_batch.push_back(conversion.get());
+      conversions.push_back(std::move(conversion));
+      indexes.push_back(index);
+    }
+
+    // solves the batch together, and serializes each solved cable
+    std::vector<bool> statuses_solved;
+    converter_->SolveBatch(conversions_batch, statuses_solved);
+
+    std::vector<std::unique_ptr<CableConverter::Conversion>> conversions_write;
+    std::vector<std::size_t> indexes_write;
+    for (std::size_t i = 0; i < conversions.size(); i++) {
+      CableConverter::Conversion& conversion = *conversions[i];
+      const std::size_t index = indexes[i];
+      RecordStatus& status = statuses_.at(index);
+      if ((statuses_solved[i] == false)
+          || (converter_->Serialize(conversion) == false)) {
+        status.message = conversion.message;
+        if (converter_->metrics() != nullptr) {
+          converter_->metrics()->AddFile(false);
+        }
+        continue;
+      }
+
+      // holds the output file until the batch is serialized
+      if (is_batched == true) {
+        conversions_write.push_back(std::move(conversions[i]));
+        indexes_write.push_back(index);
+        continue;
+      }
+
+      // writes the output file, or adds the cable to the library
+      if (library_ == nullptr) {
+        status.is_converted = converter_->Write(status.filepath_output,
+                                                conversion);
+      } else {
+        // the record number keeps each source unique, so a record only
+        // replaces the same record from an earlier run
+        const wxString source =
+            wxFileName(filepath_input_).GetFullName()
+            + wxString::Format("#%d", static_cast<int>(index + 1));
+        status.is_converted = library_->Add(
+            conversion.cable.name, std::string(source.ToUTF8().data()),
+            conversion.buffer, conversion.message);
+      }
+
+      if (status.is_converted == false) {
+        status.message = conversion.message;
+      }
+
+      if (converter_->metrics() != nullptr) {
+        converter_->metrics()->AddFile(status.is_converted);
+      }
+    }
+
+    WriteRecords(conversions_write, indexes_write);
+  }
+
+  if (log != nullptr) {
+    wxLog::SetThreadActiveTarget(nullptr);
+  }
+}
+
+void RecordConverter::WriteRecords(
+    std::vector<std::unique_ptr<CableConverter::Conversion>>& conversions,
+    std::vector<std::size_t>& indexes) {
+  if (conversions.empty() == true) {
+    return;
+  }
+
+  std::vector<wxString> filepaths_output;
+  std::vector<CableConverter::Conversion*> conversions_batch;
+  for (std::size_t i = 0; i < conversions.size(); i++) {
+    filepaths_output.push_back(statuses_.at(indexes[i]).filepath_output);
+    conversions_batch.push_back(conversions[i].get());
+  }
+
+  std::vector<bool> statuses_written;
+  converter_->WriteBatch(filepaths_output, conversions_batch,
+                         statuses_written);
+
+  for (std::size_t i = 0; i < conversions.size(); i++) {
+    RecordStatus& status = statuses_.at(indexes[i]);
+    status.is_converted = statuses_written[i];
+    if (status.is_converted == false) {
+      status.message = conversions[i]->message;
+    }
+
+    if (converter_->metrics() != nullptr) {
+      converter_->metrics()->AddFile(status.is_converted);
+    }
+  }
+
+  conversions.clear();
+  indexes.clear();
+}
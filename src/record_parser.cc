@@ -0,0 +1,166 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "record_parser.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#include "conversion_arena.h"
+
+namespace {
+
+/// \brief Parses chunks of records until the shared index is exhausted.
+/// This is the worker thread entry point.
+/// \param[in] filepath
+///   The input filepath.
+/// \param[in] records
+///   The records.
+/// \param[in] parse_record
+///   The record parse function.
+/// \param[in] log
+///   A thread safe log target that the worker logs to directly. If this is a
+///   nullptr, messages are buffered by wxWidgets until the main thread
+///   flushes them.
+/// \param[in,out] index_next
+///   The index of the next chunk to be parsed.
+/// \param[out] results
+///   The results. Each worker only modifies the results in its own chunks.
+void ParseChunks(const wxString* filepath,
+                 const std::vector<RecordParser::Record>* records,
+                 ParserRegistry::ParseRecordFunction parse_record,
+                 wxLog* log,
+                 std::atomic<std::size_t>* index_next,
+                 std::vector<RecordParser::Result>* results) {
+  if (log != nullptr) {
+    wxLog::SetThreadActiveTarget(log);
+  }
+
+  // the parse scratch of each record is released before the next one
+  ConversionArena arena;
+
+  while (true) {
+    // claims the next chunk
+    const std::size_t index_begin =
+        (*index_next)++ * RecordParser::kNumRecordsChunk;
+    if (records->size() <= index_begin) {
+      break;
+    }
+
+    std::size_t index_end = index_begin + RecordParser::kNumRecordsChunk;
+    if (records->size() < index_end) {
+      index_end = records->size();
+    }
+
+    for (std::size_t i = index_begin; i < index_end; i++) {
+      const RecordParser::Record& record = records->at(i);
+      RecordParser::Result& result = results->at(i);
+
+      ConversionArena::Scope scope_arena(&arena);
+      result.units = units::UnitSystem::kNull;
+      result.is_parsed = parse_record(*filepath, record.text,
+                                      record.line_number, result.units,
+                                      result.cable);
+      if (result.is_parsed == false) {
+        result.message = "Parsing errors were encountered.";
+      }
+    }
+  }
+
+  if (log != nullptr) {
+    wxLog::SetThreadActiveTarget(nullptr);
+  }
+}
+
+}  // namespace
+
+bool RecordParser::Parse(const wxString& filepath,
+                         const std::vector<Record>& records,
+                         ParserRegistry::ParseRecordFunction parse_record,
+                         const int& num_jobs,
+                         wxLog* log,
+                         std::vector<Result>& results) {
+  results.clear();
+  results.resize(records.size());
+
+  // determines the number of worker threads
+  const std::size_t num_chunks =
+      (records.size() + kNumRecordsChunk - 1) / kNumRecordsChunk;
+  int num_threads = num_jobs;
+  if (num_threads < 1) {
+    num_threads = std::thread::hardware_concurrency();
+  }
+  if (num_threads < 1) {
+    num_threads = 1;
+  }
+  if (static_cast<std::size_t>(num_threads) > num_chunks) {
+    num_threads = static_cast<int>(num_chunks);
+  }
+
+  // runs the worker threads and waits for all to finish
+  std::atomic<std::size_t> index_next(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.push_back(std::thread(ParseChunks, &filepath, &records,
+                                  parse_record, log, &index_next, &results));
+  }
+
+  for (auto iter = threads.begin(); iter != threads.end(); iter++) {
+    iter->join();
+  }
+
+  wxLog::FlushActive();
+
+  for (auto iter = results.cbegin(); iter != results.cend(); iter++) {
+    if (iter->is_parsed == false) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void RecordParser::Split(const TextView& contents, const TextView& marker,
+                         std::vector<Record>& records) {
+  records.clear();
+  if (marker.empty() == true) {
+    return;
+  }
+
+  const char* data = contents.data();
+  const std::size_t size = contents.size();
+
+  // scans the start of each line for the marker, and counts lines with the
+  // same search that finds the next line
+  std::size_t pos = 0;
+  int line_number = 0;
+  std::size_t pos_record = TextView::npos;
+  Record record;
+  while (pos < size) {
+    if ((marker.size() <= size - pos)
+        && (std::memcmp(data + pos, marker.data(), marker.size()) == 0)) {
+      // ends the previous record
+      if (pos_record != TextView::npos) {
+        record.text = contents.substr(pos_record, pos - pos_record);
+        records.push_back(record);
+      }
+
+      pos_record = pos;
+      record.line_number = line_number;
+    }
+
+    const void* end = std::memchr(data + pos, '\n', size - pos);
+    if (end == nullptr) {
+      break;
+    }
+    pos = static_cast<const char*>(end) - data + 1;
+    line_number++;
+  }
+
+  // ends the last record
+  if (pos_record != TextView::npos) {
+    record.text = contents.substr(pos_record);
+    records.push_back(record);
+  }
+}
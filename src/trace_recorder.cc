@@ -0,0 +1,303 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "trace_recorder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+/// \brief Appends a string with JSON escaping.
+/// \param[in] str
+///   The UTF-8 encoded string.
+/// \param[in,out] buffer
+///   The buffer.
+void AppendJsonString(const std::string& str, std::string& buffer) {
+  buffer += '"';
+  for (auto iter = str.cbegin(); iter != str.cend(); iter++) {
+    const char c = *iter;
+    if ((c == '"') || (c == '\\')) {
+      buffer += '\\';
+      buffer += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      buffer += escaped;
+    } else {
+      buffer += c;
+    }
+  }
+  buffer += '"';
+}
+
+/// The allocations made on the calling thread by recording spans. These are
+/// removed from the span counts, so the enclosing spans only count the
+/// allocations of the conversion.
+thread_local AllocationStats::Counts counts_recording = {0, 0};
+
+/// \brief Gets the allocation counts of the calling thread, without the
+///   allocations made by recording spans.
+/// \return The allocation counts.
+AllocationStats::Counts CountsThread() {
+  AllocationStats::Counts counts = AllocationStats::ThreadCounts();
+  counts.allocations -= counts_recording.allocations;
+  counts.bytes -= counts_recording.bytes;
+  return counts;
+}
+
+/// \brief Gets a percentile using the nearest rank method.
+/// \param[in] values
+///   The sorted values.
+/// \param[in] percentile
+///   The percentile, from 0 to 1.
+/// \return The percentile value.
+double Percentile(const std::vector<double>& values, const double& percentile) {
+  if (values.empty() == true) {
+    return 0;
+  }
+
+  int index = static_cast<int>(std::ceil(percentile * values.size())) - 1;
+  index = std::max(0, std::min(index, static_cast<int>(values.size()) - 1));
+  return values[index];
+}
+
+}  // namespace
+
+TraceRecorder::TraceRecorder() {
+  time_start_ = std::chrono::steady_clock::now();
+}
+
+TraceRecorder::~TraceRecorder() {
+}
+
+void TraceRecorder::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  events_.clear();
+  threads_.clear();
+  time_start_ = std::chrono::steady_clock::now();
+}
+
+void TraceRecorder::LogAllocationSummary() const {
+  const std::vector<Event> events = this->events();
+
+  // groups events by stage, in the order the stages first occurred
+  std::vector<std::string> names;
+  std::vector<std::vector<const Event*>> groups;
+  for (auto iter = events.cbegin(); iter != events.cend(); iter++) {
+    const Event& event = *iter;
+    const auto iter_name = std::find(names.cbegin(), names.cend(),
+                                     std::string(event.name));
+    const std::size_t index = iter_name - names.cbegin();
+    if (iter_name == names.cend()) {
+      names.push_back(event.name);
+      groups.push_back(std::vector<const Event*>());
+    }
+    groups[index].push_back(&event);
+  }
+
+  // logs each stage
+  wxLogMessage("Stage allocations (per span):");
+  for (std::size_t i = 0; i < names.size(); i++) {
+    const std::vector<const Event*>& group = groups[i];
+
+    int64_t allocations_max = 0;
+    int64_t allocations_total = 0;
+    int64_t bytes_max = 0;
+    int64_t bytes_total = 0;
+    int num_free = 0;
+    for (auto iter = group.cbegin(); iter != group.cend(); iter++) {
+      const Event& event = **iter;
+      allocations_max = std::max(allocations_max, event.allocations);
+      allocations_total += event.allocations;
+      bytes_max = std::max(bytes_max, event.bytes_allocated);
+      bytes_total += event.bytes_allocated;
+      if (event.allocations == 0) {
+        num_free++;
+      }
+    }
+
+    const double num = static_cast<double>(group.size());
+    wxString message;
+    message << "  " << names[i] << ": " << static_cast<int>(group.size())
+            << " spans, allocs mean "
+            << wxString::Format("%.1f", allocations_total / num)
+            << ", max " << static_cast<long long>(allocations_max)
+            << ", bytes mean "
+            << wxString::Format("%.0f", bytes_total / num)
+            << ", max " << static_cast<long long>(bytes_max)
+            << ", allocation-free " << num_free;
+    wxLogMessage(message);
+  }
+}
+
+void TraceRecorder::LogSummary() const {
+  const std::vector<Event> events = this->events();
+
+  // groups durations by stage, in the order the stages first occurred
+  std::vector<std::string> names;
+  std::vector<std::vector<double>> durations;
+  for (auto iter = events.cbegin(); iter != events.cend(); iter++) {
+    const Event& event = *iter;
+    const auto iter_name = std::find(names.cbegin(), names.cend(),
+                                     std::string(event.name));
+    const std::size_t index = iter_name - names.cbegin();
+    if (iter_name == names.cend()) {
+      names.push_back(event.name);
+      durations.push_back(std::vector<double>());
+    }
+    durations[index].push_back(event.duration);
+  }
+
+  // logs each stage, in milliseconds
+  wxLogMessage("Stage timing (ms):");
+  for (std::size_t i = 0; i < names.size(); i++) {
+    std::vector<double>& values = durations[i];
+    std::sort(values.begin(), values.end());
+
+    double total = 0;
+    for (auto iter = values.cbegin(); iter != values.cend(); iter++) {
+      total += *iter;
+    }
+
+    wxString message;
+    message << "  " << names[i] << ": " << static_cast<int>(values.size())
+            << " spans, total "
+            << wxString::Format("%.3f", total / 1000)
+            << ", mean "
+            << wxString::Format("%.3f", total / values.size() / 1000)
+            << ", p50 "
+            << wxString::Format("%.3f", Percentile(values, 0.50) / 1000)
+            << ", p99 "
+            << wxString::Format("%.3f", Percentile(values, 0.99) / 1000);
+    wxLogMessage(message);
+  }
+}
+
+void TraceRecorder::Record(
+    const char* name,
+    const wxString& filepath,
+    const std::chrono::steady_clock::time_point& start,
+    const std::chrono::steady_clock::time_point& stop,
+    const AllocationStats::Counts& counts) {
+  Event event;
+  event.allocations = counts.allocations;
+  event.bytes_allocated = counts.bytes;
+  event.duration =
+      std::chrono::duration<double, std::micro>(stop - start).count();
+  event.filepath = std::string(filepath.ToUTF8().data());
+  event.name = name;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  event.start =
+      std::chrono::duration<double, std::micro>(start - time_start_).count();
+  event.thread = ThreadIndex();
+  events_.push_back(event);
+}
+
+bool TraceRecorder::Save(const wxString& filepath) const {
+  std::vector<Event> events;
+  std::size_t num_threads;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events = events_;
+    num_threads = threads_.size();
+  }
+
+  // generates the trace event JSON
+  std::string buffer = "{\"traceEvents\":[\n";
+  char str_num[128];
+
+  // adds thread name metadata events
+  for (std::size_t i = 1; i <= num_threads; i++) {
+    snprintf(str_num, sizeof(str_num),
+             "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+             "\"args\":{\"name\":\"thread %d\"}},\n",
+             static_cast<int>(i), static_cast<int>(i));
+    buffer += str_num;
+  }
+
+  // adds complete events
+  for (auto iter = events.cbegin(); iter != events.cend(); iter++) {
+    const Event& event = *iter;
+    buffer += "{\"name\":";
+    AppendJsonString(event.name, buffer);
+    snprintf(str_num, sizeof(str_num),
+             ",\"cat\":\"conversion\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+             "\"pid\":1,\"tid\":%d,\"args\":{\"allocs\":%lld,"
+             "\"bytes\":%lld,\"file\":",
+             event.start, event.duration, event.thread,
+             static_cast<long long>(event.allocations),
+             static_cast<long long>(event.bytes_allocated));
+    buffer += str_num;
+    AppendJsonString(event.filepath, buffer);
+    buffer += "}},\n";
+  }
+
+  // removes the trailing separator
+  if (buffer.compare(buffer.size() - 2, 2, ",\n") == 0) {
+    buffer.erase(buffer.size() - 2, 1);
+  }
+  buffer += "],\"displayTimeUnit\":\"ms\"}\n";
+
+  // writes the file
+  FILE* file = fopen(filepath.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  const std::size_t size = fwrite(buffer.data(), 1, buffer.size(), file);
+  const bool is_closed = fclose(file) == 0;
+  return (size == buffer.size()) && (is_closed == true);
+}
+
+std::vector<TraceRecorder::Event> TraceRecorder::events() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return events_;
+}
+
+int TraceRecorder::ThreadIndex() {
+  const std::thread::id id = std::this_thread::get_id();
+  const auto iter = std::find(threads_.cbegin(), threads_.cend(), id);
+  if (iter != threads_.cend()) {
+    return static_cast<int>(iter - threads_.cbegin()) + 1;
+  }
+
+  threads_.push_back(id);
+  return static_cast<int>(threads_.size());
+}
+
+TraceSpan::TraceSpan(TraceRecorder* recorder, const char* name,
+                     const wxString& filepath) {
+  recorder_ = recorder;
+  if (recorder_ == nullptr) {
+    return;
+  }
+
+  filepath_ = &filepath;
+  name_ = name;
+  counts_start_ = CountsThread();
+  start_ = std::chrono::steady_clock::now();
+}
+
+TraceSpan::~TraceSpan() {
+  if (recorder_ == nullptr) {
+    return;
+  }
+
+  const std::chrono::steady_clock::time_point stop =
+      std::chrono::steady_clock::now();
+  const AllocationStats::Counts counts_stop = CountsThread();
+
+  AllocationStats::Counts counts;
+  counts.allocations = counts_stop.allocations - counts_start_.allocations;
+  counts.bytes = counts_stop.bytes - counts_start_.bytes;
+  recorder_->Record(name_, *filepath_, start_, stop, counts);
+
+  // excludes the recording allocations from the enclosing spans
+  const AllocationStats::Counts counts_recorded = CountsThread();
+  counts_recording.allocations +=
+      counts_recorded.allocations - counts_stop.allocations;
+  counts_recording.bytes += counts_recorded.bytes - counts_stop.bytes;
+}
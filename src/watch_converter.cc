@@ -0,0 +1,328 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "watch_converter.h"
+
+#include <thread>
+#include <vector>
+
+#include "wx/dir.h"
+#include "wx/filename.h"
+
+#include "async_log_sink.h"
+#include "directory_watcher.h"
+
+std::atomic<bool> WatchConverter::is_stop_requested_(false);
+
+WatchConverter::WatchConverter(const CableConverter* converter) {
+  converter_ = converter;
+  is_stopping_ = false;
+  num_converted_ = 0;
+  num_failed_ = 0;
+  num_temp_ = 0;
+}
+
+WatchConverter::~WatchConverter() {
+}
+
+void WatchConverter::RequestStop() {
+  is_stop_requested_ = true;
+}
+
+bool WatchConverter::Run(const wxString& dir_input,
+                         const wxString& dir_output,
+                         const int& num_jobs) {
+  dir_input_ = dir_input;
+  dir_output_ = dir_output;
+  is_stopping_ = false;
+  converting_.clear();
+  queue_.clear();
+  queued_.clear();
+  requeued_.clear();
+
+  // validates directories
+  if (wxFileName::DirExists(dir_input) == false) {
+    wxLogError("Invalid input directory: " + dir_input + ".");
+    return false;
+  }
+
+  if (wxFileName::DirExists(dir_output) == false) {
+    wxLogError("Invalid output directory: " + dir_output + ".");
+    return false;
+  }
+
+  if (wxFileName::IsDirWritable(dir_output) == false) {
+    wxLogError("Insufficient permissions for output directory: "
+               + dir_output + ".");
+    return false;
+  }
+
+  if (wxFileName::DirName(dir_input).SameAs(wxFileName::DirName(dir_output))
+      == true) {
+    wxLogError("The input and output directories must be different.");
+    return false;
+  }
+
+  // starts watching before the existing files are listed, so no file is
+  // missed in between
+  DirectoryWatcher watcher;
+  if (watcher.Open(dir_input) == false) {
+    wxLogError("Could not watch input directory: " + dir_input + ".");
+    return false;
+  }
+
+  EnqueueOutdated();
+
+  // determines the number of worker threads
+  int num_threads = num_jobs;
+  if (num_threads < 1) {
+    num_threads = std::thread::hardware_concurrency();
+  }
+  if (num_threads < 1) {
+    num_threads = 1;
+  }
+
+  // workers log directly to the active target if it is thread safe
+  wxLog* log = dynamic_cast<AsyncLogSink*>(wxLog::GetActiveTarget());
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.push_back(std::thread(&WatchConverter::ConvertFiles, this, log));
+  }
+
+  wxLogMessage("Watching for files in: " + dir_input);
+
+  // queues files as they are ready
+  std::vector<wxString> filepaths;
+  while (is_stop_requested_ == false) {
+    if (watcher.Wait(std::chrono::milliseconds(200), filepaths) == false) {
+      wxLogError("Input directory is no longer available: " + dir_input
+                 + ".");
+      break;
+    }
+
+    for (auto iter = filepaths.cbegin(); iter != filepaths.cend(); iter++) {
+      Enqueue(*iter);
+    }
+
+    // shows messages from the worker threads if they are buffered
+    wxLog::FlushActive();
+  }
+
+  // stops the worker threads after their current files
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  condition_.notify_all();
+
+  for (auto iter = threads.begin(); iter != threads.end(); iter++) {
+    iter->join();
+  }
+
+  wxLog::FlushActive();
+
+  wxString message;
+  message << "Watch summary: " << num_converted_.load() << " converted, "
+          << num_failed_.load() << " failed.";
+  wxLogMessage(message);
+
+  return true;
+}
+
+long WatchConverter::num_converted() const {
+  return num_converted_;
+}
+
+long WatchConverter::num_failed() const {
+  return num_failed_;
+}
+
+void WatchConverter::ConvertFile(const wxString& filepath_input) {
+  const wxString filepath_output = FilePathOutput(filepath_input);
+
+  // the temporary file is hidden, and in the output directory so the rename
+  // does not move the file across file systems
+  // it is numbered so conversions to the same output never share it
+  const wxFileName filename_output(filepath_output);
+  wxString name_temp;
+  name_temp << "." << filename_output.GetFullName() << "." << num_temp_++
+            << ".tmp";
+  const wxString filepath_temp =
+      wxFileName(dir_output_, name_temp).GetFullPath();
+
+  // the output file would be replaced by whichever file was converted last
+  wxString message;
+  bool is_converted = false;
+  const wxString filepath_shared = FilePathInputShared(filepath_input);
+  if (filepath_shared.empty() == false) {
+    message = "Output file is shared with: " + filepath_shared + ".";
+  } else {
+    is_converted = converter_->Convert(filepath_input, filepath_temp,
+                                       message);
+  }
+
+  if ((is_converted == true)
+      && (wxRenameFile(filepath_temp, filepath_output, true) == false)) {
+    message = "Could not rename temporary file: " + filepath_temp + ".";
+    is_converted = false;
+  }
+
+  // the limit table is written next to the temporary file, so it is renamed
+  // along with it
+  const wxString filepath_table_temp =
+      converter_->FilePathLimitTable(filepath_temp);
+  if ((is_converted == true) && (filepath_table_temp.empty() == false)
+      && (wxFileName::FileExists(filepath_table_temp) == true)
+      && (wxRenameFile(filepath_table_temp,
+                       converter_->FilePathLimitTable(filepath_output), true)
+          == false)) {
+    message = "Could not rename temporary file: " + filepath_table_temp + ".";
+    is_converted = false;
+  }
+
+  if (is_converted == true) {
+    wxLogMessage("Converted: " + filepath_input);
+    num_converted_++;
+  } else {
+    if (wxFileName::FileExists(filepath_temp) == true) {
+      wxRemoveFile(filepath_temp);
+    }
+
+    if ((filepath_table_temp.empty() == false)
+        && (wxFileName::FileExists(filepath_table_temp) == true)) {
+      wxRemoveFile(filepath_table_temp);
+    }
+
+    wxLogMessage("Failed: " + filepath_input + "  --  " + message);
+    num_failed_++;
+  }
+
+  if (converter_->metrics() != nullptr) {
+    converter_->metrics()->AddFile(is_converted);
+  }
+}
+
+void WatchConverter::ConvertFiles(wxLog* log) {
+  if (log != nullptr) {
+    wxLog::SetThreadActiveTarget(log);
+  }
+
+  while (true) {
+    // waits for the next file
+    wxString filepath;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while ((is_stopping_ == false) && (queue_.empty() == true)) {
+        condition_.wait(lock);
+      }
+
+      if (is_stopping_ == true) {
+        break;
+      }
+
+      filepath = queue_.front();
+      queue_.pop_front();
+      queued_.erase(filepath);
+      converting_.insert(filepath);
+    }
+
+    ConvertFile(filepath);
+
+    // queues the file again if it changed while it was converted
+    bool is_requeued = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      converting_.erase(filepath);
+      if (requeued_.erase(filepath) != 0) {
+        queued_.insert(filepath);
+        queue_.push_back(filepath);
+        is_requeued = true;
+      }
+    }
+
+    if (is_requeued == true) {
+      condition_.notify_one();
+    }
+  }
+
+  if (log != nullptr) {
+    wxLog::SetThreadActiveTarget(nullptr);
+  }
+}
+
+void WatchConverter::Enqueue(const wxString& filepath) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // a file that is being converted is queued when its conversion finishes,
+    // so two workers never convert it at once
+    if (converting_.count(filepath) != 0) {
+      requeued_.insert(filepath);
+      return;
+    }
+
+    if (queued_.insert(filepath).second == false) {
+      return;
+    }
+    queue_.push_back(filepath);
+  }
+  condition_.notify_one();
+}
+
+void WatchConverter::EnqueueOutdated() {
+  wxArrayString filepaths;
+  wxDir::GetAllFiles(dir_input_, &filepaths, wxEmptyString, wxDIR_FILES);
+  filepaths.Sort();
+
+  for (std::size_t i = 0; i < filepaths.GetCount(); i++) {
+    const wxString& filepath_input = filepaths[i];
+    const wxFileName filename_input(filepath_input);
+    const wxString name = filename_input.GetFullName();
+    if (name.StartsWith(".") || name.EndsWith(".tmp")) {
+      continue;
+    }
+
+    const wxFileName filename_output(FilePathOutput(filepath_input));
+    if ((filename_output.FileExists() == false)
+        || (filename_output.GetModificationTime().IsEarlierThan(
+                filename_input.GetModificationTime()) == true)) {
+      Enqueue(filepath_input);
+    }
+  }
+}
+
+wxString WatchConverter::FilePathInputShared(
+    const wxString& filepath_input) const {
+  // the input files with the same output file have the same name, with any
+  // extension or none
+  const wxFileName filename_input(filepath_input);
+  const wxString name = filename_input.GetName();
+  wxArrayString filepaths;
+  wxDir::GetAllFiles(dir_input_, &filepaths, name + ".*", wxDIR_FILES);
+
+  const wxString filepath_bare = wxFileName(dir_input_, name).GetFullPath();
+  if (wxFileName::FileExists(filepath_bare) == true) {
+    filepaths.Add(filepath_bare);
+  }
+
+  const bool is_case_sensitive = wxFileName::IsCaseSensitive();
+  for (std::size_t i = 0; i < filepaths.GetCount(); i++) {
+    const wxFileName filename(filepaths[i]);
+    if ((filename.GetName().IsSameAs(name, is_case_sensitive) == false)
+        || (filename.GetFullName().EndsWith(".tmp") == true)
+        || (filename.SameAs(filename_input) == true)) {
+      continue;
+    }
+
+    return filepaths[i];
+  }
+
+  return wxEmptyString;
+}
+
+wxString WatchConverter::FilePathOutput(const wxString& filepath_input) const {
+  wxFileName filename(dir_output_, wxFileName(filepath_input).GetName());
+  filename.SetExt(converter_->ExtensionOutput());
+  return filename.GetFullPath();
+}
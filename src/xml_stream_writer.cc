@@ -0,0 +1,228 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "xml_stream_writer.h"
+
+#include <cstdio>
+#include <cstring>
+
+XmlStreamWriter::XmlStreamWriter(const int& indentstep) {
+  indentstep_ = indentstep;
+}
+
+XmlStreamWriter::~XmlStreamWriter() {
+}
+
+void XmlStreamWriter::AddAttribute(const wxString& name,
+                                   const wxString& value) {
+  buffer_ += ' ';
+  Append(name);
+  buffer_ += "=\"";
+  AppendEscaped(value, true);
+  buffer_ += '"';
+}
+
+void XmlStreamWriter::AddAttribute(const char* name, const char* value) {
+  buffer_ += ' ';
+  buffer_ += name;
+  buffer_ += "=\"";
+  AppendEscaped(value, std::strlen(value), true);
+  buffer_ += '"';
+}
+
+void XmlStreamWriter::Clear() {
+  buffer_.clear();
+  elements_.clear();
+}
+
+void XmlStreamWriter::EndElement() {
+  if (elements_.empty() == true) {
+    return;
+  }
+
+  const ElementState& state = elements_.back();
+  if (state.is_start_tag_open == true) {
+    // no children, so an empty element tag is used
+    buffer_ += "/>";
+  } else {
+    if ((0 <= indentstep_) && (state.is_last_child_text == false)) {
+      AppendIndentation(static_cast<int>(elements_.size() - 1) * indentstep_);
+    }
+    // the buffer is reserved first, so the name isn't moved while appending
+    // it to the same buffer
+    buffer_.reserve(buffer_.size() + state.size_name + 3);
+    buffer_ += "</";
+    buffer_.append(buffer_, state.pos_name, state.size_name);
+    buffer_ += '>';
+  }
+  elements_.pop_back();
+
+  // ends the document after the root element
+  if (elements_.empty() == true) {
+    buffer_ += '\n';
+  }
+}
+
+bool XmlStreamWriter::Save(const wxString& filepath) const {
+  FILE* file = fopen(filepath.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  const std::size_t size = fwrite(buffer_.data(), 1, buffer_.size(), file);
+  const bool is_closed = fclose(file) == 0;
+  return (size == buffer_.size()) && (is_closed == true);
+}
+
+void XmlStreamWriter::StartElement(const wxString& name) {
+  if (elements_.empty() == true) {
+    buffer_ += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+  } else {
+    BeginChild(false);
+  }
+
+  buffer_ += '<';
+  const std::size_t pos_name = buffer_.size();
+  Append(name);
+  PushElement(pos_name);
+}
+
+void XmlStreamWriter::StartElement(const char* name) {
+  if (elements_.empty() == true) {
+    buffer_ += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+  } else {
+    BeginChild(false);
+  }
+
+  buffer_ += '<';
+  const std::size_t pos_name = buffer_.size();
+  buffer_ += name;
+  PushElement(pos_name);
+}
+
+void XmlStreamWriter::TakeBuffer(std::string& buffer) {
+  buffer.clear();
+  buffer.swap(buffer_);
+  elements_.clear();
+}
+
+void XmlStreamWriter::WriteNode(const wxXmlNode* node) {
+  if (node == nullptr) {
+    return;
+  }
+
+  if (node->GetType() == wxXML_TEXT_NODE) {
+    WriteText(node->GetContent());
+    return;
+  }
+
+  if (node->GetType() != wxXML_ELEMENT_NODE) {
+    return;
+  }
+
+  StartElement(node->GetName());
+
+  for (const wxXmlAttribute* attribute = node->GetAttributes();
+       attribute != nullptr; attribute = attribute->GetNext()) {
+    AddAttribute(attribute->GetName(), attribute->GetValue());
+  }
+
+  for (const wxXmlNode* child = node->GetChildren(); child != nullptr;
+       child = child->GetNext()) {
+    WriteNode(child);
+  }
+
+  EndElement();
+}
+
+void XmlStreamWriter::WriteText(const wxString& content) {
+  BeginChild(true);
+  AppendEscaped(content, false);
+}
+
+void XmlStreamWriter::WriteText(const char* content) {
+  BeginChild(true);
+  AppendEscaped(content, std::strlen(content), false);
+}
+
+const std::string& XmlStreamWriter::buffer() const {
+  return buffer_;
+}
+
+void XmlStreamWriter::Append(const wxString& str) {
+  const auto utf8 = str.ToUTF8();
+  buffer_.append(utf8.data(), utf8.length());
+}
+
+void XmlStreamWriter::AppendEscaped(const wxString& str,
+                                    const bool& is_attribute) {
+  const auto utf8 = str.ToUTF8();
+  AppendEscaped(utf8.data(), utf8.length(), is_attribute);
+}
+
+void XmlStreamWriter::AppendEscaped(const char* data,
+                                    const std::size_t& length,
+                                    const bool& is_attribute) {
+  // only ASCII characters are escaped, so the UTF-8 bytes can be scanned
+  // directly
+  for (std::size_t i = 0; i < length; i++) {
+    const char c = data[i];
+    switch (c) {
+      case '<':
+        buffer_ += "&lt;";
+        break;
+      case '>':
+        buffer_ += "&gt;";
+        break;
+      case '&':
+        buffer_ += "&amp;";
+        break;
+      case '\r':
+        buffer_ += "&#xD;";
+        break;
+      case '"':
+        buffer_ += is_attribute ? "&quot;" : "\"";
+        break;
+      case '\t':
+        buffer_ += is_attribute ? "&#x9;" : "\t";
+        break;
+      case '\n':
+        buffer_ += is_attribute ? "&#xA;" : "\n";
+        break;
+      default:
+        buffer_ += c;
+    }
+  }
+}
+
+void XmlStreamWriter::AppendIndentation(const int& indent) {
+  buffer_ += '\n';
+  buffer_.append(indent, ' ');
+}
+
+void XmlStreamWriter::BeginChild(const bool& is_text) {
+  if (elements_.empty() == true) {
+    return;
+  }
+
+  ElementState& state = elements_.back();
+  if (state.is_start_tag_open == true) {
+    buffer_ += '>';
+    state.is_start_tag_open = false;
+  }
+
+  if ((0 <= indentstep_) && (is_text == false)) {
+    AppendIndentation(static_cast<int>(elements_.size()) * indentstep_);
+  }
+
+  state.is_last_child_text = is_text;
+}
+
+void XmlStreamWriter::PushElement(const std::size_t& pos_name) {
+  ElementState state;
+  state.is_last_child_text = false;
+  state.is_start_tag_open = true;
+  state.pos_name = pos_name;
+  state.size_name = buffer_.size() - pos_name;
+  elements_.push_back(state);
+}